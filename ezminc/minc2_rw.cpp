@@ -0,0 +1,222 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       :
+@DESCRIPTION: C++ interface to minc files, uses MINC2 API only
+@CREATED    : Oct. 19, 2026
+---------------------------------------------------------------------------- */
+#include <stdlib.h>
+#include <string.h>
+#include "minc2_rw.h"
+
+namespace minc
+{
+  minc2_base::minc2_base():
+    _slice_dimensions(0),
+    _datatype(MI_TYPE_UNKNOWN)
+  {
+  }
+
+  minc2_base::~minc2_base()
+  {
+  }
+
+  void minc2_base::close(void)
+  {
+    _vol.close();
+    _dims.clear();
+    _chunk.clear();
+    _slice_dimensions=0;
+    _datatype=MI_TYPE_UNKNOWN;
+  }
+
+  size_t minc2_base::voxels(void) const
+  {
+    size_t n=1;
+    for(size_t i=0;i<_dims.size();i++)
+      n*=_dims[i].length;
+    return n;
+  }
+
+  void minc2_base::_setup_dimensions(void)
+  {
+    int ndims;
+    CHECK_MINC_CALL(miget_volume_dimension_count(_vol.get(),MI_DIMCLASS_ANY,MI_DIMATTR_ALL,&ndims));
+
+    std::vector<midimhandle_t> hdims(ndims>0?ndims:1);
+    if(miget_volume_dimensions(_vol.get(),MI_DIMCLASS_ANY,MI_DIMATTR_ALL,MI_DIMORDER_FILE,ndims,&hdims[0])!=ndims)
+      REPORT_ERROR("Can't get dimensions");
+
+    _dims.resize(ndims);
+    for(int i=0;i<ndims;i++)
+    {
+      char *name;
+      CHECK_MINC_CALL(miget_dimension_name(hdims[i],&name));
+      _dims[i].name=name;
+      free(name);
+      CHECK_MINC_CALL(miget_dimension_size(hdims[i],&_dims[i].length));
+      if(miget_dimension_start(hdims[i],MI_ORDER_FILE,&_dims[i].start)<0)
+        _dims[i].start=0.0;
+      if(miget_dimension_separation(hdims[i],MI_ORDER_FILE,&_dims[i].step)<0)
+        _dims[i].step=1.0;
+    }
+
+    _chunk.resize(ndims);
+    if(ndims>0)
+      CHECK_MINC_CALL(miget_volume_chunk_dims(_vol.get(),ndims,&_chunk[0]));
+
+    CHECK_MINC_CALL(miget_slice_dimension_count(_vol.get(),MI_DIMCLASS_ANY,MI_DIMATTR_ALL,&_slice_dimensions));
+    CHECK_MINC_CALL(miget_data_type(_vol.get(),&_datatype));
+  }
+
+  minc2_reader::minc2_reader()
+  {
+  }
+
+  void minc2_reader::open(const char *path)
+  {
+    close();
+
+    mihandle_t vol;
+    if(miopen_volume(path,MI2_OPEN_READ,&vol)<0)
+      REPORT_ERROR("Can't open minc file for reading!");
+    _vol=minc2_handle(vol);
+
+    _setup_dimensions();
+  }
+
+  minc2_writer::minc2_writer():_slice_scaling(false)
+  {
+  }
+
+  void minc2_writer::open(const char *path,const std::vector<minc2_dim>& dims,mitype_t datatype,
+                          const std::vector<misize_t>& chunk)
+  {
+    close();
+
+    std::vector<midimhandle_t> hdims(dims.size());
+    for(size_t i=0;i<dims.size();i++)
+    {
+      midimclass_t dimclass=MI_DIMCLASS_SPATIAL;
+      if(dims[i].name=="time")
+        dimclass=MI_DIMCLASS_TIME;
+      else if(dims[i].name=="vector_dimension")
+        dimclass=MI_DIMCLASS_RECORD;
+
+      CHECK_MINC_CALL(micreate_dimension(dims[i].name.c_str(),dimclass,
+                                         MI_DIMATTR_REGULARLY_SAMPLED,
+                                         dims[i].length,&hdims[i]));
+      if(dimclass!=MI_DIMCLASS_RECORD)
+      {
+        CHECK_MINC_CALL(miset_dimension_start(hdims[i],dims[i].start));
+        CHECK_MINC_CALL(miset_dimension_separation(hdims[i],dims[i].step));
+      }
+    }
+
+    mivolumeprops_t props=NULL;
+    if(!chunk.empty())
+    {
+      std::vector<int> edges(chunk.begin(),chunk.end());
+      CHECK_MINC_CALL(minew_volume_props(&props));
+      CHECK_MINC_CALL(miset_props_blocking(props,static_cast<int>(edges.size()),&edges[0]));
+    }
+
+    mihandle_t vol;
+    int r=micreate_volume(path,static_cast<int>(hdims.size()),hdims.empty()?NULL:&hdims[0],
+                          datatype,MI_CLASS_REAL,props,&vol);
+    if(props)
+      mifree_volume_props(props);
+    if(r<0)
+      REPORT_ERROR("Can't create minc file!");
+    _vol=minc2_handle(vol);
+
+    // integer types need a range for each slice
+    _slice_scaling=(datatype!=MI_TYPE_FLOAT && datatype!=MI_TYPE_DOUBLE);
+    CHECK_MINC_CALL(miset_slice_scaling_flag(_vol.get(),_slice_scaling));
+    CHECK_MINC_CALL(micreate_volume_image(_vol.get()));
+
+    _setup_dimensions();
+  }
+
+  void minc2_writer::open(const char *path,const minc2_base& imitate,mitype_t datatype)
+  {
+    open(path,imitate.dims(),datatype,imitate.chunk());
+  }
+
+  minc2_slab_iterator::minc2_slab_iterator(const minc2_base& vol,size_t max_voxels):
+    _dims(vol.dim_no()),_start(vol.dim_no(),0),_count(vol.dim_no(),1),_incr(vol.dim_no(),1),
+    _last(false)
+  {
+    int ndims=vol.dim_no();
+    // a slice is whatever the file scales as one, which is the whole
+    // volume for files without slice scaling
+    int image_dims=vol.slice_dimensions();
+    size_t voxels=1;
+    int i;
+
+    for(i=0;i<ndims;i++)
+      _dims[i]=vol.dim(i).length;
+
+    // whole dimensions from the last one, then whole chunks along one more
+    for(i=ndims-1;i>=0;i--)
+    {
+      if(i>=ndims-image_dims || voxels*_dims[i]<=max_voxels)
+      {
+        _incr[i]=_dims[i];
+        voxels*=_dims[i];
+        continue;
+      }
+      misize_t incr=max_voxels/voxels;
+      misize_t chunk=vol.chunk().empty()?1:vol.chunk()[i];
+      if(chunk>1 && incr>=chunk)
+        incr-=incr%chunk;
+      _incr[i]=incr>0?incr:1;
+      break;
+    }
+
+    begin();
+  }
+
+  void minc2_slab_iterator::begin(void)
+  {
+    _last=_dims.empty();
+    for(size_t i=0;i<_dims.size();i++)
+    {
+      _start[i]=0;
+      _count[i]=_incr[i]<_dims[i]?_incr[i]:_dims[i];
+    }
+  }
+
+  bool minc2_slab_iterator::next(void)
+  {
+    if(_last) return false;
+
+    for(int i=static_cast<int>(_dims.size())-1;i>=0;i--)
+    {
+      _start[i]+=_incr[i];
+      if(_start[i]<_dims[i])
+      {
+        _count[i]=_start[i]+_incr[i]<=_dims[i]?_incr[i]:_dims[i]-_start[i];
+        return true;
+      }
+      _start[i]=0;
+      _count[i]=_incr[i]<_dims[i]?_incr[i]:_dims[i];
+    }
+    _last=true;
+    return false;
+  }
+
+  size_t minc2_slab_iterator::voxels(void) const
+  {
+    size_t n=1;
+    for(size_t i=0;i<_count.size();i++)
+      n*=_count[i];
+    return n;
+  }
+
+  size_t minc2_slab_iterator::max_voxels(void) const
+  {
+    size_t n=1;
+    for(size_t i=0;i<_incr.size();i++)
+      n*=_incr[i]<_dims[i]?_incr[i]:_dims[i];
+    return n;
+  }
+}
@@ -0,0 +1,328 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       :
+@DESCRIPTION: C++ interface to minc files, uses MINC2 API only
+@CREATED    : Oct. 19, 2026
+---------------------------------------------------------------------------- */
+#ifndef MINC2_RW_H
+#define MINC2_RW_H
+
+#include <vector>
+#include <string>
+
+#include "minc_io_exceptions.h"
+
+extern "C" {
+#include <minc2.h>
+}
+
+namespace minc
+{
+  //! MINC2 storage type corresponding to a C++ type
+  template<class T> struct minc2_type {};
+  template<> struct minc2_type<unsigned char>  { static mitype_t type(void) { return MI_TYPE_UBYTE; } };
+  template<> struct minc2_type<signed char>    { static mitype_t type(void) { return MI_TYPE_BYTE; } };
+  template<> struct minc2_type<char>           { static mitype_t type(void) { return MI_TYPE_BYTE; } };
+  template<> struct minc2_type<unsigned short> { static mitype_t type(void) { return MI_TYPE_USHORT; } };
+  template<> struct minc2_type<short>          { static mitype_t type(void) { return MI_TYPE_SHORT; } };
+  template<> struct minc2_type<unsigned int>   { static mitype_t type(void) { return MI_TYPE_UINT; } };
+  template<> struct minc2_type<int>            { static mitype_t type(void) { return MI_TYPE_INT; } };
+  template<> struct minc2_type<float>          { static mitype_t type(void) { return MI_TYPE_FLOAT; } };
+  template<> struct minc2_type<double>         { static mitype_t type(void) { return MI_TYPE_DOUBLE; } };
+
+  //! owner of an open volume handle, closes it when destroyed
+  //! can be moved, but not copied
+  class minc2_handle
+  {
+  protected:
+    mihandle_t _vol;
+  public:
+    minc2_handle():_vol(NULL)
+    {
+    }
+
+    explicit minc2_handle(mihandle_t vol):_vol(vol)
+    {
+    }
+
+    minc2_handle(minc2_handle&& that):_vol(that._vol)
+    {
+      that._vol=NULL;
+    }
+
+    minc2_handle& operator=(minc2_handle&& that)
+    {
+      if(this!=&that)
+      {
+        close();
+        _vol=that._vol;
+        that._vol=NULL;
+      }
+      return *this;
+    }
+
+    minc2_handle(const minc2_handle&)=delete;
+    minc2_handle& operator=(const minc2_handle&)=delete;
+
+    ~minc2_handle()
+    {
+      close();
+    }
+
+    //! close the volume, if any
+    void close(void)
+    {
+      if(_vol)
+        miclose_volume(_vol);
+      _vol=NULL;
+    }
+
+    //! give up ownership of the volume
+    mihandle_t release(void)
+    {
+      mihandle_t vol=_vol;
+      _vol=NULL;
+      return vol;
+    }
+
+    mihandle_t get(void) const
+    {
+      return _vol;
+    }
+
+    bool is_open(void) const
+    {
+      return _vol!=NULL;
+    }
+  };
+
+  //! dimension of a minc2 volume
+  struct minc2_dim
+  {
+    std::string name;
+    misize_t length;
+    double start;
+    double step;
+
+    minc2_dim(const std::string& n="",misize_t l=0,double sta=0.0,double spa=1.0):
+      name(n),length(l),start(sta),step(spa)
+    {
+    }
+  };
+
+  //! minc2 volume rw base class, all coordinates are in file order
+  class minc2_base
+  {
+  protected:
+    minc2_handle _vol;
+    std::vector<minc2_dim> _dims;
+    std::vector<misize_t> _chunk;
+    int _slice_dimensions;
+    mitype_t _datatype;
+
+    void _setup_dimensions(void);
+  public:
+    minc2_base();
+    minc2_base(minc2_base&&)=default;
+    minc2_base& operator=(minc2_base&&)=default;
+    virtual ~minc2_base();
+
+    //! close the minc file
+    virtual void close(void);
+
+    //! get the volume handle
+    mihandle_t handle(void) const
+    {
+      return _vol.get();
+    }
+
+    bool is_open(void) const
+    {
+      return _vol.is_open();
+    }
+
+    //! number of dimensions
+    int dim_no(void) const
+    {
+      return static_cast<int>(_dims.size());
+    }
+
+    //! get the dimension information
+    const minc2_dim& dim(unsigned int n) const
+    {
+      if(n>=_dims.size())
+        REPORT_ERROR("Dimension is not defined");
+      return _dims[n];
+    }
+
+    //! get the dimensions
+    const std::vector<minc2_dim>& dims(void) const
+    {
+      return _dims;
+    }
+
+    //! storage chunk size along each dimension
+    const std::vector<misize_t>& chunk(void) const
+    {
+      return _chunk;
+    }
+
+    //! number of dimensions in one slice (image-max and image-min do not vary over them)
+    int slice_dimensions(void) const
+    {
+      return _slice_dimensions;
+    }
+
+    //! data type stored in the file
+    mitype_t datatype(void) const
+    {
+      return _datatype;
+    }
+
+    //! total number of voxels
+    size_t voxels(void) const;
+  };
+
+  //! minc2 file reader
+  class minc2_reader:public minc2_base
+  {
+  public:
+    minc2_reader();
+    minc2_reader(minc2_reader&&)=default;
+    minc2_reader& operator=(minc2_reader&&)=default;
+
+    //! open an existing minc2 file
+    void open(const char *path);
+
+    //! read real values of a hyperslab straight into buffer
+    template<class T> void read(const misize_t *start,const misize_t *count,T* buffer) const
+    {
+      CHECK_MINC_CALL(miget_real_value_hyperslab(_vol.get(),minc2_type<T>::type(),
+                                                 start,count,buffer));
+    }
+
+    //! read real values of the whole volume straight into buffer
+    template<class T> void read(T* buffer) const
+    {
+      std::vector<misize_t> start(_dims.size(),0),count(_dims.size());
+      for(size_t i=0;i<_dims.size();i++)
+        count[i]=_dims[i].length;
+      read(&start[0],&count[0],buffer);
+    }
+  };
+
+  //! minc2 file writer
+  class minc2_writer:public minc2_base
+  {
+  protected:
+    bool _slice_scaling;
+  public:
+    minc2_writer();
+    minc2_writer(minc2_writer&&)=default;
+    minc2_writer& operator=(minc2_writer&&)=default;
+
+    //! create a new minc2 file
+    //! \param dims - dimensions, in file order
+    //! \param datatype - data type to store, integer types are scaled slice by slice
+    //! \param chunk - storage chunk size along each dimension, or empty for the default
+    void open(const char *path,const std::vector<minc2_dim>& dims,mitype_t datatype,
+              const std::vector<misize_t>& chunk=std::vector<misize_t>());
+
+    //! create a new minc2 file with the same dimensions as another one
+    void open(const char *path,const minc2_base& imitate,mitype_t datatype);
+
+    //! write real values of a hyperslab straight from buffer
+    //! with integer data types, the hyperslab must cover whole slices
+    template<class T> void write(const misize_t *start,const misize_t *count,const T* buffer)
+    {
+      if(_slice_scaling)
+        _set_slice_ranges(start,count,buffer);
+      CHECK_MINC_CALL(miset_real_value_hyperslab(_vol.get(),minc2_type<T>::type(),
+                                                 start,count,const_cast<T*>(buffer)));
+    }
+
+    //! write real values of the whole volume straight from buffer
+    template<class T> void write(const T* buffer)
+    {
+      std::vector<misize_t> start(_dims.size(),0),count(_dims.size());
+      for(size_t i=0;i<_dims.size();i++)
+        count[i]=_dims[i].length;
+      write(&start[0],&count[0],buffer);
+    }
+
+  protected:
+    //! set the range of every slice in the hyperslab from the values in buffer
+    template<class T> void _set_slice_ranges(const misize_t *start,const misize_t *count,const T* buffer)
+    {
+      int outer=dim_no()-_slice_dimensions;
+      size_t slices=1,slice_len=1;
+      for(int i=0;i<outer;i++)
+        slices*=count[i];
+      for(int i=outer;i<dim_no();i++)
+      {
+        if(start[i]!=0 || count[i]!=_dims[i].length)
+          REPORT_ERROR("Hyperslab must cover whole slices");
+        slice_len*=count[i];
+      }
+
+      std::vector<misize_t> slice(start,start+dim_no());
+      for(size_t s=0;s<slices;s++)
+      {
+        const T* data=buffer+s*slice_len;
+        double r_min=data[0],r_max=data[0];
+        for(size_t i=1;i<slice_len;i++)
+        {
+          if(r_min>data[i]) r_min=data[i];
+          if(r_max<data[i]) r_max=data[i];
+        }
+
+        size_t index=s;
+        for(int i=outer-1;i>=0;i--)
+        {
+          slice[i]=start[i]+index%count[i];
+          index/=count[i];
+        }
+        CHECK_MINC_CALL(miset_slice_range(_vol.get(),&slice[0],dim_no(),r_max,r_min));
+      }
+    }
+  };
+
+  //! walks through a volume in slabs made of whole storage chunks
+  //! the slabs are contiguous, they cover whole dimensions from the last one,
+  //! then a multiple of the chunk size along one dimension
+  //! a slab always covers whole slices, so it can be given to minc2_writer::write
+  class minc2_slab_iterator
+  {
+  protected:
+    std::vector<misize_t> _dims,_start,_count,_incr;
+    bool _last;
+  public:
+    //! \param max_voxels - largest slab, but a slab is never thinner than one slice
+    minc2_slab_iterator(const minc2_base& vol,size_t max_voxels=1<<22);
+
+    void begin(void);
+    bool next(void);
+
+    bool last(void) const
+    {
+      return _last;
+    }
+
+    const misize_t* start(void) const
+    {
+      return &_start[0];
+    }
+
+    const misize_t* count(void) const
+    {
+      return &_count[0];
+    }
+
+    //! number of voxels in the current slab
+    size_t voxels(void) const;
+
+    //! number of voxels in the largest slab
+    size_t max_voxels(void) const;
+  };
+}
+
+#endif //MINC2_RW_H
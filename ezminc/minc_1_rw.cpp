@@ -22,6 +22,12 @@
 #include <stdlib.h>
 #include "minc_1_rw.h"
 
+#ifdef MINC2
+extern "C" {
+#include <minc2.h>
+}
+#endif
+
 namespace minc
 {
   dim_info::dim_info(int l, double sta,
@@ -474,11 +480,12 @@ namespace minc
   
   minc_1_reader::minc_1_reader(const minc_1_reader& that):
     minc_1_base(that),
-    _metadate_only(false), _have_temp_file(false), _read_prepared(false)
+    _metadate_only(false), _have_temp_file(false), _read_prepared(false),
+    _chunk_slices(1)
   {
   }
   
-  minc_1_reader::minc_1_reader():_metadate_only(false),_have_temp_file(false),_read_prepared(false)
+  minc_1_reader::minc_1_reader():_metadate_only(false),_have_temp_file(false),_read_prepared(false),_chunk_slices(1)
   {
   }
   
@@ -492,6 +499,7 @@ namespace minc
 #endif 
     _metadate_only=metadate_only;
     _read_prepared=false;
+    _chunk_slices=1;
     _positive_directions=positive_directions;
     //ncopts = 0;
 
@@ -655,6 +663,21 @@ namespace minc
       _slab[_ndims-i-1]=_info[_ndims-i-1].length;
       _slab_len*=_info[_ndims-i-1].length;
     }
+    
+#ifdef MINC2
+    // find out how many slices are stored together, so that they can be read at once
+    if(_minc2 && !_metadate_only && !rw && _ndims>static_cast<int>(_slice_dimensions))
+    {
+      mihandle_t vol;
+      if(miopen_volume(path,MI2_OPEN_READ,&vol)==MI_NOERROR)
+      {
+        misize_t chunk[MAX_VAR_DIMS];
+        if(miget_volume_chunk_dims(vol,MAX_VAR_DIMS,chunk)==MI_NOERROR)
+          _chunk_slices=static_cast<int>(chunk[_ndims-_slice_dimensions-1]);
+        miclose_volume(vol);
+      }
+    }
+#endif
   }
   
   void minc_1_reader::close(void)
@@ -1297,6 +1320,26 @@ namespace minc
     CHECK_MINC_CALL(miicv_get(_icvid, &_cur[0], &_slab[0], buffer));
   }
   
+  int minc_1_reader::read_slices(void* buffer,int nslices)
+  {
+    if(!_read_prepared)
+      REPORT_ERROR("Not ready to read, use setup_read_XXXX");
+    
+    int d=_ndims-_slice_dimensions-1;
+    std::vector<long> count(_slab);
+    if(d<0 || nslices<1)
+      nslices=1;
+    else 
+    {
+      long left=static_cast<long>(_info[d].length)-_cur[d];
+      if(nslices>left)
+        nslices=static_cast<int>(left);
+      count[d]=nslices;
+    }
+    CHECK_MINC_CALL(miicv_get(_icvid, &_cur[0], &count[0], buffer));
+    return nslices;
+  }
+  
   void minc_1_writer::write(void* buffer)
   {
     if(!_write_prepared)
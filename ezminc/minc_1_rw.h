@@ -338,6 +338,7 @@ namespace minc
       std::string _tempfile;
       bool _have_temp_file;
       bool _read_prepared;
+      int _chunk_slices;
       void _setup_dimensions(void);
 
     public:
@@ -362,6 +363,17 @@ namespace minc
     
     //! read single slice
     void read(void* slice);
+    
+    //! read up to nslices consecutive slices, starting at the current one, without advancing
+    //! \return number of slices read, never past the end of the slice dimension
+    int read_slices(void* slices,int nslices);
+    
+    //! number of slices stored together in the file (1 if not known)
+    int chunk_slices(void) const
+    {
+      return _chunk_slices;
+    }
+    
     //! setup reading in float format
     void setup_read_float(void);
     //! setup reading in double format
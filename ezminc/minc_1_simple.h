@@ -15,6 +15,8 @@
 #ifndef MINC_1_SIMPLE_H
 #define MINC_1_SIMPLE_H
 
+#include <algorithm>
+
 #include "minc_1_rw.h"
 
 namespace minc
@@ -28,6 +30,16 @@ namespace minc
       std::vector<long> _cur;
       bool _last;
       size_t _count;
+      size_t _slice;   //current slice in the buffer
+      size_t _nslices; //number of slices in the buffer
+      
+      //! read as many slices as are stored together in the file
+      void _read_slices(void)
+      {
+        _nslices=_rw->read_slices(&_buf[0],_rw->chunk_slices());
+        _slice=0;
+        _cur=_rw->current_slice();
+      }
     public:
       
     const std::vector<long>& cur(void) const
@@ -36,15 +48,15 @@ namespace minc
     }
     
     
-    minc_input_iterator(const minc_input_iterator<T>& a):_rw(a._rw),_cur(a._cur),_last(a._last),_count(a._count)
+    minc_input_iterator(const minc_input_iterator<T>& a):_rw(a._rw),_cur(a._cur),_last(a._last),_count(a._count),_slice(a._slice),_nslices(a._nslices)
     {
     }
     
-    minc_input_iterator(minc_1_reader& rw):_rw(&rw),_last(false),_count(0)
+    minc_input_iterator(minc_1_reader& rw):_rw(&rw),_last(false),_count(0),_slice(0),_nslices(0)
     {
     }
     
-    minc_input_iterator():_rw(NULL),_last(false),_count(0)
+    minc_input_iterator():_rw(NULL),_last(false),_count(0),_slice(0),_nslices(0)
     {
     }
     
@@ -53,6 +65,8 @@ namespace minc
       _rw=&rw;
       _last=false;
       _count=0;
+      _slice=0;
+      _nslices=0;
     }
     
     bool next(void)
@@ -81,8 +95,10 @@ namespace minc
             _last=true;
             break;
           }
-          _rw->read(&_buf[0]);
-          _cur=_rw->current_slice();
+          if(++_slice<_nslices)
+            _cur=_rw->current_slice();
+          else
+            _read_slices();
           _count=0;
           break;
         }
@@ -98,16 +114,15 @@ namespace minc
     void begin(void)
     {
       _cur.resize(MAX_VAR_DIMS,0);
-      _buf.resize(_rw->slice_len());
+      _buf.resize(static_cast<size_t>(_rw->slice_len())*_rw->chunk_slices());
       _count=0;
       _rw->begin();
-      _rw->read(&_buf[0]);
-      _cur=_rw->current_slice();
+      _read_slices();
     }
     
     const T& value(void) const
     {
-      return _buf[_count];
+      return _buf[_slice*_rw->slice_len()+_count];
     }
   };
   
@@ -205,10 +220,73 @@ namespace minc
     }
   };
   
-  //! will attempt to laod the whole volume in T Z Y X V order into buffer, file should be prepared (setup_read_XXXX)
-  template<class T> void load_standard_volume(minc_1_reader& rw, T* volume)
+  //! default memory budget, in bytes, for the slabs used by load_standard_volume and save_standard_volume
+  const size_t minc_io_slab_budget=64*1024*1024;
+  
+  //! copy count[] elements between two buffers with different strides
+  //! the two dimensions that are contiguous in the source and in the destination are copied in tiles
+  template<class T> void copy_strided(const T* src,const std::vector<size_t>& src_strides,
+                                      T* dst,const std::vector<size_t>& dst_strides,
+                                      const std::vector<size_t>& count)
   {
-    std::vector<size_t> strides(MAX_VAR_DIMS,0);
+    const size_t tile=16;
+    int ndims=static_cast<int>(count.size());
+    int a=-1,b=-1;
+    
+    for(int i=0;i<ndims;i++)
+    {
+      if(count[i]<=1) continue;
+      if(a<0 || src_strides[i]<src_strides[a]) a=i;
+      if(b<0 || dst_strides[i]<dst_strides[b]) b=i;
+    }
+    if(a<0) //single element
+    {
+      dst[0]=src[0];
+      return;
+    }
+    if(b==a) b=-1;
+    
+    size_t ca=count[a],sa=src_strides[a],da=dst_strides[a];
+    size_t cb=b<0?1:count[b],sb=b<0?0:src_strides[b],db=b<0?0:dst_strides[b];
+    std::vector<size_t> idx(ndims,0);
+    
+    for(;;)
+    {
+      size_t src_offset=0,dst_offset=0;
+      for(int i=0;i<ndims;i++)
+      {
+        src_offset+=idx[i]*src_strides[i];
+        dst_offset+=idx[i]*dst_strides[i];
+      }
+      
+      for(size_t jb=0;jb<cb;jb+=tile)
+      {
+        size_t eb=std::min(cb,jb+tile);
+        for(size_t ja=0;ja<ca;ja+=tile)
+        {
+          size_t ea=std::min(ca,ja+tile);
+          for(size_t ia=ja;ia<ea;ia++)
+            for(size_t ib=jb;ib<eb;ib++)
+              dst[dst_offset+ia*da+ib*db]=src[src_offset+ia*sa+ib*sb];
+        }
+      }
+      
+      //move to the next tile row
+      int i;
+      for(i=ndims-1;i>=0;i--)
+      {
+        if(i==a || i==b) continue;
+        if(++idx[i]<count[i]) break;
+        idx[i]=0;
+      }
+      if(i<0) break;
+    }
+  }
+  
+  //! strides of the T Z Y X V order, for each file dimension
+  template<class RW> std::vector<size_t> standard_strides(RW& rw)
+  {
+    std::vector<size_t> strides(rw.dim_no(),0);
     size_t str=1;
     for(size_t i=0;i<5;i++)
     {      
@@ -216,38 +294,102 @@ namespace minc
       strides[rw.map_space(i)]=str;
       str*=rw.ndim(i);
     }
-
-    minc_input_iterator<T> in(rw);
-    for(in.begin();!in.last();in.next())
+    return strides;
+  }
+  
+  //! shape and strides of a slab of nslices slices, starting at slice dimension d, in file order
+  template<class RW> size_t slab_shape(RW& rw,int d,size_t nslices,
+                                       std::vector<size_t>& count,std::vector<size_t>& strides)
+  {
+    size_t str=1;
+    count.resize(rw.dim_no());
+    strides.resize(rw.dim_no());
+    for(int i=rw.dim_no()-1;i>=0;i--)
+    {
+      count[i]=i>d?rw.dim(i).length:(i==d?nslices:1);
+      strides[i]=str;
+      str*=count[i];
+    }
+    return str;
+  }
+  
+  //! will attempt to laod the whole volume in T Z Y X V order into buffer, file should be prepared (setup_read_XXXX)
+  //! the file is read in slabs of several slices, straight into the buffer if the file is in the same order
+  template<class T> void load_standard_volume(minc_1_reader& rw, T* volume,size_t budget=minc_io_slab_budget)
+  {
+    std::vector<size_t> strides=standard_strides(rw);
+    std::vector<size_t> count,slab_strides;
+    int d=rw.dim_no()-rw.slice_dimensions()-1;
+    
+    //in the same order, file strides are the standard ones
+    size_t str=slab_shape(rw,-1,1,count,slab_strides);
+    bool direct=(str>0 && strides==slab_strides);
+    
+    int nslices=1;
+    if(d>=0)
+      nslices=direct?rw.dim(d).length:std::max<size_t>(1,budget/(rw.slice_len()*sizeof(T)));
+    std::vector<T> buf(direct?0:static_cast<size_t>(rw.slice_len())*nslices);
+    
+    rw.begin();
+    while(!rw.last())
     {
       size_t address=0;
-      for(size_t i=0;i<static_cast<size_t>(rw.dim_no());i++)
-        address+=in.cur()[i]*strides[i];
-        
-      volume[address]=in.value();
+      for(int i=0;i<rw.dim_no();i++)
+        address+=rw.current_slice()[i]*strides[i];
+      
+      int n=rw.read_slices(direct?volume+address:&buf[0],nslices);
+      if(!direct)
+      {
+        slab_shape(rw,d,n,count,slab_strides);
+        copy_strided(&buf[0],slab_strides,volume+address,strides,count);
+      }
+      
+      if(d<0) break; // the case when slice_dimensions==dim_no
+      for(int i=0;i<n;i++)
+        rw.next_slice();
     }
   }
   
   //! will attempt to save the whole volume in T Z Y X V order from buffer, file should be prepared (setup_read_XXXX)
-  template<class T> void save_standard_volume(minc_1_writer& rw, const T* volume)
+  //! the volume is reordered in slabs of several slices, or written straight if the file is in the same order
+  template<class T> void save_standard_volume(minc_1_writer& rw, const T* volume,size_t budget=minc_io_slab_budget)
   {
-    std::vector<size_t> strides(MAX_VAR_DIMS,0);
-    size_t str=1;
-    for(size_t i=0;i<5;i++)
-    {      
-      if(rw.map_space(i)<0) continue;
-      strides[rw.map_space(i)]=str;
-      str*=rw.ndim(i);
-    }
+    std::vector<size_t> strides=standard_strides(rw);
+    std::vector<size_t> count,slab_strides;
+    int d=rw.dim_no()-rw.slice_dimensions()-1;
     
-    minc_output_iterator<T> out(rw);
-    for(out.begin();!out.last();out.next())
+    size_t str=slab_shape(rw,-1,1,count,slab_strides);
+    bool direct=(str>0 && strides==slab_strides);
+    
+    size_t nslices=direct?1:std::max<size_t>(1,budget/(rw.slice_len()*sizeof(T)));
+    std::vector<T> buf(direct?0:static_cast<size_t>(rw.slice_len())*nslices);
+    
+    rw.begin();
+    while(!rw.last())
     {
       size_t address=0;
-      for(size_t i=0;i<static_cast<size_t>(rw.dim_no());i++)
-        address+=out.cur()[i]*strides[i];
-        
-      out.value(volume[address]);
+      for(int i=0;i<rw.dim_no();i++)
+        address+=rw.current_slice()[i]*strides[i];
+      
+      size_t n=1;
+      if(d>=0 && !direct)
+        n=std::min<size_t>(nslices,rw.dim(d).length-rw.current_slice()[d]);
+      
+      const T* slab=volume+address;
+      if(!direct)
+      {
+        slab_shape(rw,d,n,count,slab_strides);
+        copy_strided(volume+address,strides,&buf[0],slab_strides,count);
+        slab=&buf[0];
+      }
+      
+      //slices are written one by one, each gets its own range
+      for(size_t i=0;i<n;i++)
+      {
+        rw.write(const_cast<T*>(slab+i*rw.slice_len()));
+        if(d<0) return; // the case when slice_dimensions==dim_no
+        rw.next_slice();
+      }
     }
   }
 
@@ -23,7 +23,7 @@
 namespace minc
 {
   
-  template<class T> void load_simple_volume(minc_1_reader& rw,simple_volume<T>& vol)
+  template<class T,class A> void load_simple_volume(minc_1_reader& rw,simple_volume<T,A>& vol)
   {
     if(rw.ndim(1)<=0||rw.ndim(2)<=0||rw.ndim(3)<=0||rw.ndim(4)>0) 
       REPORT_ERROR("Need 3D minc file");
@@ -79,7 +79,7 @@ namespace minc
     }
   }
   
-  template<class T> void save_simple_volume(minc_1_writer& rw,const simple_volume<T>& vol)
+  template<class T,class A> void save_simple_volume(minc_1_writer& rw,const simple_volume<T,A>& vol)
   {
     if(typeid(T)==typeid(unsigned char))
     {
@@ -116,7 +116,7 @@ namespace minc
   }
   
   
-  template<class T> void load_4d_volume(minc_1_reader& rw,simple_4d_volume<T>& vol)
+  template<class T,class A> void load_4d_volume(minc_1_reader& rw,simple_4d_volume<T,A>& vol)
   {
     //if(rw.ndim(1)<=0||rw.ndim(2)<=0||rw.ndim(3)<=0||rw.ndim(4)<=0) 
     //  REPORT_ERROR("Need 4D minc file");
@@ -191,7 +191,7 @@ namespace minc
     }
   }
   
-  template<class T> void save_4d_volume(minc_1_writer& rw,const simple_4d_volume<T>& vol)
+  template<class T,class A> void save_4d_volume(minc_1_writer& rw,const simple_4d_volume<T,A>& vol)
   {
     if(typeid(T)==typeid(unsigned char))
       rw.setup_write_byte();
@@ -238,14 +238,14 @@ namespace minc
   
   bool is_same(minc_1_reader& one,minc_1_reader& two,bool verbose=true);
   
-  template<class T> void load_minc_file(const char *file,simple_4d_volume<T>& vol)
+  template<class T,class A> void load_minc_file(const char *file,simple_4d_volume<T,A>& vol)
   {
       minc_1_reader rdr;
       rdr.open(file);
       load_4d_volume(rdr,vol);  
   }
   
-  template<class T> void generate_info(const simple_4d_volume<T>& vol,minc_info& info)
+  template<class T,class A> void generate_info(const simple_4d_volume<T,A>& vol,minc_info& info)
   {
      bool have_time=vol.frames()>1||vol.t_step()!=0.0; //assume that it is 3D file otherwise
      
@@ -289,7 +289,7 @@ namespace minc
           
   }
   
-  template<class T> void save_minc_file(const char *file,const simple_4d_volume<T>& vol,
+  template<class T,class A> void save_minc_file(const char *file,const simple_4d_volume<T,A>& vol,
                                         const char* history=NULL,const minc_1_reader* original=NULL,
                                         nc_type datatype=NC_NAT,bool is_signed=false)
   {
@@ -13,6 +13,7 @@
               express or implied warranty.
 ---------------------------------------------------------------------------- */
 #ifndef MINC_IO_4D_VOLUME_H
+#define MINC_IO_4D_VOLUME_H
 
 #include "minc_io_simple_volume.h"
 #include <vector>
@@ -22,7 +23,7 @@ namespace minc
 {
   
   //! simple 4D volume - collection of 3D volumes
-  template<class T> class simple_4d_volume
+  template<class T,class Alloc=aligned_allocator<T> > class simple_4d_volume
   {
     protected:
       enum    {ndims=3};
@@ -42,7 +43,7 @@ namespace minc
       }
       
     public:
-      typedef simple_volume<T> volume;
+      typedef simple_volume<T,Alloc> volume;
       typedef std::vector<volume> volume_list;
       
       int dim(int i) const
@@ -165,6 +166,70 @@ namespace minc
 
       volume_list _volumes;
   }; 
+  
+  //! statistics of finite voxels of all frames
+  template<class T,class A> voxel_stats volume_stats(const simple_4d_volume<T,A>& v)
+  {
+    voxel_stats s;
+    for(size_t t=0;t<v.frames();t++)
+      s.merge(volume_stats(v.frame(t)));
+    return s;
+  }
+  
+  //! statistics of finite voxels of all frames inside the mask
+  template<class T,class A,class M> voxel_stats volume_stats(const simple_4d_volume<T,A>& v,const simple_volume<unsigned char,M>& mask)
+  {
+    voxel_stats s;
+    for(size_t t=0;t<v.frames();t++)
+      s.merge(volume_stats(v.frame(t),mask));
+    return s;
+  }
+  
+  //! histogram of finite voxels of all frames with nbins bins covering [lo,hi]
+  template<class T,class A> std::vector<size_t> volume_histogram(const simple_4d_volume<T,A>& v,size_t nbins,double lo,double hi)
+  {
+    std::vector<size_t> hist(nbins,0);
+    for(size_t t=0;t<v.frames();t++)
+      buffer_histogram(v.frame(t).c_buf(),static_cast<const unsigned char*>(NULL),v.frame(t).c_buf_size(),lo,hi,hist);
+    return hist;
+  }
+  
+  //! histogram of finite voxels of all frames inside the mask with nbins bins covering [lo,hi]
+  template<class T,class A,class M> std::vector<size_t> volume_histogram(const simple_4d_volume<T,A>& v,const simple_volume<unsigned char,M>& mask,
+                                                                          size_t nbins,double lo,double hi)
+  {
+    std::vector<size_t> hist(nbins,0);
+    for(size_t t=0;t<v.frames();t++)
+    {
+      if(v.frame(t).size()!=mask.size())
+        REPORT_ERROR("Volume size mismatch");
+      buffer_histogram(v.frame(t).c_buf(),mask.c_buf(),mask.c_buf_size(),lo,hi,hist);
+    }
+    return hist;
+  }
+  
+  //! percentiles of finite voxels of all frames, fractions are in [0,1]
+  template<class T,class A> std::vector<double> volume_percentiles(const simple_4d_volume<T,A>& v,const std::vector<double>& fractions)
+  {
+    std::vector<T> values;
+    for(size_t t=0;t<v.frames();t++)
+      buffer_collect(v.frame(t).c_buf(),static_cast<const unsigned char*>(NULL),v.frame(t).c_buf_size(),values);
+    return values_percentiles(values,fractions);
+  }
+  
+  //! percentiles of finite voxels of all frames inside the mask, fractions are in [0,1]
+  template<class T,class A,class M> std::vector<double> volume_percentiles(const simple_4d_volume<T,A>& v,const simple_volume<unsigned char,M>& mask,
+                                                                            const std::vector<double>& fractions)
+  {
+    std::vector<T> values;
+    for(size_t t=0;t<v.frames();t++)
+    {
+      if(v.frame(t).size()!=mask.size())
+        REPORT_ERROR("Volume size mismatch");
+      buffer_collect(v.frame(t).c_buf(),mask.c_buf(),mask.c_buf_size(),values);
+    }
+    return values_percentiles(values,fractions);
+  }
 
 }
 
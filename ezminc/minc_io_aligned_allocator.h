@@ -0,0 +1,82 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       :
+@DESCRIPTION: Allocator for aligned voxel buffers
+@CREATED    : Oct. 19, 2026
+---------------------------------------------------------------------------- */
+#ifndef MINC_IO_ALIGNED_ALLOCATOR_H
+#define MINC_IO_ALIGNED_ALLOCATOR_H
+
+#include <stdlib.h>
+#include <cstddef>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace minc
+{
+  //! alignment of voxel buffers, enough for aligned loads of any SIMD width in use
+  const size_t minc_io_alignment=64;
+
+  //! standard allocator returning memory aligned to Align bytes (a power of two)
+  template<class T,size_t Align=minc_io_alignment> class aligned_allocator
+  {
+  public:
+    typedef T         value_type;
+    typedef T*        pointer;
+    typedef const T*  const_pointer;
+    typedef T&        reference;
+    typedef const T&  const_reference;
+    typedef size_t    size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<class U> struct rebind
+    {
+      typedef aligned_allocator<U,Align> other;
+    };
+
+    aligned_allocator()
+    {
+    }
+
+    template<class U> aligned_allocator(const aligned_allocator<U,Align>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+      void *p=NULL;
+      if(!n) return NULL;
+#ifdef _WIN32
+      p=_aligned_malloc(n*sizeof(T),Align);
+#else
+      if(posix_memalign(&p,Align<sizeof(void*)?sizeof(void*):Align,n*sizeof(T)))
+        p=NULL;
+#endif
+      if(!p) throw std::bad_alloc();
+      return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p,size_t)
+    {
+#ifdef _WIN32
+      _aligned_free(p);
+#else
+      free(p);
+#endif
+    }
+  };
+
+  template<class T,class U,size_t Align> bool operator==(const aligned_allocator<T,Align>&,const aligned_allocator<U,Align>&)
+  {
+    return true;
+  }
+
+  template<class T,class U,size_t Align> bool operator!=(const aligned_allocator<T,Align>&,const aligned_allocator<U,Align>&)
+  {
+    return false;
+  }
+
+} //minc
+
+#endif //MINC_IO_ALIGNED_ALLOCATOR_H
@@ -0,0 +1,289 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       :
+@DESCRIPTION: Reductions over voxel buffers: statistics, histograms, percentiles
+@CREATED    : Oct. 19, 2026
+---------------------------------------------------------------------------- */
+#ifndef MINC_IO_REDUCE_H
+#define MINC_IO_REDUCE_H
+
+#include "minc_io_exceptions.h"
+#include <math.h>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace minc
+{
+  //! number of voxels reduced at once, small enough to stay in cache
+  const size_t minc_io_reduce_block=4096;
+
+  //! only finite voxels are taken into account by the reductions
+  template<class T> inline bool voxel_is_finite(const T&)
+  {
+    return true;
+  }
+
+  //! x-x is NaN for infinities and NaN, and the test does not branch
+  template<> inline bool voxel_is_finite(const float& v)
+  {
+    return (v-v)==0.0f;
+  }
+
+  template<> inline bool voxel_is_finite(const double& v)
+  {
+    return (v-v)==0.0;
+  }
+
+  //! summary statistics of a set of voxels
+  struct voxel_stats
+  {
+    size_t count; //! number of voxels
+    double min,max;
+    double sum;   //! compensated sum
+    double comp;  //! running compensation of sum (Kahan)
+    double mean;
+    double m2;    //! sum of squared differences from the mean
+
+    voxel_stats():
+      count(0),
+      min(std::numeric_limits<double>::infinity()),
+      max(-std::numeric_limits<double>::infinity()),
+      sum(0.0),comp(0.0),mean(0.0),m2(0.0)
+    {
+    }
+
+    //! population variance
+    double variance(void) const
+    {
+      return count>0?m2/count:0.0;
+    }
+
+    //! sample variance
+    double sample_variance(void) const
+    {
+      return count>1?m2/(count-1):0.0;
+    }
+
+    double sd(void) const
+    {
+      return sqrt(variance());
+    }
+
+    //! combine with the statistics of another set of voxels
+    //! means and variances are merged pairwise (Chan et al.), sums with Kahan compensation
+    void merge(const voxel_stats& b)
+    {
+      if(!b.count) return;
+      if(!count)
+      {
+        *this=b;
+        return;
+      }
+      size_t n=count+b.count;
+      double delta=b.mean-mean;
+      mean+=delta*b.count/n;
+      m2+=b.m2+delta*delta*count/n*b.count;
+      count=n;
+
+      double y=b.sum-(comp+b.comp);
+      double t=sum+y;
+      comp=(t-sum)-y;
+      sum=t;
+
+      if(b.min<min) min=b.min;
+      if(b.max>max) max=b.max;
+    }
+  };
+
+  //! statistics of one block, in two passes: sum and range, then squared differences from the mean
+  template<class T> voxel_stats block_stats(const T* v,const unsigned char* mask,size_t n)
+  {
+    voxel_stats s;
+    double sum=0.0,sum2=0.0;
+    double mn=s.min,mx=s.max;
+    size_t cnt=0;
+
+    if(mask)
+    {
+#if defined(_OPENMP) && _OPENMP>=201307
+#pragma omp simd reduction(+:sum,cnt) reduction(min:mn) reduction(max:mx)
+#endif
+      for(size_t i=0;i<n;i++)
+      {
+        bool ok=mask[i]&&voxel_is_finite(v[i]);
+        double x=static_cast<double>(v[i]);
+        sum+=ok?x:0.0;
+        cnt+=ok;
+        mn=ok&&x<mn?x:mn;
+        mx=ok&&x>mx?x:mx;
+      }
+    } else {
+#if defined(_OPENMP) && _OPENMP>=201307
+#pragma omp simd reduction(+:sum,cnt) reduction(min:mn) reduction(max:mx)
+#endif
+      for(size_t i=0;i<n;i++)
+      {
+        bool ok=voxel_is_finite(v[i]);
+        double x=static_cast<double>(v[i]);
+        sum+=ok?x:0.0;
+        cnt+=ok;
+        mn=ok&&x<mn?x:mn;
+        mx=ok&&x>mx?x:mx;
+      }
+    }
+    if(!cnt) return s;
+
+    double mean=sum/cnt;
+    if(mask)
+    {
+#if defined(_OPENMP) && _OPENMP>=201307
+#pragma omp simd reduction(+:sum2)
+#endif
+      for(size_t i=0;i<n;i++)
+      {
+        bool ok=mask[i]&&voxel_is_finite(v[i]);
+        double d=static_cast<double>(v[i])-mean;
+        sum2+=ok?d*d:0.0;
+      }
+    } else {
+#if defined(_OPENMP) && _OPENMP>=201307
+#pragma omp simd reduction(+:sum2)
+#endif
+      for(size_t i=0;i<n;i++)
+      {
+        bool ok=voxel_is_finite(v[i]);
+        double d=static_cast<double>(v[i])-mean;
+        sum2+=ok?d*d:0.0;
+      }
+    }
+
+    s.count=cnt;
+    s.sum=sum;
+    s.mean=mean;
+    s.m2=sum2;
+    s.min=mn;
+    s.max=mx;
+    return s;
+  }
+
+  //! statistics of finite voxels where mask is set, or of all finite voxels if mask is NULL
+  //! blocks are split statically between threads and merged in order, so results do not depend on timing
+  template<class T> voxel_stats buffer_stats(const T* v,const unsigned char* mask,size_t n)
+  {
+    long nblocks=static_cast<long>((n+minc_io_reduce_block-1)/minc_io_reduce_block);
+#ifdef _OPENMP
+    std::vector<voxel_stats> parts(omp_get_max_threads());
+#pragma omp parallel
+#else
+    std::vector<voxel_stats> parts(1);
+#endif
+    {
+#ifdef _OPENMP
+      voxel_stats& part=parts[omp_get_thread_num()];
+#pragma omp for schedule(static)
+#else
+      voxel_stats& part=parts[0];
+#endif
+      for(long b=0;b<nblocks;b++)
+      {
+        size_t s=b*minc_io_reduce_block;
+        size_t l=n-s<minc_io_reduce_block?n-s:minc_io_reduce_block;
+        part.merge(block_stats(v+s,mask?mask+s:NULL,l));
+      }
+    }
+
+    voxel_stats total;
+    for(size_t i=0;i<parts.size();i++)
+      total.merge(parts[i]);
+    return total;
+  }
+
+  //! add finite voxels where mask is set into a histogram of hist.size() bins covering [lo,hi]
+  //! voxels outside of the range are not counted
+  template<class T> void buffer_histogram(const T* v,const unsigned char* mask,size_t n,
+                                          double lo,double hi,std::vector<size_t>& hist)
+  {
+    long nbins=static_cast<long>(hist.size());
+    if(!nbins || !(hi>lo))
+      REPORT_ERROR("Invalid histogram range");
+    double scale=nbins/(hi-lo);
+
+#ifdef _OPENMP
+    std::vector<std::vector<size_t> > parts(omp_get_max_threads(),std::vector<size_t>(nbins,0));
+#pragma omp parallel
+#else
+    std::vector<std::vector<size_t> > parts(1,std::vector<size_t>(nbins,0));
+#endif
+    {
+#ifdef _OPENMP
+      size_t *h=&parts[omp_get_thread_num()][0];
+#pragma omp for schedule(static)
+#else
+      size_t *h=&parts[0][0];
+#endif
+      for(long i=0;i<static_cast<long>(n);i++)
+      {
+        if((mask && !mask[i]) || !voxel_is_finite(v[i]))
+          continue;
+        double x=static_cast<double>(v[i]);
+        if(x<lo || x>hi)
+          continue;
+        long bin=static_cast<long>((x-lo)*scale);
+        h[bin<nbins?bin:nbins-1]++;
+      }
+    }
+
+    for(size_t p=0;p<parts.size();p++)
+      for(long b=0;b<nbins;b++)
+        hist[b]+=parts[p][b];
+  }
+
+  //! append finite voxels where mask is set to values
+  template<class T> void buffer_collect(const T* v,const unsigned char* mask,size_t n,std::vector<T>& values)
+  {
+    for(size_t i=0;i<n;i++)
+      if((!mask || mask[i]) && voxel_is_finite(v[i]))
+        values.push_back(v[i]);
+  }
+
+  //! percentiles of values, fractions are in [0,1], interpolated linearly between ranks
+  //! values are reordered
+  template<class T> std::vector<double> values_percentiles(std::vector<T>& values,const std::vector<double>& fractions)
+  {
+    if(values.empty())
+      REPORT_ERROR("No voxels to compute percentiles");
+
+    std::vector<std::pair<double,size_t> > order(fractions.size());
+    for(size_t i=0;i<fractions.size();i++)
+    {
+      if(fractions[i]<0.0 || fractions[i]>1.0)
+        REPORT_ERROR("Percentile fraction out of range");
+      order[i]=std::make_pair(fractions[i],i);
+    }
+    std::sort(order.begin(),order.end());
+
+    // each selection only looks past the previous one
+    std::vector<double> result(fractions.size());
+    typename std::vector<T>::iterator from=values.begin();
+    for(size_t i=0;i<order.size();i++)
+    {
+      double pos=order[i].first*(values.size()-1);
+      size_t k=static_cast<size_t>(floor(pos));
+      typename std::vector<T>::iterator kth=values.begin()+k;
+      std::nth_element(from,kth,values.end());
+      from=kth;
+
+      double r=static_cast<double>(*kth);
+      if(pos>k)
+        r+=(pos-k)*(static_cast<double>(*std::min_element(kth+1,values.end()))-r);
+      result[order[i].second]=r;
+    }
+    return result;
+  }
+
+} //minc
+
+#endif //MINC_IO_REDUCE_H
@@ -17,13 +17,81 @@
 
 #include "minc_io_exceptions.h"
 #include "minc_io_fixed_vector.h"
+#include "minc_io_aligned_allocator.h"
+#include "minc_io_reduce.h"
 #include <string.h>
 #include <math.h>
+#include <algorithm>
 
 namespace minc 
 {
+  //! a box inside a simple_volume, shares the voxels of the volume
+  template<class T> class simple_volume_view
+  {
+    public:
+      enum    {ndims=3};
+      typedef fixed_vec<ndims,size_t> idx;
+      
+    protected:
+      T * _vol;    //! first voxel of the box
+      idx _size;   //! dimension sizes
+      idx _stride; //! strides of the volume
+      
+    public:
+      simple_volume_view(T* vol,const idx& size,const idx& stride):
+        _vol(vol),_size(size),_stride(stride)
+      {
+      }
+      
+      size_t dim(size_t i) const
+      {
+        return _size[i];
+      }
+      
+      const idx& size() const
+      {
+        return _size;
+      }
+      
+      //! start of one row along x
+      T* row(size_t y,size_t z) const
+      {
+        return _vol+y*_stride[1]+z*_stride[2];
+      }
+      
+      T& operator()(size_t x,size_t y,size_t z) const
+      {
+        return _vol[x+y*_stride[1]+z*_stride[2]];
+      }
+      
+      T& operator()(const idx& i) const
+      {
+        return _vol[dot(i,_stride)];
+      }
+      
+      //! copy voxels from a view of the same size
+      template<class S> void copy_from(const simple_volume_view<S>& src) const
+      {
+        if(src.size()!=_size)
+          REPORT_ERROR("Dimensions are different");
+        
+        for(size_t z=0;z<_size[2];z++)
+          for(size_t y=0;y<_size[1];y++)
+            std::copy(src.row(y,z),src.row(y,z)+_size[0],row(y,z));
+      }
+      
+      //! set all voxels to the same value
+      void fill(const T& v) const
+      {
+        for(size_t z=0;z<_size[2];z++)
+          for(size_t y=0;y<_size[1];y++)
+            std::fill(row(y,z),row(y,z)+_size[0],v);
+      }
+  };
+  
   //! very simple 3D volume, initially created as an example but became usable
-    template<class T> class simple_volume
+  //! voxels are stored in a buffer from Alloc (aligned to minc_io_alignment by default), or in an external buffer
+    template<class T,class Alloc=aligned_allocator<T> > class simple_volume
     {
     public:
     
@@ -31,6 +99,8 @@ namespace minc
       typedef fixed_vec<ndims,size_t> idx;
       typedef fixed_vec<ndims,int>    idx_i;
       typedef fixed_vec<ndims,double> vect;
+      typedef simple_volume_view<T>       view_type;
+      typedef simple_volume_view<const T> const_view_type;
       
     protected:
     
@@ -39,10 +109,42 @@ namespace minc
       idx _stride; //! used internally 
       size_t _count;  //! total number of voxels
       bool _free_memory; //! should the array be freed
+      Alloc _alloc; //! allocator of the array
       
       vect _step,_start;    //! conversion to wold coordinates
       vect _direction_cosines[3];
       
+      //! free the array, if it is ours
+      void _release(void)
+      {
+        if(_vol && _free_memory)
+        {
+          for(size_t i=0;i<_count;i++)
+            _vol[i].~T();
+          _alloc.deallocate(_vol,_count);
+        }
+        _vol=0;
+        _free_memory=false;
+      }
+      
+      //! take over the array and the geometry of another volume
+      void _steal(simple_volume& a)
+      {
+        _vol=a._vol;
+        _size=a._size;
+        _stride=a._stride;
+        _count=a._count;
+        _free_memory=a._free_memory;
+        _step=a._step;
+        _start=a._start;
+        for(size_t i=0;i<ndims;i++)
+          _direction_cosines[i]=a._direction_cosines[i];
+        
+        a._vol=0;
+        a._free_memory=false;
+        a._count=0;
+        a._size=IDX<size_t>(0,0,0);
+      }
       
       void _allocate(T* data=NULL)
       {
@@ -59,7 +161,9 @@ namespace minc
           _vol=data;
           _free_memory=false;
         } else {
-          _vol=new T[total];
+          _vol=_alloc.allocate(total);
+          for(size_t i=0;i<total;i++)
+            ::new(static_cast<void*>(_vol+i)) T;
           _free_memory=true;
         }
         
@@ -124,12 +228,12 @@ namespace minc
         return _count;
       }
 
-      explicit simple_volume(const size_t* dims):_vol(0),_size(dims)
+      explicit simple_volume(const size_t* dims):_vol(0),_size(dims),_free_memory(false)
       {
         _allocate();
       }
       
-      explicit simple_volume(const int* dims):_vol(0)
+      explicit simple_volume(const int* dims):_vol(0),_free_memory(false)
       {
         _size[0]=static_cast<size_t>(dims[0]);
         _size[1]=static_cast<size_t>(dims[1]);
@@ -137,16 +241,14 @@ namespace minc
         _allocate();
       }
       
-      simple_volume(const simple_volume<T>& a,bool copy_data=true):_vol(0)
+      simple_volume(const simple_volume& a,bool copy_data=true):_vol(0),_free_memory(false),_alloc(a._alloc)
       {
         for(size_t i=0;i<ndims;i++) 
           _size[i]=a._size[i];
         _allocate();
         
         if(copy_data)
-        {
-          memmove(_vol,a._vol,_size[0]*_size[1]*_size[2]*sizeof(T));
-        }
+          std::copy(a._vol,a._vol+_count,_vol);
         
         _step=a._step;
         _start=a._start;
@@ -154,31 +256,44 @@ namespace minc
           _direction_cosines[i]=a._direction_cosines[i];
       }
       
-      simple_volume(size_t sx,size_t sy,size_t sz):_vol(0)
+      //! move the array of another volume, which is left empty
+      simple_volume(simple_volume&& a) noexcept:_vol(0),_count(0),_free_memory(false),_alloc(a._alloc)
+      {
+        _steal(a);
+      }
+      
+      simple_volume(size_t sx,size_t sy,size_t sz):_vol(0),_free_memory(false)
       {
         _size=IDX(sx,sy,sz);
         _allocate();
       }
       
-      simple_volume(int sx,int sy,int sz):_vol(0)
+      simple_volume(int sx,int sy,int sz):_vol(0),_free_memory(false)
       {
         _size=IDX<size_t>(sx,sy,sz);
         _allocate();
       }      
       
-      explicit simple_volume(const idx& s):_vol(0)
+      explicit simple_volume(const idx& s,const Alloc& alloc=Alloc()):_vol(0),_free_memory(false),_alloc(alloc)
       {
         _size=s;
         _allocate();
       }
       
-      explicit simple_volume(const idx_i& s):_vol(0)
+      explicit simple_volume(const idx_i& s):_vol(0),_free_memory(false)
       {
         _size=IDX<size_t>(s[0],s[1],s[2]);
         _allocate();
       }
+      
+      //! use an external buffer for storage, it will not be freed
+      simple_volume(const idx& s,T* array):_vol(0),_free_memory(false)
+      {
+        _size=s;
+        _allocate(array);
+      }
 
-      simple_volume():_vol(0),_count(0),_free_memory(false)
+      explicit simple_volume(const Alloc& alloc=Alloc()):_vol(0),_count(0),_free_memory(false),_alloc(alloc)
       {
         for(size_t i=0;i<ndims;i++)
         {
@@ -201,8 +316,7 @@ namespace minc
         if( _size[0]==sx && _size[1]==sy && _size[2]==sz )
           return;
         
-        if(_vol && _free_memory)
-          delete [] _vol;
+        _release();
         _size=IDX(sx,sy,sz);
         _allocate();
       }
@@ -211,8 +325,7 @@ namespace minc
       {
         if(_size==s) return;
         
-        if(_vol&&_free_memory)
-          delete [] _vol;
+        _release();
         _size=s;
         _allocate();
       }
@@ -224,8 +337,42 @@ namespace minc
       
       virtual ~simple_volume()
       {
-        if(_vol && _free_memory)
-          delete [] _vol;
+        _release();
+      }
+      
+      //! does the volume own its array
+      bool owns_memory(void) const
+      {
+        return _free_memory;
+      }
+      
+      //! allocator of the array
+      const Alloc& get_allocator(void) const
+      {
+        return _alloc;
+      }
+      
+      //! box from s (inclusive) to f (exclusive), without copying
+      view_type view(const idx& s,const idx& f)
+      {
+        return view_type(_vol+dot(s,_stride),f-s,_stride);
+      }
+      
+      //! box from s (inclusive) to f (exclusive), without copying
+      const_view_type view(const idx& s,const idx& f) const
+      {
+        return const_view_type(_vol+dot(s,_stride),f-s,_stride);
+      }
+      
+      //! the whole volume
+      view_type view(void)
+      {
+        return view_type(_vol,_size,_stride);
+      }
+      
+      const_view_type view(void) const
+      {
+        return const_view_type(_vol,_size,_stride);
       }
       
       T& operator()(size_t x,size_t y,size_t z)
@@ -376,7 +523,7 @@ namespace minc
         return _size;
       }
       
-      void extract_subvolume(simple_volume<T>& dst,const idx& s, const idx& f) const
+      void extract_subvolume(simple_volume& dst,const idx& s, const idx& f) const
       {
         for(size_t k=s[2];k<f[2];k++)
          for(size_t j=s[1];j<f[1];j++)
@@ -434,7 +581,7 @@ namespace minc
         return true;
       }
           
-      simple_volume<T>& operator+=(const simple_volume<T>& a)
+      simple_volume& operator+=(const simple_volume& a)
       {
         for(size_t i=0;i<ndims;i++) 
           if(_size[i]!=a._size[i])
@@ -445,14 +592,14 @@ namespace minc
         return *this;
       }
       
-      simple_volume<T>& operator+=(const T& a)
+      simple_volume& operator+=(const T& a)
       {
         for(size_t i=0;i<_count;i++)
           _vol[i]+=a;
         return *this;
       }
       
-      simple_volume<T>& operator-=(const simple_volume<T>& a)
+      simple_volume& operator-=(const simple_volume& a)
       {
          if(_size!=a._size)
             REPORT_ERROR("Dimensions are different");
@@ -462,14 +609,14 @@ namespace minc
         return *this;
       }
       
-      simple_volume<T>& operator-=(const T& a)
+      simple_volume& operator-=(const T& a)
       {
         for(size_t i=0;i<_count;i++)
           _vol[i]-=a;
         return *this;
       }
       
-      simple_volume<T>& operator*=(const simple_volume<T>& a)
+      simple_volume& operator*=(const simple_volume& a)
       {
         for(size_t i=0;i<ndims;i++) 
           if(_size[i]!=a._size[i])
@@ -480,16 +627,16 @@ namespace minc
         return *this;
       }
       
-      simple_volume<T>& operator*=(const T& a)
+      simple_volume& operator*=(const T& a)
       {
         for(size_t i=0;i<_count;i++)
           _vol[i]*=a;
         return *this;
       }
       
-      simple_volume<T>& operator/=(const simple_volume<T>& a)
+      simple_volume& operator/=(const simple_volume& a)
       {
-        if(_size!=a._size())
+        if(_size!=a._size)
           REPORT_ERROR("Dimensions are different");
         
         for(size_t i=0;i<_count;i++)
@@ -497,18 +644,19 @@ namespace minc
         return *this;
       }
       
-      simple_volume<T>& operator/=(const T& a)
+      simple_volume& operator/=(const T& a)
       {
         for(size_t i=0;i<_count;i++)
           _vol[i]/=a;
         return *this;
       }
       
-      simple_volume& operator=(const simple_volume<T>&a)
+      simple_volume& operator=(const simple_volume&a)
       {
+        if(this==&a) return *this;
         resize(a.dim(0),a.dim(1),a.dim(2));
         
-        memmove(_vol, a._vol, _count*sizeof(T));
+        std::copy(a._vol,a._vol+_count,_vol);
         
         _step=a._step;
         _start=a._start;
@@ -519,6 +667,16 @@ namespace minc
         return *this;
       }
       
+      //! move the array of another volume, which is left empty
+      simple_volume& operator=(simple_volume&& a) noexcept
+      {
+        if(this==&a) return *this;
+        _release();
+        _alloc=a._alloc;
+        _steal(a);
+        return *this;
+      }
+      
       simple_volume& operator=(const T&a)
       {
         for(size_t i=0;i<_count;i++)
@@ -526,7 +684,7 @@ namespace minc
         return *this;
       }
       
-      void weighted_add(const simple_volume<T>&a, double w)
+      void weighted_add(const simple_volume&a, double w)
       {
         if(_size!=a._size)
           REPORT_ERROR("Dimensions are different");
@@ -581,75 +739,115 @@ namespace minc
         return r;
       }
       
-      //!use provided buffer for storage
+      //!use provided buffer for storage, it will not be freed
       void assign(const idx& s,T* array) 
       {
+        _release();
         _size=s;
-        allocate(array);
+        _allocate(array);
       }
       
-      //!use provided buffer for storage
+      //!use provided buffer for storage, it will not be freed
       void assign(const idx_i& s,T* array) 
       {
-        _size=IDX<size_t>(s[0],s[1],s[2]);
-        allocate(array);
+        assign(IDX<size_t>(s[0],s[1],s[2]),array);
       }
   };
   
   //! remove (unpad) or add padding as needed, volume will be centered
-  template<class T>void pad_volume(const simple_volume<T> &src,simple_volume<T> &dst, const T& fill)
+  template<class T,class A1,class A2>void pad_volume(const simple_volume<T,A1> &src,simple_volume<T,A2> &dst, const T& fill)
   {
-    fixed_vec<3,size_t> sz1=src.size();
-    fixed_vec<3,size_t> sz2=dst.size();
-    fixed_vec<3,size_t> d=sz2-sz1;
-    fixed_vec<3,size_t> i;
+    fixed_vec<3,size_t> s1,s2,f2;
     
-    d/=2;//offset
-  
-    for( i[2]=0;i[2]<sz2[2];i[2]++)
-      for( i[1]=0;i[1]<sz2[1];i[1]++)
-        for( i[0]=0;i[0]<sz2[0];i[0]++)
+    for(size_t i=0;i<3;i++)
     {
-      fixed_vec<3,size_t> j= i-d;
-      
-      if( src.hit(j)) 
-        dst.set(i,src.get(j));
-      else
-        dst.set(i,fill);
+      //offset of src in dst, may be negative
+      long d=(static_cast<long>(dst.dim(i))-static_cast<long>(src.dim(i)))/2;
+      s1[i]=d<0?-d:0;
+      s2[i]=d>0?d:0;
+      f2[i]=s2[i]+std::min(src.dim(i)-s1[i],dst.dim(i)-s2[i]);
     }
+    
+    dst.view().fill(fill);
+    dst.view(s2,f2).copy_from(src.view(s1,s1+(f2-s2)));
   }
   
-  template<class T>void volume_min_max(const simple_volume<T>& v,T &_min,T &_max)
+  //! statistics of all finite voxels
+  template<class T,class A> voxel_stats volume_stats(const simple_volume<T,A>& v)
   {
-    _min=_max=v.c_buf()[0];
-    
-    for(size_t i=0;i<v.c_buf_size();i++)
-    {
-			if(isnan(v.c_buf()[i]) || isinf(v.c_buf()[i])) 
-				continue;
-			
-      if(v.c_buf()[i]>_max) _max=v.c_buf()[i];
-      else if(v.c_buf()[i]<_min) _min=v.c_buf()[i];
-    }
+    return buffer_stats(v.c_buf(),static_cast<const unsigned char*>(NULL),v.c_buf_size());
   }
   
-  template<class T> void  volume_min_max(const simple_volume<T>& v,const simple_volume<unsigned char>& mask,T &_min,T &_max)
+  //! statistics of finite voxels inside the mask
+  template<class T,class A,class M> voxel_stats volume_stats(const simple_volume<T,A>& v,const simple_volume<unsigned char,M>& mask)
   {
     if(v.size()!=mask.size())
       REPORT_ERROR("Volume size mismatch");
-    
-    _min=1e10;
-    _max=-1e10;
-    
-    for(size_t i=0;i<v.c_buf_size();i++)
+    return buffer_stats(v.c_buf(),mask.c_buf(),v.c_buf_size());
+  }
+  
+  //! histogram of finite voxels with nbins bins covering [lo,hi]
+  template<class T,class A> std::vector<size_t> volume_histogram(const simple_volume<T,A>& v,size_t nbins,double lo,double hi)
+  {
+    std::vector<size_t> hist(nbins,0);
+    buffer_histogram(v.c_buf(),static_cast<const unsigned char*>(NULL),v.c_buf_size(),lo,hi,hist);
+    return hist;
+  }
+  
+  //! histogram of finite voxels inside the mask with nbins bins covering [lo,hi]
+  template<class T,class A,class M> std::vector<size_t> volume_histogram(const simple_volume<T,A>& v,const simple_volume<unsigned char,M>& mask,
+                                                                          size_t nbins,double lo,double hi)
+  {
+    if(v.size()!=mask.size())
+      REPORT_ERROR("Volume size mismatch");
+    std::vector<size_t> hist(nbins,0);
+    buffer_histogram(v.c_buf(),mask.c_buf(),v.c_buf_size(),lo,hi,hist);
+    return hist;
+  }
+  
+  //! percentiles of finite voxels, fractions are in [0,1]
+  template<class T,class A> std::vector<double> volume_percentiles(const simple_volume<T,A>& v,const std::vector<double>& fractions)
+  {
+    std::vector<T> values;
+    values.reserve(v.c_buf_size());
+    buffer_collect(v.c_buf(),static_cast<const unsigned char*>(NULL),v.c_buf_size(),values);
+    return values_percentiles(values,fractions);
+  }
+  
+  //! percentiles of finite voxels inside the mask, fractions are in [0,1]
+  template<class T,class A,class M> std::vector<double> volume_percentiles(const simple_volume<T,A>& v,const simple_volume<unsigned char,M>& mask,
+                                                                            const std::vector<double>& fractions)
+  {
+    if(v.size()!=mask.size())
+      REPORT_ERROR("Volume size mismatch");
+    std::vector<T> values;
+    buffer_collect(v.c_buf(),mask.c_buf(),v.c_buf_size(),values);
+    return values_percentiles(values,fractions);
+  }
+  
+  //! range of finite voxels
+  template<class T,class A>void volume_min_max(const simple_volume<T,A>& v,T &_min,T &_max)
+  {
+    voxel_stats s=volume_stats(v);
+    if(s.count)
     {
-      if(mask.c_buf()[i])
-      {
-				if(isnan(v.c_buf()[i]) || isinf(v.c_buf()[i])) 
-					continue;
-        if(v.c_buf()[i]>_max) _max=v.c_buf()[i];
-        else if(v.c_buf()[i]<_min) _min=v.c_buf()[i];
-      }
+      _min=static_cast<T>(s.min);
+      _max=static_cast<T>(s.max);
+    } else
+      _min=_max=v.c_buf()[0];
+  }
+  
+  //! range of finite voxels inside the mask
+  template<class T,class A,class M> void  volume_min_max(const simple_volume<T,A>& v,const simple_volume<unsigned char,M>& mask,T &_min,T &_max)
+  {
+    voxel_stats s=volume_stats(v,mask);
+    if(s.count)
+    {
+      _min=static_cast<T>(s.min);
+      _max=static_cast<T>(s.max);
+    } else {
+      _min=1e10;
+      _max=-1e10;
     }
   }
   
@@ -6,6 +6,7 @@
 
 #include "minc_1_rw.h"
 #include "minc_1_simple.h"
+#include "minc_io_reduce.h"
 
 using namespace minc;
 
@@ -41,14 +42,9 @@ template<class TPixel> double calc_stats(const char * filename)
   load_standard_volume(rdr,&in_buffer[0]);
   rdr.close();
   
-  double mean=0.0;
+  voxel_stats stats=buffer_stats(&in_buffer[0],static_cast<const unsigned char*>(NULL),volume);
   
-  for(int i=0;i<volume;i++)
-    mean+=in_buffer[i];
-  
-  mean/=volume;
-  
-  return mean;
+  return stats.mean;
 }
 
 
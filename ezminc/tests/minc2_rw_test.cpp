@@ -0,0 +1,126 @@
+#include <iostream>
+#include <unistd.h>
+#include <stdlib.h>
+#include <vector>
+#include <math.h>
+#include <utility>
+
+#include "minc2_rw.h"
+
+using namespace minc;
+
+template<class TPixel> void make_rw_test(const char * filename,mitype_t datatype,double max_diff=0.0)
+{
+  std::vector<minc2_dim> dims;
+  dims.push_back(minc2_dim("zspace",12,-5.0,2.1));
+  dims.push_back(minc2_dim("yspace",11,-4.0,1.1));
+  dims.push_back(minc2_dim("xspace",10,-3.0,0.1));
+
+  std::vector<misize_t> chunk(3);
+  chunk[0]=4;chunk[1]=11;chunk[2]=10;
+
+  size_t volume=12*11*10;
+
+  //fill the buffer
+  std::vector<TPixel> buffer(volume);
+  for(size_t i=0;i<volume;i++)
+    buffer[i]=static_cast<TPixel>(random()%200)+static_cast<TPixel>(i/110);
+
+  //write volume slab by slab, moving the writer around on the way
+  {
+    minc2_writer wrt;
+    wrt.open(filename,dims,datatype,chunk);
+
+    minc2_writer moved(std::move(wrt));
+    if(wrt.is_open() || !moved.is_open())
+      REPORT_ERROR("Writer was not moved");
+
+    if(moved.chunk()[0]!=4)
+      REPORT_ERROR("Mismatched chunk size");
+
+    //integer types are scaled slice by slice, real types as one volume
+    bool real_type=(datatype==MI_TYPE_FLOAT || datatype==MI_TYPE_DOUBLE);
+    if(moved.slice_dimensions()!=(real_type?3:2))
+      REPORT_ERROR("Mismatched number of image dimensions");
+
+    size_t offset=0;
+    minc2_slab_iterator slab(moved,300);
+    for(slab.begin();!slab.last();slab.next())
+    {
+      if(slab.count()[1]!=11 || slab.count()[2]!=10)
+        REPORT_ERROR("Slab is not made of whole chunks");
+      if(moved.slice_dimensions()==2 && slab.count()[0]>4)
+        REPORT_ERROR("Slab is not made of whole chunks");
+      //with 3 image dimensions, a slice is the whole volume
+      if(moved.slice_dimensions()==3 && slab.count()[0]!=12)
+        REPORT_ERROR("Slab is not made of whole slices");
+      moved.write(slab.start(),slab.count(),&buffer[offset]);
+      offset+=slab.voxels();
+    }
+    if(offset!=volume)
+      REPORT_ERROR("Slabs do not cover the volume");
+  }
+
+  //reading volume
+  minc2_reader rdr;
+  rdr.open(filename);
+
+  for(int i=0;i<3;i++)
+  {
+    if(rdr.dim(i).name!=dims[i].name)
+      REPORT_ERROR("Mismatched dimension");
+    if(rdr.dim(i).length!=dims[i].length)
+      REPORT_ERROR("Mismatched dimension length");
+    if(fabs(rdr.dim(i).step-dims[i].step)>1e-6)
+      REPORT_ERROR("Mismatched step");
+    if(fabs(rdr.dim(i).start-dims[i].start)>1e-6)
+      REPORT_ERROR("Mismatched start");
+  }
+
+  std::vector<TPixel> in_buffer(volume);
+  rdr.read(&in_buffer[0]);
+
+  for(size_t i=0;i<volume;i++)
+    if(fabs((double)buffer[i]-(double)in_buffer[i])>max_diff)
+    {
+      std::cerr<<"Expected:"<<buffer[i]<<" got:"<<in_buffer[i]<<" @ "<<i<<std::endl;
+      REPORT_ERROR("Data mismatched too much!");
+    }
+
+  //read one slice in the middle
+  misize_t start[3]={5,0,0};
+  misize_t count[3]={1,11,10};
+  std::vector<TPixel> slice(110);
+  rdr.read(start,count,&slice[0]);
+  for(size_t i=0;i<110;i++)
+    if(fabs((double)buffer[5*110+i]-(double)slice[i])>max_diff)
+      REPORT_ERROR("Slice mismatched too much!");
+}
+
+int main(int argc,char **argv)
+{
+  try
+  {
+    if(argc>1)
+    {
+      if(chdir(argv[1]))
+        REPORT_ERROR("Can't chdir!");
+    }
+
+    //no rounding expected
+    make_rw_test<float>("EZminc2_float.mnc",MI_TYPE_FLOAT);
+    make_rw_test<double>("EZminc2_double.mnc",MI_TYPE_DOUBLE);
+
+    // some rounding expected
+    make_rw_test<float>("EZminc2_float_short.mnc",MI_TYPE_SHORT,0.1);
+    make_rw_test<double>("EZminc2_double_byte.mnc",MI_TYPE_UBYTE,0.5);
+    make_rw_test<int>("EZminc2_int_short.mnc",MI_TYPE_SHORT,1.0);
+
+  } catch (const minc::generic_error & err) {
+    std::cerr << "Got an error at:" << err.file () << ":" << err.line () << std::endl;
+    std::cerr << err.msg()<<std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include <iostream>
+#include <math.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include "minc_io_simple_volume.h"
+#include "minc_io_4d_volume.h"
+
+using namespace minc;
+
+int main(int argc,char **argv)
+{
+  try
+  {
+    minc_float_volume a(IDX<size_t>(7,6,5));
+    for(size_t i=0;i<a.c_buf_size();i++)
+      a.c_buf()[i]=static_cast<float>(i);
+
+    if(reinterpret_cast<uintptr_t>(a.c_buf())%minc_io_alignment)
+      REPORT_ERROR("Voxels are not aligned");
+
+    //moving should not copy the voxels
+    const float *voxels=a.c_buf();
+    minc_float_volume b(std::move(a));
+    if(b.c_buf()!=voxels || a.c_buf_size()!=0)
+      REPORT_ERROR("Volume was not moved");
+
+    minc_float_volume c;
+    c=std::move(b);
+    if(c.c_buf()!=voxels || c.dim(2)!=5)
+      REPORT_ERROR("Volume was not move-assigned");
+
+    //external buffer is used in place
+    std::vector<float> external(7*6*5,1.0f);
+    {
+      minc_float_volume e(IDX<size_t>(7,6,5),&external[0]);
+      if(e.owns_memory() || e.c_buf()!=&external[0])
+        REPORT_ERROR("External buffer was not used");
+      e.set(1,2,3,5.0f);
+    }
+    if(external[1+2*7+3*42]!=5.0f)
+      REPORT_ERROR("External buffer was not written");
+
+    //view shares the voxels
+    minc_float_volume::view_type v=c.view(IDX<size_t>(1,2,3),IDX<size_t>(4,5,5));
+    if(v.dim(0)!=3 || v.dim(1)!=3 || v.dim(2)!=2)
+      REPORT_ERROR("Wrong view size");
+    if(v(0,0,0)!=c.get(1,2,3) || v(2,2,1)!=c.get(3,4,4))
+      REPORT_ERROR("View does not match the volume");
+    v(1,1,1)=-1.0f;
+    if(c.get(2,3,4)!=-1.0f)
+      REPORT_ERROR("View does not share voxels");
+
+    //pad and unpad back
+    minc_float_volume padded(IDX<size_t>(11,10,9)),unpadded(IDX<size_t>(7,6,5));
+    pad_volume(c,padded,0.0f);
+    if(padded.get(0,0,0)!=0.0f || padded.get(2,2,2)!=c.get(0,0,0) || padded.get(8,7,6)!=c.get(6,5,4))
+      REPORT_ERROR("Padding is wrong");
+    pad_volume(padded,unpadded,0.0f);
+    for(size_t i=0;i<c.c_buf_size();i++)
+      if(unpadded.c_buf()[i]!=c.c_buf()[i])
+        REPORT_ERROR("Unpadding is wrong");
+
+    //reductions against a straightforward computation
+    minc_float_volume r(IDX<size_t>(37,29,23));
+    minc_byte_volume mask(IDX<size_t>(37,29,23));
+    for(size_t i=0;i<r.c_buf_size();i++)
+    {
+      r.c_buf()[i]=static_cast<float>(1000.0+sin(i*0.01)*100.0);
+      mask.c_buf()[i]=(i%3)==0;
+    }
+    r.c_buf()[5]=NAN;
+    r.c_buf()[7]=INFINITY;
+
+    long double sum=0.0,msum=0.0;
+    size_t mcount=0;
+    for(size_t i=0;i<r.c_buf_size();i++)
+    {
+      if(i==5 || i==7) continue;
+      sum+=r.c_buf()[i];
+      if(mask.c_buf()[i]) { msum+=r.c_buf()[i]; mcount++; }
+    }
+
+    voxel_stats st=volume_stats(r);
+    if(st.count!=r.c_buf_size()-2 || fabs(st.sum-static_cast<double>(sum))>1e-6*fabs(static_cast<double>(sum)))
+      REPORT_ERROR("Wrong sum");
+    long double var=0.0;
+    for(size_t i=0;i<r.c_buf_size();i++)
+      if(i!=5 && i!=7)
+        var+=(r.c_buf()[i]-static_cast<long double>(st.mean))*(r.c_buf()[i]-static_cast<long double>(st.mean));
+    var/=st.count;
+    if(fabs(st.variance()-static_cast<double>(var))>1e-9*static_cast<double>(var))
+      REPORT_ERROR("Wrong variance");
+
+    float mn,mx;
+    volume_min_max(r,mn,mx);
+    if(!(mn>=900.0f && mx<=1100.0f && mx>mn))
+      REPORT_ERROR("Wrong range");
+
+    voxel_stats ms=volume_stats(r,mask);
+    if(ms.count!=mcount || fabs(ms.mean-static_cast<double>(msum/mcount))>1e-6)
+      REPORT_ERROR("Wrong masked mean");
+
+    std::vector<size_t> h=volume_histogram(r,mask,10,900.0,1100.0);
+    size_t hsum=0;
+    for(size_t i=0;i<h.size();i++) hsum+=h[i];
+    if(hsum!=mcount)
+      REPORT_ERROR("Wrong masked histogram");
+
+    std::vector<double> fr;
+    fr.push_back(1.0);fr.push_back(0.0);fr.push_back(0.5);
+    std::vector<double> p=volume_percentiles(r,fr);
+    if(p[0]!=mx || p[1]!=mn || !(p[2]>mn && p[2]<mx))
+      REPORT_ERROR("Wrong percentiles");
+
+    simple_4d_volume<float> r4;
+    r4.resize(4,3,2,2);
+    for(int t=0;t<2;t++)
+      for(size_t i=0;i<r4.frame(t).c_buf_size();i++)
+        r4.frame(t).c_buf()[i]=static_cast<float>(t*24+i);
+    st=volume_stats(r4);
+    if(st.count!=48 || st.mean!=23.5 || st.min!=0.0 || st.max!=47.0)
+      REPORT_ERROR("Wrong 4D statistics");
+    fr.assign(1,0.25);
+    if(volume_percentiles(r4,fr)[0]!=11.75)
+      REPORT_ERROR("Wrong 4D percentile");
+
+  } catch (const minc::generic_error & err) {
+    std::cerr << "Got an error at:" << err.file () << ":" << err.line () << std::endl;
+    std::cerr << err.msg()<<std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,344 @@
+/** \file swap_convert.c
+ * \brief Byte swapping and voxel type conversion shared by the readers
+ * and writers.
+ *
+ * Byte swapping uses byte shuffles (pshufb) when the processor has them,
+ * chosen at run time on x86 compilers that allow it, and plain loops
+ * otherwise.  Type conversion is done a block at a time through a buffer
+ * that stays in the first level cache, with one simple loop per pair of
+ * types, which the compiler can vectorize.
+ *
+ ************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SWAP_CONVERT_X86 1
+#include <immintrin.h>
+#endif
+
+#include "swap_convert.h"
+
+/* Number of elements converted at once, small enough for the cache. */
+#define SWAP_CONVERT_BLOCK 1024
+
+int
+minc_host_big_endian(void)
+{
+  union {
+    unsigned short s;
+    unsigned char c[2];
+  } v;
+
+  v.s = 0x0102;
+  return v.c[0] == 1;
+}
+
+size_t
+minc_value_size(minc_value_type type)
+{
+  switch (type) {
+  case MINC_VALUE_UBYTE:
+  case MINC_VALUE_BYTE:
+    return 1;
+  case MINC_VALUE_USHORT:
+  case MINC_VALUE_SHORT:
+    return 2;
+  case MINC_VALUE_UINT:
+  case MINC_VALUE_INT:
+  case MINC_VALUE_FLOAT:
+    return 4;
+  case MINC_VALUE_DOUBLE:
+    return 8;
+  }
+  return 0;
+}
+
+#ifdef SWAP_CONVERT_X86
+
+/* Byte shuffles reversing 2, 4 and 8 byte elements. */
+static const unsigned char swap_shuffle[3][16] = {
+  { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+  { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+  { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 }
+};
+
+__attribute__((target("avx2")))
+static size_t
+swap_avx2(unsigned char *data, size_t n_bytes, const unsigned char *shuffle)
+{
+  __m256i mask = _mm256_broadcastsi128_si256(
+    _mm_loadu_si128((const __m128i *) shuffle));
+  size_t i;
+
+  for (i = 0; i + 32 <= n_bytes; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *) (data + i));
+    _mm256_storeu_si256((__m256i *) (data + i), _mm256_shuffle_epi8(v, mask));
+  }
+  return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t
+swap_ssse3(unsigned char *data, size_t n_bytes, const unsigned char *shuffle)
+{
+  __m128i mask = _mm_loadu_si128((const __m128i *) shuffle);
+  size_t i;
+
+  for (i = 0; i + 16 <= n_bytes; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) (data + i));
+    _mm_storeu_si128((__m128i *) (data + i), _mm_shuffle_epi8(v, mask));
+  }
+  return i;
+}
+
+/** Returns 2 if the processor has AVX2, 1 if it has SSSE3, 0 otherwise.
+ */
+static int
+swap_cpu_level(void)
+{
+  static int level = -1;
+
+  if (level < 0) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+      level = 2;
+    else if (__builtin_cpu_supports("ssse3"))
+      level = 1;
+    else
+      level = 0;
+  }
+  return level;
+}
+
+#endif /* SWAP_CONVERT_X86 */
+
+void
+minc_swap_bytes(void *data, size_t n, size_t size)
+{
+  unsigned char *p = (unsigned char *) data;
+  size_t n_bytes = n * size;
+  size_t i = 0;
+  size_t j;
+
+  if (size < 2)
+    return;
+
+#ifdef SWAP_CONVERT_X86
+  if (size == 2 || size == 4 || size == 8) {
+    const unsigned char *shuffle = swap_shuffle[size == 2 ? 0 : size == 4 ? 1 : 2];
+
+    switch (swap_cpu_level()) {
+    case 2:
+      i = swap_avx2(p, n_bytes, shuffle);
+      break;
+    case 1:
+      i = swap_ssse3(p, n_bytes, shuffle);
+      break;
+    }
+  }
+#endif
+
+  /* The rest, a whole element at a time. */
+  switch (size) {
+  case 2:
+    for (; i < n_bytes; i += 2) {
+      unsigned short v;
+      memcpy(&v, p + i, 2);
+      v = (unsigned short) ((v >> 8) | (v << 8));
+      memcpy(p + i, &v, 2);
+    }
+    break;
+  case 4:
+    for (; i < n_bytes; i += 4) {
+      unsigned int v;
+      memcpy(&v, p + i, 4);
+      v = ((v >> 24) | ((v >> 8) & 0xff00U) |
+           ((v << 8) & 0xff0000U) | (v << 24));
+      memcpy(p + i, &v, 4);
+    }
+    break;
+  default:
+    for (; i < n_bytes; i += size) {
+      for (j = 0; j < size / 2; j++) {
+        unsigned char t = p[i + j];
+        p[i + j] = p[i + size - 1 - j];
+        p[i + size - 1 - j] = t;
+      }
+    }
+    break;
+  }
+}
+
+/** Clamps a value to [lo,hi], with invalid values set to zero.
+ */
+static double
+clamp_value(double v, double lo, double hi)
+{
+  v = (v == v) ? v : 0.0;
+  v = (v < lo) ? lo : v;
+  return (v > hi) ? hi : v;
+}
+
+/* One loop per pair of types.  Integer sources whose range fits in the
+ * destination are cast directly, everything else is clamped.
+ */
+#define CONVERT_INT_LOOP(stype, smin, smax, dtype, lo, hi)              \
+  {                                                                     \
+    const stype *s = (const stype *) src;                               \
+    dtype *d = (dtype *) dst;                                           \
+    if ((double) (smin) >= (lo) && (double) (smax) <= (hi)) {           \
+      for (i = 0; i < n; i++)                                           \
+        d[i] = (dtype) s[i];                                            \
+    }                                                                   \
+    else if (round) {                                                   \
+      for (i = 0; i < n; i++)                                           \
+        d[i] = (dtype) clamp_value(rint((double) s[i]), lo, hi);        \
+    }                                                                   \
+    else {                                                              \
+      for (i = 0; i < n; i++)                                           \
+        d[i] = (dtype) clamp_value((double) s[i], lo, hi);              \
+    }                                                                   \
+  }
+
+#define CONVERT_TO_INT(dtype, lo, hi)                                   \
+  switch (src_type) {                                                   \
+  case MINC_VALUE_UBYTE:                                                \
+    CONVERT_INT_LOOP(unsigned char, 0, UCHAR_MAX, dtype, lo, hi);       \
+    break;                                                              \
+  case MINC_VALUE_BYTE:                                                 \
+    CONVERT_INT_LOOP(signed char, SCHAR_MIN, SCHAR_MAX, dtype, lo, hi); \
+    break;                                                              \
+  case MINC_VALUE_USHORT:                                               \
+    CONVERT_INT_LOOP(unsigned short, 0, USHRT_MAX, dtype, lo, hi);      \
+    break;                                                              \
+  case MINC_VALUE_SHORT:                                                \
+    CONVERT_INT_LOOP(short, SHRT_MIN, SHRT_MAX, dtype, lo, hi);         \
+    break;                                                              \
+  case MINC_VALUE_UINT:                                                 \
+    CONVERT_INT_LOOP(unsigned int, 0, UINT_MAX, dtype, lo, hi);         \
+    break;                                                              \
+  case MINC_VALUE_INT:                                                  \
+    CONVERT_INT_LOOP(int, INT_MIN, INT_MAX, dtype, lo, hi);             \
+    break;                                                              \
+  case MINC_VALUE_FLOAT:                                                \
+    CONVERT_INT_LOOP(float, -DBL_MAX, DBL_MAX, dtype, lo, hi);          \
+    break;                                                              \
+  case MINC_VALUE_DOUBLE:                                               \
+    CONVERT_INT_LOOP(double, -DBL_MAX, DBL_MAX, dtype, lo, hi);         \
+    break;                                                              \
+  }
+
+#define CONVERT_REAL_LOOP(stype, dtype)                                 \
+  {                                                                     \
+    const stype *s = (const stype *) src;                               \
+    dtype *d = (dtype *) dst;                                           \
+    for (i = 0; i < n; i++)                                             \
+      d[i] = (dtype) s[i];                                              \
+  }
+
+#define CONVERT_TO_REAL(dtype)                                          \
+  switch (src_type) {                                                   \
+  case MINC_VALUE_UBYTE:  CONVERT_REAL_LOOP(unsigned char, dtype); break; \
+  case MINC_VALUE_BYTE:   CONVERT_REAL_LOOP(signed char, dtype); break; \
+  case MINC_VALUE_USHORT: CONVERT_REAL_LOOP(unsigned short, dtype); break; \
+  case MINC_VALUE_SHORT:  CONVERT_REAL_LOOP(short, dtype); break;       \
+  case MINC_VALUE_UINT:   CONVERT_REAL_LOOP(unsigned int, dtype); break; \
+  case MINC_VALUE_INT:    CONVERT_REAL_LOOP(int, dtype); break;         \
+  case MINC_VALUE_FLOAT:  CONVERT_REAL_LOOP(float, dtype); break;       \
+  case MINC_VALUE_DOUBLE: CONVERT_REAL_LOOP(double, dtype); break;      \
+  }
+
+/** Converts n native order elements between buffers that do not overlap.
+ */
+static void
+convert_block(void *dst, minc_value_type dst_type,
+              const void *src, minc_value_type src_type,
+              size_t n, int round)
+{
+  size_t i;
+
+  switch (dst_type) {
+  case MINC_VALUE_UBYTE:
+    CONVERT_TO_INT(unsigned char, 0.0, UCHAR_MAX);
+    break;
+  case MINC_VALUE_BYTE:
+    CONVERT_TO_INT(signed char, SCHAR_MIN, SCHAR_MAX);
+    break;
+  case MINC_VALUE_USHORT:
+    CONVERT_TO_INT(unsigned short, 0.0, USHRT_MAX);
+    break;
+  case MINC_VALUE_SHORT:
+    CONVERT_TO_INT(short, SHRT_MIN, SHRT_MAX);
+    break;
+  case MINC_VALUE_UINT:
+    CONVERT_TO_INT(unsigned int, 0.0, UINT_MAX);
+    break;
+  case MINC_VALUE_INT:
+    CONVERT_TO_INT(int, INT_MIN, INT_MAX);
+    break;
+  case MINC_VALUE_FLOAT:
+    CONVERT_TO_REAL(float);
+    break;
+  case MINC_VALUE_DOUBLE:
+    CONVERT_TO_REAL(double);
+    break;
+  }
+}
+
+void
+minc_swap_convert(void *dst, minc_value_type dst_type,
+                  const void *src, minc_value_type src_type,
+                  size_t n, int flags)
+{
+  double temp[SWAP_CONVERT_BLOCK];
+  size_t src_size = minc_value_size(src_type);
+  size_t dst_size = minc_value_size(dst_type);
+  size_t src_addr = (size_t) src;
+  size_t dst_addr = (size_t) dst;
+  size_t n_blocks, b;
+  int overlap, backward;
+
+  if (src_type == dst_type) {
+    if (dst != src)
+      memmove(dst, src, n * src_size);
+    if (!(flags & MINC_SWAP_SRC) != !(flags & MINC_SWAP_DST))
+      minc_swap_bytes(dst, n, dst_size);
+    return;
+  }
+
+  /* Overlapping buffers are converted through the temporary buffer,
+   * and from the end when the elements grow, so that no source block
+   * is overwritten before it is read.
+   */
+  overlap = (src_addr < dst_addr + n * dst_size &&
+             dst_addr < src_addr + n * src_size);
+  backward = overlap && dst_size > src_size;
+
+  n_blocks = (n + SWAP_CONVERT_BLOCK - 1) / SWAP_CONVERT_BLOCK;
+  for (b = 0; b < n_blocks; b++) {
+    size_t start = (backward ? n_blocks - 1 - b : b) * SWAP_CONVERT_BLOCK;
+    size_t count = n - start < SWAP_CONVERT_BLOCK ? n - start : SWAP_CONVERT_BLOCK;
+    const unsigned char *s = (const unsigned char *) src + start * src_size;
+    unsigned char *d = (unsigned char *) dst + start * dst_size;
+
+    if (overlap || (flags & MINC_SWAP_SRC)) {
+      memcpy(temp, s, count * src_size);
+      if (flags & MINC_SWAP_SRC)
+        minc_swap_bytes(temp, count, src_size);
+      s = (const unsigned char *) temp;
+    }
+
+    convert_block(d, dst_type, s, src_type, count, flags & MINC_ROUND);
+
+    if (flags & MINC_SWAP_DST)
+      minc_swap_bytes(d, count, dst_size);
+  }
+}
@@ -0,0 +1,51 @@
+/*
+ * \file swap_convert.h
+ * \brief Byte swapping and voxel type conversion shared by the readers
+ * and writers.
+ */
+#ifndef MINC_SWAP_CONVERT_H
+#define MINC_SWAP_CONVERT_H
+
+#include <stddef.h>
+
+/** Element types handled by minc_swap_convert().
+ */
+typedef enum {
+  MINC_VALUE_UBYTE,
+  MINC_VALUE_BYTE,
+  MINC_VALUE_USHORT,
+  MINC_VALUE_SHORT,
+  MINC_VALUE_UINT,
+  MINC_VALUE_INT,
+  MINC_VALUE_FLOAT,
+  MINC_VALUE_DOUBLE
+} minc_value_type;
+
+/** Flags for minc_swap_convert().
+ */
+#define MINC_SWAP_SRC 1         /* source is in the other byte order */
+#define MINC_SWAP_DST 2         /* write the destination in the other byte order */
+#define MINC_ROUND    4         /* round, rather than truncate, to integers */
+
+/** Returns non-zero on big-endian machines.
+ */
+int minc_host_big_endian(void);
+
+/** Returns the size in bytes of an element of the given type.
+ */
+size_t minc_value_size(minc_value_type type);
+
+/** Reverses the byte order of n elements of size bytes each, in place.
+ */
+void minc_swap_bytes(void *data, size_t n, size_t size);
+
+/** Converts n elements from src_type to dst_type, swapping the bytes of
+ *  the source and destination as the flags ask.  Conversions to integer
+ *  types are clamped to the range of the type, with invalid floating
+ *  point values converted to zero.  src and dst may be the same buffer.
+ */
+void minc_swap_convert(void *dst, minc_value_type dst_type,
+                       const void *src, minc_value_type src_type,
+                       size_t n, int flags);
+
+#endif /*MINC_SWAP_CONVERT_H*/
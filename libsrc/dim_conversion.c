@@ -14,6 +14,14 @@
                  MI_get_dim_bufsize_step
                  MI_icv_get_dim_conversion
                  MI_icv_dimconvert
+                 MI_icv_free_rows
+                 MI_icv_dimconvert_pixel
+                 MI_icv_convert_row
+                 MI_icv_compress_row
+                 MI_icv_expand_row
+                 MI_get_row_values
+                 MI_put_row_values
+                 MI_reverse_values
                  MI_icv_dimconv_init
 @CREATED    : September 9, 1992. (Peter Neelin)
 @MODIFIED   : 
@@ -94,6 +102,9 @@
 #include <math.h>
 #include <type_limits.h>
 
+/* Eight byte values, copied without interpreting them */
+typedef struct { char bytes[8]; } mi_value8_type;
+
 /* Private functions */
 PRIVATE int MI_icv_get_dim(mi_icv_type *icvp, int cdfid, int varid);
 PRIVATE int MI_get_dim_flip(mi_icv_type *icvp, int cdfid, int dimvid[], 
@@ -104,6 +115,23 @@ PRIVATE int MI_icv_get_dim_conversion(mi_icv_type *icvp, int subsc[]);
 PRIVATE int MI_icv_dimconvert(int operation, mi_icv_type *icvp,
                               long start[], long count[], void *values,
                               long bufstart[], long bufcount[], void *buffer);
+PRIVATE void MI_icv_free_rows(mi_icv_dimconv_type *dcp);
+PRIVATE void MI_icv_dimconvert_pixel(mi_icv_type *icvp,
+                                     mi_icv_dimconv_type *dcp,
+                                     void *iptr, void *optr);
+PRIVATE int MI_icv_convert_row(mi_icv_type *icvp, mi_icv_dimconv_type *dcp,
+                               void *iptr, void *optr);
+PRIVATE int MI_icv_compress_row(mi_icv_type *icvp, mi_icv_dimconv_type *dcp,
+                                void *iptr, void *optr);
+PRIVATE int MI_icv_expand_row(mi_icv_type *icvp, mi_icv_dimconv_type *dcp,
+                              void *iptr, void *optr);
+PRIVATE void MI_get_row_values(nc_type type, int sign, void *ptr, long step,
+                               long nvalues, double values[]);
+PRIVATE void MI_put_row_values(void *ptr, long step, long nvalues,
+                               long pix_num, long pix_off[],
+                               int value_size, void *values, int check,
+                               void *first, void *last);
+PRIVATE void MI_reverse_values(void *values, long nvalues, int value_size);
 PRIVATE int MI_icv_dimconv_init(int operation, mi_icv_type *icvp,
                               mi_icv_dimconv_type *dcp,
                               long start[], long count[], void *values,
@@ -607,11 +635,15 @@ PRIVATE int MI_icv_get_dim_conversion(mi_icv_type *icvp, int subsc[])
 @RETURNS    : MI_ERROR if an error occurs
 @DESCRIPTION: Converts values and dimensions from an input buffer to the 
               user's buffer. Called by MI_var_action.
-@METHOD     : 
+@METHOD     : Works through the rows of the fastest varying dimension,
+              converting each one whole where it can (MI_icv_convert_row,
+              MI_icv_compress_row and MI_icv_expand_row), and a pixel at
+              a time otherwise (MI_icv_dimconvert_pixel).
 @GLOBALS    : 
 @CALLS      : NetCDF routines
 @CREATED    : August 27, 1992 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 19, 2026
+                 - convert whole rows where possible
 ---------------------------------------------------------------------------- */
 PRIVATE int MI_icv_dimconvert(int operation, mi_icv_type *icvp,
                               long start[], long count[], void *values,
@@ -619,20 +651,17 @@ PRIVATE int MI_icv_dimconvert(int operation, mi_icv_type *icvp,
 {
    mi_icv_dimconv_type dim_conv_struct;
    mi_icv_dimconv_type *dcp;
-   double sum0, sum1;           /* Counters for averaging values */
-   double dvalue;               /* Pixel value */
    long counter[MAX_VAR_DIMS];  /* Dimension loop counter */
-   void *ptr, *iptr, *optr;     /* Pointers for looping through fastest dim */
+   void *iptr, *optr;           /* Pointers to the first pixel of a row */
    void *ivecptr[MAX_VAR_DIMS]; /* Pointers to start of each dimension */
    void *ovecptr[MAX_VAR_DIMS];
    long *end;                   /* Pointer to array of dimension ends */
    int fastdim;                 /* Dimension that varies fastest */
-   long ipix;                   /* Buffer subscript */
+   long ipix;                   /* Pixel subscript in a row */
    int idim;                    /* Dimension subscript */
    int notmodified;             /* First dimension not reset */
-   int out_of_range;            /* Flag indicating one pixel of sum out of 
-                                   range */
-   double dmin, dmax, epsilon;  /* Range limits */
+   int done;                    /* Row converted whole */
+   double epsilon;              /* Epsilon for range limits */
 
    MI_SAVE_ROUTINE_NAME("MI_icv_dimconvert");
 
@@ -646,12 +675,30 @@ PRIVATE int MI_icv_dimconvert(int operation, mi_icv_type *icvp,
    optr    = dcp->ostart;
    end     = dcp->end;
    fastdim = icvp->derv_dimconv_fastdim;
-   dmax = icvp->fill_valid_max;
-   dmin = icvp->fill_valid_min;
-   epsilon = (dmax - dmin) * FILLVALUE_EPSILON;
+   dcp->dmax = icvp->fill_valid_max;
+   dcp->dmin = icvp->fill_valid_min;
+   epsilon = (dcp->dmax - dcp->dmin) * FILLVALUE_EPSILON;
    epsilon = fabs(epsilon);
-   dmax += epsilon;
-   dmin -= epsilon;
+   dcp->dmax += epsilon;
+   dcp->dmin -= epsilon;
+
+   /* Get buffers for compressing or expanding whole rows. Without them,
+      rows are done a pixel at a time. */
+   dcp->row_num = end[fastdim];
+   dcp->row_sum = NULL;
+   dcp->row_value = NULL;
+   dcp->row_count = NULL;
+   dcp->row_outside = NULL;
+   if ((dcp->do_compress || dcp->do_expand) && (dcp->row_num > 0)) {
+      dcp->row_sum = MALLOC(dcp->row_num, double);
+      dcp->row_value = MALLOC(dcp->row_num, double);
+      dcp->row_count = MALLOC(dcp->row_num, long);
+      dcp->row_outside = MALLOC(dcp->row_num, char);
+      if ((dcp->row_sum == NULL) || (dcp->row_value == NULL) ||
+          (dcp->row_count == NULL) || (dcp->row_outside == NULL)) {
+         MI_icv_free_rows(dcp);
+      }
+   }
 
    /* Initialize counters */
    for (idim=0; idim<=fastdim; idim++) {
@@ -660,117 +707,565 @@ PRIVATE int MI_icv_dimconvert(int operation, mi_icv_type *icvp,
       ovecptr[idim] = optr;
    }
 
-   /* Loop through data */
-
+   /* Loop through rows */
    while (counter[0] < end[0]) {
 
-      /* Compress data by averaging if needed */
-      if (!dcp->do_compress) {
-         {MI_TO_DOUBLE(dvalue, dcp->intype, dcp->insign, iptr)}
-         out_of_range = (icvp->do_fillvalue && 
-                         ((dvalue < dmin) || (dvalue > dmax)));
+      /* Convert the row whole if possible */
+      if (!dcp->do_compress && !dcp->do_expand)
+         done = MI_icv_convert_row(icvp, dcp, iptr, optr);
+      else if (dcp->do_compress && !dcp->do_expand)
+         done = MI_icv_compress_row(icvp, dcp, iptr, optr);
+      else if (!dcp->do_compress && dcp->do_expand)
+         done = MI_icv_expand_row(icvp, dcp, iptr, optr);
+      else
+         done = FALSE;
+
+      /* Otherwise, a pixel at a time */
+      if (!done) {
+         for (ipix=0; ipix<end[fastdim]; ipix++) {
+            MI_icv_dimconvert_pixel(icvp, dcp,
+               (void *) ((char *) iptr + ipix * dcp->istep[fastdim]),
+               (void *) ((char *) optr + ipix * dcp->ostep[fastdim]));
+         }
       }
-      else {
-         sum1 = 0.0;
-         sum0 = 0.0;
-         out_of_range=FALSE;
-         for (ipix=0; ipix<dcp->in_pix_num; ipix++) {
-            ptr=(void *) ((char *)iptr + dcp->in_pix_off[ipix]);
-
-            /* Check if we are outside the buffer.
-               If we are looking before the buffer, then we need to
-               add in the previous result to do averaging properly. If
-               we are looking after the buffer, then break. */
-            if (ptr<dcp->in_pix_first) {
-               /* Get the output value and re-scale it */
-               {MI_TO_DOUBLE(dvalue, dcp->outtype, dcp->outsign, optr)}
-               if (icvp->do_scale) {
-                  dvalue = ((icvp->scale==0.0) ?
-                            0.0 : (dvalue - icvp->offset) / icvp->scale);
-               }
-            }
-            else if (ptr>dcp->in_pix_last) {
-               continue;
-            }
-            else {
-               {MI_TO_DOUBLE(dvalue, dcp->intype, dcp->insign, ptr)}
+
+      /* At the end of fastdim, reset the counter and increment the next 
+         dimension down - keep going as needed. The vectors ovecptr and 
+         ivecptr give the starting values of optr and iptr for that
+         dimension. */
+      counter[fastdim] = end[fastdim];
+      idim = fastdim;
+      while ((idim>0) && (counter[idim] >= end[idim])) {
+         counter[idim] = 0;
+         idim--;
+         counter[idim]++;
+         ovecptr[idim] = (void *)((char *)ovecptr[idim]+dcp->ostep[idim]);
+         ivecptr[idim] = (void *)((char *)ivecptr[idim]+dcp->istep[idim]);
+      }
+      notmodified = idim;
+
+      /* Copy the starting index up the vector */
+      for (idim=notmodified+1; idim<=fastdim; idim++) {
+         ovecptr[idim]=ovecptr[notmodified];
+         ivecptr[idim]=ivecptr[notmodified];
+      }
+
+      optr = ovecptr[fastdim];
+      iptr = ivecptr[fastdim];
+
+   }      /* while more rows to process */
+
+   MI_icv_free_rows(dcp);
+
+   MI_RETURN(MI_NOERROR);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_icv_free_rows
+@INPUT      : dcp        - dimconvert structure pointer
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Frees the buffers used for compressing or expanding whole
+              rows in MI_icv_dimconvert.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void MI_icv_free_rows(mi_icv_dimconv_type *dcp)
+{
+   if (dcp->row_sum != NULL) FREE(dcp->row_sum);
+   if (dcp->row_value != NULL) FREE(dcp->row_value);
+   if (dcp->row_count != NULL) FREE(dcp->row_count);
+   if (dcp->row_outside != NULL) FREE(dcp->row_outside);
+   dcp->row_sum = NULL;
+   dcp->row_value = NULL;
+   dcp->row_count = NULL;
+   dcp->row_outside = NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_icv_dimconvert_pixel
+@INPUT      : icvp       - icv structure pointer
+              dcp        - dimconvert structure pointer
+              iptr       - pointer to the input pixel
+              optr       - pointer to the output pixel
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Converts one pixel for MI_icv_dimconvert, averaging the
+              input pixels that it compresses and writing each output
+              pixel that it expands to.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : August 27, 1992 (Peter Neelin), as part of MI_icv_dimconvert
+@MODIFIED   : October 19, 2026
+                 - moved out of MI_icv_dimconvert
+---------------------------------------------------------------------------- */
+PRIVATE void MI_icv_dimconvert_pixel(mi_icv_type *icvp,
+                                     mi_icv_dimconv_type *dcp,
+                                     void *iptr, void *optr)
+{
+   double sum0, sum1;           /* Counters for averaging values */
+   double dvalue;               /* Pixel value */
+   void *ptr;                   /* Pointer to compressed/expanded pixel */
+   long ipix;                   /* Buffer subscript */
+   int out_of_range;            /* Flag indicating one pixel of sum out of 
+                                   range */
+   double dmin, dmax;           /* Range limits */
+
+   dmin = dcp->dmin;
+   dmax = dcp->dmax;
+
+   /* Compress data by averaging if needed */
+   if (!dcp->do_compress) {
+      {MI_TO_DOUBLE(dvalue, dcp->intype, dcp->insign, iptr)}
+      out_of_range = (icvp->do_fillvalue && 
+                      ((dvalue < dmin) || (dvalue > dmax)));
+   }
+   else {
+      sum1 = 0.0;
+      sum0 = 0.0;
+      out_of_range=FALSE;
+      for (ipix=0; ipix<dcp->in_pix_num; ipix++) {
+         ptr=(void *) ((char *)iptr + dcp->in_pix_off[ipix]);
+
+         /* Check if we are outside the buffer.
+            If we are looking before the buffer, then we need to
+            add in the previous result to do averaging properly. If
+            we are looking after the buffer, then break. */
+         if (ptr<dcp->in_pix_first) {
+            /* Get the output value and re-scale it */
+            {MI_TO_DOUBLE(dvalue, dcp->outtype, dcp->outsign, optr)}
+            if (icvp->do_scale) {
+               dvalue = ((icvp->scale==0.0) ?
+                         0.0 : (dvalue - icvp->offset) / icvp->scale);
             }
+         }
+         else if (ptr>dcp->in_pix_last) {
+            continue;
+         }
+         else {
+            {MI_TO_DOUBLE(dvalue, dcp->intype, dcp->insign, ptr)}
+         }
 
-            /* Add in the value, checking for range if needed */
-            if (icvp->do_fillvalue && ((dvalue < dmin) || (dvalue > dmax))) {
-               out_of_range = TRUE;
+         /* Add in the value, checking for range if needed */
+         if (icvp->do_fillvalue && ((dvalue < dmin) || (dvalue > dmax))) {
+            out_of_range = TRUE;
+         }
+         else {
+            sum1 += dvalue;
+            sum0++;
+         }
+      }         /* Foreach pixel to compress */
+
+      /* Average values */
+      if (sum0!=0.0)
+         dvalue = sum1/sum0;
+      else
+         dvalue = 0.0;
+   }           /* If compress */
+
+   /* Check for out of range values and scale result */
+   if (out_of_range) {
+      dvalue = icvp->user_fillvalue;
+   }
+   else if (icvp->do_scale) {
+      dvalue = icvp->scale * dvalue + icvp->offset;
+   }
+
+   /* Expand data if needed */
+   if (!dcp->do_expand) {
+      {MI_FROM_DOUBLE(dvalue, dcp->outtype, dcp->outsign, optr)}
+   }
+   else {
+      for (ipix=0; ipix<dcp->out_pix_num; ipix++) {
+         ptr=(void *) ((char *)optr + dcp->out_pix_off[ipix]);
+
+         /* Check if we are outside the buffer. */
+         if ((ptr>=dcp->out_pix_first) && (ptr<=dcp->out_pix_last)) {
+            {MI_FROM_DOUBLE(dvalue, dcp->outtype, dcp->outsign, ptr)}
+         }
+
+      }         /* Foreach pixel to expand */
+   }         /* if expand */
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_icv_convert_row
+@INPUT      : icvp       - icv structure pointer
+              dcp        - dimconvert structure pointer
+              iptr       - pointer to the first input pixel of the row
+              optr       - pointer to the first output pixel of the row
+@OUTPUT     : (none)
+@RETURNS    : TRUE if the row was converted, FALSE if it must be done a
+              pixel at a time
+@DESCRIPTION: Converts a row for MI_icv_dimconvert when there is no
+              compression or expansion. The values of the row are next to
+              each other in both buffers, so the row is converted in one
+              call to MI_convert_type, and reversed afterwards if it is
+              flipped.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : MI_convert_type
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int MI_icv_convert_row(mi_icv_type *icvp, mi_icv_dimconv_type *dcp,
+                               void *iptr, void *optr)
+{
+   int fastdim = icvp->derv_dimconv_fastdim;
+   long nvalues = dcp->row_num;
+   long istep = dcp->istep[fastdim];
+   long ostep = dcp->ostep[fastdim];
+   int inlen = nctypelen(dcp->intype);
+   int outlen = nctypelen(dcp->outtype);
+
+   if ((dcp->intype == NC_CHAR) || (dcp->outtype == NC_CHAR) ||
+       (labs(istep) != inlen) || (labs(ostep) != outlen))
+      return FALSE;
+
+   /* A row with a negative step ends at its first value */
+   if (istep < 0)
+      iptr = (void *) ((char *) iptr - (nvalues - 1) * inlen);
+   if (ostep < 0)
+      optr = (void *) ((char *) optr - (nvalues - 1) * outlen);
+
+   if (MI_convert_type(nvalues, dcp->intype, dcp->insign, iptr,
+                       dcp->outtype, dcp->outsign, optr, icvp) < 0)
+      return FALSE;
+   if ((istep < 0) != (ostep < 0))
+      MI_reverse_values(optr, nvalues, outlen);
+
+   return TRUE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_icv_compress_row
+@INPUT      : icvp       - icv structure pointer
+              dcp        - dimconvert structure pointer
+              iptr       - pointer to the first input pixel of the row
+              optr       - pointer to the first output pixel of the row
+@OUTPUT     : (none)
+@RETURNS    : TRUE if the row was converted, FALSE if it must be done a
+              pixel at a time
+@DESCRIPTION: Compresses a row for MI_icv_dimconvert. Each pixel of the
+              boxes being averaged is gathered for the whole row in turn
+              and added into the sums for the row, in the same order as
+              MI_icv_dimconvert_pixel adds them, so the averages come out
+              the same. Only rows whose boxes lie entirely within the
+              input buffer are done this way.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : MI_convert_type
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int MI_icv_compress_row(mi_icv_type *icvp, mi_icv_dimconv_type *dcp,
+                                void *iptr, void *optr)
+{
+   int fastdim = icvp->derv_dimconv_fastdim;
+   long nvalues = dcp->row_num;
+   long istep = dcp->istep[fastdim];
+   long ostep = dcp->ostep[fastdim];
+   int outlen = nctypelen(dcp->outtype);
+   double *sum = dcp->row_sum;
+   double *value = dcp->row_value;
+   long *count = dcp->row_count;
+   char *outside = dcp->row_outside;
+   char *first, *last;
+   double dmin = dcp->dmin;
+   double dmax = dcp->dmax;
+   double dvalue;
+   long ipix, i;
+
+   if ((sum == NULL) || (dcp->outtype == NC_CHAR) || (labs(ostep) != outlen))
+      return FALSE;
+
+   /* Check that every pixel of every box is in the buffer */
+   first = (char *) iptr + MIN(0, (nvalues - 1) * istep);
+   last  = (char *) iptr + MAX(0, (nvalues - 1) * istep);
+   for (ipix=0; ipix<dcp->in_pix_num; ipix++) {
+      if (((void *) (first + dcp->in_pix_off[ipix]) < dcp->in_pix_first) ||
+          ((void *) (last + dcp->in_pix_off[ipix]) > dcp->in_pix_last))
+         return FALSE;
+   }
+
+   /* Add up the pixels of each box */
+   for (i=0; i<nvalues; i++) {
+      sum[i] = 0.0;
+      count[i] = 0;
+      outside[i] = FALSE;
+   }
+   for (ipix=0; ipix<dcp->in_pix_num; ipix++) {
+      MI_get_row_values(dcp->intype, dcp->insign,
+                        (char *) iptr + dcp->in_pix_off[ipix], istep,
+                        nvalues, value);
+      if (icvp->do_fillvalue) {
+         for (i=0; i<nvalues; i++) {
+            dvalue = value[i];
+            if ((dvalue < dmin) || (dvalue > dmax)) {
+               outside[i] = TRUE;
             }
             else {
-               sum1 += dvalue;
-               sum0++;
+               sum[i] += dvalue;
+               count[i]++;
             }
-         }         /* Foreach pixel to compress */
-
-         /* Average values */
-         if (sum0!=0.0)
-            dvalue = sum1/sum0;
-         else
-            dvalue = 0.0;
-      }           /* If compress */
+         }
+      }
+      else {
+         for (i=0; i<nvalues; i++)
+            sum[i] += value[i];
+      }
+   }
 
-      /* Check for out of range values and scale result */
-      if (out_of_range) {
+   /* Average values, and check for out of range values and scale */
+   for (i=0; i<nvalues; i++) {
+      if (!icvp->do_fillvalue)
+         count[i] = dcp->in_pix_num;
+      dvalue = (count[i] != 0) ? sum[i] / (double) count[i] : 0.0;
+      if (outside[i])
          dvalue = icvp->user_fillvalue;
-      }
-      else if (icvp->do_scale) {
+      else if (icvp->do_scale)
          dvalue = icvp->scale * dvalue + icvp->offset;
-      }
+      value[i] = dvalue;
+   }
 
-      /* Expand data if needed */
-      if (!dcp->do_expand) {
-         {MI_FROM_DOUBLE(dvalue, dcp->outtype, dcp->outsign, optr)}
-      }
-      else {
-         for (ipix=0; ipix<dcp->out_pix_num; ipix++) {
-            ptr=(void *) ((char *)optr + dcp->out_pix_off[ipix]);
+   /* Store the row */
+   if (ostep < 0)
+      optr = (void *) ((char *) optr - (nvalues - 1) * outlen);
+   if (MI_convert_type(nvalues, NC_DOUBLE, MI_PRIV_SIGNED, value,
+                       dcp->outtype, dcp->outsign, optr, NULL) < 0)
+      return FALSE;
+   if (ostep < 0)
+      MI_reverse_values(optr, nvalues, outlen);
 
-            /* Check if we are outside the buffer. */
-            if ((ptr>=dcp->out_pix_first) && (ptr<=dcp->out_pix_last)) {
-               {MI_FROM_DOUBLE(dvalue, dcp->outtype, dcp->outsign, ptr)}
-            }
+   return TRUE;
+}
 
-         }         /* Foreach pixel to expand */
-      }         /* if expand */
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_icv_expand_row
+@INPUT      : icvp       - icv structure pointer
+              dcp        - dimconvert structure pointer
+              iptr       - pointer to the first input pixel of the row
+              optr       - pointer to the first output pixel of the row
+@OUTPUT     : (none)
+@RETURNS    : TRUE if the row was converted, FALSE if it must be done a
+              pixel at a time
+@DESCRIPTION: Expands a row for MI_icv_dimconvert. The row is converted
+              once, and then copied to the pixels of the boxes that it
+              expands to.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : MI_convert_type
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int MI_icv_expand_row(mi_icv_type *icvp, mi_icv_dimconv_type *dcp,
+                              void *iptr, void *optr)
+{
+   int fastdim = icvp->derv_dimconv_fastdim;
+   long nvalues = dcp->row_num;
+   long istep = dcp->istep[fastdim];
+   long ostep = dcp->ostep[fastdim];
+   int inlen = nctypelen(dcp->intype);
+   int outlen = nctypelen(dcp->outtype);
+   void *value = (void *) dcp->row_value;
+   char *first, *last, *ptr;
+   long ipix;
 
-      /* Increment the counter and the pointers */
-      if ((++counter[fastdim]) < end[fastdim]) {
-         optr = (void *) ((char *) optr + dcp->ostep[fastdim]);
-         iptr = (void *) ((char *) iptr + dcp->istep[fastdim]);
-      }
-      else {
-         /* If we reach the end of fastdim, then reset the counter and
-            increment the next dimension down - keep going as needed.
-            The vectors ovecptr and ivecptr give the starting values of optr 
-            and iptr for that dimension. */
-         idim = fastdim;
-         while ((idim>0) && (counter[idim] >= end[idim])) {
-            counter[idim] = 0;
-            idim--;
-            counter[idim]++;
-            ovecptr[idim] = (void *)((char *)ovecptr[idim]+dcp->ostep[idim]);
-            ivecptr[idim] = (void *)((char *)ivecptr[idim]+dcp->istep[idim]);
-         }
-         notmodified = idim;
+   if ((value == NULL) || (dcp->intype == NC_CHAR) ||
+       (dcp->outtype == NC_CHAR) || (labs(istep) != inlen))
+      return FALSE;
+
+   /* Convert the row, in the order of the output */
+   if (istep < 0)
+      iptr = (void *) ((char *) iptr - (nvalues - 1) * inlen);
+   if (MI_convert_type(nvalues, dcp->intype, dcp->insign, iptr,
+                       dcp->outtype, dcp->outsign, value, icvp) < 0)
+      return FALSE;
+   if (istep < 0)
+      MI_reverse_values(value, nvalues, outlen);
+
+   /* Copy it to each pixel of the boxes, checking against the ends of
+      the buffer only if the boxes reach them */
+   first = last = (char *) optr;
+   for (ipix=0; ipix<dcp->out_pix_num; ipix++) {
+      ptr = (char *) optr + dcp->out_pix_off[ipix];
+      first = MIN(first, ptr + MIN(0, (nvalues - 1) * ostep));
+      last  = MAX(last,  ptr + MAX(0, (nvalues - 1) * ostep));
+   }
+   MI_put_row_values(optr, ostep, nvalues, dcp->out_pix_num,
+                     dcp->out_pix_off, outlen, value,
+                     ((void *) first < dcp->out_pix_first) ||
+                     ((void *) last > dcp->out_pix_last),
+                     dcp->out_pix_first, dcp->out_pix_last);
 
-         /* Copy the starting index up the vector */
-         for (idim=notmodified+1; idim<=fastdim; idim++) {
-            ovecptr[idim]=ovecptr[notmodified];
-            ivecptr[idim]=ivecptr[notmodified];
-         }
+   return TRUE;
+}
 
-         optr = ovecptr[fastdim];
-         iptr = ivecptr[fastdim];
-      }      /* if at end of row */
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_get_row_values
+@INPUT      : type       - type of values
+              sign       - sign of values
+              ptr        - pointer to the first value
+              step       - step between values in bytes
+              nvalues    - number of values
+@OUTPUT     : values     - the values as doubles
+@RETURNS    : (nothing)
+@DESCRIPTION: Gets a row of values that are a fixed step apart.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+#define MI_GET_ROW_LOOP(type) \
+   for (i=0; i<nvalues; i++) \
+      values[i] = (double) *((type *) ((char *) ptr + i * step));
 
-   }      /* while more pixels to process */
+PRIVATE void MI_get_row_values(nc_type type, int sign, void *ptr, long step,
+                               long nvalues, double values[])
+{
+   long i;
 
+   switch (type) {
+   case NC_BYTE :
+   case NC_CHAR :
+      if (sign == MI_PRIV_UNSIGNED)
+         MI_GET_ROW_LOOP(unsigned char)
+      else
+         MI_GET_ROW_LOOP(signed char)
+      break;
+   case NC_SHORT :
+      if (sign == MI_PRIV_UNSIGNED)
+         MI_GET_ROW_LOOP(unsigned short)
+      else
+         MI_GET_ROW_LOOP(signed short)
+      break;
+   case NC_INT :
+      if (sign == MI_PRIV_UNSIGNED)
+         MI_GET_ROW_LOOP(unsigned int)
+      else
+         MI_GET_ROW_LOOP(signed int)
+      break;
+   case NC_FLOAT :
+      MI_GET_ROW_LOOP(float)
+      break;
+   case NC_DOUBLE :
+      MI_GET_ROW_LOOP(double)
+      break;
+   default :
+      for (i=0; i<nvalues; i++)
+         values[i] = 0.0;
+      break;
+   }
+}
 
-   MI_RETURN(MI_NOERROR);
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_put_row_values
+@INPUT      : ptr        - pointer to the first box
+              step       - step between boxes in bytes
+              nvalues    - number of values (and boxes)
+              pix_num    - number of pixels in each box
+              pix_off    - offsets of the pixels from the start of a box
+              value_size - size of each value in bytes
+              values     - the values, next to each other
+              check      - TRUE if pixels outside of first to last
+                 should be skipped
+              first, last - first and last byte of the buffer
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Copies each of a row of values to every pixel of its box.
+@METHOD     : Boxes are done in order, as MI_icv_dimconvert_pixel does
+              them, since at the edges of the buffer the pixels of one
+              box can land on those of another.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+#define MI_PUT_ROW_LOOP(type) \
+   { \
+      type *in = (type *) values; \
+      char *box, *out; \
+      for (i=0; i<nvalues; i++) { \
+         box = (char *) ptr + i * step; \
+         for (ipix=0; ipix<pix_num; ipix++) { \
+            out = box + pix_off[ipix]; \
+            if (!check || (((void *) out >= first) && \
+                           ((void *) out <= last))) \
+               *((type *) out) = in[i]; \
+         } \
+      } \
+   }
+
+PRIVATE void MI_put_row_values(void *ptr, long step, long nvalues,
+                               long pix_num, long pix_off[],
+                               int value_size, void *values, int check,
+                               void *first, void *last)
+{
+   long i, ipix;
+
+   switch (value_size) {
+   case 1 :
+      MI_PUT_ROW_LOOP(unsigned char)
+      break;
+   case 2 :
+      MI_PUT_ROW_LOOP(unsigned short)
+      break;
+   case 4 :
+      MI_PUT_ROW_LOOP(unsigned int)
+      break;
+   case 8 :
+      MI_PUT_ROW_LOOP(mi_value8_type)
+      break;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_reverse_values
+@INPUT      : values     - pointer to values
+              nvalues    - number of values
+              value_size - size of each value in bytes
+@OUTPUT     : values     - values in the opposite order
+@RETURNS    : (nothing)
+@DESCRIPTION: Reverses the order of a vector of values in place.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+#define MI_REVERSE_LOOP(type) \
+   { \
+      type *lo = (type *) values; \
+      type *hi = lo + nvalues - 1; \
+      type temp; \
+      for (; lo < hi; lo++, hi--) { \
+         temp = *lo; \
+         *lo = *hi; \
+         *hi = temp; \
+      } \
+   }
+
+PRIVATE void MI_reverse_values(void *values, long nvalues, int value_size)
+{
+   switch (value_size) {
+   case 1 :
+      MI_REVERSE_LOOP(unsigned char)
+      break;
+   case 2 :
+      MI_REVERSE_LOOP(unsigned short)
+      break;
+   case 4 :
+      MI_REVERSE_LOOP(unsigned int)
+      break;
+   case 8 :
+      MI_REVERSE_LOOP(mi_value8_type)
+      break;
+   }
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -1469,15 +1469,15 @@ PRIVATE int MI_icv_access(int operation, mi_icv_type *icvp, long start[],
 @GLOBALS    : 
 @CALLS      : NetCDF routines
 @CREATED    : September 9, 1992 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 19, 2026
+                 - fill with block copies rather than a byte at a time
 ---------------------------------------------------------------------------- */
 PRIVATE int MI_icv_zero_buffer(mi_icv_type *icvp, long count[], void *values)
 {
    double zeroval, zerobuf;
    void *zerostart;
    int zerolen, idim, ndims;
-   char *bufptr, *bufend, *zeroptr, *zeroend;
-   long buflen;
+   long buflen, filled, copylen;
 
    MI_SAVE_ROUTINE_NAME("MI_icv_zero_buffer");
 
@@ -1498,14 +1498,15 @@ PRIVATE int MI_icv_zero_buffer(mi_icv_type *icvp, long count[], void *values)
    for (idim=0; idim<ndims; idim++)
       buflen *= count[idim];
 
-   /* Loop through the buffer, copying the zero pixel */
-   bufend = (char *) values + buflen;
-   zeroend = (char *) zerostart + zerolen;
-   for (bufptr = (char *) values, zeroptr = (char *) zerostart;
-        bufptr < bufend; bufptr++, zeroptr++) {
-      if (zeroptr >= zeroend)
-         zeroptr = (char *) zerostart;
-      *bufptr = *zeroptr;
+   /* Copy the zero pixel to the start of the buffer, then fill the rest
+      by copying what is already filled, doubling it each time */
+   if (buflen <= 0) {
+      MI_RETURN(MI_NOERROR);
+   }
+   (void) memcpy(values, zerostart, (size_t) zerolen);
+   for (filled = zerolen; filled < buflen; filled += copylen) {
+      copylen = MIN(filled, buflen - filled);
+      (void) memcpy((char *) values + filled, values, (size_t) copylen);
    }
 
    MI_RETURN(MI_NOERROR);
@@ -201,6 +201,12 @@ typedef struct {
    long usr_step[MAX_VAR_DIMS];
    long *istep, *ostep;
    void *istart, *ostart;       /* Beginning of buffers */
+   double dmin, dmax;           /* Range of legal values, with epsilon */
+   long row_num;                /* Pixels in a row of the fastest dim */
+   double *row_sum;             /* Buffers for converting whole rows */
+   double *row_value;
+   long *row_count;
+   char *row_outside;
 } mi_icv_dimconv_type;
 
 #endif
@@ -11,6 +11,7 @@
               private :
                  MI_get_sign
                  MI_var_action
+                 MI_convert_values
 @CREATED    : July 27, 1992. (Peter Neelin, Montreal Neurological Institute)
 @MODIFIED   : 
  * $Log: value_conversion.c,v $
@@ -103,6 +104,12 @@
 PRIVATE int MI_var_action(int ndims, long var_start[], long var_count[], 
                           long nvalues, void *var_buffer, void *caller_data);
 PRIVATE int MI_get_sign(nc_type datatype, int sign);
+PRIVATE void MI_convert_values(long number_of_values,
+                               nc_type intype, int insgn, void *invalues,
+                               nc_type outtype, int outsgn, void *outvalues,
+                               int do_scale, double scale, double offset,
+                               int do_fillvalue, double dmin, double dmax,
+                               double fillvalue);
 
 
 
@@ -563,6 +570,8 @@ PRIVATE int MI_get_sign(nc_type datatype, int sign)
 @CREATED    : July 27, 1992 (Peter Neelin)
 @MODIFIED   : August 28, 1992 (P.N.)
                  - replaced type conversions with macros
+              October 19, 2026
+                 - conversion done by MI_convert_values
 ---------------------------------------------------------------------------- */
 SEMIPRIVATE int MI_convert_type(long number_of_values,
                                 nc_type intype,  int insign,  void *invalues,
@@ -571,9 +580,6 @@ SEMIPRIVATE int MI_convert_type(long number_of_values,
 {
    int inincr, outincr;    /* Pointer increments for arrays */
    int insgn, outsgn;      /* Signs for input and output */
-   long i;
-   double dvalue=0.0;      /* Temporary double for conversion */
-   void *inptr, *outptr;   /* Pointers to input and output values */
    int do_scale;           /* Should scaling be done? */
    int do_fillvalue;       /* Should fillvalue checking be done? */
    double fillvalue;       /* Value to fill with */
@@ -622,35 +628,177 @@ SEMIPRIVATE int MI_convert_type(long number_of_values,
                        (size_t) number_of_values*inincr);
    }
    
-   /* Otherwise, loop through */
+   /* Otherwise, convert with the loop for this pair of types */
    else {
+      MI_convert_values(number_of_values,
+                        intype, insgn, invalues, outtype, outsgn, outvalues,
+                        do_scale, (do_scale ? icvp->scale : 0.0),
+                        (do_scale ? icvp->offset : 0.0),
+                        do_fillvalue, dmin, dmax, fillvalue);
+   }
 
-      /* Step through values  */
-      inptr=invalues; 
-      outptr=outvalues;
-      for (i=0 ; i<number_of_values; i++) { 
-
-         /* Convert the input value */
-         {MI_TO_DOUBLE(dvalue, intype, insgn, inptr)}
-
-         /* Check the value for range and scale the value if necessary */
-         if (do_fillvalue && ((dvalue < dmin) || (dvalue > dmax))) {
-            dvalue = fillvalue;
-         }
-         else if (do_scale) {
-            dvalue = icvp->scale * dvalue + icvp->offset;
-         }
-
-         /* Truncate if necessary and assign the value */
-         {MI_FROM_DOUBLE(dvalue, outtype, outsgn, outptr)}
-
-         inptr  = (void *) ((char *)inptr  + inincr);
-         outptr = (void *) ((char *)outptr + outincr);
+   MI_RETURN(MI_NOERROR);
+   
+}
 
-      }           /* End of for loop */
+/* Loops for MI_convert_values, one for each pair of types and each
+   combination of scaling and range checking, so that nothing but the
+   conversion itself is left inside them and the compiler can vectorize
+   them. Each value is converted exactly as MI_TO_DOUBLE, the scaling of
+   MI_convert_type and MI_FROM_DOUBLE would convert it. */
+
+#define MI_STORE_INT(out, dvalue, type, lo, hi) \
+   dvalue = MAX(lo, dvalue); \
+   dvalue = MIN(hi, dvalue); \
+   out = (type) ROUND(dvalue);
+
+#define MI_STORE_UCHAR(out, dvalue) \
+   MI_STORE_INT(out, dvalue, unsigned char, 0, UCHAR_MAX)
+#define MI_STORE_SCHAR(out, dvalue) \
+   MI_STORE_INT(out, dvalue, signed char, SCHAR_MIN, SCHAR_MAX)
+#define MI_STORE_USHORT(out, dvalue) \
+   MI_STORE_INT(out, dvalue, unsigned short, 0, USHRT_MAX)
+#define MI_STORE_SHORT(out, dvalue) \
+   MI_STORE_INT(out, dvalue, signed short, SHRT_MIN, SHRT_MAX)
+#define MI_STORE_UINT(out, dvalue) \
+   MI_STORE_INT(out, dvalue, unsigned int, 0, UINT_MAX)
+#define MI_STORE_SINT(out, dvalue) \
+   MI_STORE_INT(out, dvalue, signed int, INT_MIN, INT_MAX)
+#define MI_STORE_FLOAT(out, dvalue) \
+   dvalue = MAX(-FLT_MAX, dvalue); \
+   out = MIN(FLT_MAX, dvalue);
+#define MI_STORE_DOUBLE(out, dvalue) \
+   out = dvalue;
+
+#define MI_CONVERT_LOOP(intype, outtype, STORE) \
+   { \
+      intype *in = (intype *) invalues; \
+      outtype *out = (outtype *) outvalues; \
+      if (!do_fillvalue && !do_scale) { \
+         for (i=0; i<number_of_values; i++) { \
+            dvalue = (double) in[i]; \
+            STORE(out[i], dvalue) \
+         } \
+      } \
+      else if (!do_fillvalue) { \
+         for (i=0; i<number_of_values; i++) { \
+            dvalue = scale * (double) in[i] + offset; \
+            STORE(out[i], dvalue) \
+         } \
+      } \
+      else if (!do_scale) { \
+         for (i=0; i<number_of_values; i++) { \
+            dvalue = (double) in[i]; \
+            dvalue = ((dvalue < dmin) || (dvalue > dmax)) ? \
+               fillvalue : dvalue; \
+            STORE(out[i], dvalue) \
+         } \
+      } \
+      else { \
+         for (i=0; i<number_of_values; i++) { \
+            dvalue = (double) in[i]; \
+            dvalue = ((dvalue < dmin) || (dvalue > dmax)) ? \
+               fillvalue : scale * dvalue + offset; \
+            STORE(out[i], dvalue) \
+         } \
+      } \
+   }
 
-   }              /* End of else */
+#define MI_CONVERT_FROM(outtype, STORE) \
+   switch (intype) { \
+   case NC_BYTE : \
+   case NC_CHAR : \
+      if (insgn == MI_PRIV_UNSIGNED) \
+         MI_CONVERT_LOOP(unsigned char, outtype, STORE) \
+      else \
+         MI_CONVERT_LOOP(signed char, outtype, STORE) \
+      break; \
+   case NC_SHORT : \
+      if (insgn == MI_PRIV_UNSIGNED) \
+         MI_CONVERT_LOOP(unsigned short, outtype, STORE) \
+      else \
+         MI_CONVERT_LOOP(signed short, outtype, STORE) \
+      break; \
+   case NC_INT : \
+      if (insgn == MI_PRIV_UNSIGNED) \
+         MI_CONVERT_LOOP(unsigned int, outtype, STORE) \
+      else \
+         MI_CONVERT_LOOP(signed int, outtype, STORE) \
+      break; \
+   case NC_FLOAT : \
+      MI_CONVERT_LOOP(float, outtype, STORE) \
+      break; \
+   case NC_DOUBLE : \
+      MI_CONVERT_LOOP(double, outtype, STORE) \
+      break; \
+   default : \
+      break; \
+   }
 
-   MI_RETURN(MI_NOERROR);
-   
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : MI_convert_values
+@INPUT      : number_of_values  - number of values to convert
+              intype            - type of input values
+              insgn             - sign of input values (MI_PRIV_SIGNED or
+                 MI_PRIV_UNSIGNED)
+              invalues          - vector of values
+              outtype           - type of output values
+              outsgn            - sign of output values
+              do_scale          - boolean indicating whether scaling
+                 should be done
+              scale, offset     - the scaling, if any
+              do_fillvalue      - boolean indicating whether values outside
+                 of dmin to dmax should be set to fillvalue
+              dmin, dmax        - range of legal values
+              fillvalue         - value for values out of range
+@OUTPUT     : outvalues         - output values
+@RETURNS    : (nothing)
+@DESCRIPTION: Does the work of MI_convert_type when values must be
+              converted, with a separate loop for each pair of types,
+              rather than switching on the types for every value.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void MI_convert_values(long number_of_values,
+                               nc_type intype, int insgn, void *invalues,
+                               nc_type outtype, int outsgn, void *outvalues,
+                               int do_scale, double scale, double offset,
+                               int do_fillvalue, double dmin, double dmax,
+                               double fillvalue)
+{
+   long i;
+   double dvalue;
+
+   switch (outtype) {
+   case NC_BYTE :
+   case NC_CHAR :
+      if (outsgn == MI_PRIV_UNSIGNED)
+         {MI_CONVERT_FROM(unsigned char, MI_STORE_UCHAR)}
+      else
+         {MI_CONVERT_FROM(signed char, MI_STORE_SCHAR)}
+      break;
+   case NC_SHORT :
+      if (outsgn == MI_PRIV_UNSIGNED)
+         {MI_CONVERT_FROM(unsigned short, MI_STORE_USHORT)}
+      else
+         {MI_CONVERT_FROM(signed short, MI_STORE_SHORT)}
+      break;
+   case NC_INT :
+      if (outsgn == MI_PRIV_UNSIGNED)
+         {MI_CONVERT_FROM(unsigned int, MI_STORE_UINT)}
+      else
+         {MI_CONVERT_FROM(signed int, MI_STORE_SINT)}
+      break;
+   case NC_FLOAT :
+      {MI_CONVERT_FROM(float, MI_STORE_FLOAT)}
+      break;
+   case NC_DOUBLE :
+      {MI_CONVERT_FROM(double, MI_STORE_DOUBLE)}
+      break;
+   default :
+      break;
+   }
 }
@@ -159,9 +159,17 @@
 
 #include "minc_private.h"
 #include <float.h>
+#include <limits.h>
 #include <math.h>
 #include "voxel_loop.h"
 #include "nd_loop.h"
+#if MINC2
+#include "minc2.h"
+#endif /* MINC2 */
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif /* _OPENMP */
 
 /* Minimum number of voxels to put in a buffer. If this is too small,
    then for large images excessive reading can result. If it is
@@ -174,6 +182,11 @@
 /* Epsilon for coordinate comparisons */
 #define COORD_EPSILON (FLT_EPSILON * 10.0)
 
+/* User functions that can be called on a chunk */
+#define LOOP_VOXEL_FUNCTION  0
+#define LOOP_START_FUNCTION  1
+#define LOOP_FINISH_FUNCTION 2
+
 /* Typedefs */
 typedef struct Loopfile_Info Loopfile_Info;
 
@@ -215,8 +228,11 @@ struct Loop_Options {
    int is_floating_type;
    int is_labels;
    AllocateBufferFunction allocate_buffer_function;
+   int num_threads;
+   int pipeline_io;
 #if MINC2
    int v2format;
+   int minc2_native;
 #endif /* MINC2 */
 };
 
@@ -238,8 +254,65 @@ struct Loopfile_Info {
    int want_headers_only;
    int sequential_access;
    int can_open_all_input;
+#if MINC2
+   int use_volumes;               /* Read and write through the volume */
+   mihandle_t *input_volume;      /* handles instead of the icv's */
+   mihandle_t *output_volume;
+#endif /* MINC2 */
 };
 
+/* A call to a user function on a chunk */
+typedef struct {
+   int function_type;
+   int ndims;
+   long num_voxels;
+   int num_input_buffers;
+   int input_vector_length;
+   double **input_buffers;
+   int num_output_buffers;
+   int output_vector_length;
+   double **output_buffers;
+   Loop_Info loop_info;
+   int ends_block;                 /* Block can be written after call */
+   int output_set;
+   long block_cur[MAX_VAR_DIMS];
+   long block_curcount[MAX_VAR_DIMS];
+} Loop_Call;
+
+/* Input to be read during a step of the loop */
+typedef struct {
+   int all_files;                  /* Read every file and index */
+   int ifile;                      /* Otherwise, the file and index */
+   int dim_index;
+   long *chunk_cur;
+   long *chunk_curcount;
+   double **input_buffers;
+   Loop_Info loop_info;            /* Shape of a single file read */
+} Loop_IO;
+
+/* State shared between the I/O and the user function calls */
+typedef struct {
+   Loop_Options *loop_options;
+   Loopfile_Info *loopfile_info;
+   int pipelined;
+   int ndims;
+   int modify_vector_count;
+   long block_num_voxels;
+   int num_output_files;
+   int output_vector_length;
+   double **output_buffers[2];
+   double *global_minimum;
+   double *global_maximum;
+   int call_pending;               /* call is to be made in next step */
+   Loop_Call call;
+   int write_ready;                /* write_cur is to be written */
+   int write_set;
+   long write_cur[MAX_VAR_DIMS];
+   long write_curcount[MAX_VAR_DIMS];
+   int num_slice_dims;             /* Dimensions of image-max and image-min */
+   int result_code;
+} Loop_Pipeline;
+
 /* Function prototypes */
 PRIVATE int get_loop_dim_size(int inmincid, Loop_Options *loop_options);
 PRIVATE void translate_input_coords(int inmincid,
@@ -268,14 +341,60 @@ PRIVATE void setup_variables(int inmincid, int outmincid,
 PRIVATE void update_history(int mincid, char *arg_string);
 PRIVATE void setup_icvs(Loop_Options *loop_options, 
                         Loopfile_Info *loopfile_info);
+#if MINC2
+PRIVATE void setup_volume_handles(Loop_Options *loop_options, 
+                                  Loopfile_Info *loopfile_info);
+PRIVATE void close_volume_handles(Loopfile_Info *loopfile_info);
+PRIVATE int volume_needs_fill_check(mihandle_t volume, 
+                                    double *valid_min, double *valid_max);
+PRIVATE int get_volume_hyperslab(mihandle_t volume, 
+                                 long chunk_cur[], long chunk_curcount[],
+                                 long input_cur[], long input_curcount[],
+                                 double *buffer);
+PRIVATE int put_volume_slice_range(mihandle_t volume, long slice_cur[],
+                                   double minimum, double maximum);
+PRIVATE int put_volume_hyperslab(Loop_Options *loop_options, 
+                                 mihandle_t volume,
+                                 long block_cur[], long count[],
+                                 double *buffer);
+#endif /* MINC2 */
+PRIVATE void get_input_chunk_dims(Loop_Options *loop_options,
+                                  Loopfile_Info *loopfile_info,
+                                  int ndims, long chunk_dims[]);
 PRIVATE int do_voxel_loop(Loop_Options *loop_options,
                           Loopfile_Info *loopfile_info);
+PRIVATE int use_pipeline_io(Loop_Options *loop_options);
+PRIVATE void read_loop_inputs(Loop_Pipeline *pipeline, Loop_IO *io);
+PRIVATE void write_loop_block(Loop_Pipeline *pipeline, 
+                              long block_cur[], long block_curcount[],
+                              int output_set);
+PRIVATE void do_loop_io(Loop_Pipeline *pipeline, int do_write, Loop_IO *io);
+PRIVATE void run_loop_step(Loop_Pipeline *pipeline, Loop_IO *io);
+PRIVATE void queue_loop_call(Loop_Pipeline *pipeline, int function_type,
+                             long num_voxels, double *input_buffers[],
+                             double *results_buffers[], 
+                             Loop_Info *loop_info);
+PRIVATE void end_loop_block(Loop_Pipeline *pipeline, 
+                            long block_cur[], long block_curcount[],
+                            int output_set);
+PRIVATE int get_call_slabs(Loop_Options *loop_options, Loop_Call *call,
+                           int *split_dim, long *num_elements,
+                           long *slab_voxels);
+PRIVATE void call_function_on_slab(Loop_Options *loop_options, 
+                                   Loop_Call *call, int split_dim,
+                                   long slab_start, long slab_count,
+                                   long slab_voxels);
+PRIVATE void make_loop_call(Loop_Options *loop_options, Loop_Call *call,
+                            long num_voxels, double *input_buffers[],
+                            double *output_buffers[], Loop_Info *loop_info);
+PRIVATE void call_voxel_function(Loop_Options *loop_options, Loop_Call *call);
 PRIVATE void setup_looping(Loop_Options *loop_options, 
                            Loopfile_Info *loopfile_info,
                            int *ndims,
                            long block_start[], long block_end[], 
                            long block_incr[], long *block_num_voxels,
-                           long chunk_incr[], long *chunk_num_voxels);
+                           long chunk_incr[], long *chunk_num_voxels,
+                           int *num_slice_dims);
 PRIVATE void initialize_file_and_index(Loop_Options *loop_options, 
                                        Loopfile_Info *loopfile_info,
                                        int do_loop,
@@ -346,7 +465,7 @@ PRIVATE void set_info_loopfile_info(Loop_Info *loop_info,
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : January 10, 1994 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : Oct. 19, 2026 : MINC 2.0 volume handles
 ---------------------------------------------------------------------------- */
 MNCAPI int voxel_loop(int num_input_files, char *input_files[], 
                       int num_output_files, char *output_files[], 
@@ -403,6 +522,11 @@ MNCAPI int voxel_loop(int num_input_files, char *input_files[],
    /* Setup icv's */
    setup_icvs(loop_options, loopfile_info);
 
+#if MINC2
+   /* Use volume handles instead, if we can */
+   setup_volume_handles(loop_options, loopfile_info);
+#endif /* MINC2 */
+
    /* Loop through the voxels */
    status = do_voxel_loop(loop_options, loopfile_info);
 
@@ -1250,6 +1374,378 @@ PRIVATE void setup_icvs(Loop_Options *loop_options,
    }
 }
 
+#if MINC2
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : setup_volume_handles
+@INPUT      : loop_options - user options for looping
+              loopfile_info - information on files used in loop
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to open MINC 2.0 volume handles on all of the input 
+              and output files, if set_loop_minc2_native asked for it and 
+              every file is a MINC 2.0 file. Handles do not use icv's, so 
+              all of the files are kept open. If any file cannot be opened,
+              the icv's are used as before.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void setup_volume_handles(Loop_Options *loop_options, 
+                                  Loopfile_Info *loopfile_info)
+{
+   int ifile, num_input_files, num_output_files;
+   int ok;
+
+   loopfile_info->use_volumes = FALSE;
+   if (!loop_options->minc2_native || 
+       (loop_options->loop_dimension != NULL) ||
+       loop_options->convert_input_to_scalar) {
+      return;
+   }
+
+   num_input_files = get_input_numfiles(loopfile_info);
+   num_output_files = get_output_numfiles(loopfile_info);
+
+   /* Check that all of the files are MINC 2.0 files */
+   for (ifile=0; ifile < num_input_files; ifile++) {
+      if (!MI2_ISH5OBJ(get_input_mincid(loopfile_info, ifile))) return;
+   }
+   for (ifile=0; ifile < num_output_files; ifile++) {
+      if (!MI2_ISH5OBJ(get_output_mincid(loopfile_info, ifile))) return;
+   }
+
+   /* Open the volumes */
+   loopfile_info->input_volume = MALLOC(num_input_files, mihandle_t);
+   for (ifile=0; ifile < num_input_files; ifile++)
+      loopfile_info->input_volume[ifile] = NULL;
+   if (num_output_files > 0) {
+      loopfile_info->output_volume = MALLOC(num_output_files, mihandle_t);
+      for (ifile=0; ifile < num_output_files; ifile++)
+         loopfile_info->output_volume[ifile] = NULL;
+   }
+
+   ok = TRUE;
+   for (ifile=0; ok && (ifile < num_input_files); ifile++) {
+      ok = (miopen_volume(loopfile_info->input_files[ifile], MI2_OPEN_READ,
+                          &loopfile_info->input_volume[ifile])
+            == MI_NOERROR);
+   }
+   for (ifile=0; ok && (ifile < num_output_files); ifile++) {
+      ok = (miopen_volume(loopfile_info->output_files[ifile], MI2_OPEN_RDWR,
+                          &loopfile_info->output_volume[ifile])
+            == MI_NOERROR);
+   }
+
+   if (ok) {
+      loopfile_info->use_volumes = TRUE;
+   }
+   else {
+      close_volume_handles(loopfile_info);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : close_volume_handles
+@INPUT      : loopfile_info - information on files used in loop
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to close any volume handles opened by 
+              setup_volume_handles. Safe to call more than once.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void close_volume_handles(Loopfile_Info *loopfile_info)
+{
+   int ifile;
+
+   if (loopfile_info->input_volume != NULL) {
+      for (ifile=0; ifile < loopfile_info->num_input_files; ifile++) {
+         if (loopfile_info->input_volume[ifile] != NULL)
+            (void) miclose_volume(loopfile_info->input_volume[ifile]);
+      }
+      FREE(loopfile_info->input_volume);
+      loopfile_info->input_volume = NULL;
+   }
+
+   if (loopfile_info->output_volume != NULL) {
+      for (ifile=0; ifile < loopfile_info->num_output_files; ifile++) {
+         if (loopfile_info->output_volume[ifile] != NULL)
+            (void) miclose_volume(loopfile_info->output_volume[ifile]);
+      }
+      FREE(loopfile_info->output_volume);
+      loopfile_info->output_volume = NULL;
+   }
+
+   loopfile_info->use_volumes = FALSE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : volume_needs_fill_check
+@INPUT      : volume - input volume handle
+@OUTPUT     : valid_min - smallest valid voxel value, less epsilon
+              valid_max - largest valid voxel value, plus epsilon
+@RETURNS    : TRUE if some voxel values of the file type are outside of
+              the valid range.
+@DESCRIPTION: Routine to find the range of voxel values that the input 
+              icv's would not replace with the fill value. The range is 
+              widened by FILLVALUE_EPSILON, as the icv's do.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int volume_needs_fill_check(mihandle_t volume, 
+                                    double *valid_min, double *valid_max)
+{
+   mitype_t datatype;
+   double type_min, type_max, epsilon;
+
+   if ((miget_data_type(volume, &datatype) != MI_NOERROR) ||
+       (miget_volume_valid_range(volume, valid_max, valid_min) 
+        != MI_NOERROR)) {
+      *valid_min = -DBL_MAX;
+      *valid_max = DBL_MAX;
+      return FALSE;
+   }
+
+   epsilon = fabs((*valid_max - *valid_min) * FILLVALUE_EPSILON);
+   *valid_min -= epsilon;
+   *valid_max += epsilon;
+
+   switch (datatype) {
+   case MI_TYPE_BYTE:   type_min = SCHAR_MIN; type_max = SCHAR_MAX; break;
+   case MI_TYPE_UBYTE:  type_min = 0;         type_max = UCHAR_MAX; break;
+   case MI_TYPE_SHORT:  type_min = SHRT_MIN;  type_max = SHRT_MAX;  break;
+   case MI_TYPE_USHORT: type_min = 0;         type_max = USHRT_MAX; break;
+   case MI_TYPE_INT:    type_min = INT_MIN;   type_max = INT_MAX;   break;
+   case MI_TYPE_UINT:   type_min = 0;         type_max = UINT_MAX;  break;
+   case MI_TYPE_FLOAT:  type_min = -FLT_MAX;  type_max = FLT_MAX;   break;
+   default:             type_min = -DBL_MAX;  type_max = DBL_MAX;   break;
+   }
+
+   return ((type_min < *valid_min) || (type_max > *valid_max));
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_volume_hyperslab
+@INPUT      : volume - input volume handle
+              chunk_cur - start of chunk
+              chunk_curcount - count of chunk
+              buffer - buffer for real values
+@OUTPUT     : input_cur - start for input file
+              input_curcount - count for input file
+@RETURNS    : MI_ERROR if an error occurs.
+@DESCRIPTION: Routine to read a chunk of real values from an input volume.
+              Without a looping dimension, the file coordinates are the
+              chunk coordinates for the dimensions of the file. Voxels
+              outside of the valid range are set to -DBL_MAX, the fill
+              value that setup_icvs asks the input icv's for.
+@METHOD     : The voxel values are only read, as well as the real values,
+              when the file type can hold values outside of the valid 
+              range.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int get_volume_hyperslab(mihandle_t volume, 
+                                 long chunk_cur[], long chunk_curcount[],
+                                 long input_cur[], long input_curcount[],
+                                 double *buffer)
+{
+   misize_t start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+   int ndims, idim;
+   long ivox, num_values;
+   double valid_min, valid_max;
+   char *is_fill;
+
+   if (miget_volume_dimension_count(volume, MI_DIMCLASS_ANY, MI_DIMATTR_ALL,
+                                    &ndims) != MI_NOERROR) {
+      return MI_ERROR;
+   }
+
+   num_values = 1;
+   for (idim=0; idim < ndims; idim++) {
+      input_cur[idim] = chunk_cur[idim];
+      input_curcount[idim] = chunk_curcount[idim];
+      start[idim] = (misize_t) chunk_cur[idim];
+      count[idim] = (misize_t) chunk_curcount[idim];
+      num_values *= chunk_curcount[idim];
+   }
+
+   if (!volume_needs_fill_check(volume, &valid_min, &valid_max)) {
+      return miget_real_value_hyperslab(volume, MI_TYPE_DOUBLE, 
+                                        start, count, buffer);
+   }
+
+   /* Find the invalid voxels, then read the real values over them */
+   if (miget_voxel_value_hyperslab(volume, MI_TYPE_DOUBLE, 
+                                   start, count, buffer) != MI_NOERROR) {
+      return MI_ERROR;
+   }
+   is_fill = MALLOC(num_values, char);
+   for (ivox=0; ivox < num_values; ivox++) {
+      is_fill[ivox] = ((buffer[ivox] < valid_min) || 
+                       (buffer[ivox] > valid_max));
+   }
+   if (miget_real_value_hyperslab(volume, MI_TYPE_DOUBLE, 
+                                  start, count, buffer) != MI_NOERROR) {
+      FREE(is_fill);
+      return MI_ERROR;
+   }
+   for (ivox=0; ivox < num_values; ivox++) {
+      if (is_fill[ivox]) buffer[ivox] = -DBL_MAX;
+   }
+   FREE(is_fill);
+
+   return MI_NOERROR;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : put_volume_slice_range
+@INPUT      : volume - output volume handle
+              slice_cur - start of slice
+              minimum - minimum of slice
+              maximum - maximum of slice
+@OUTPUT     : (none)
+@RETURNS    : MI_ERROR if an error occurs.
+@DESCRIPTION: Routine to set the range of one slice of an output volume.
+              This must be done before the values of the slice are written.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int put_volume_slice_range(mihandle_t volume, long slice_cur[],
+                                   double minimum, double maximum)
+{
+   misize_t start[MAX_VAR_DIMS];
+   int ndims, idim;
+
+   if (miget_volume_dimension_count(volume, MI_DIMCLASS_ANY, MI_DIMATTR_ALL,
+                                    &ndims) != MI_NOERROR) {
+      return MI_ERROR;
+   }
+
+   for (idim=0; idim < ndims; idim++)
+      start[idim] = (misize_t) slice_cur[idim];
+
+   return miset_slice_range(volume, start, (size_t) ndims, 
+                            maximum, minimum);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : put_volume_hyperslab
+@INPUT      : loop_options - user options for looping
+              volume - output volume handle
+              block_cur - start of block
+              count - count of block
+              buffer - real values of block
+@OUTPUT     : (none)
+@RETURNS    : MI_ERROR if an error occurs.
+@DESCRIPTION: Routine to write a block of real values to an output volume.
+              The ranges of its slices must already be set. Label volumes 
+              are written without scaling.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int put_volume_hyperslab(Loop_Options *loop_options, 
+                                 mihandle_t volume,
+                                 long block_cur[], long count[],
+                                 double *buffer)
+{
+   misize_t start[MAX_VAR_DIMS], edges[MAX_VAR_DIMS];
+   int ndims, idim;
+
+   if (miget_volume_dimension_count(volume, MI_DIMCLASS_ANY, MI_DIMATTR_ALL,
+                                    &ndims) != MI_NOERROR) {
+      return MI_ERROR;
+   }
+
+   for (idim=0; idim < ndims; idim++) {
+      start[idim] = (misize_t) block_cur[idim];
+      edges[idim] = (misize_t) count[idim];
+   }
+
+   if (loop_options->is_labels) {
+      return miset_voxel_value_hyperslab(volume, MI_TYPE_DOUBLE, 
+                                         start, edges, buffer);
+   }
+
+   return miset_real_value_hyperslab(volume, MI_TYPE_DOUBLE, 
+                                     start, edges, buffer);
+}
+#endif /* MINC2 */
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_input_chunk_dims
+@INPUT      : loop_options - user options for looping
+              loopfile_info - information on files used in loop
+              ndims - number of looping dimensions
+@OUTPUT     : chunk_dims - storage chunk size along each dimension
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to get the storage chunk shape of the first input 
+              file, so that blocks can be made of whole chunks. Files that 
+              are not chunked (or not MINC 2.0) give 1 for every dimension.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void get_input_chunk_dims(Loop_Options *loop_options,
+                                  Loopfile_Info *loopfile_info,
+                                  int ndims, long chunk_dims[])
+{
+#if MINC2
+   misize_t file_chunk_dims[MAX_VAR_DIMS];
+   mihandle_t volume;
+   int file_ndims;
+#endif /* MINC2 */
+   int idim;
+
+   for (idim=0; idim < ndims; idim++)
+      chunk_dims[idim] = 1;
+
+#if MINC2
+   /* Only the input dimensions are looped over without a loop dimension */
+   if ((loop_options->loop_dimension != NULL) ||
+       !MI2_ISH5OBJ(get_input_mincid(loopfile_info, 0))) {
+      return;
+   }
+
+   if (loopfile_info->use_volumes) {
+      volume = loopfile_info->input_volume[0];
+   }
+   else if (miopen_volume(loopfile_info->input_files[0], MI2_OPEN_READ,
+                          &volume) != MI_NOERROR) {
+      return;
+   }
+
+   if ((miget_volume_dimension_count(volume, MI_DIMCLASS_ANY, 
+                                     MI_DIMATTR_ALL, &file_ndims)
+        == MI_NOERROR) &&
+       (miget_volume_chunk_dims(volume, MAX_VAR_DIMS, file_chunk_dims)
+        == MI_NOERROR)) {
+      for (idim=0; (idim < file_ndims) && (idim < ndims); idim++)
+         chunk_dims[idim] = (long) file_chunk_dims[idim];
+   }
+
+   if (!loopfile_info->use_volumes)
+      (void) miclose_volume(volume);
+#endif /* MINC2 */
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : do_voxel_loop
 @INPUT      : loop_options - user options for looping
@@ -1257,11 +1753,16 @@ PRIVATE void setup_icvs(Loop_Options *loop_options,
 @OUTPUT     : (none)
 @RETURNS    : non-zero if an error occurs.
 @DESCRIPTION: Routine to loop through the voxels and do something to each one
-@METHOD     : 
+@METHOD     : Files are read and written by the calling thread. Calls to the
+              user functions go through a Loop_Pipeline, which makes them
+              straight away or, with set_loop_pipeline_io, while the next
+              chunk is read and the previous block is written.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : January 10, 1994 (Peter Neelin)
 @MODIFIED   : November 30, 1994 (P.N.)
+@MODIFIED   : Oct. 19, 2026 : pipelined I/O
+@MODIFIED   : Oct. 19, 2026 : MINC 2.0 volume handles
 ---------------------------------------------------------------------------- */
 PRIVATE int do_voxel_loop(Loop_Options *loop_options,
                           Loopfile_Info *loopfile_info)
@@ -1272,29 +1773,30 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
    long chunk_start[MAX_VAR_DIMS], chunk_end[MAX_VAR_DIMS];
    long chunk_incr[MAX_VAR_DIMS];
    long chunk_cur[MAX_VAR_DIMS], chunk_curcount[MAX_VAR_DIMS];
-   long input_cur[MAX_VAR_DIMS], input_curcount[MAX_VAR_DIMS];
    long firstfile_cur[MAX_VAR_DIMS], firstfile_curcount[MAX_VAR_DIMS];
-   double **input_buffers, **output_buffers, **extra_buffers;
+   double **input_buffers[2], **output_buffers[2], **extra_buffers;
    double **results_buffers;
-   long chunk_num_voxels, block_num_voxels, ivox;
+   Loop_Pipeline *pipeline;
+   Loop_IO *io;
+   Loop_Info *chunk_info;
+   long chunk_num_voxels, block_num_voxels;
    int outmincid, imgid, maxid, minid;
-   double *data, minimum, maximum, valid_range[2];
+   double valid_range[2];
    double *global_minimum, *global_maximum;
-   int ifile, ofile, ibuff, ndims, idim;
-   int num_output_files;
+   int ifile, ofile, ibuff, iset, ndims, idim;
+   int num_output_files, num_sets;
    int num_input_buffers, num_output_buffers, num_extra_buffers;
    int input_vector_length, output_vector_length;
-   int modify_vector_count;
-   int current_input;
-   int input_icvid, input_mincid;
+   int input_set, output_set;
+   int num_slice_dims;
+   int input_mincid;
    int loop_dim_index;
    int dim_index;
    int outer_file_loop;
    int dummy_index;
    int input_curfile;
    nc_type file_datatype;
-   int status_code;
-   int result_code = EXIT_SUCCESS;
+   int result_code;
 
    /* Get number of files, buffers, etc. */
    num_output_files = get_output_numfiles(loopfile_info);
@@ -1313,7 +1815,9 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
    }
    else
       output_vector_length = 1;
-   modify_vector_count = (input_vector_length != output_vector_length);
+
+   /* Use two sets of input and output buffers when pipelining */
+   num_sets = (use_pipeline_io(loop_options) ? 2 : 1);
 
    /* Initialize all of the counters to reasonable values */
    (void) miset_coords(MAX_VAR_DIMS, 0, block_start);
@@ -1326,8 +1830,6 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
    (void) miset_coords(MAX_VAR_DIMS, 0, chunk_incr);
    (void) miset_coords(MAX_VAR_DIMS, 0, chunk_cur);
    (void) miset_coords(MAX_VAR_DIMS, 0, chunk_curcount);
-   (void) miset_coords(MAX_VAR_DIMS, 0, input_cur);
-   (void) miset_coords(MAX_VAR_DIMS, 0, input_curcount);
    (void) miset_coords(MAX_VAR_DIMS, 0, firstfile_cur);
    (void) miset_coords(MAX_VAR_DIMS, 0, firstfile_curcount);
 
@@ -1335,7 +1837,7 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
    setup_looping(loop_options, loopfile_info, &ndims,
                  block_start, block_end, 
                  block_incr, &block_num_voxels,
-                 chunk_incr, &chunk_num_voxels);
+                 chunk_incr, &chunk_num_voxels, &num_slice_dims);
 
    /* Allocate space for buffers */
 
@@ -1343,9 +1845,9 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
       loop_options->allocate_buffer_function
          (loop_options->caller_data, TRUE, 
           num_input_buffers, chunk_num_voxels, input_vector_length, 
-          &input_buffers, 
+          &input_buffers[0], 
           num_output_files, block_num_voxels, output_vector_length, 
-          &output_buffers, 
+          &output_buffers[0], 
           num_extra_buffers, chunk_num_voxels, output_vector_length, 
           &extra_buffers, 
           loop_options->loop_info);
@@ -1353,20 +1855,25 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
    }
    else {
 
-      /* Allocate input buffers */
-      input_buffers = MALLOC(num_input_buffers, double *);
-      for (ibuff=0; ibuff < num_input_buffers; ibuff++) {
-         input_buffers[ibuff] = MALLOC(chunk_num_voxels * input_vector_length, 
-                                       double);
-      }
+      for (iset=0; iset < num_sets; iset++) {
 
-      /* Allocate output buffers */
-      if (num_output_files > 0) {
-         output_buffers = MALLOC(num_output_files, double *);
-         for (ibuff=0; ibuff < num_output_files; ibuff++) {
-            output_buffers[ibuff] = MALLOC(block_num_voxels * 
-                                           output_vector_length, double);
+         /* Allocate input buffers */
+         input_buffers[iset] = MALLOC(num_input_buffers, double *);
+         for (ibuff=0; ibuff < num_input_buffers; ibuff++) {
+            input_buffers[iset][ibuff] = 
+               MALLOC(chunk_num_voxels * input_vector_length, double);
          }
+
+         /* Allocate output buffers */
+         output_buffers[iset] = NULL;
+         if (num_output_files > 0) {
+            output_buffers[iset] = MALLOC(num_output_files, double *);
+            for (ibuff=0; ibuff < num_output_files; ibuff++) {
+               output_buffers[iset][ibuff] = 
+                  MALLOC(block_num_voxels * output_vector_length, double);
+            }
+         }
+
       }
 
       /* Allocate extra buffers */
@@ -1385,13 +1892,16 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
       results_buffers = MALLOC(num_output_buffers, double *);
       for (ibuff=0; ibuff < num_output_buffers; ibuff++) {
          if (ibuff < num_output_files) {
-            results_buffers[ibuff] = output_buffers[ibuff];
+            results_buffers[ibuff] = output_buffers[0][ibuff];
          }
          else {
             results_buffers[ibuff] = extra_buffers[ibuff-num_output_files];
          }
       }
    }
+   else {
+      results_buffers = NULL;
+   }
 
    /* Initialize global min and max */
    if (num_output_files > 0) {
@@ -1407,6 +1917,39 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
       global_maximum = NULL;
    }
 
+   /* Set up the pipeline */
+   pipeline = MALLOC(1, Loop_Pipeline);
+   pipeline->loop_options = loop_options;
+   pipeline->loopfile_info = loopfile_info;
+   pipeline->pipelined = (num_sets > 1);
+   pipeline->ndims = ndims;
+   pipeline->modify_vector_count = 
+      (input_vector_length != output_vector_length);
+   pipeline->block_num_voxels = block_num_voxels;
+   pipeline->num_output_files = num_output_files;
+   pipeline->output_vector_length = output_vector_length;
+   for (iset=0; iset < num_sets; iset++)
+      pipeline->output_buffers[iset] = output_buffers[iset];
+   pipeline->global_minimum = global_minimum;
+   pipeline->global_maximum = global_maximum;
+   pipeline->call_pending = FALSE;
+   pipeline->write_ready = FALSE;
+   pipeline->num_slice_dims = num_slice_dims;
+   pipeline->result_code = EXIT_SUCCESS;
+   pipeline->call.num_input_buffers = num_input_buffers;
+   pipeline->call.input_vector_length = input_vector_length;
+   pipeline->call.num_output_buffers = num_output_buffers;
+   pipeline->call.output_vector_length = output_vector_length;
+   pipeline->call.output_buffers = (num_output_buffers > 0 ?
+                                    MALLOC(num_output_buffers, double *) :
+                                    NULL);
+   pipeline->call.ndims = ndims;
+
+   io = MALLOC(1, Loop_IO);
+   io->chunk_cur = chunk_cur;
+   io->chunk_curcount = chunk_curcount;
+   chunk_info = create_loop_info();
+
    /* Initialize loop info - just to be safe */
    initialize_loop_info(loop_options->loop_info);
 
@@ -1417,6 +1960,8 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
    }
 
    /* Outer loop over files, if appropriate */
+   input_set = 0;
+   output_set = 0;
    outer_file_loop = (loop_options->do_accumulate && 
                       (num_output_buffers <= 0));
    for (initialize_file_and_index(loop_options, loopfile_info,
@@ -1440,7 +1985,7 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
 
          /* Set results_buffers to beginning of output buffers */
          for (ofile=0; ofile < num_output_files; ofile++) {
-            results_buffers[ofile] = output_buffers[ofile];
+            results_buffers[ofile] = output_buffers[output_set][ofile];
          }
 
          /* Loop through chunks (space for input buffers) */
@@ -1468,7 +2013,7 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
                chunk_num_voxels *= chunk_curcount[idim];
             chunk_num_voxels /= input_vector_length;
 
-            /* Translate start and count for file and save in loop_info */
+            /* Translate start and count for file and save in chunk_info */
             if (outer_file_loop)
                input_curfile = ifile;
             else
@@ -1478,105 +2023,67 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
                                    chunk_curcount, firstfile_curcount,
                                    &loop_dim_index, loop_options);
 
-            /* Save start and count and file and index in loop_info */
-            set_info_shape(loop_options->loop_info, 
-                           firstfile_cur, firstfile_curcount);
-            set_info_current_file(loop_options->loop_info, 0);
-            set_info_current_index(loop_options->loop_info, 0);
+            /* Save start and count and file and index in chunk_info */
+            initialize_loop_info(chunk_info);
+            set_info_shape(chunk_info, firstfile_cur, firstfile_curcount);
+            set_info_current_file(chunk_info, 0);
+            set_info_current_index(chunk_info, 0);
 
-            /* Initialize results buffers if necessary */
             if (loop_options->do_accumulate) {
-               if (loop_options->start_function != NULL) {
-                  loop_options->start_function
-                     (loop_options->caller_data,
-                      chunk_num_voxels,
-                      num_output_buffers,
-                      output_vector_length,
-                      results_buffers,
-                      loop_options->loop_info);
-               }
-            }
 
-            /* Get the input buffers and accumulate them if needed */
-            current_input = 0;
-            for (initialize_file_and_index(loop_options, loopfile_info,
-                                           !outer_file_loop, &ifile, 
-                                           &dim_index, &dummy_index);
-                 finish_file_and_index(loop_options, loopfile_info,
-                                       !outer_file_loop, ifile, 
-                                       dim_index, dummy_index);
-                 increment_file_and_index(loop_options, loopfile_info,
-                                          !outer_file_loop, &ifile, 
-                                          &dim_index, &dummy_index)) {
-
-               /* Get input icvid and mincid and translate coords for file.
-                  We need to do this each time in case we have an outer
-                  file loop. */
-               input_icvid = get_input_icvid(loopfile_info, ifile);
-               (void) miicv_inqint(input_icvid, MI_ICV_CDFID, 
-                                   &input_mincid);
-               translate_input_coords(input_mincid, chunk_cur, input_cur,
-                                      chunk_curcount, input_curcount,
-                                      &loop_dim_index, loop_options);
-
-
-               /* Read buffer */
-               ibuff = (loop_options->do_accumulate ? 0 : current_input);
-               input_cur[loop_dim_index] = dim_index;
-               status_code = miicv_get(input_icvid,
-                                       input_cur, input_curcount, 
-                                       input_buffers[ibuff]);
-               if (status_code != MI_NOERROR) {
-                 result_code = EXIT_FAILURE;
-               }
-               if (loop_options->do_accumulate) {
-                  set_info_shape(loop_options->loop_info, 
-                                 input_cur, input_curcount);
-                  set_info_current_file(loop_options->loop_info, ifile);
-                  set_info_current_index(loop_options->loop_info, dim_index);
-                  set_info_loopfile_info(loop_options->loop_info, 
-                                         loopfile_info);
-                  loop_options->voxel_function(loop_options->caller_data,
-                                               chunk_num_voxels, 
-                                               num_input_buffers, 
-                                               input_vector_length,
-                                               input_buffers,
-                                               num_output_buffers, 
-                                               output_vector_length,
-                                               results_buffers,
-                                               loop_options->loop_info);
-                  set_info_loopfile_info(loop_options->loop_info, NULL);
+               /* Initialize results buffers if necessary */
+               if (loop_options->start_function != NULL) {
+                  queue_loop_call(pipeline, LOOP_START_FUNCTION,
+                                  chunk_num_voxels, NULL,
+                                  results_buffers, chunk_info);
                }
 
-               current_input++;
+               /* Get the input buffers one at a time and accumulate them.
+                  If there is an outer file loop, ifile and dim_index are 
+                  left alone by the inner loop. */
+               for (initialize_file_and_index(loop_options, loopfile_info,
+                                              !outer_file_loop, &ifile, 
+                                              &dim_index, &dummy_index);
+                    finish_file_and_index(loop_options, loopfile_info,
+                                          !outer_file_loop, ifile, 
+                                          dim_index, dummy_index);
+                    increment_file_and_index(loop_options, loopfile_info,
+                                             !outer_file_loop, &ifile, 
+                                             &dim_index, &dummy_index)) {
+
+                  io->all_files = FALSE;
+                  io->ifile = ifile;
+                  io->dim_index = dim_index;
+                  io->input_buffers = input_buffers[input_set];
+                  run_loop_step(pipeline, io);
+
+                  queue_loop_call(pipeline, LOOP_VOXEL_FUNCTION,
+                                  chunk_num_voxels, input_buffers[input_set],
+                                  results_buffers, &io->loop_info);
+                  input_set = (input_set + 1) % num_sets;
 
-            }            /* Inner loop over files and dimension index */
+               }
 
-            /* Do something with the buffers or finish accumulation */
-            set_info_shape(loop_options->loop_info, 
-                           firstfile_cur, firstfile_curcount);
-            set_info_current_file(loop_options->loop_info, 0);
-            set_info_current_index(loop_options->loop_info, 0);
-            if (loop_options->do_accumulate) {
+               /* Finish accumulation */
                if (loop_options->finish_function != NULL) {
-                  loop_options->finish_function(loop_options->caller_data,
-                                                chunk_num_voxels, 
-                                                num_output_buffers,
-                                                output_vector_length,
-                                                results_buffers,
-                                                loop_options->loop_info);
+                  queue_loop_call(pipeline, LOOP_FINISH_FUNCTION,
+                                  chunk_num_voxels, NULL,
+                                  results_buffers, chunk_info);
                }
+
             }
             else {
-               loop_options->voxel_function(loop_options->caller_data,
-                                            chunk_num_voxels, 
-                                            num_input_buffers, 
-                                            input_vector_length,
-                                            input_buffers,
-                                            num_output_buffers, 
-                                            output_vector_length,
-                                            results_buffers,
-                                            loop_options->loop_info);
+
+               /* Get all of the input buffers and do something with them */
+               io->all_files = TRUE;
+               io->input_buffers = input_buffers[input_set];
+               run_loop_step(pipeline, io);
+
+               queue_loop_call(pipeline, LOOP_VOXEL_FUNCTION,
+                               chunk_num_voxels, input_buffers[input_set],
+                               results_buffers, chunk_info);
+               input_set = (input_set + 1) % num_sets;
+
             }
 
             /* Increment results_buffers through output buffers */
@@ -1591,49 +2098,8 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
          }     /* End of loop through chunks */
 
          /* Write out output buffers */
-
-         for (ofile=0; ofile < num_output_files; ofile++) {
-            outmincid = get_output_mincid(loopfile_info, ofile);
-            maxid = ncvarid(outmincid, MIimagemax);
-            minid = ncvarid(outmincid, MIimagemin);
-            data = output_buffers[ofile];
-
-            /* Find the max and min */
-            minimum = DBL_MAX;
-            maximum = -DBL_MAX;
-            for (ivox=0; ivox < block_num_voxels*output_vector_length; 
-                 ivox++) {
-               if (data[ivox] != -DBL_MAX) {
-                  if (data[ivox] < minimum) minimum = data[ivox];
-                  if (data[ivox] > maximum) maximum = data[ivox];
-               }
-            }
-            if ((minimum == DBL_MAX) && (maximum == -DBL_MAX)) {
-               minimum = 0.0;
-               maximum = 0.0;
-            }
-
-            /* Save global min and max */
-            if (minimum < global_minimum[ofile]) 
-               global_minimum[ofile] = minimum;
-            if (maximum > global_maximum[ofile]) 
-               global_maximum[ofile] = maximum;
-
-            /* Write out the max and min */
-            
-            if( ! loop_options->is_labels )
-            {
-               (void) mivarput1(outmincid, maxid, block_cur, 
-                              NC_DOUBLE, NULL, &maximum);
-               (void) mivarput1(outmincid, minid, block_cur, 
-                              NC_DOUBLE, NULL, &minimum);
-            }
-            /* Write out the values */
-            if (modify_vector_count)
-               block_curcount[ndims-1] = output_vector_length;
-            (void) miicv_put(get_output_icvid(loopfile_info, ofile), 
-                             block_cur, block_curcount, data);
-         }          /* End of loop through output files */
+         end_loop_block(pipeline, block_cur, block_curcount, output_set);
+         output_set = (output_set + 1) % num_sets;
 
          nd_increment_loop(block_cur, block_start, block_incr, 
                            block_end, ndims);
@@ -1642,10 +2108,23 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
 
    }     /* End of outer loop through files and dimension indices */
 
+   /* Finish the last calls and writes */
+   while (pipeline->call_pending || pipeline->write_ready) {
+      run_loop_step(pipeline, NULL);
+   }
+   result_code = pipeline->result_code;
+
+#if MINC2
+   /* Close the volume handles before the final attributes are written */
+   close_volume_handles(loopfile_info);
+#endif /* MINC2 */
+
    /* Data has been completely written */
    for (ofile=0; ofile < num_output_files; ofile++) {
       outmincid = get_output_mincid(loopfile_info, ofile);
       imgid = ncvarid(outmincid, MIimage);
+      maxid = ncvarid(outmincid, MIimagemax);
+      minid = ncvarid(outmincid, MIimagemin);
       (void) miattputstr(outmincid, imgid, MIcomplete, MI_TRUE);
       if (loop_options->is_floating_type) {
          if ((global_minimum[ofile] == DBL_MAX) && 
@@ -1699,6 +2178,14 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
       (void) fflush(stdout);
    }
 
+   /* Free the pipeline */
+   if (pipeline->call.output_buffers != NULL) {
+      FREE(pipeline->call.output_buffers);
+   }
+   FREE(pipeline);
+   FREE(io);
+   free_loop_info(chunk_info);
+
    /* Free results pointer array, but not its buffers, since these
       were allocate as output_buffers and extra_buffers */
    if (num_output_buffers > 0) {
@@ -1710,27 +2197,31 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
       loop_options->allocate_buffer_function
          (loop_options->caller_data, FALSE, 
           num_input_buffers, chunk_num_voxels, input_vector_length, 
-          &input_buffers, 
+          &input_buffers[0], 
           num_output_files, block_num_voxels, output_vector_length, 
-          &output_buffers, 
+          &output_buffers[0], 
           num_extra_buffers, chunk_num_voxels, output_vector_length, 
           &extra_buffers, 
           loop_options->loop_info);
    }
    else {
 
-      /* Free input buffers */
-      for (ibuff=0; ibuff < num_input_buffers; ibuff++) {
-         FREE(input_buffers[ibuff]);
-      }
-      FREE(input_buffers);
+      for (iset=0; iset < num_sets; iset++) {
+
+         /* Free input buffers */
+         for (ibuff=0; ibuff < num_input_buffers; ibuff++) {
+            FREE(input_buffers[iset][ibuff]);
+         }
+         FREE(input_buffers[iset]);
 
-      /* Free output buffers */
-      if (num_output_files > 0) {
-         for (ibuff=0; ibuff < num_output_files; ibuff++) {
-            FREE(output_buffers[ibuff]);
+         /* Free output buffers */
+         if (num_output_files > 0) {
+            for (ibuff=0; ibuff < num_output_files; ibuff++) {
+               FREE(output_buffers[iset][ibuff]);
+            }
+            FREE(output_buffers[iset]);
          }
-         FREE(output_buffers);
+
       }
 
       /* Free extra buffers */
@@ -1753,6 +2244,667 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
 
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : use_pipeline_io
+@INPUT      : loop_options - user options for looping
+@OUTPUT     : (none)
+@RETURNS    : TRUE if I/O will be overlapped with the user functions.
+@DESCRIPTION: Routine to decide whether to pipeline I/O. This needs OpenMP
+              and a second set of buffers, which we cannot get from a user 
+              allocate_buffer_function.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int use_pipeline_io(Loop_Options *loop_options)
+{
+#ifdef _OPENMP
+   return (loop_options->pipeline_io && 
+           (loop_options->allocate_buffer_function == NULL));
+#else
+   return FALSE;
+#endif /* _OPENMP */
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : read_loop_inputs
+@INPUT      : pipeline - state of the loop
+              io - what to read
+@OUTPUT     : io->loop_info - shape of a single file read
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to read the current chunk from every input file and
+              dimension index into io->input_buffers, or, if io->all_files
+              is FALSE, from just io->ifile and io->dim_index into the first
+              buffer. Errors are recorded in pipeline->result_code.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : January 10, 1994 (Peter Neelin)
+@MODIFIED   : Oct. 19, 2026 : moved out of do_voxel_loop
+@MODIFIED   : Oct. 19, 2026 : MINC 2.0 volume handles
+---------------------------------------------------------------------------- */
+PRIVATE void read_loop_inputs(Loop_Pipeline *pipeline, Loop_IO *io)
+{
+   Loop_Options *loop_options;
+   Loopfile_Info *loopfile_info;
+   long input_cur[MAX_VAR_DIMS], input_curcount[MAX_VAR_DIMS];
+   int ifile, dim_index, dummy_index, current_input;
+   int input_icvid, input_mincid, loop_dim_index;
+
+   loop_options = pipeline->loop_options;
+   loopfile_info = pipeline->loopfile_info;
+
+   (void) miset_coords(MAX_VAR_DIMS, 0, input_cur);
+   (void) miset_coords(MAX_VAR_DIMS, 0, input_curcount);
+
+   ifile = io->ifile;
+   dim_index = io->dim_index;
+   current_input = 0;
+   for (initialize_file_and_index(loop_options, loopfile_info,
+                                  io->all_files, &ifile, 
+                                  &dim_index, &dummy_index);
+        finish_file_and_index(loop_options, loopfile_info,
+                              io->all_files, ifile, 
+                              dim_index, dummy_index);
+        increment_file_and_index(loop_options, loopfile_info,
+                                 io->all_files, &ifile, 
+                                 &dim_index, &dummy_index)) {
+
+#if MINC2
+      /* Read straight from the volume if we can */
+      if (loopfile_info->use_volumes) {
+         if (get_volume_hyperslab(loopfile_info->input_volume[ifile],
+                                  io->chunk_cur, io->chunk_curcount,
+                                  input_cur, input_curcount,
+                                  io->input_buffers[current_input])
+             != MI_NOERROR) {
+            pipeline->result_code = EXIT_FAILURE;
+         }
+         current_input++;
+         continue;
+      }
+#endif /* MINC2 */
+
+      /* Get input icvid and mincid and translate coords for file */
+      input_icvid = get_input_icvid(loopfile_info, ifile);
+      (void) miicv_inqint(input_icvid, MI_ICV_CDFID, &input_mincid);
+      translate_input_coords(input_mincid, io->chunk_cur, input_cur,
+                             io->chunk_curcount, input_curcount,
+                             &loop_dim_index, loop_options);
+
+      /* Read buffer */
+      input_cur[loop_dim_index] = dim_index;
+      if (miicv_get(input_icvid, input_cur, input_curcount, 
+                    io->input_buffers[current_input]) != MI_NOERROR) {
+         pipeline->result_code = EXIT_FAILURE;
+      }
+
+      current_input++;
+   }
+
+   /* Save the shape, file and index for an accumulating function */
+   if (!io->all_files) {
+      initialize_loop_info(&io->loop_info);
+      set_info_shape(&io->loop_info, input_cur, input_curcount);
+      set_info_current_file(&io->loop_info, ifile);
+      set_info_current_index(&io->loop_info, dim_index);
+      set_info_loopfile_info(&io->loop_info, loopfile_info);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : write_loop_block
+@INPUT      : pipeline - state of the loop
+              block_cur - start of the block
+              block_curcount - count of the block
+              output_set - set of output buffers holding the block
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to write a finished block to the output files, with
+              its image-max and image-min, and to update the global max
+              and min.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : January 10, 1994 (Peter Neelin)
+@MODIFIED   : Oct. 19, 2026 : moved out of do_voxel_loop
+@MODIFIED   : Oct. 19, 2026 : MINC 2.0 volume handles
+---------------------------------------------------------------------------- */
+PRIVATE void write_loop_block(Loop_Pipeline *pipeline, 
+                              long block_cur[], long block_curcount[],
+                              int output_set)
+{
+   Loop_Options *loop_options;
+   Loopfile_Info *loopfile_info;
+   long count[MAX_VAR_DIMS], slice_cur[MAX_VAR_DIMS];
+   long ivox, islice, index, num_slices, slice_values;
+   int ofile, outmincid, maxid, minid, idim;
+   double *data, *slice_data, minimum, maximum;
+
+   loop_options = pipeline->loop_options;
+   loopfile_info = pipeline->loopfile_info;
+
+   for (idim=0; idim < MAX_VAR_DIMS; idim++)
+      count[idim] = block_curcount[idim];
+   if (pipeline->modify_vector_count)
+      count[pipeline->ndims-1] = pipeline->output_vector_length;
+
+   /* A block may be more than one slice thick */
+   num_slices = 1;
+   for (idim=0; idim < pipeline->num_slice_dims; idim++)
+      num_slices *= count[idim];
+   slice_values = 1;
+   for (idim=pipeline->num_slice_dims; idim < pipeline->ndims; idim++)
+      slice_values *= count[idim];
+
+   for (ofile=0; ofile < pipeline->num_output_files; ofile++) {
+      data = pipeline->output_buffers[output_set][ofile];
+
+      if (!loopfile_info->use_volumes) {
+         outmincid = get_output_mincid(loopfile_info, ofile);
+         maxid = ncvarid(outmincid, MIimagemax);
+         minid = ncvarid(outmincid, MIimagemin);
+      }
+
+      for (islice=0; islice < num_slices; islice++) {
+         slice_data = data + islice * slice_values;
+
+         /* Find the max and min */
+         minimum = DBL_MAX;
+         maximum = -DBL_MAX;
+         for (ivox=0; ivox < slice_values; ivox++) {
+            if (slice_data[ivox] != -DBL_MAX) {
+               if (slice_data[ivox] < minimum) minimum = slice_data[ivox];
+               if (slice_data[ivox] > maximum) maximum = slice_data[ivox];
+            }
+         }
+         if ((minimum == DBL_MAX) && (maximum == -DBL_MAX)) {
+            minimum = 0.0;
+            maximum = 0.0;
+         }
+
+         /* Save global min and max */
+         if (minimum < pipeline->global_minimum[ofile]) 
+            pipeline->global_minimum[ofile] = minimum;
+         if (maximum > pipeline->global_maximum[ofile]) 
+            pipeline->global_maximum[ofile] = maximum;
+
+         if (loop_options->is_labels) continue;
+
+         /* Get the start of the slice */
+         for (idim=0; idim < MAX_VAR_DIMS; idim++)
+            slice_cur[idim] = block_cur[idim];
+         index = islice;
+         for (idim=pipeline->num_slice_dims-1; idim >= 0; idim--) {
+            slice_cur[idim] += index % count[idim];
+            index /= count[idim];
+         }
+
+#if MINC2
+         /* Set the slice range in the volume if we can */
+         if (loopfile_info->use_volumes) {
+            if (put_volume_slice_range(loopfile_info->output_volume[ofile],
+                                       slice_cur, minimum, maximum)
+                != MI_NOERROR) {
+               pipeline->result_code = EXIT_FAILURE;
+            }
+            continue;
+         }
+#endif /* MINC2 */
+
+         /* Write out the max and min */
+         (void) mivarput1(outmincid, maxid, slice_cur, 
+                          NC_DOUBLE, NULL, &maximum);
+         (void) mivarput1(outmincid, minid, slice_cur, 
+                          NC_DOUBLE, NULL, &minimum);
+      }
+
+#if MINC2
+      /* Write straight to the volume if we can */
+      if (loopfile_info->use_volumes) {
+         if (put_volume_hyperslab(loop_options, 
+                                  loopfile_info->output_volume[ofile],
+                                  block_cur, count, data)
+             != MI_NOERROR) {
+            pipeline->result_code = EXIT_FAILURE;
+         }
+         continue;
+      }
+#endif /* MINC2 */
+
+      /* Write out the values */
+      (void) miicv_put(get_output_icvid(loopfile_info, ofile), 
+                       block_cur, count, data);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : do_loop_io
+@INPUT      : pipeline - state of the loop
+              do_write - TRUE if the block in pipeline->write_cur should be
+                 written
+              io - what to read, or NULL
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to do the file I/O for one step of the loop. Only
+              ever called from the thread that called voxel_loop.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void do_loop_io(Loop_Pipeline *pipeline, int do_write, Loop_IO *io)
+{
+   if (do_write) {
+      write_loop_block(pipeline, pipeline->write_cur, 
+                       pipeline->write_curcount, pipeline->write_set);
+   }
+   if (io != NULL) {
+      read_loop_inputs(pipeline, io);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : run_loop_step
+@INPUT      : pipeline - state of the loop
+              io - what to read, or NULL
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to do one step of the loop: write the block that is
+              ready to be written, if any, and read what io asks for, while
+              making the pending call to the user function, if any. The
+              I/O is done by the calling thread and the call is split into
+              slabs over the other threads of the team. The call gets no
+              loopfile info, so that the user functions cannot touch the
+              files while they are in use.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void run_loop_step(Loop_Pipeline *pipeline, Loop_IO *io)
+{
+   Loop_Call *call;
+   int do_write, idim;
+#ifdef _OPENMP
+   long num_elements, slab_voxels;
+   int split_dim, num_slabs;
+#endif /* _OPENMP */
+
+   call = &pipeline->call;
+
+   /* Take the block that is ready to be written */
+   do_write = pipeline->write_ready;
+   pipeline->write_ready = FALSE;
+
+   if (!pipeline->call_pending) {
+      do_loop_io(pipeline, do_write, io);
+      return;
+   }
+
+   /* The files are read and written while the call is made, so the user
+      functions must not reach them through get_info_current_mincid or
+      get_info_whole_file */
+   set_info_loopfile_info(&call->loop_info, NULL);
+
+#ifdef _OPENMP
+   num_slabs = get_call_slabs(pipeline->loop_options, call, &split_dim,
+                              &num_elements, &slab_voxels);
+
+#pragma omp parallel num_threads(num_slabs + 1)
+   {
+      int thread, num_workers, islab;
+      long slab_start, slab_end;
+
+      thread = omp_get_thread_num();
+      num_workers = omp_get_num_threads() - 1;
+
+      if (thread == 0)
+         do_loop_io(pipeline, do_write, io);
+
+      if ((thread > 0) || (num_workers == 0)) {
+         if (num_workers == 0) num_workers = 1;
+         for (islab = (thread > 0 ? thread - 1 : 0); islab < num_slabs; 
+              islab += num_workers) {
+            slab_start = (num_elements * islab) / num_slabs;
+            slab_end = (num_elements * (islab+1)) / num_slabs;
+            call_function_on_slab(pipeline->loop_options, call, split_dim,
+                                  slab_start, slab_end - slab_start, 
+                                  slab_voxels);
+         }
+      }
+   }
+#else
+   do_loop_io(pipeline, do_write, io);
+   call_voxel_function(pipeline->loop_options, call);
+#endif /* _OPENMP */
+
+   /* Once the last call for a block is done, it can be written */
+   pipeline->call_pending = FALSE;
+   if (call->ends_block) {
+      pipeline->write_ready = TRUE;
+      pipeline->write_set = call->output_set;
+      for (idim=0; idim < MAX_VAR_DIMS; idim++) {
+         pipeline->write_cur[idim] = call->block_cur[idim];
+         pipeline->write_curcount[idim] = call->block_curcount[idim];
+      }
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : queue_loop_call
+@INPUT      : pipeline - state of the loop
+              function_type - LOOP_VOXEL_FUNCTION, LOOP_START_FUNCTION or
+                 LOOP_FINISH_FUNCTION
+              num_voxels - number of voxels in the chunk
+              input_buffers - input data (NULL for start and finish
+                 functions)
+              results_buffers - output and extra buffers for the chunk
+              loop_info - shape, file and index for the call
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to call a user function on a chunk. Without
+              pipelining the call is made straight away, otherwise it is
+              made during the next step of the loop.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void queue_loop_call(Loop_Pipeline *pipeline, int function_type,
+                             long num_voxels, double *input_buffers[],
+                             double *results_buffers[], 
+                             Loop_Info *loop_info)
+{
+   Loop_Call *call;
+   int ibuff;
+
+   call = &pipeline->call;
+
+   /* Calls are made in order, so finish any that is pending */
+   if (pipeline->call_pending) {
+      run_loop_step(pipeline, NULL);
+   }
+
+   call->function_type = function_type;
+   call->num_voxels = num_voxels;
+   call->input_buffers = input_buffers;
+   for (ibuff=0; ibuff < call->num_output_buffers; ibuff++)
+      call->output_buffers[ibuff] = results_buffers[ibuff];
+   call->loop_info = *loop_info;
+   call->ends_block = FALSE;
+
+   if (pipeline->pipelined) {
+      pipeline->call_pending = TRUE;
+   }
+   else {
+      call_voxel_function(pipeline->loop_options, call);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : end_loop_block
+@INPUT      : pipeline - state of the loop
+              block_cur - start of the block
+              block_curcount - count of the block
+              output_set - set of output buffers holding the block
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to write out a block once all of its calls have been
+              made. Without pipelining it is written straight away,
+              otherwise during the step after its last call.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void end_loop_block(Loop_Pipeline *pipeline, 
+                            long block_cur[], long block_curcount[],
+                            int output_set)
+{
+   Loop_Call *call;
+   int idim;
+
+   if (!pipeline->pipelined) {
+      write_loop_block(pipeline, block_cur, block_curcount, output_set);
+      return;
+   }
+
+   call = &pipeline->call;
+
+   if (pipeline->call_pending) {
+      call->ends_block = TRUE;
+      call->output_set = output_set;
+      for (idim=0; idim < MAX_VAR_DIMS; idim++) {
+         call->block_cur[idim] = block_cur[idim];
+         call->block_curcount[idim] = block_curcount[idim];
+      }
+   }
+   else {
+      if (pipeline->write_ready) {
+         run_loop_step(pipeline, NULL);
+      }
+      pipeline->write_ready = TRUE;
+      pipeline->write_set = output_set;
+      for (idim=0; idim < MAX_VAR_DIMS; idim++) {
+         pipeline->write_cur[idim] = block_cur[idim];
+         pipeline->write_curcount[idim] = block_curcount[idim];
+      }
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_call_slabs
+@INPUT      : loop_options - user options for looping
+              call - the call to split
+@OUTPUT     : split_dim - dimension along which the chunk is split
+              num_elements - number of elements along split_dim
+              slab_voxels - number of voxels in one element along split_dim
+@RETURNS    : number of slabs
+@DESCRIPTION: Routine to split a chunk into at most one slab per thread
+              requested with set_loop_num_threads, along its first dimension
+              with more than one element. The vector dimension, if any, is
+              last and cannot be split.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE int get_call_slabs(Loop_Options *loop_options, Loop_Call *call,
+                           int *split_dim, long *num_elements,
+                           long *slab_voxels)
+{
+   int idim, num_slabs;
+
+   *split_dim = 0;
+   *num_elements = 1;
+   *slab_voxels = call->num_voxels;
+
+   for (idim=0; idim < call->ndims; idim++) {
+      if (call->loop_info.count[idim] > 1) {
+         if ((idim < call->ndims-1) || (call->input_vector_length <= 1)) {
+            *split_dim = idim;
+            *num_elements = call->loop_info.count[idim];
+            *slab_voxels = call->num_voxels / *num_elements;
+            if (*slab_voxels * *num_elements != call->num_voxels) {
+               *num_elements = 1;
+               *slab_voxels = call->num_voxels;
+            }
+         }
+         break;
+      }
+   }
+
+   num_slabs = loop_options->num_threads;
+   if (num_slabs > *num_elements) num_slabs = (int) *num_elements;
+   if (num_slabs < 1) num_slabs = 1;
+
+   return num_slabs;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : call_function_on_slab
+@INPUT      : loop_options - user options for looping
+              call - the call to make
+              split_dim - dimension along which the chunk is split
+              slab_start - first element of the slab along split_dim
+              slab_count - number of elements of the slab along split_dim
+              slab_voxels - number of voxels in one element along split_dim
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to call a user function on one slab of a chunk, with
+              buffer pointers and a Loop_Info describing only that slab.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void call_function_on_slab(Loop_Options *loop_options, 
+                                   Loop_Call *call, int split_dim,
+                                   long slab_start, long slab_count,
+                                   long slab_voxels)
+{
+   Loop_Info *slab_info;
+   double **slab_input, **slab_output;
+   long offset;
+   int ibuff;
+
+   /* Describe the slab */
+   slab_info = MALLOC(1, Loop_Info);
+   *slab_info = call->loop_info;
+   slab_info->start[split_dim] += slab_start;
+   slab_info->count[split_dim] = slab_count;
+   set_info_shape(slab_info, slab_info->start, slab_info->count);
+
+   /* Point into the chunk buffers */
+   offset = slab_start * slab_voxels;
+   slab_input = NULL;
+   slab_output = NULL;
+   if (call->input_buffers != NULL) {
+      slab_input = MALLOC(call->num_input_buffers, double *);
+      for (ibuff=0; ibuff < call->num_input_buffers; ibuff++)
+         slab_input[ibuff] = call->input_buffers[ibuff] + 
+            offset * call->input_vector_length;
+   }
+   if (call->num_output_buffers > 0) {
+      slab_output = MALLOC(call->num_output_buffers, double *);
+      for (ibuff=0; ibuff < call->num_output_buffers; ibuff++)
+         slab_output[ibuff] = call->output_buffers[ibuff] + 
+            offset * call->output_vector_length;
+   }
+
+   make_loop_call(loop_options, call, slab_count * slab_voxels,
+                  slab_input, slab_output, slab_info);
+
+   if (slab_input != NULL) FREE(slab_input);
+   if (slab_output != NULL) FREE(slab_output);
+   FREE(slab_info);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : make_loop_call
+@INPUT      : loop_options - user options for looping
+              call - the call to make
+              num_voxels - number of voxels to pass
+              input_buffers - input buffers to pass
+              output_buffers - output buffers to pass
+              loop_info - loop info to pass
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to call the user function for a call.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void make_loop_call(Loop_Options *loop_options, Loop_Call *call,
+                            long num_voxels, double *input_buffers[],
+                            double *output_buffers[], Loop_Info *loop_info)
+{
+   switch (call->function_type) {
+   case LOOP_START_FUNCTION:
+      loop_options->start_function(loop_options->caller_data,
+                                   num_voxels, call->num_output_buffers,
+                                   call->output_vector_length, 
+                                   output_buffers, loop_info);
+      break;
+   case LOOP_FINISH_FUNCTION:
+      loop_options->finish_function(loop_options->caller_data,
+                                    num_voxels, call->num_output_buffers,
+                                    call->output_vector_length, 
+                                    output_buffers, loop_info);
+      break;
+   default:
+      loop_options->voxel_function(loop_options->caller_data,
+                                   num_voxels, 
+                                   call->num_input_buffers, 
+                                   call->input_vector_length,
+                                   input_buffers,
+                                   call->num_output_buffers, 
+                                   call->output_vector_length,
+                                   output_buffers, loop_info);
+      break;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : call_voxel_function
+@INPUT      : loop_options - user options for looping
+              call - the call to make
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to call a user function on a chunk from the thread
+              that called voxel_loop. If more than one thread was requested
+              with set_loop_num_threads, the function is called concurrently
+              on slabs of the chunk. Slabs are disjoint, so accumulation
+              into the output and extra buffers needs no merging.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+PRIVATE void call_voxel_function(Loop_Options *loop_options, Loop_Call *call)
+{
+   long num_elements, slab_voxels;
+   int split_dim, num_slabs, islab;
+
+   num_slabs = get_call_slabs(loop_options, call, &split_dim,
+                              &num_elements, &slab_voxels);
+
+   /* Call the function on the whole chunk, as we always did */
+   if (num_slabs == 1) {
+      *loop_options->loop_info = call->loop_info;
+      make_loop_call(loop_options, call, call->num_voxels,
+                     call->input_buffers, call->output_buffers,
+                     loop_options->loop_info);
+      set_info_loopfile_info(loop_options->loop_info, NULL);
+      return;
+   }
+
+   /* Call it on each slab in parallel */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(num_slabs) schedule(static,1)
+#endif /* _OPENMP */
+   for (islab=0; islab < num_slabs; islab++) {
+      long slab_start, slab_end;
+
+      slab_start = (num_elements * islab) / num_slabs;
+      slab_end = (num_elements * (islab+1)) / num_slabs;
+      call_function_on_slab(loop_options, call, split_dim,
+                            slab_start, slab_end - slab_start, slab_voxels);
+   }
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : setup_looping
 @INPUT      : loop_options - users options controlling looping
@@ -1764,30 +2916,39 @@ PRIVATE int do_voxel_loop(Loop_Options *loop_options,
               block_num_voxels - number of voxels in block
               chunk_incr - increment for stepping through chunks
               chunk_num_voxels - number of voxels in chunk
+              num_slice_dims - number of dimensions over which the
+                 image-max and image-min vary
 @RETURNS    : (nothing)
 @DESCRIPTION: Routine to set up vectors giving blocks and chunks through
               which we will loop.
-@METHOD     : 
+@METHOD     : Blocks are grown from single slices to whole storage chunks
+              of the first input file along the slice dimensions, 
+              innermost first, as long as the output buffers stay within 
+              half of the copy space. Chunks are then cut on chunk 
+              boundaries where they can be.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : December 2, 1994 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : Oct. 19, 2026 : buffer space for pipelined I/O
+@MODIFIED   : Oct. 19, 2026 : blocks and chunks aligned to file chunks
 ---------------------------------------------------------------------------- */
 PRIVATE void setup_looping(Loop_Options *loop_options, 
                            Loopfile_Info *loopfile_info,
                            int *ndims,
                            long block_start[], long block_end[], 
                            long block_incr[], long *block_num_voxels,
-                           long chunk_incr[], long *chunk_num_voxels)
+                           long chunk_incr[], long *chunk_num_voxels,
+                           int *num_slice_dims)
 {
    int inmincid;
    int total_ndims, scalar_ndims, idim;
    int input_vector_length, output_vector_length;
-   int num_input_buffers;
+   int num_input_buffers, num_output_files;
+   int num_sets;
    int vector_data;
    int nimgdims;
-   long size[MAX_VAR_DIMS];
-   long max_voxels_in_buffer;
+   long size[MAX_VAR_DIMS], file_chunk[MAX_VAR_DIMS];
+   long max_voxels_in_buffer, max_voxels_in_block, incr;
 
    /* Get input mincid */
    inmincid = get_input_mincid(loopfile_info, 0);
@@ -1837,30 +2998,63 @@ PRIVATE void setup_looping(Loop_Options *loop_options,
       chunk_incr[idim] = block_incr[idim];
    }
 
-   /* Figure out chunk size. Enforce a minimum chunk size. */
-   *chunk_num_voxels = 1;
+   /* Grow blocks to whole file chunks along the slice dimensions, keeping 
+      the output buffers within half of the copy space. Pipelined I/O
+      needs two sets of input and output buffers in the same space. */
    num_input_buffers = (loop_options->do_accumulate ? 1 : 
                         loop_options->num_all_inputs);
+   num_sets = (use_pipeline_io(loop_options) ? 2 : 1);
+   get_input_chunk_dims(loop_options, loopfile_info, total_ndims, 
+                        file_chunk);
+   num_output_files = get_output_numfiles(loopfile_info);
+   if (num_output_files < 1) num_output_files = 1;
+   max_voxels_in_block = loop_options->total_copy_space / 
+      ((long) sizeof(double) * 2 * num_sets * num_output_files * 
+       output_vector_length);
+   for (idim=total_ndims-nimgdims-1; idim >= 0; idim--) {
+      incr = (file_chunk[idim] < size[idim] ? file_chunk[idim] : size[idim]);
+      if ((incr <= 1) || 
+          (*block_num_voxels * incr > max_voxels_in_block)) break;
+      *block_num_voxels *= incr;
+      block_incr[idim] = incr;
+   }
+
+   /* Figure out chunk size. Enforce a minimum chunk size. Chunks must
+      fill the block from the end so that they are contiguous in the
+      output buffers. */
+   *chunk_num_voxels = 1;
    max_voxels_in_buffer = 
       (loop_options->total_copy_space/((long) sizeof(double)) - 
-       get_output_numfiles(loopfile_info) * *block_num_voxels *
+       num_sets * get_output_numfiles(loopfile_info) * *block_num_voxels *
        output_vector_length) / 
-          (num_input_buffers * input_vector_length + 
+          (num_sets * num_input_buffers * input_vector_length + 
            loop_options->num_extra_buffers * output_vector_length);
    if (max_voxels_in_buffer < MIN_VOXELS_IN_BUFFER) {
       max_voxels_in_buffer = MIN_VOXELS_IN_BUFFER;
    }
    if (max_voxels_in_buffer > 0) {
       for (idim=scalar_ndims-1; idim >= 0; idim--) {
-         chunk_incr[idim] = max_voxels_in_buffer / *chunk_num_voxels;
-         if (chunk_incr[idim] > block_incr[idim])
+         if (*chunk_num_voxels * block_incr[idim] <= max_voxels_in_buffer) {
             chunk_incr[idim] = block_incr[idim];
+         }
+         else {
+            chunk_incr[idim] = max_voxels_in_buffer / *chunk_num_voxels;
+            if ((file_chunk[idim] > 1) && 
+                (chunk_incr[idim] >= file_chunk[idim]))
+               chunk_incr[idim] -= chunk_incr[idim] % file_chunk[idim];
+            if (chunk_incr[idim] < 1) chunk_incr[idim] = 1;
+            *chunk_num_voxels *= chunk_incr[idim];
+            break;
+         }
          *chunk_num_voxels *= chunk_incr[idim];
       }
+      for (idim--; idim >= 0; idim--)
+         chunk_incr[idim] = 1;
    }
 
    /* Set ndims */
    *ndims = total_ndims;
+   *num_slice_dims = (total_ndims > nimgdims ? total_ndims - nimgdims : 0);
                 
 }
 
@@ -2090,6 +3284,13 @@ PRIVATE Loopfile_Info *initialize_loopfile_info(int num_input_files,
    }
    loopfile_info->current_output_file_number = -1;
 
+#if MINC2
+   /* Volume handles are set up later, if at all */
+   loopfile_info->use_volumes = FALSE;
+   loopfile_info->input_volume = NULL;
+   loopfile_info->output_volume = NULL;
+#endif /* MINC2 */
+
    /* Check for an already open input file */
    if (loop_options->input_mincid != MI_ERROR) {
       loopfile_info->input_mincid[0] = loop_options->input_mincid;
@@ -2147,6 +3348,11 @@ PRIVATE void cleanup_loopfile_info(Loopfile_Info *loopfile_info)
       (void) miclose(loopfile_info->output_mincid[ifile]);
    }
 
+#if MINC2
+   /* Close volume handles */
+   close_volume_handles(loopfile_info);
+#endif /* MINC2 */
+
    /* Free input arrays */
    if (loopfile_info->input_files != NULL)
       FREE(loopfile_info->input_files);
@@ -2765,11 +3971,14 @@ MNCAPI Loop_Options *create_loop_options(void)
    loop_options->loop_info = create_loop_info();
 
    loop_options->allocate_buffer_function = NULL;
+   loop_options->num_threads = 1;
+   loop_options->pipeline_io = FALSE;
 
    loop_options->is_labels = FALSE; /* for backward compatibility*/
    
 #if MINC2
    loop_options->v2format = FALSE; /* Use MINC 2.0 file format (HDF5)? */
+   loop_options->minc2_native = FALSE; /* Use MINC 2.0 volume handles? */
 #endif /* MINC2 */
 
    /* Return the structure pointer */
@@ -2844,6 +4053,33 @@ MNCAPI void set_loop_v2format(Loop_Options *loop_options, int v2format)
 {
    loop_options->v2format = v2format;
 }
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : set_loop_minc2_native
+@INPUT      : loop_options - user options for looping
+              minc2_native - TRUE if MINC 2.0 files should be read and 
+                 written through the MINC 2.0 volume API
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to have voxel data read with miget_real_value_hyperslab
+              and written with miset_real_value_hyperslab rather than 
+              through icv's on the netCDF emulation. This is only done if
+              all input and output files are MINC 2.0 files that can be 
+              opened with miopen_volume, there is no looping dimension and
+              the input is not converted to scalar. Headers are still 
+              handled as before. Input voxels outside of the valid range
+              are not replaced by -DBL_MAX.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+MNCAPI void set_loop_minc2_native(Loop_Options *loop_options, 
+                                  int minc2_native)
+{
+   loop_options->minc2_native = minc2_native;
+}
 #endif /* MINC2 */
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -3207,6 +4443,74 @@ MNCAPI void set_loop_allocate_buffer_function(Loop_Options *loop_options,
    loop_options->allocate_buffer_function = allocate_buffer_function;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : set_loop_num_threads
+@INPUT      : loop_options - user options for looping
+              num_threads - number of threads on which to call the user
+                 functions, or 0 to use all processors.
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to have the voxel, start and finish functions called
+              concurrently on disjoint slabs of each chunk. The functions
+              must then be safe to call from several threads at once, and
+              any information they need about the slab they are working on
+              must come from the loop_info argument. Reading and writing of
+              files is still done by the calling thread. Has no effect 
+              unless the library was built with OpenMP.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+MNCAPI void set_loop_num_threads(Loop_Options *loop_options, 
+                                 int num_threads)
+{
+   if (num_threads < 0) {
+      (void) fprintf(stderr, "Bad num_threads %d in set_loop_num_threads\n",
+                     num_threads);
+      num_threads = 1;
+   }
+
+#ifdef _OPENMP
+   if (num_threads == 0)
+      num_threads = omp_get_num_procs();
+#else
+   num_threads = 1;
+#endif /* _OPENMP */
+
+   loop_options->num_threads = num_threads;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : set_loop_pipeline_io
+@INPUT      : loop_options - user options for looping
+              pipeline_io - TRUE if reading and writing should overlap
+                 with calls to the user functions
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to have the next chunk read, and the previous block
+              written, while the user functions work on the current chunk.
+              Two sets of input and output buffers then share the space
+              given by set_loop_buffer_size. The functions are
+              called from a thread other than the caller's while the
+              files are in use, so they must not read or write the files
+              themselves: get_info_current_mincid and get_info_whole_file
+              return MI_ERROR when called from them. Has no effect
+              unless the library was built with OpenMP, or if
+              set_loop_allocate_buffer_function is used.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+MNCAPI void set_loop_pipeline_io(Loop_Options *loop_options, 
+                                 int pipeline_io)
+{
+   loop_options->pipeline_io = pipeline_io;
+}
+
 /* ------------ Routines to set and get loop info ------------ */
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -3422,7 +4726,10 @@ MNCAPI int get_info_current_file(Loop_Info *loop_info)
 @INPUT      : loop_info - info structure pointer
 @OUTPUT     : (none)
 @RETURNS    : Minc id for current input file (for accumulating over files)
-@DESCRIPTION: Routine to get the current input file mincid.
+              or MI_ERROR if the file is not available
+@DESCRIPTION: Routine to get the current input file mincid. Returns
+              MI_ERROR when called from a voxel function while I/O is
+              pipelined (see set_loop_pipeline_io).
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
@@ -3505,7 +4812,9 @@ PRIVATE void set_info_loopfile_info(Loop_Info *loop_info,
 @RETURNS    : Id of current minc file
 @DESCRIPTION: Routine to change minc file handling to get the whole input 
               file, not just the header (should be called from within the 
-              input_file_function).
+              input_file_function). Returns MI_ERROR when called from a
+              voxel function while I/O is pipelined (see 
+              set_loop_pipeline_io).
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
@@ -259,6 +259,8 @@ MNCAPI void set_loop_clobber(Loop_Options *loop_options,
 #if MINC2
 MNCAPI void set_loop_v2format(Loop_Options *loop_options,
 			      int use_v2_format);
+MNCAPI void set_loop_minc2_native(Loop_Options *loop_options,
+                                  int minc2_native);
 #endif /* MINC2 */
 MNCAPI void set_loop_verbose(Loop_Options *loop_options, 
                              int verbose);
@@ -294,6 +296,13 @@ MNCAPI void set_loop_accumulate(Loop_Options *loop_options,
                                 VoxelFinishFunction finish_function);
 MNCAPI void set_loop_allocate_buffer_function(Loop_Options *loop_options, 
                          AllocateBufferFunction allocate_buffer_function);
+MNCAPI void set_loop_num_threads(Loop_Options *loop_options, 
+                                 int num_threads);
+/* With pipelined I/O the voxel functions run while the files are being
+   read and written, so they must not access the files themselves:
+   get_info_current_mincid and get_info_whole_file return MI_ERROR there */
+MNCAPI void set_loop_pipeline_io(Loop_Options *loop_options, 
+                                 int pipeline_io);
 MNCAPI void set_loop_labels(Loop_Options *loop_options, 
                              int labels);
 
@@ -517,6 +517,12 @@ int miget_volume_real_range(mihandle_t volume, double real_range[])
     double *buffer;
     int i;
 
+#ifdef HAVE_MINC1
+    if (volume->minc1_id >= 0) {
+        return miget_minc1_real_range(volume, real_range);
+    }
+#endif /*HAVE_MINC1*/
+
     /* First find the real minimum.
      */
     spc_id = H5Dget_space(volume->imin_id);
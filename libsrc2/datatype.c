@@ -32,6 +32,11 @@ int miget_data_type_size ( mihandle_t volume, misize_t *voxel_size )
   hid_t type_id;
   hid_t file_id = volume->hdf_id;
 
+  if ( volume->minc1_id >= 0 ) {
+    *voxel_size = mitype_len ( volume->volume_type );
+    return ( MI_NOERROR );
+  }
+
   grp_id = midescend_path ( file_id, MI_FULLIMAGE_PATH );
 
   if ( grp_id < 0 ) {
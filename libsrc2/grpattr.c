@@ -503,6 +503,13 @@ int miget_attr_length ( mihandle_t vol, const char *path, const char *name,
   char fullpath[256];
   int status = MI_ERROR;      /* Guilty until proven innocent */
 
+#ifdef HAVE_MINC1
+  if ( vol->minc1_id >= 0 ) {
+    full_path_for_attr(fullpath, sizeof(fullpath), path, name, vol);
+    return miget_minc1_attr_info ( vol, fullpath, name, NULL, length );
+  }
+#endif /*HAVE_MINC1*/
+
   /* Get a handle to the actual HDF file
    */
   hdf_file = vol->hdf_id;
@@ -591,6 +598,13 @@ int miget_attr_type ( mihandle_t vol, const char *path, const char *name,
   char fullpath[256];
   int status = MI_ERROR;      /* Guilty until proven innocent */
 
+#ifdef HAVE_MINC1
+  if ( vol->minc1_id >= 0 ) {
+    full_path_for_attr(fullpath, sizeof(fullpath), path, name, vol);
+    return miget_minc1_attr_info ( vol, fullpath, name, data_type, NULL );
+  }
+#endif /*HAVE_MINC1*/
+
   /* Get a handle to the actual HDF file
    */
   hdf_file = vol->hdf_id;
@@ -764,6 +778,14 @@ int miget_attr_values ( mihandle_t vol, mitype_t data_type, const char *path,
   
   hsize_t hdf_attr_size = 0;
 
+#ifdef HAVE_MINC1
+  if ( vol->minc1_id >= 0 ) {
+    full_path_for_attr(fullpath, sizeof(fullpath), path, name, vol);
+    return miget_minc1_attr_values ( vol, data_type, fullpath, name,
+                                     length, values );
+  }
+#endif /*HAVE_MINC1*/
+
   /* Get a handle to the actual HDF file
    */
   hdf_file = vol->hdf_id;
@@ -20,6 +20,21 @@
 #define MIRW_OP_READ 1
 #define MIRW_OP_WRITE 2
 
+#ifdef HAVE_MINC1
+/* Conversions of the voxels read from a MINC 1.0 volume */
+#define MIRW_MINC1_VOXEL 0
+#define MIRW_MINC1_REAL 1
+#define MIRW_MINC1_NORMALIZED 2
+
+static int mirw_hyperslab_minc1(int opcode, int conversion,
+                                mihandle_t volume,
+                                mitype_t buffer_data_type,
+                                const misize_t start[],
+                                const misize_t count[],
+                                double data_min, double data_max,
+                                void *buffer);
+#endif /*HAVE_MINC1*/
+
 #ifndef HAVE_COPYSIGN
 double
 copysign(double x, double y)
@@ -190,6 +205,13 @@ static int mirw_hyperslab_raw(int opcode,
   char path[MI2_MAX_PATH];
   size_t icount[MI2_MAX_VAR_DIMS];
 
+#ifdef HAVE_MINC1
+  if (volume->minc1_id >= 0) {
+    return mirw_hyperslab_minc1(opcode, MIRW_MINC1_VOXEL, volume, midatatype,
+                                start, count, 0.0, 0.0, buffer);
+  }
+#endif /*HAVE_MINC1*/
+
   /* Disallow write operations to anything but the highest resolution.
    */
   if (opcode == MIRW_OP_WRITE && volume->selected_resolution != 0) {
@@ -401,6 +423,13 @@ static int mirw_hyperslab_icv(int opcode,
   hsize_t i;
   int j;
 
+#ifdef HAVE_MINC1
+  if (volume->minc1_id >= 0) {
+    return mirw_hyperslab_minc1(opcode, MIRW_MINC1_REAL, volume,
+                                buffer_data_type, start, count, 0.0, 0.0,
+                                buffer);
+  }
+#endif /*HAVE_MINC1*/
 
   /* Disallow write operations to anything but the highest resolution.
    */
@@ -841,6 +870,194 @@ cleanup:
 
 
 
+#ifdef HAVE_MINC1
+/** Read a hyperslab of a MINC 1.0 volume, read in place (see
+ * miopen_minc1_volume()). The voxels come from the netCDF image variable
+ * in file order, are rescaled as the HDF5 paths above rescale them, with
+ * the same slice ranges, and are then reordered into the apparent order.
+ */
+static int mirw_hyperslab_minc1(int opcode, int conversion,
+                                mihandle_t volume,
+                                mitype_t buffer_data_type,
+                                const misize_t start[],
+                                const misize_t count[],
+                                double data_min, double data_max,
+                                void *buffer)
+{
+  hsize_t hdf_start[MI2_MAX_VAR_DIMS];
+  hsize_t hdf_count[MI2_MAX_VAR_DIMS];
+  int dir[MI2_MAX_VAR_DIMS];  /* Direction vector in file order */
+  size_t icount[MI2_MAX_VAR_DIMS];
+  int ndims = volume->number_of_dims;
+  int n_different;
+  int slice_ndims = 0;
+  int is_float;
+  double volume_valid_min, volume_valid_max;
+  double *image_slice_max_buffer = NULL;
+  double *image_slice_min_buffer = NULL;
+  double *temp_buffer = NULL;
+  hsize_t image_slice_length = 1;
+  hsize_t total_number_of_slices = 1;
+  int result = MI_ERROR;
+  int i;
+
+  if (opcode == MIRW_OP_WRITE) {
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Trying to write to a MINC 1.0 volume");
+  }
+  if (buffer_data_type == MI_TYPE_UNKNOWN) {
+    buffer_data_type = volume->volume_type;
+  }
+
+  n_different = mitranslate_hyperslab_origin(volume, start, count, hdf_start, hdf_count, dir);
+
+  miget_volume_valid_range(volume, &volume_valid_max, &volume_valid_min);
+
+  /*Floating point volumes are not slice scaled, as in MINC1*/
+  is_float = (volume->volume_type == MI_TYPE_FLOAT ||
+              volume->volume_type == MI_TYPE_DOUBLE);
+
+  if (conversion != MIRW_MINC1_VOXEL) {
+    if (volume->has_slice_scaling && !is_float) {
+      slice_ndims = volume->minc1_slice_ndims;
+    }
+    for (i = 0; i < slice_ndims; i++) {
+      total_number_of_slices *= hdf_count[i];
+    }
+    for (i = slice_ndims; i < ndims; i++) {
+      image_slice_length *= hdf_count[i];
+    }
+
+    image_slice_max_buffer = malloc(total_number_of_slices * sizeof(double));
+    image_slice_min_buffer = malloc(total_number_of_slices * sizeof(double));
+    if (image_slice_max_buffer == NULL || image_slice_min_buffer == NULL) {
+      MI_LOG_ERROR(MI2_MSG_OUTOFMEM,total_number_of_slices*sizeof(double));
+      goto cleanup;
+    }
+
+    if (slice_ndims > 0) {
+      if (miread_minc1_scale(volume, volume->minc1_imax_id, hdf_start,
+                             hdf_count, image_slice_max_buffer) < 0 ||
+          miread_minc1_scale(volume, volume->minc1_imin_id, hdf_start,
+                             hdf_count, image_slice_min_buffer) < 0) {
+        goto cleanup;
+      }
+    } else {
+      *image_slice_max_buffer = volume->scale_max;
+      *image_slice_min_buffer = volume->scale_min;
+    }
+  }
+
+  if (conversion == MIRW_MINC1_NORMALIZED) {
+    temp_buffer = malloc(total_number_of_slices * image_slice_length * sizeof(double));
+    if (temp_buffer == NULL) {
+      MI_LOG_ERROR(MI2_MSG_OUTOFMEM,total_number_of_slices*image_slice_length*sizeof(double));
+      goto cleanup;
+    }
+    if (miread_minc1_voxels(volume, MI_TYPE_DOUBLE, hdf_start, hdf_count,
+                            temp_buffer) < 0) {
+      goto cleanup;
+    }
+
+    switch(buffer_data_type)
+    {
+      case MI_TYPE_FLOAT:
+        APPLY_DESCALING_NORM(float,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,0.0f,1.0f);
+        break;
+      case MI_TYPE_DOUBLE:
+        APPLY_DESCALING_NORM(double,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,0.0,1.0);
+        break;
+      case MI_TYPE_INT:
+        APPLY_DESCALING_NORM(int,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,INT_MIN,INT_MAX);
+        break;
+      case MI_TYPE_UINT:
+        APPLY_DESCALING_NORM(unsigned int,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,0,UINT_MAX);
+        break;
+      case MI_TYPE_SHORT:
+        APPLY_DESCALING_NORM(short,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,SHRT_MIN,SHRT_MAX);
+        break;
+      case MI_TYPE_USHORT:
+        APPLY_DESCALING_NORM(unsigned short,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,0,USHRT_MAX);
+        break;
+      case MI_TYPE_BYTE:
+        APPLY_DESCALING_NORM(char,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,SCHAR_MIN,SCHAR_MAX);
+        break;
+      case MI_TYPE_UBYTE:
+        APPLY_DESCALING_NORM(unsigned char,temp_buffer,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max,data_min,data_max,0,UCHAR_MAX);
+        break;
+      default:
+        MI_LOG_ERROR(MI2_MSG_BADTYPE,buffer_data_type);
+        goto cleanup;
+    }
+  } else {
+    if (miread_minc1_voxels(volume, buffer_data_type, hdf_start, hdf_count,
+                            buffer) < 0) {
+      goto cleanup;
+    }
+
+    /*unity scaling needs no conversion*/
+    if (conversion == MIRW_MINC1_REAL && !is_float &&
+        (slice_ndims > 0 ||
+         *image_slice_max_buffer != volume_valid_max ||
+         *image_slice_min_buffer != volume_valid_min)) {
+      switch(buffer_data_type)
+      {
+        case MI_TYPE_FLOAT:
+          APPLY_DESCALING(float,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        case MI_TYPE_DOUBLE:
+          APPLY_DESCALING(double,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        case MI_TYPE_INT:
+          APPLY_DESCALING(int,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        case MI_TYPE_UINT:
+          APPLY_DESCALING(unsigned int,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        case MI_TYPE_SHORT:
+          APPLY_DESCALING(short,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        case MI_TYPE_USHORT:
+          APPLY_DESCALING(unsigned short,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        case MI_TYPE_BYTE:
+          APPLY_DESCALING(char,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        case MI_TYPE_UBYTE:
+          APPLY_DESCALING(unsigned char,buffer,image_slice_length,total_number_of_slices,image_slice_min_buffer,image_slice_max_buffer,volume_valid_min,volume_valid_max);
+          break;
+        default:
+          MI_LOG_ERROR(MI2_MSG_BADTYPE,buffer_data_type);
+          goto cleanup;
+      }
+    }
+  }
+
+  /* Restructure the array after reading the data in file orientation.
+   */
+  if (n_different != 0) {
+    for (i = 0; i < ndims; i++) {
+      icount[i] = count[i];
+    }
+    restructure_array(ndims, buffer, icount, mitype_len(buffer_data_type),
+                      volume->dim_indices, dir);
+  }
+  result = MI_NOERROR;
+
+cleanup:
+  if (temp_buffer != NULL) {
+    free(temp_buffer);
+  }
+  if (image_slice_min_buffer != NULL) {
+    free(image_slice_min_buffer);
+  }
+  if (image_slice_max_buffer != NULL) {
+    free(image_slice_max_buffer);
+  }
+  return (result);
+}
+#endif /*HAVE_MINC1*/
+
+
 /** Read/write a hyperslab of data, performing dimension remapping
  * and data rescaling as needed. Data in the range (min-max) will map to the appropriate full range of buffer_data_type
  */
@@ -884,6 +1101,13 @@ static int mirw_hyperslab_normalized(int opcode,
   hsize_t i;
   int j;
 
+#ifdef HAVE_MINC1
+  if (volume->minc1_id >= 0) {
+    return mirw_hyperslab_minc1(opcode, MIRW_MINC1_NORMALIZED, volume,
+                                buffer_data_type, start, count,
+                                data_min, data_max, buffer);
+  }
+#endif /*HAVE_MINC1*/
 
   /* Disallow write operations to anything but the highest resolution.
    */
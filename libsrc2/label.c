@@ -16,30 +16,10 @@
 #include <hdf5.h>
 #include "minc2.h"
 #include "minc2_private.h"
+#include "swap_convert.h"
 
 #define MI_LABEL_MAX 128
 
-static int miswap2(unsigned short tmp)
-{
-    unsigned char *x = (unsigned char *) &tmp;
-    unsigned char t = x[0];
-    x[0] = x[1];
-    x[1] = t;
-    return (tmp);
-}
-
-static int miswap4(unsigned int tmp)
-{
-    unsigned char *x = (unsigned char *) &tmp;
-    unsigned char t = x[0];
-    x[0] = x[3];
-    x[3] = t;
-    t = x[1];
-    x[1] = x[2];
-    x[2] = t;
-    return (tmp);
-}
-
 /**
  * This function associates a label name with an integer value for the given
  * volume. Functions which read and write voxel values will read/write 
@@ -76,10 +56,14 @@ int  midefine_label(mihandle_t volume, int value, const char *name)
     if (H5Tget_order(volume->ftype_id) != H5Tget_order(volume->mtype_id)) {
         switch (H5Tget_size(volume->ftype_id)) {
         case 2:
-            value = miswap2((unsigned short) value);
+            {
+                unsigned short tmp = (unsigned short) value;
+                minc_swap_bytes(&tmp, 1, sizeof(tmp));
+                value = tmp;
+            }
             break;
         case 4:
-            value = miswap4((unsigned int) value);
+            minc_swap_bytes(&value, 1, sizeof(value));
             break;
         }
     }
@@ -17,6 +17,7 @@
 
 #include "minc2.h"
 #include "minc2_private.h"
+#include "swap_convert.h"
 
 #ifndef HAVE_RINT
 double rint(double v)
@@ -398,6 +399,13 @@ int miget_attribute ( mihandle_t volume, const char *path, const char *name,
   hid_t hdf_attr = -1;
   int status = MI_ERROR;      /* Guilty until proven innocent */
 
+#ifdef HAVE_MINC1
+  if ( volume->minc1_id >= 0 ) {
+    return miget_minc1_attr_values ( volume, data_type, path, name,
+                                     length, values );
+  }
+#endif /*HAVE_MINC1*/
+
   /* Get a handle to the actual HDF file
   */
   hdf_file = volume->hdf_id;
@@ -660,47 +668,46 @@ void mitransform_coord ( double out_coord[],
 */
 static int rounding_enabled = FALSE;
 
-static void miswap8 ( unsigned char *tmp_ptr )
-{
-  unsigned char x;
-
-  x = tmp_ptr[0];
-  tmp_ptr[0] = tmp_ptr[7];
-  tmp_ptr[7] = x;
-
-  x = tmp_ptr[1];
-  tmp_ptr[1] = tmp_ptr[6];
-  tmp_ptr[6] = x;
-
-  x = tmp_ptr[2];
-  tmp_ptr[2] = tmp_ptr[5];
-  tmp_ptr[5] = x;
-
-  x = tmp_ptr[3];
-  tmp_ptr[3] = tmp_ptr[4];
-  tmp_ptr[4] = x;
-}
-
-static void miswap4 ( unsigned char *tmp_ptr )
+/** Returns the value type of an HDF5 integer type of the given size and
+ * sign.
+ */
+static minc_value_type mi2_int_value_type ( size_t nb, H5T_sign_t sg )
 {
-  unsigned char x;
-
-  x = tmp_ptr[0];
-  tmp_ptr[0] = tmp_ptr[3];
-  tmp_ptr[3] = x;
-
-  x = tmp_ptr[1];
-  tmp_ptr[1] = tmp_ptr[2];
-  tmp_ptr[2] = x;
+  switch ( nb ) {
+  case 1:
+    return ( sg == H5T_SGN_2 ? MINC_VALUE_BYTE : MINC_VALUE_UBYTE );
+  case 2:
+    return ( sg == H5T_SGN_2 ? MINC_VALUE_SHORT : MINC_VALUE_USHORT );
+  default:
+    return ( sg == H5T_SGN_2 ? MINC_VALUE_INT : MINC_VALUE_UINT );
+  }
 }
 
-static void miswap2 ( unsigned char *tmp_ptr )
+/** Converts the elements of an HDF5 conversion buffer in place.
+ *
+ * The logic of HDF5 seems to be that if a stride is specified,
+ * both the source and destination pointers should advance by that
+ * amount.  This seems wrong to me, but I've examined the HDF5 sources
+ * and that's what their own type converters do.
+ */
+static void mi2_convert_buffer ( void *buf_ptr,
+                                 size_t nelements,
+                                 size_t buf_stride,
+                                 minc_value_type dst_type,
+                                 minc_value_type src_type,
+                                 int flags )
 {
-  unsigned char x;
+  unsigned char *ptr = ( unsigned char * ) buf_ptr;
 
-  x = tmp_ptr[0];
-  tmp_ptr[0] = tmp_ptr[1];
-  tmp_ptr[1] = x;
+  if ( buf_stride == 0 ) {
+    minc_swap_convert ( buf_ptr, dst_type, buf_ptr, src_type, nelements,
+                        flags );
+  } else {
+    while ( nelements-- > 0 ) {
+      minc_swap_convert ( ptr, dst_type, ptr, src_type, 1, flags );
+      ptr += buf_stride;
+    }
+  }
 }
 
 /** Generic HDF5 integer-to-double converter.
@@ -716,16 +723,10 @@ static herr_t mi2_int_to_dbl ( hid_t src_id,
                                void *bkg_ptr,
                                hid_t dset_xfer_plist )
 {
-  unsigned char *dst_ptr;
-  unsigned char *src_ptr;
   size_t src_nb;
   size_t dst_nb;
   H5T_sign_t src_sg;
-  double t;
-  size_t dst_cnt;
-  size_t src_cnt;
-  int src_swap;
-  int dst_swap;
+  int flags;
 
   switch ( cdata->command ) {
   case H5T_CONV_INIT:
@@ -747,153 +748,18 @@ static herr_t mi2_int_to_dbl ( hid_t src_id,
   case H5T_CONV_CONV:
     src_nb = H5Tget_size ( src_id );
     src_sg = H5Tget_sign ( src_id );
-    dst_nb = H5Tget_size ( dst_id );
-
-    if ( buf_stride == 0 ) {
-      dst_cnt = dst_nb;
-      src_cnt = src_nb;
-    } else {
-      dst_cnt = buf_stride;
-      src_cnt = buf_stride;
-    }
-
-    /* Convert starting from "far side" of buffer... (Hope this works!)
-    */
-    dst_ptr = ( ( unsigned char * ) buf_ptr ) + ( ( nelements - 1 ) * dst_nb );
-    src_ptr = ( ( unsigned char * ) buf_ptr ) + ( ( nelements - 1 ) * src_nb );
+    flags = 0;
 
     if ( H5Tget_order ( H5T_NATIVE_INT ) != H5Tget_order ( src_id ) ) {
-      src_swap = 1;
-    } else {
-      src_swap = 0;
+      flags |= MINC_SWAP_SRC;
     }
 
     if ( H5Tget_order ( H5T_NATIVE_DOUBLE ) != H5Tget_order ( dst_id ) ) {
-      dst_swap = 1;
-    } else {
-      dst_swap = 0;
-    }
-
-    if ( src_sg == H5T_SGN_2 ) {
-      switch ( src_nb ) {
-      case 4:
-
-        while ( nelements-- > 0 ) {
-          if ( src_swap ) {
-            miswap4 ( src_ptr );
-          }
-
-          t = * ( int * ) src_ptr;
-          * ( double * ) dst_ptr = t;
-
-          if ( dst_swap ) {
-            miswap8 ( dst_ptr );
-          }
-
-          src_ptr -= src_cnt;
-          dst_ptr -= dst_cnt;
-        }
-
-        break;
-      case 2:
-
-        while ( nelements-- > 0 ) {
-          if ( src_swap ) {
-            miswap2 ( src_ptr );
-          }
-
-          t = * ( short * ) src_ptr;
-          * ( double * ) dst_ptr = t;
-
-          if ( dst_swap ) {
-            miswap8 ( dst_ptr );
-          }
-
-          src_ptr -= src_cnt;
-          dst_ptr -= dst_cnt;
-        }
-
-        break;
-      case 1:
-
-        while ( nelements-- > 0 ) {
-          t = * ( char * ) src_ptr;
-          * ( double * ) dst_ptr = t;
-
-          if ( dst_swap ) {
-            miswap8 ( dst_ptr );
-          }
-
-          src_ptr -= src_cnt;
-          dst_ptr -= dst_cnt;
-        }
-
-        break;
-      default:
-        /* Should not happen! */
-        break;
-      }
-    } else {
-      switch ( src_nb ) {
-      case 4:
-
-        while ( nelements-- > 0 ) {
-          if ( src_swap ) {
-            miswap4 ( src_ptr );
-          }
-
-          t = * ( unsigned int * ) src_ptr;
-          * ( double * ) dst_ptr = t;
-
-          if ( dst_swap ) {
-            miswap8 ( dst_ptr );
-          }
-
-          src_ptr -= src_cnt;
-          dst_ptr -= dst_cnt;
-        }
-
-        break;
-      case 2:
-
-        while ( nelements-- > 0 ) {
-          if ( src_swap ) {
-            miswap2 ( src_ptr );
-          }
-
-          t = * ( unsigned short * ) src_ptr;
-          * ( double * ) dst_ptr = t;
-
-          if ( dst_swap ) {
-            miswap8 ( dst_ptr );
-          }
-
-          src_ptr -= src_cnt;
-          dst_ptr -= dst_cnt;
-        }
-
-        break;
-      case 1:
-
-        while ( nelements-- > 0 ) {
-          t = * ( unsigned char * ) src_ptr;
-          * ( double * ) dst_ptr = t;
-
-          if ( dst_swap ) {
-            miswap8 ( dst_ptr );
-          }
-
-          src_ptr -= src_cnt;
-          dst_ptr -= dst_cnt;
-        }
-
-        break;
-      default:
-        /* Should not happen! */
-        break;
-      }
+      flags |= MINC_SWAP_DST;
     }
 
+    mi2_convert_buffer ( buf_ptr, nelements, buf_stride, MINC_VALUE_DOUBLE,
+                         mi2_int_value_type ( src_nb, src_sg ), flags );
     break;
 
   case H5T_CONV_FREE:
@@ -919,16 +785,10 @@ static herr_t mi2_dbl_to_int ( hid_t src_id,
                                void *bkg_ptr,
                                hid_t dset_xfer_plist )
 {
-  unsigned char *dst_ptr;
-  unsigned char *src_ptr;
   size_t src_nb;
   size_t dst_nb;
   H5T_sign_t dst_sg;
-  double t;
-  size_t dst_cnt;
-  size_t src_cnt;
-  int src_swap;
-  int dst_swap;
+  int flags;
 
   switch ( cdata->command ) {
   case H5T_CONV_INIT:
@@ -952,371 +812,21 @@ static herr_t mi2_dbl_to_int ( hid_t src_id,
   case H5T_CONV_CONV:
     dst_nb = H5Tget_size ( dst_id );
     dst_sg = H5Tget_sign ( dst_id );
-    src_nb = H5Tget_size ( src_id );
-    dst_ptr = ( unsigned char * ) buf_ptr;
-    src_ptr = ( unsigned char * ) buf_ptr;
+    flags = rounding_enabled ? MINC_ROUND : 0;
 
     if ( H5Tget_order ( H5T_NATIVE_DOUBLE ) != H5Tget_order ( src_id ) ) {
-      src_swap = 1;
-    } else {
-      src_swap = 0;
+      flags |= MINC_SWAP_SRC;
     }
 
     if ( H5Tget_order ( H5T_NATIVE_INT ) != H5Tget_order ( dst_id ) ) {
-      dst_swap = 1;
-    } else {
-      dst_swap = 0;
+      flags |= MINC_SWAP_DST;
     }
 
-    /* The logic of HDF5 seems to be that if a stride is specified,
-    * both the source and destination pointers should advance by that
-    * amount.  This seems wrong to me, but I've examined the HDF5 sources
-    * and that's what their own type converters do.
+    /* Values outside of the range of the integer type are clamped.
     */
-    if ( buf_stride == 0 ) {
-      dst_cnt = dst_nb;
-      src_cnt = src_nb;
-    } else {
-      dst_cnt = buf_stride;
-      src_cnt = buf_stride;
-    }
-
-    if ( rounding_enabled ) {
-      if ( dst_sg == H5T_SGN_2 ) {
-        switch ( dst_nb ) {
-        case 4:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = rint ( * ( double * ) src_ptr );
-
-            if ( t > INT_MAX ) {
-              t = INT_MAX;
-            } else
-              if ( t < INT_MIN ) {
-                t = INT_MIN;
-              }
-
-            * ( ( int * ) dst_ptr ) = ( int ) t;
-
-            if ( dst_swap ) {
-              miswap4 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        case 2:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = rint ( * ( double * ) src_ptr );
-
-            if ( t > SHRT_MAX ) {
-              t = SHRT_MAX;
-            } else
-              if ( t < SHRT_MIN ) {
-                t = SHRT_MIN;
-              }
-
-            * ( ( short * ) dst_ptr ) = ( short ) t;
-
-            if ( dst_swap ) {
-              miswap2 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        case 1:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = rint ( * ( double * ) src_ptr );
-
-            if ( t > CHAR_MAX ) {
-              t = CHAR_MAX;
-            } else
-              if ( t < CHAR_MIN ) {
-                t = CHAR_MIN;
-              }
-
-            * ( ( char * ) src_ptr ) = ( char ) t;
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        default:
-          /* Can't handle this! */
-          break;
-        }
-      } else {
-        switch ( dst_nb ) {
-        case 4:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = rint ( * ( double * ) src_ptr );
-
-            if ( t > UINT_MAX ) {
-              t = UINT_MAX;
-            } else
-              if ( t < 0 ) {
-                t = 0;
-              }
-
-            * ( ( unsigned int * ) dst_ptr ) = ( unsigned int ) t;
-
-            if ( dst_swap ) {
-              miswap4 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-
-        case 2:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = rint ( * ( double * ) src_ptr );
-
-            if ( t > USHRT_MAX ) {
-              t = USHRT_MAX;
-            } else
-              if ( t < 0 ) {
-                t = 0;
-              }
-
-            * ( ( unsigned short * ) dst_ptr ) = ( unsigned short ) t;
-
-            if ( dst_swap ) {
-              miswap2 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        case 1:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = rint ( * ( double * ) src_ptr );
-
-            if ( t > UCHAR_MAX ) {
-              t = UCHAR_MAX;
-            } else
-              if ( t < 0 ) {
-                t = 0;
-              }
-
-            * ( ( unsigned char * ) dst_ptr ) = ( unsigned char ) t;
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        default:
-          /* Can't handle any other values */
-          break;
-        }
-      }
-    } else {
-      if ( dst_sg == H5T_SGN_2 ) {
-        switch ( dst_nb ) {
-        case 4:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = ( int ) ( * ( double * ) src_ptr );
-
-            if ( t > INT_MAX ) {
-              t = INT_MAX;
-            } else
-              if ( t < INT_MIN ) {
-                t = INT_MIN;
-              }
-
-            * ( ( int * ) dst_ptr ) = ( int ) t;
-
-            if ( dst_swap ) {
-              miswap4 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        case 2:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = ( int ) ( * ( double * ) src_ptr );
-
-            if ( t > SHRT_MAX ) {
-              t = SHRT_MAX;
-            } else
-              if ( t < SHRT_MIN ) {
-                t = SHRT_MIN;
-              }
-
-            * ( ( short * ) dst_ptr ) = ( short ) t;
-
-            if ( dst_swap ) {
-              miswap4 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        case 1:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = ( int ) ( * ( double * ) src_ptr );
-
-            if ( t > CHAR_MAX ) {
-              t = CHAR_MAX;
-            } else
-              if ( t < CHAR_MIN ) {
-                t = CHAR_MIN;
-              }
-
-            * ( ( char * ) src_ptr ) = ( char ) t;
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        default:
-          /* Can't handle this! */
-          break;
-        }
-      } else {
-        switch ( dst_nb ) {
-        case 4:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = ( int ) ( * ( double * ) src_ptr );
-
-            if ( t > UINT_MAX ) {
-              t = UINT_MAX;
-            } else
-              if ( t < 0 ) {
-                t = 0;
-              }
-
-            * ( ( unsigned int * ) dst_ptr ) = ( unsigned int ) t;
-
-            if ( dst_swap ) {
-              miswap4 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-
-        case 2:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = ( int ) ( * ( double * ) src_ptr );
-
-            if ( t > USHRT_MAX ) {
-              t = USHRT_MAX;
-            } else
-              if ( t < 0 ) {
-                t = 0;
-              }
-
-            * ( ( unsigned short * ) dst_ptr ) = ( unsigned short ) t;
-
-            if ( dst_swap ) {
-              miswap2 ( dst_ptr );
-            }
-
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        case 1:
-
-          while ( nelements-- > 0 ) {
-            if ( src_swap ) {
-              miswap8 ( src_ptr );
-            }
-
-            t = ( int ) ( * ( double * ) src_ptr );
-
-            if ( t > UCHAR_MAX ) {
-              t = UCHAR_MAX;
-            } else
-              if ( t < 0 ) {
-                t = 0;
-              }
-
-            * ( ( unsigned char * ) dst_ptr ) = ( unsigned char ) t;
-            dst_ptr += dst_cnt;
-            src_ptr += src_cnt;
-          }
-
-          break;
-        default:
-          /* Can't handle any other values */
-          break;
-        }
-      }
-    }
-
+    mi2_convert_buffer ( buf_ptr, nelements, buf_stride,
+                         mi2_int_value_type ( dst_nb, dst_sg ),
+                         MINC_VALUE_DOUBLE, flags );
     break;
 
   case H5T_CONV_FREE:
@@ -1357,7 +867,6 @@ static herr_t mi2_int_to_int ( hid_t src_id,
 			       hid_t dset_xfer_plist )
 {
   unsigned char *dst_ptr;
-  size_t dst_cnt;
   size_t dst_sz;
 
   switch ( cdata->command ) {
@@ -1374,40 +883,17 @@ static herr_t mi2_int_to_int ( hid_t src_id,
       return 0;			/* Nothing to do. */
     }
 
-    /* The logic of HDF5 seems to be that if a stride is specified,
-    * both the source and destination pointers should advance by that
-    * amount.  This seems wrong to me, but I've examined the HDF5 sources
-    * and that's what their own type converters do.
-    */
-    if ( buf_stride == 0 ) {
-      dst_cnt = dst_sz;
-    } else {
-      dst_cnt = buf_stride;
+    if ( dst_sz != 1 && dst_sz != 2 && dst_sz != 4 && dst_sz != 8 ) {
+      return (-1);
     }
 
-    switch ( dst_sz ) {
-    case 8:
-      while ( nelements-- > 0 ) {
-	miswap8 ( dst_ptr );
-	dst_ptr += dst_cnt;
-      }
-      break;
-    case 4:
-      while ( nelements-- > 0 ) {
-	miswap4 ( dst_ptr );
-	dst_ptr += dst_cnt;
-      }
-      break;
-    case 2:
+    if ( buf_stride == 0 ) {
+      minc_swap_bytes ( dst_ptr, nelements, dst_sz );
+    } else {
       while ( nelements-- > 0 ) {
-	miswap2 ( dst_ptr );
-	dst_ptr += dst_cnt;
+	minc_swap_bytes ( dst_ptr, 1, dst_sz );
+	dst_ptr += buf_stride;
       }
-      break;
-    case 1:
-      break;
-    default:
-      return (-1);
     }
     break;
 
@@ -0,0 +1,553 @@
+/**
+ * \file minc1_volume.c
+ * \brief MINC 2.0 access to MINC 1.0 (netCDF) volumes.
+ *
+ * When miopen_volume() cannot open a file as HDF5, it reads it here as a
+ * MINC 1.0 file, in place. The volume handle gets its dimensions, type,
+ * valid range and scaling from the netCDF image variable, and the voxels,
+ * slice ranges and attributes are only read from the netCDF file when
+ * they are asked for, rather than copying the whole file into a
+ * temporary MINC 2.0 file first. Such volumes are read-only.
+ ************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <hdf5.h>
+#include "minc.h"
+#include "minc2.h"
+#include "minc2_private.h"
+
+/** Get the MINC 2.0 type of the values of a netCDF variable.
+ */
+static mitype_t minc1_to_mitype(nc_type datatype, int is_signed)
+{
+  switch (datatype) {
+  case NC_BYTE:
+    return (is_signed ? MI_TYPE_BYTE : MI_TYPE_UBYTE);
+  case NC_SHORT:
+    return (is_signed ? MI_TYPE_SHORT : MI_TYPE_USHORT);
+  case NC_INT:
+    return (is_signed ? MI_TYPE_INT : MI_TYPE_UINT);
+  case NC_FLOAT:
+    return (MI_TYPE_FLOAT);
+  case NC_DOUBLE:
+    return (MI_TYPE_DOUBLE);
+  default:
+    return (MI_TYPE_UNKNOWN);
+  }
+}
+
+/** Get the netCDF type and sign to read values of a MINC 2.0 type,
+ * or NC_NAT if there is none.
+ */
+static nc_type mitype_to_minc1(mitype_t data_type, const char **sign)
+{
+  *sign = MI_SIGNED;
+
+  switch (data_type) {
+  case MI_TYPE_UBYTE:
+    *sign = MI_UNSIGNED;
+    /* fall through */
+  case MI_TYPE_BYTE:
+    return (NC_BYTE);
+  case MI_TYPE_USHORT:
+    *sign = MI_UNSIGNED;
+    /* fall through */
+  case MI_TYPE_SHORT:
+    return (NC_SHORT);
+  case MI_TYPE_UINT:
+    *sign = MI_UNSIGNED;
+    /* fall through */
+  case MI_TYPE_INT:
+    return (NC_INT);
+  case MI_TYPE_FLOAT:
+    return (NC_FLOAT);
+  case MI_TYPE_DOUBLE:
+    return (NC_DOUBLE);
+  default:
+    return (NC_NAT);
+  }
+}
+
+/** Read all the values of a one-dimensional variable, as the offsets
+ * or widths of an irregular dimension.
+ */
+static double *miget_minc1_dim_values(int fd, const char *varname,
+                                      misize_t length)
+{
+  int varid;
+  int ndims;
+  long start = 0;
+  long count = (long) length;
+  double *values;
+
+  varid = ncvarid(fd, varname);
+  if (varid == MI_ERROR ||
+      ncvarinq(fd, varid, NULL, NULL, &ndims, NULL, NULL) == MI_ERROR ||
+      ndims != 1) {
+    return (NULL);
+  }
+
+  values = (double *) malloc(length * sizeof(double));
+  if (values == NULL) {
+    MI_LOG_ERROR(MI2_MSG_OUTOFMEM, length * sizeof(double));
+    return (NULL);
+  }
+  if (mivarget(fd, varid, &start, &count, NC_DOUBLE, MI_SIGNED,
+               values) == MI_ERROR) {
+    free(values);
+    return (NULL);
+  }
+  return (values);
+}
+
+/** Make a dimension handle from a netCDF dimension and its dimension
+ * variable, with the defaults miopen_volume() uses for a missing
+ * attribute.
+ */
+static int miget_minc1_dimension(int fd, int dimid, midimhandle_t *hdim_ptr)
+{
+  char name[MAX_NC_NAME];
+  char temp[MI2_CHAR_LENGTH];
+  char width_name[MAX_NC_NAME + 8];
+  double cosines[MI2_3D];
+  midimhandle_t hdim;
+  long length;
+  int varid;
+  int n;
+
+  if (ncdiminq(fd, dimid, name, &length) == MI_ERROR) {
+    return (MI_ERROR);
+  }
+
+  hdim = (midimhandle_t) malloc(sizeof (*hdim));
+  if (hdim == NULL) {
+    return MI_LOG_ERROR(MI2_MSG_OUTOFMEM, sizeof (*hdim));
+  }
+  memset(hdim, 0, sizeof (*hdim));
+
+  hdim->name = strdup(name);
+  hdim->length = (misize_t) length;
+  hdim->attr = MI_DIMATTR_REGULARLY_SAMPLED;
+
+  if (!strcmp(name, MItime)) {
+    hdim->dim_class = MI_DIMCLASS_TIME;
+  } else if (!strcmp(name, MIvector_dimension)) {
+    hdim->dim_class = MI_DIMCLASS_RECORD;
+  } else {
+    hdim->dim_class = MI_DIMCLASS_SPATIAL;
+  }
+
+  if (strcmp(name, MIvector_dimension)) {
+    hdim->start = 0.0;
+    hdim->step = 1.0;
+  }
+  if (!strcmp(name, MIxspace)) {
+    hdim->direction_cosines[MI2_X] = 1.0;
+  } else if (!strcmp(name, MIyspace)) {
+    hdim->direction_cosines[MI2_Y] = 1.0;
+  } else if (!strcmp(name, MIzspace)) {
+    hdim->direction_cosines[MI2_Z] = 1.0;
+  }
+
+  varid = ncvarid(fd, name);
+  if (varid != MI_ERROR) {
+    if (strcmp(name, MIvector_dimension)) {
+      miattget1(fd, varid, MIstart, NC_DOUBLE, &hdim->start);
+      miattget1(fd, varid, MIstep, NC_DOUBLE, &hdim->step);
+    }
+    if (miattget(fd, varid, MIdirection_cosines, NC_DOUBLE, MI2_3D,
+                 cosines, &n) != MI_ERROR && n == MI2_3D) {
+      memcpy(hdim->direction_cosines, cosines, sizeof(cosines));
+    }
+    if (miattgetstr(fd, varid, MIunits, sizeof(temp), temp) != NULL) {
+      hdim->units = strdup(temp);
+    }
+    if (miattgetstr(fd, varid, MIspacing, sizeof(temp), temp) != NULL &&
+        !strcmp(temp, MI_IRREGULAR)) {
+      hdim->attr = MI_DIMATTR_NOT_REGULARLY_SAMPLED;
+      hdim->offsets = miget_minc1_dim_values(fd, name, hdim->length);
+      sprintf(width_name, "%s-width", name);
+      hdim->widths = miget_minc1_dim_values(fd, width_name, hdim->length);
+    }
+  }
+  if (hdim->units == NULL) {
+    hdim->units = strdup("");
+  }
+
+  *hdim_ptr = hdim;
+  return (MI_NOERROR);
+}
+
+/** Fill in a volume handle from a MINC 1.0 file, leaving the file open
+ * for reading. Fails, with the handle left as it was, if the file is not
+ * a MINC 1.0 file or has an image this cannot read in place.
+ */
+int miopen_minc1_volume(const char *filename, mihandle_t volume)
+{
+  int fd;
+  int imgid;
+  int imaxid;
+  int iminid;
+  int ndims;
+  int slice_ndims = 0;
+  int dimids[MAX_VAR_DIMS];
+  int slice_dimids[MAX_VAR_DIMS];
+  nc_type datatype;
+  int is_signed;
+  mitype_t volume_type;
+  midimhandle_t *dim_handles = NULL;
+  double valid_range[2];
+  double scale_min = 0.0;
+  double scale_max = 1.0;
+  long index[MAX_VAR_DIMS];
+  int old_ncopts;
+  int result = MI_ERROR;
+  int i;
+
+  old_ncopts = get_ncopts();
+  set_ncopts(0);
+
+  fd = miopen(filename, NC_NOWRITE);
+  if (fd < 0) {
+    set_ncopts(old_ncopts);
+    return (MI_ERROR);
+  }
+
+  imgid = ncvarid(fd, MIimage);
+  if (imgid == MI_ERROR ||
+      ncvarinq(fd, imgid, NULL, NULL, &ndims, dimids, NULL) == MI_ERROR ||
+      ndims < 1 || ndims > MI2_MAX_VAR_DIMS ||
+      miget_datatype(fd, imgid, &datatype, &is_signed) == MI_ERROR) {
+    goto cleanup;
+  }
+  volume_type = minc1_to_mitype(datatype, is_signed);
+  if (volume_type == MI_TYPE_UNKNOWN) {
+    goto cleanup;
+  }
+
+  /* Slice scaling is on if image-max varies over any dimension. Those
+   * must be the slowest varying dimensions of the image, as in MINC 2.0.
+   */
+  imaxid = ncvarid(fd, MIimagemax);
+  iminid = ncvarid(fd, MIimagemin);
+  if (imaxid != MI_ERROR && iminid != MI_ERROR) {
+    if (ncvarinq(fd, imaxid, NULL, NULL, &slice_ndims, slice_dimids,
+                 NULL) == MI_ERROR || slice_ndims >= ndims) {
+      goto cleanup;
+    }
+    for (i = 0; i < slice_ndims; i++) {
+      if (slice_dimids[i] != dimids[i]) {
+        goto cleanup;
+      }
+    }
+    if (ncvarinq(fd, iminid, NULL, NULL, &i, slice_dimids,
+                 NULL) == MI_ERROR || i != slice_ndims) {
+      goto cleanup;
+    }
+    for (i = 0; i < slice_ndims; i++) {
+      if (slice_dimids[i] != dimids[i]) {
+        goto cleanup;
+      }
+    }
+    if (slice_ndims == 0) {
+      index[0] = 0;
+      if (mivarget1(fd, imaxid, index, NC_DOUBLE, MI_SIGNED,
+                    &scale_max) == MI_ERROR ||
+          mivarget1(fd, iminid, index, NC_DOUBLE, MI_SIGNED,
+                    &scale_min) == MI_ERROR) {
+        goto cleanup;
+      }
+    }
+  } else {
+    imaxid = iminid = -1;
+  }
+
+  if (miget_valid_range(fd, imgid, valid_range) == MI_ERROR) {
+    goto cleanup;
+  }
+
+  dim_handles = (midimhandle_t *) calloc(ndims, sizeof(midimhandle_t));
+  if (dim_handles == NULL) {
+    MI_LOG_ERROR(MI2_MSG_OUTOFMEM, ndims * sizeof(midimhandle_t));
+    goto cleanup;
+  }
+  for (i = 0; i < ndims; i++) {
+    if (miget_minc1_dimension(fd, dimids[i], &dim_handles[i]) < 0) {
+      goto cleanup;
+    }
+    dim_handles[i]->volume_handle = volume;
+  }
+
+  volume->hdf_id = -1;
+  volume->minc1_id = fd;
+  volume->minc1_image_id = imgid;
+  volume->minc1_imax_id = imaxid;
+  volume->minc1_imin_id = iminid;
+  volume->minc1_slice_ndims = slice_ndims;
+  volume->has_slice_scaling = (slice_ndims >= 1);
+  volume->scale_min = scale_min;
+  volume->scale_max = scale_max;
+  volume->volume_type = volume_type;
+  volume->volume_class = MI_CLASS_REAL;
+  volume->number_of_dims = ndims;
+  volume->dim_handles = dim_handles;
+  if (valid_range[0] < valid_range[1]) {
+    volume->valid_min = valid_range[0];
+    volume->valid_max = valid_range[1];
+  } else {
+    volume->valid_min = valid_range[1];
+    volume->valid_max = valid_range[0];
+  }
+  dim_handles = NULL;
+  result = MI_NOERROR;
+
+cleanup:
+  if (dim_handles != NULL) {
+    for (i = 0; i < ndims; i++) {
+      if (dim_handles[i] != NULL) {
+        mifree_dimension_handle(dim_handles[i]);
+      }
+    }
+    free(dim_handles);
+  }
+  if (result != MI_NOERROR) {
+    miclose(fd);
+  }
+  set_ncopts(old_ncopts);
+  return (result);
+}
+
+/** Close the MINC 1.0 file of a volume.
+ */
+int miclose_minc1_volume(mihandle_t volume)
+{
+  int result = miclose(volume->minc1_id);
+
+  volume->minc1_id = -1;
+  return (result == MI_ERROR ? MI_ERROR : MI_NOERROR);
+}
+
+/** Read a hyperslab of voxel values, in file order, converted to
+ * \a data_type.
+ */
+int miread_minc1_voxels(mihandle_t volume, mitype_t data_type,
+                        const hsize_t start[], const hsize_t count[],
+                        void *buffer)
+{
+  long nc_start[MAX_VAR_DIMS];
+  long nc_count[MAX_VAR_DIMS];
+  const char *sign;
+  nc_type datatype;
+  int i;
+
+  datatype = mitype_to_minc1(data_type, &sign);
+  if (datatype == NC_NAT) {
+    return MI_LOG_ERROR(MI2_MSG_BADTYPE, data_type);
+  }
+
+  for (i = 0; i < volume->number_of_dims; i++) {
+    nc_start[i] = (long) start[i];
+    nc_count[i] = (long) count[i];
+  }
+  if (mivarget(volume->minc1_id, volume->minc1_image_id, nc_start, nc_count,
+               datatype, sign, buffer) == MI_ERROR) {
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Can't read MINC 1.0 image");
+  }
+  return (MI_NOERROR);
+}
+
+/** Read the image-max or image-min values (\a varid) of the slices in
+ * a hyperslab given in file order.
+ */
+int miread_minc1_scale(mihandle_t volume, int varid,
+                       const hsize_t start[], const hsize_t count[],
+                       double *values)
+{
+  long nc_start[MAX_VAR_DIMS];
+  long nc_count[MAX_VAR_DIMS];
+  int i;
+
+  for (i = 0; i < volume->minc1_slice_ndims; i++) {
+    nc_start[i] = (long) start[i];
+    nc_count[i] = (long) count[i];
+  }
+  if (mivarget(volume->minc1_id, varid, nc_start, nc_count, NC_DOUBLE,
+               MI_SIGNED, values) == MI_ERROR) {
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Can't read MINC 1.0 slice range");
+  }
+  return (MI_NOERROR);
+}
+
+/** Get the range of the real values of the whole volume.
+ */
+int miget_minc1_real_range(mihandle_t volume, double real_range[])
+{
+  return (miget_image_range(volume->minc1_id, real_range) == MI_ERROR ?
+          MI_ERROR : MI_NOERROR);
+}
+
+/** Find the netCDF variable holding the attributes of a path in the
+ * MINC 2.0 hierarchy, laid out as a converted file would be: the root
+ * and info groups hold the global attributes, and the image, dimensions
+ * and info groups hold a dataset for each variable.
+ */
+static int miget_minc1_varid(mihandle_t volume, const char *path, int *varid)
+{
+  static const char *groups[] = {
+    MI_FULLIMAGE_PATH "/",
+    MI_FULLDIMENSIONS_PATH "/",
+    MI_ROOT_PATH "/" MI_INFO_NAME "/",
+    NULL
+  };
+  const char *name;
+  int i;
+
+  if (!strcmp(path, MI_ROOT_PATH) || !strcmp(path, MI_ROOT_PATH "/") ||
+      !strcmp(path, MI_ROOT_PATH "/" MI_INFO_NAME)) {
+    *varid = NC_GLOBAL;
+    return (MI_NOERROR);
+  }
+
+  for (i = 0; groups[i] != NULL; i++) {
+    if (!strncmp(path, groups[i], strlen(groups[i]))) {
+      name = path + strlen(groups[i]);
+      if (*name == '\0' && i == 2) {
+        *varid = NC_GLOBAL;
+        return (MI_NOERROR);
+      }
+      if (*name == '\0' || strchr(name, '/') != NULL) {
+        return (MI_ERROR);
+      }
+      *varid = ncvarid(volume->minc1_id, name);
+      return (*varid == MI_ERROR ? MI_ERROR : MI_NOERROR);
+    }
+  }
+  return (MI_ERROR);
+}
+
+/** Get the type and length of an attribute, given the full MINC 2.0
+ * path of the object it belongs to.
+ */
+int miget_minc1_attr_info(mihandle_t volume, const char *path,
+                          const char *name, mitype_t *data_type,
+                          size_t *length)
+{
+  nc_type datatype;
+  int att_length;
+  int varid;
+  int old_ncopts;
+  int result = MI_ERROR;
+
+  old_ncopts = get_ncopts();
+  set_ncopts(0);
+
+  if (miget_minc1_varid(volume, path, &varid) == MI_NOERROR &&
+      ncattinq(volume->minc1_id, varid, name, &datatype,
+               &att_length) != MI_ERROR) {
+    if (data_type != NULL) {
+      switch (datatype) {
+      case NC_CHAR:
+        *data_type = MI_TYPE_STRING;
+        break;
+      case NC_FLOAT:
+        *data_type = MI_TYPE_FLOAT;
+        break;
+      case NC_DOUBLE:
+        *data_type = MI_TYPE_DOUBLE;
+        break;
+      default:
+        *data_type = MI_TYPE_INT;
+        break;
+      }
+    }
+    if (length != NULL) {
+      *length = (size_t) att_length;
+    }
+    result = MI_NOERROR;
+  }
+
+  set_ncopts(old_ncopts);
+  return (result);
+}
+
+/** Get the values of an attribute, given the full MINC 2.0 path of the
+ * object it belongs to. Numeric attributes are converted to \a data_type;
+ * strings are zero terminated if there is room.
+ */
+int miget_minc1_attr_values(mihandle_t volume, mitype_t data_type,
+                            const char *path, const char *name,
+                            size_t length, void *values)
+{
+  nc_type datatype;
+  double *buffer = NULL;
+  int att_length;
+  int varid;
+  int old_ncopts;
+  int result = MI_ERROR;
+  int i;
+
+  old_ncopts = get_ncopts();
+  set_ncopts(0);
+
+  if (miget_minc1_varid(volume, path, &varid) == MI_ERROR ||
+      ncattinq(volume->minc1_id, varid, name, &datatype,
+               &att_length) == MI_ERROR ||
+      length < (size_t) att_length) {
+    goto cleanup;
+  }
+
+  if (data_type == MI_TYPE_STRING) {
+    if (datatype != NC_CHAR ||
+        ncattget(volume->minc1_id, varid, name, values) == MI_ERROR) {
+      goto cleanup;
+    }
+    if (length > (size_t) att_length) {
+      ((char *) values)[att_length] = '\0';
+    }
+    result = MI_NOERROR;
+    goto cleanup;
+  }
+
+  if (datatype == NC_CHAR || att_length < 1) {
+    goto cleanup;
+  }
+  buffer = (double *) malloc(att_length * sizeof(double));
+  if (buffer == NULL ||
+      miattget(volume->minc1_id, varid, name, NC_DOUBLE, att_length, buffer,
+               NULL) == MI_ERROR) {
+    goto cleanup;
+  }
+
+  for (i = 0; i < att_length; i++) {
+    switch (data_type) {
+    case MI_TYPE_INT:
+      ((int *) values)[i] = (int) buffer[i];
+      break;
+    case MI_TYPE_UINT:
+      ((unsigned int *) values)[i] = (unsigned int) buffer[i];
+      break;
+    case MI_TYPE_FLOAT:
+      ((float *) values)[i] = (float) buffer[i];
+      break;
+    case MI_TYPE_DOUBLE:
+      ((double *) values)[i] = buffer[i];
+      break;
+    default:
+      goto cleanup;
+    }
+  }
+  result = MI_NOERROR;
+
+cleanup:
+  if (buffer != NULL) {
+    free(buffer);
+  }
+  set_ncopts(old_ncopts);
+  return (result);
+}
+
+/* kate: indent-mode cstyle; indent-width 2; replace-tabs on; */
@@ -742,6 +742,14 @@ int miget_slice_dimension_count(mihandle_t volume, midimclass_t dimclass,
 */
 int miget_volume_voxel_count(mihandle_t volume, misize_t *number_of_voxels);
 
+/** Get the chunk sizes of the image dataset, in file order. A dataset
+  * that is not chunked is one chunk, so its chunk sizes are the sizes of
+  * its dimensions.
+  * \ingroup mi2Vol
+*/
+int miget_volume_chunk_dims(mihandle_t volume, misize_t array_length,
+                            misize_t chunk_dims[]);
+
 /** Opens an existing MINC volume for read-only access if mode argument is
   * MI2_OPEN_READ, or read-write access if mode argument is MI2_OPEN_RDWR.
   * \ingroup mi2Vol
@@ -119,6 +119,11 @@ struct mivolume {
   double scale_min;             /* Global minimum */
   double scale_max;             /* Global maximum */
   miboolean_t is_dirty;         /* TRUE if data has been modified. */
+  int minc1_id;                 /* MINC 1.0 file read in place, or -1 */
+  int minc1_image_id;           /* Variable for image */
+  int minc1_imax_id;            /* Variable for image-max */
+  int minc1_imin_id;            /* Variable for image-min */
+  int minc1_slice_ndims;        /* Dimensions image-max varies over */
 };
 
 /**
@@ -203,6 +208,25 @@ int mitranslate_hyperslab_origin(mihandle_t volume,
 /* From volume.c */
 void misave_valid_range(mihandle_t volume);
 
+#ifdef HAVE_MINC1
+/* From minc1_volume.c */
+int miopen_minc1_volume(const char *filename, mihandle_t volume);
+int miclose_minc1_volume(mihandle_t volume);
+int miread_minc1_voxels(mihandle_t volume, mitype_t data_type,
+                        const hsize_t start[], const hsize_t count[],
+                        void *buffer);
+int miread_minc1_scale(mihandle_t volume, int varid,
+                       const hsize_t start[], const hsize_t count[],
+                       double *values);
+int miget_minc1_real_range(mihandle_t volume, double real_range[]);
+int miget_minc1_attr_info(mihandle_t volume, const char *path,
+                          const char *name, mitype_t *data_type,
+                          size_t *length);
+int miget_minc1_attr_values(mihandle_t volume, mitype_t data_type,
+                            const char *path, const char *name,
+                            size_t length, void *values);
+#endif /*HAVE_MINC1*/
+
 /* From valid.c*/
 void miinit_default_range(mitype_t mitype, double *valid_max, double *valid_min);
 
@@ -0,0 +1,309 @@
+/**
+ * \file minc2_simple.c
+ * \brief Simplified interface for whole MINC 2.0 volumes.
+ *
+ * Unlike minc_load_data() and minc_save_data(), which go through icv's
+ * a slice at a time, these move a whole volume with one hyperslab call,
+ * so each compressed chunk of the image is inflated or deflated once,
+ * and the range of the values to be saved is found in one pass.
+ ************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <hdf5.h>
+#include "minc2.h"
+#include "minc2_private.h"
+#include "minc2_simple.h"
+
+static char *minc2_simple_dimnames[MINC2_SIMPLE_NDIMS] = {
+  MItime, MIzspace, MIyspace, MIxspace
+};
+
+/** Find which of the simple dimensions a dimension is, or -1.
+ */
+static int minc2_simple_dim_index(midimhandle_t hdim)
+{
+  int i;
+
+  for (i = 0; i < MINC2_SIMPLE_NDIMS; i++) {
+    if (!strcmp(hdim->name, minc2_simple_dimnames[i])) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/** Open a volume, fill in \a info from it, and make the apparent
+ * dimension order the standard one.
+ */
+static int minc2_simple_open(const char *path, mihandle_t *volume_ptr,
+                             minc2_simple_info *info)
+{
+  mihandle_t volume;
+  midimhandle_t hdims[MI2_MAX_VAR_DIMS];
+  char *names[MINC2_SIMPLE_NDIMS];
+  double real_range[2];
+  int ndims, i, j, k;
+
+  if (miopen_volume(path, MI2_OPEN_READ, &volume) < 0) {
+    return MI_ERROR;
+  }
+
+  memset(info, 0, sizeof(minc2_simple_info));
+  info->dir_cos[MINC2_SIMPLE_X][MI2_X] = 1.0;
+  info->dir_cos[MINC2_SIMPLE_Y][MI2_Y] = 1.0;
+  info->dir_cos[MINC2_SIMPLE_Z][MI2_Z] = 1.0;
+
+  ndims = volume->number_of_dims;
+  if (ndims < 1 || ndims > MINC2_SIMPLE_NDIMS ||
+      miget_volume_dimensions(volume, MI_DIMCLASS_ANY, MI_DIMATTR_ALL,
+                              MI_DIMORDER_FILE, ndims, hdims) != ndims) {
+    miclose_volume(volume);
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Simple volumes have one to four dimensions");
+  }
+
+  for (i = 0; i < ndims; i++) {
+    k = minc2_simple_dim_index(hdims[i]);
+    if (k < 0 || info->sizes[k] != 0) {
+      miclose_volume(volume);
+      return MI_LOG_ERROR(MI2_MSG_GENERIC,"Simple volumes have only time, zspace, yspace and xspace dimensions");
+    }
+    info->sizes[k] = hdims[i]->length;
+    info->steps[k] = hdims[i]->step;
+    info->starts[k] = hdims[i]->start;
+    for (j = 0; j < MI2_3D; j++) {
+      info->dir_cos[k][j] = hdims[i]->direction_cosines[j];
+    }
+  }
+
+  /* Ask for the dimensions in the standard order.
+   */
+  info->ndims = 0;
+  for (i = 0; i < MINC2_SIMPLE_NDIMS; i++) {
+    if (info->sizes[i] != 0) {
+      names[info->ndims++] = minc2_simple_dimnames[i];
+    }
+  }
+  if (miset_apparent_dimension_order_by_name(volume, info->ndims, names) < 0) {
+    miclose_volume(volume);
+    return MI_ERROR;
+  }
+
+  miget_voxel_to_world(volume, info->voxel_to_world);
+  miget_data_type(volume, &info->file_type);
+  if (miget_volume_real_range(volume, real_range) == MI_NOERROR) {
+    info->real_min = real_range[0];
+    info->real_max = real_range[1];
+  }
+
+  *volume_ptr = volume;
+  return MI_NOERROR;
+}
+
+/** Get the start and count of the whole volume in the standard order.
+ */
+static void minc2_simple_slab(const minc2_simple_info *info,
+                              misize_t start[], misize_t count[])
+{
+  int i, n = 0;
+
+  for (i = 0; i < MINC2_SIMPLE_NDIMS; i++) {
+    if (info->sizes[i] != 0) {
+      start[n] = 0;
+      count[n] = info->sizes[i];
+      n++;
+    }
+  }
+}
+
+#define MINC2_SIMPLE_RANGE(type)               \
+  {                                            \
+    const type *ptr = (const type *) buffer;  \
+    for (i = 0; i < n; i++) {                 \
+      double value = (double) ptr[i];         \
+      if (value < min) min = value;           \
+      if (value > max) max = value;           \
+    }                                          \
+  }
+
+/** Find the range of the values in a buffer.
+ */
+static int minc2_simple_range(mitype_t buffer_type, const void *buffer,
+                              misize_t n, double *min_ptr, double *max_ptr)
+{
+  double min = DBL_MAX;
+  double max = -DBL_MAX;
+  misize_t i;
+
+  switch (buffer_type) {
+  case MI_TYPE_BYTE:
+    MINC2_SIMPLE_RANGE(signed char);
+    break;
+  case MI_TYPE_UBYTE:
+    MINC2_SIMPLE_RANGE(unsigned char);
+    break;
+  case MI_TYPE_SHORT:
+    MINC2_SIMPLE_RANGE(short);
+    break;
+  case MI_TYPE_USHORT:
+    MINC2_SIMPLE_RANGE(unsigned short);
+    break;
+  case MI_TYPE_INT:
+    MINC2_SIMPLE_RANGE(int);
+    break;
+  case MI_TYPE_UINT:
+    MINC2_SIMPLE_RANGE(unsigned int);
+    break;
+  case MI_TYPE_FLOAT:
+    MINC2_SIMPLE_RANGE(float);
+    break;
+  case MI_TYPE_DOUBLE:
+    MINC2_SIMPLE_RANGE(double);
+    break;
+  default:
+    return MI_LOG_ERROR(MI2_MSG_BADTYPE,buffer_type);
+  }
+
+  if (n == 0) {
+    min = max = 0.0;
+  }
+  *min_ptr = min;
+  *max_ptr = max;
+  return MI_NOERROR;
+}
+
+int minc2_simple_get_info(const char *path, minc2_simple_info *info)
+{
+  mihandle_t volume;
+
+  if (path == NULL || info == NULL) {
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Trying to get info with null path or info");
+  }
+  if (minc2_simple_open(path, &volume, info) < 0) {
+    return MI_ERROR;
+  }
+  return miclose_volume(volume);
+}
+
+int minc2_simple_load(const char *path, mitype_t buffer_type, void *buffer,
+                      minc2_simple_info *info)
+{
+  minc2_simple_info local_info;
+  mihandle_t volume;
+  misize_t start[MINC2_SIMPLE_NDIMS];
+  misize_t count[MINC2_SIMPLE_NDIMS];
+  int result;
+
+  if (path == NULL || buffer == NULL) {
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Trying to load with null path or buffer");
+  }
+  if (info == NULL) {
+    info = &local_info;
+  }
+  if (minc2_simple_open(path, &volume, info) < 0) {
+    return MI_ERROR;
+  }
+
+  minc2_simple_slab(info, start, count);
+  result = miget_real_value_hyperslab(volume, buffer_type, start, count,
+                                      buffer);
+  miclose_volume(volume);
+  return result < 0 ? MI_ERROR : MI_NOERROR;
+}
+
+int minc2_simple_save(const char *path, mitype_t file_type,
+                      mitype_t buffer_type, const void *buffer,
+                      const minc2_simple_info *info)
+{
+  midimhandle_t hdims[MINC2_SIMPLE_NDIMS];
+  mihandle_t volume;
+  misize_t start[MINC2_SIMPLE_NDIMS];
+  misize_t count[MINC2_SIMPLE_NDIMS];
+  misize_t n = 1;
+  double min, max, valid_min, valid_max;
+  int ndims = 0;
+  int i;
+
+  if (path == NULL || buffer == NULL || info == NULL) {
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Trying to save with null path, buffer or info");
+  }
+  if (file_type == MI_TYPE_UNKNOWN) {
+    file_type = info->file_type;
+  }
+
+  for (i = 0; i < MINC2_SIMPLE_NDIMS; i++) {
+    if (info->sizes[i] != 0) {
+      n *= info->sizes[i];
+    }
+  }
+  if (minc2_simple_range(buffer_type, buffer, n, &min, &max) < 0) {
+    return MI_ERROR;
+  }
+
+  /* Integer voxels are scaled to the range of the values, unless the
+   * buffer holds integers that the file type can store as they are.
+   */
+  miinit_default_range(file_type, &valid_max, &valid_min);
+  if (buffer_type != MI_TYPE_FLOAT && buffer_type != MI_TYPE_DOUBLE) {
+    if (min < valid_min || max > valid_max) {
+      return MI_LOG_ERROR(MI2_MSG_GENERIC,"Integer values out of the range of the file type");
+    }
+    valid_min = min;
+    valid_max = max;
+  }
+  if (max <= min) {
+    max = min + 1.0;
+    valid_max = valid_min + 1.0;
+  }
+
+  for (i = 0; i < MINC2_SIMPLE_NDIMS; i++) {
+    if (info->sizes[i] == 0) {
+      continue;
+    }
+    if (micreate_dimension(minc2_simple_dimnames[i],
+                           i == MINC2_SIMPLE_T ?
+                           MI_DIMCLASS_TIME : MI_DIMCLASS_SPATIAL,
+                           MI_DIMATTR_REGULARLY_SAMPLED, info->sizes[i],
+                           &hdims[ndims]) < 0) {
+      goto dim_error;
+    }
+    miset_dimension_separation(hdims[ndims],
+                               info->steps[i] != 0.0 ? info->steps[i] : 1.0);
+    miset_dimension_start(hdims[ndims], info->starts[i]);
+    if (i != MINC2_SIMPLE_T) {
+      miset_dimension_cosines(hdims[ndims], info->dir_cos[i]);
+    }
+    ndims++;
+  }
+
+  if (micreate_volume(path, ndims, hdims, file_type, MI_CLASS_REAL, NULL,
+                      &volume) < 0) {
+    goto dim_error;
+  }
+  if (micreate_volume_image(volume) < 0 ||
+      miset_volume_valid_range(volume, valid_max, valid_min) < 0 ||
+      miset_volume_range(volume, max, min) < 0) {
+    miclose_volume(volume);
+    return MI_ERROR;
+  }
+
+  minc2_simple_slab(info, start, count);
+  if (miset_real_value_hyperslab(volume, buffer_type, start, count,
+                                 (void *) buffer) < 0) {
+    miclose_volume(volume);
+    return MI_ERROR;
+  }
+  return miclose_volume(volume);
+
+ dim_error:
+  for (i = 0; i < ndims; i++) {
+    mifree_dimension_handle(hdims[i]);
+  }
+  return MI_ERROR;
+}
+
+/* kate: indent-mode cstyle; indent-width 2; replace-tabs on; */
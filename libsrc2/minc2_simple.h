@@ -0,0 +1,72 @@
+/**
+ * \file minc2_simple.h
+ * \brief Simplified interface for whole MINC 2.0 volumes.
+ *
+ * The MINC 2.0 counterpart of minc_load_data() and minc_save_data():
+ * a volume is read or written with a single hyperslab call, in the
+ * standard time, zspace, yspace, xspace order, with the voxel to world
+ * transform at hand.
+ **/
+
+#ifndef MINC2_SIMPLE_H
+#define MINC2_SIMPLE_H
+
+#include "minc2.h"
+
+#ifdef __cplusplus
+extern "C" {               /* Hey, Mr. Compiler - this is "C" code! */
+#endif /* __cplusplus defined */
+
+/** Indices of the dimensions in a minc2_simple_info, which are also
+ * their order in the buffers, slowest varying first.
+ */
+#define MINC2_SIMPLE_T 0
+#define MINC2_SIMPLE_Z 1
+#define MINC2_SIMPLE_Y 2
+#define MINC2_SIMPLE_X 3
+#define MINC2_SIMPLE_NDIMS 4
+
+/** The layout and coordinates of a volume. A dimension that the volume
+ * does not have has a size of zero.
+ */
+typedef struct minc2_simple_info
+{
+  int ndims;                        /**< Number of dimensions present */
+  misize_t sizes[MINC2_SIMPLE_NDIMS]; /**< Length of each dimension */
+  double steps[MINC2_SIMPLE_NDIMS]; /**< Separation of the samples */
+  double starts[MINC2_SIMPLE_NDIMS]; /**< Position of the first sample */
+  double dir_cos[MINC2_SIMPLE_NDIMS][MI2_3D]; /**< Spatial direction cosines */
+  double voxel_to_world[4][4];      /**< Maps (x, y, z, 1) voxel indices
+                                         to world coordinates */
+  mitype_t file_type;               /**< Voxel type in the file */
+  double real_min, real_max;        /**< Range of the real values */
+} minc2_simple_info;
+
+/** Get the layout, coordinates and type of the volume in a file, to
+ * size the buffer for minc2_simple_load().
+ */
+int minc2_simple_get_info(const char *path, minc2_simple_info *info);
+
+/** Load the real values of a whole volume into \a buffer, which must
+ * hold every voxel in \a buffer_type, time varying slowest and x
+ * fastest. Only the time, zspace, yspace and xspace dimensions are
+ * allowed. \a info, if not NULL, gets the layout and coordinates.
+ */
+int minc2_simple_load(const char *path, mitype_t buffer_type, void *buffer,
+                      minc2_simple_info *info);
+
+/** Save the real values in \a buffer, laid out as minc2_simple_load()
+ * leaves them, as a new volume with the dimensions, steps, starts and
+ * direction cosines of \a info. The voxels are stored as \a file_type,
+ * or as info->file_type if that is MI_TYPE_UNKNOWN, scaled to the range
+ * of the values.
+ */
+int minc2_simple_save(const char *path, mitype_t file_type,
+                      mitype_t buffer_type, const void *buffer,
+                      const minc2_simple_info *info);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus defined */
+
+#endif /*MINC2_SIMPLE_H*/
@@ -58,6 +58,27 @@ static int mirw_slice_minmax ( int opcode, mihandle_t volume,
     return mirw_volume_minmax ( opcode, volume, value );
   }
 
+#ifdef HAVE_MINC1
+  if ( volume->minc1_id >= 0 ) {
+    if ( opcode & MIRW_SCALE_SET ) {
+      return MI_LOG_ERROR(MI2_MSG_GENERIC,"Trying to write to a MINC 1.0 volume");
+    }
+    for ( i = 0; i < (misize_t) volume->number_of_dims; i++ ) {
+      count[i] = 1;
+    }
+    mitranslate_hyperslab_origin ( volume,
+                                   start_positions,
+                                   count,
+                                   hdf_start,
+                                   hdf_count,
+                                   dir );
+    return miread_minc1_scale ( volume,
+                                ( opcode & MIRW_SCALE_MIN ) ?
+                                volume->minc1_imin_id : volume->minc1_imax_id,
+                                hdf_start, hdf_count, value );
+  }
+#endif /*HAVE_MINC1*/
+
   if ( opcode & MIRW_SCALE_MIN ) {
     dset_id = volume->imin_id;
   } else {
@@ -437,6 +437,10 @@ static mihandle_t mialloc_volume_handle(void)
     handle->imax_id = -1;
     handle->imin_id = -1;
     handle->plist_id = -1;
+    handle->minc1_id = -1;
+    handle->minc1_image_id = -1;
+    handle->minc1_imax_id = -1;
+    handle->minc1_imin_id = -1;
     handle->has_slice_scaling = FALSE;
     handle->is_dirty = FALSE;
     handle->dim_indices = NULL;
@@ -1049,6 +1053,18 @@ int miget_volume_voxel_count(mihandle_t volume, misize_t *number_of_voxels)
     return MI_LOG_ERROR(MI2_MSG_GENERIC,"Trying to get voxel count with null volume or null variable");
   }
 
+  /* A MINC 1.0 volume has no dataset to ask.
+   */
+  if (volume->minc1_id >= 0) {
+    int i;
+
+    *number_of_voxels = 1;
+    for (i = 0; i < volume->number_of_dims; i++) {
+      *number_of_voxels *= volume->dim_handles[i]->length;
+    }
+    return (MI_NOERROR);
+  }
+
   /* Quickest way to do this is with the dataspace identifier of the
   * volume. Use the volume's current resolution.
   */
@@ -1070,6 +1086,65 @@ int miget_volume_voxel_count(mihandle_t volume, misize_t *number_of_voxels)
   return (MI_NOERROR);
 }
 
+/** Get the chunk sizes of the image dataset, in file order. A dataset
+  * that is not chunked is one chunk, so its chunk sizes are the sizes of
+  * its dimensions. Reading whole chunks along every dimension means each
+  * chunk is decompressed only once.
+  * \ingroup mi2Vol
+  */
+int miget_volume_chunk_dims(mihandle_t volume, misize_t array_length,
+                            misize_t chunk_dims[])
+{
+  char path[MI2_MAX_PATH];
+  hid_t dset_id;
+  hid_t fspc_id;
+  hid_t plist_id;
+  hsize_t dims[MI2_MAX_VAR_DIMS];
+  int ndims;
+  misize_t i;
+
+  /* Validate parameters */
+  if (volume == NULL || chunk_dims == NULL) {
+    return MI_LOG_ERROR(MI2_MSG_GENERIC,"Trying to get chunk dimensions with null volume or null variable");
+  }
+
+  /* MINC 1.0 images are not chunked.
+   */
+  if (volume->minc1_id >= 0) {
+    for (i = 0; i < array_length && i < (misize_t) volume->number_of_dims; i++) {
+      chunk_dims[i] = volume->dim_handles[i]->length;
+    }
+    return (MI_NOERROR);
+  }
+
+  sprintf(path, MI_ROOT_PATH "/image/%d/image", volume->selected_resolution);
+  MI_CHECK_HDF_CALL_RET(dset_id = H5Dopen1(volume->hdf_id, path),"H5Dopen1");
+
+  /* Start with the dataset dimensions */
+  MI_CHECK_HDF_CALL_RET(fspc_id = H5Dget_space(dset_id),"H5Dget_space");
+  ndims = H5Sget_simple_extent_dims(fspc_id, dims, NULL);
+  H5Sclose(fspc_id);
+
+  /* Replace them with the chunk dimensions, if any */
+  plist_id = H5Dget_create_plist(dset_id);
+  if (ndims >= 0 && plist_id >= 0 && H5Pget_layout(plist_id) == H5D_CHUNKED) {
+    ndims = H5Pget_chunk(plist_id, MI2_MAX_VAR_DIMS, dims);
+  }
+  if (plist_id >= 0) {
+    H5Pclose(plist_id);
+  }
+  H5Dclose(dset_id);
+
+  if (ndims < 0) {
+    return MI_LOG_ERROR(MI2_MSG_HDF5,"H5Pget_chunk");
+  }
+
+  for (i = 0; i < array_length && i < (misize_t) ndims; i++) {
+    chunk_dims[i] = (misize_t) dims[i];
+  }
+  return (MI_NOERROR);
+}
+
 /* Get the number of dimensions in the file */
 static int _miget_file_dimension_count(hid_t file_id)
 {
@@ -1360,10 +1435,21 @@ int miopen_volume(const char *filename, int mode, mihandle_t *volume)
   file_id = _hdf_open(filename, hdf_mode);
  
   if (file_id < 0) {
-    /*try to convert MINC1 file*/
+    /*try to read MINC1 file in place, or else convert it*/
 #ifdef HAVE_MINC1
     char * temp_file=NULL;
 
+    if ( mode == MI2_OPEN_READ &&
+         miopen_minc1_volume( filename, handle ) == MI_NOERROR )
+    {
+      handle->mode = mode;
+      miset_volume_world_indices( handle );
+      miget_voxel_to_world( handle, handle->v2w_transform );
+      miinvert_transform( handle->v2w_transform, handle->w2v_transform );
+      *volume = handle;
+      return (MI_NOERROR);
+    }
+
     if ( mode == MI2_OPEN_READ )
     {
       if( (temp_file=micreate_tempfile()))
@@ -1634,6 +1720,13 @@ int miclose_volume(mihandle_t volume)
   if (volume->plist_id > 0) {
     H5Pclose(volume->plist_id);
   }
+#ifdef HAVE_MINC1
+  if (volume->minc1_id >= 0) {
+    if (miclose_minc1_volume(volume) < 0) {
+      return (MI_ERROR);
+    }
+  } else
+#endif /*HAVE_MINC1*/
   if (_hdf_close(volume->hdf_id) < 0) {
     return (MI_ERROR);
   }
@@ -1768,6 +1861,12 @@ int miget_slice_dimension_count(mihandle_t volume, midimclass_t dimclass,
     *number_of_dimensions=number_of_volume_dimensions;
     return MI_NOERROR;
   }
+
+  if(volume->minc1_id >= 0)
+  {
+    *number_of_dimensions=number_of_volume_dimensions-volume->minc1_slice_ndims;
+    return MI_NOERROR;
+  }
   
   image_max_fspc_id=H5Dget_space(volume->imax_id);
   slice_ndims = H5Sget_simple_extent_ndims ( image_max_fspc_id );
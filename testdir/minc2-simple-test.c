@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "minc2.h"
+#include "minc2_simple.h"
+
+#define TESTRPT(msg, val) (error_cnt++, fprintf(stderr, \
+                                  "Error reported on line #%d, %s: %d\n", \
+                                  __LINE__, msg, val))
+
+#define CT 3
+#define CZ 5
+#define CY 7
+#define CX 9
+
+static int error_cnt = 0;
+
+static double real_value(int t, int z, int y, int x)
+{
+  return 1000.0 * t + 100.0 * z + 10.0 * y + x - 250.5;
+}
+
+/* Write a volume through the ordinary API, in xspace, zspace, yspace
+ * order, with a flipped y axis and rotated axes, so that loading it has
+ * to reorder the voxels.
+ */
+static void create_file_order_volume(const char *fname)
+{
+  static char *names[3] = { "xspace", "zspace", "yspace" };
+  static const misize_t sizes[3] = { CX, CZ, CY };
+  static const double steps[3] = { 1.5, 2.0, -0.5 };
+  static const double starts[3] = { -10.0, 20.0, 5.0 };
+  double cosines[3][3] = {
+    { 0.8, 0.6, 0.0 }, { 0.0, 0.0, 1.0 }, { -0.6, 0.8, 0.0 }
+  };
+  misize_t start[3] = { 0, 0, 0 };
+  misize_t count[3] = { CX, CZ, CY };
+  midimhandle_t hdim[3];
+  mihandle_t vol;
+  double *values;
+  int x, y, z, i;
+
+  for (i = 0; i < 3; i++) {
+    micreate_dimension(names[i], MI_DIMCLASS_SPATIAL,
+                       MI_DIMATTR_REGULARLY_SAMPLED, sizes[i], &hdim[i]);
+    miset_dimension_separation(hdim[i], steps[i]);
+    miset_dimension_start(hdim[i], starts[i]);
+    miset_dimension_cosines(hdim[i], cosines[i]);
+  }
+  if (micreate_volume(fname, 3, hdim, MI_TYPE_FLOAT, MI_CLASS_REAL, NULL,
+                      &vol) < 0) {
+    TESTRPT("micreate_volume failed", 0);
+    return;
+  }
+  micreate_volume_image(vol);
+  miset_volume_range(vol, real_value(0, CZ - 1, CY - 1, CX - 1),
+                     real_value(0, 0, 0, 0));
+
+  values = malloc(CX * CZ * CY * sizeof(double));
+  for (x = 0; x < CX; x++)
+    for (z = 0; z < CZ; z++)
+      for (y = 0; y < CY; y++)
+        values[(x * CZ + z) * CY + y] = real_value(0, z, y, x);
+  if (miset_real_value_hyperslab(vol, MI_TYPE_DOUBLE, start, count,
+                                 values) < 0) {
+    TESTRPT("miset_real_value_hyperslab failed", 0);
+  }
+  free(values);
+  miclose_volume(vol);
+}
+
+/* Load the volume written above, and check the voxel order and the
+ * voxel to world transform.
+ */
+static void test_load_reordered(const char *fname)
+{
+  minc2_simple_info info;
+  mihandle_t vol;
+  double values[CZ][CY][CX];
+  int x, y, z, i;
+
+  create_file_order_volume(fname);
+
+  if (minc2_simple_load(fname, MI_TYPE_DOUBLE, values, &info) < 0) {
+    TESTRPT("minc2_simple_load failed", 0);
+    return;
+  }
+  if (info.ndims != 3 || info.sizes[MINC2_SIMPLE_T] != 0 ||
+      info.sizes[MINC2_SIMPLE_Z] != CZ || info.sizes[MINC2_SIMPLE_Y] != CY ||
+      info.sizes[MINC2_SIMPLE_X] != CX) {
+    TESTRPT("wrong sizes", info.ndims);
+    return;
+  }
+  if (info.file_type != MI_TYPE_FLOAT || info.steps[MINC2_SIMPLE_Y] != -0.5) {
+    TESTRPT("wrong type or step", info.file_type);
+  }
+
+  for (z = 0; z < CZ; z++)
+    for (y = 0; y < CY; y++)
+      for (x = 0; x < CX; x++)
+        if (fabs(values[z][y][x] - real_value(0, z, y, x)) > 1e-4) {
+          TESTRPT("wrong value", (z * CY + y) * CX + x);
+        }
+
+  /* The transform maps (x, y, z) indices as miconvert_voxel_to_world
+   * maps file indices.
+   */
+  miopen_volume(fname, MI2_OPEN_READ, &vol);
+  for (i = 0; i < 8; i++) {
+    double voxel[3], world[3], simple[3];
+    int j;
+
+    x = (i & 1) ? CX - 1 : 0;
+    y = (i & 2) ? CY - 1 : 1;
+    z = (i & 4) ? CZ - 1 : 2;
+    voxel[0] = x;
+    voxel[1] = z;
+    voxel[2] = y;
+    miconvert_voxel_to_world(vol, voxel, world);
+    for (j = 0; j < 3; j++) {
+      simple[j] = info.voxel_to_world[j][0] * x +
+        info.voxel_to_world[j][1] * y + info.voxel_to_world[j][2] * z +
+        info.voxel_to_world[j][3];
+      if (fabs(simple[j] - world[j]) > 1e-6) {
+        TESTRPT("wrong world coordinate", i);
+      }
+    }
+  }
+  miclose_volume(vol);
+}
+
+/* Save a 4D volume from a buffer, and load it back in another type.
+ */
+static void test_save_and_load(const char *fname, mitype_t file_type,
+                               mitype_t buffer_type, double tolerance)
+{
+  minc2_simple_info info, file_info;
+  static double values[CT][CZ][CY][CX];
+  static float loaded[CT][CZ][CY][CX];
+  static int ivalues[CT][CZ][CY][CX];
+  void *buffer = (buffer_type == MI_TYPE_INT) ? (void *) ivalues :
+    (void *) values;
+  int t, z, y, x, i;
+
+  for (t = 0; t < CT; t++)
+    for (z = 0; z < CZ; z++)
+      for (y = 0; y < CY; y++)
+        for (x = 0; x < CX; x++) {
+          values[t][z][y][x] = real_value(t, z, y, x);
+          ivalues[t][z][y][x] = (int) floor(real_value(t, z, y, x));
+        }
+
+  memset(&info, 0, sizeof(info));
+  info.ndims = 4;
+  info.sizes[MINC2_SIMPLE_T] = CT;
+  info.sizes[MINC2_SIMPLE_Z] = CZ;
+  info.sizes[MINC2_SIMPLE_Y] = CY;
+  info.sizes[MINC2_SIMPLE_X] = CX;
+  for (i = 0; i < MINC2_SIMPLE_NDIMS; i++) {
+    info.steps[i] = 0.5 * (i + 1);
+    info.starts[i] = -3.0 * i;
+  }
+  info.dir_cos[MINC2_SIMPLE_X][0] = 1.0;
+  info.dir_cos[MINC2_SIMPLE_Y][1] = 1.0;
+  info.dir_cos[MINC2_SIMPLE_Z][2] = 1.0;
+
+  if (minc2_simple_save(fname, file_type, buffer_type, buffer, &info) < 0) {
+    TESTRPT("minc2_simple_save failed", file_type);
+    return;
+  }
+  if (minc2_simple_load(fname, MI_TYPE_FLOAT, loaded, &file_info) < 0) {
+    TESTRPT("minc2_simple_load failed", file_type);
+    return;
+  }
+
+  if (file_info.ndims != 4 || file_info.file_type != file_type) {
+    TESTRPT("wrong dimensions or type", file_info.ndims);
+  }
+  for (i = 0; i < MINC2_SIMPLE_NDIMS; i++) {
+    if (file_info.sizes[i] != info.sizes[i] ||
+        fabs(file_info.steps[i] - info.steps[i]) > 1e-6 ||
+        fabs(file_info.starts[i] - info.starts[i]) > 1e-6) {
+      TESTRPT("wrong dimension", i);
+    }
+  }
+  if (fabs(file_info.voxel_to_world[0][0] - info.steps[MINC2_SIMPLE_X]) > 1e-6 ||
+      fabs(file_info.voxel_to_world[2][3] - info.starts[MINC2_SIMPLE_Z]) > 1e-6) {
+    TESTRPT("wrong voxel to world transform", 0);
+  }
+
+  for (t = 0; t < CT; t++)
+    for (z = 0; z < CZ; z++)
+      for (y = 0; y < CY; y++)
+        for (x = 0; x < CX; x++) {
+          double expected = (buffer_type == MI_TYPE_INT) ?
+            ivalues[t][z][y][x] : values[t][z][y][x];
+          if (fabs(loaded[t][z][y][x] - expected) > tolerance) {
+            fprintf(stderr, "%s: (%d,%d,%d,%d) is %g, expected %g\n", fname,
+                    t, z, y, x, loaded[t][z][y][x], expected);
+            TESTRPT("wrong value", file_type);
+            return;
+          }
+        }
+}
+
+int main(void)
+{
+  double step = (real_value(CT - 1, CZ - 1, CY - 1, CX - 1) -
+                 real_value(0, 0, 0, 0)) / 65535.0;
+
+  test_load_reordered("minc2-simple-reorder.mnc");
+  test_save_and_load("minc2-simple-float.mnc", MI_TYPE_FLOAT,
+                     MI_TYPE_DOUBLE, 1e-3);
+  test_save_and_load("minc2-simple-short.mnc", MI_TYPE_SHORT,
+                     MI_TYPE_DOUBLE, step);
+  test_save_and_load("minc2-simple-int.mnc", MI_TYPE_SHORT,
+                     MI_TYPE_INT, 0.0);
+
+  if (error_cnt != 0) {
+    fprintf(stderr, "%d error%s reported\n",
+            error_cnt, (error_cnt == 1) ? "" : "s");
+  }
+  else {
+    fprintf(stderr, "No errors\n");
+  }
+  return (error_cnt);
+}
@@ -7,6 +7,66 @@
 
 static int error_cnt = 0;
 
+/* Create a small volume, with the given chunking (or none), and check
+ * the chunk sizes reported by miget_volume_chunk_dims.
+ */
+static void test_chunk_dims(const char *fname, const int *edge_lengths,
+                            const misize_t *expected)
+{
+  static const char *names[3] = { "zspace", "yspace", "xspace" };
+  static const misize_t sizes[3] = { 10, 20, 30 };
+  midimhandle_t hdim[3];
+  mivolumeprops_t props = NULL;
+  mihandle_t vol;
+  misize_t chunk_dims[3];
+  int r;
+  int i;
+
+  for (i = 0; i < 3; i++) {
+    r = micreate_dimension(names[i], MI_DIMCLASS_SPATIAL,
+                           MI_DIMATTR_REGULARLY_SAMPLED, sizes[i], &hdim[i]);
+    if (r < 0) {
+      TESTRPT("micreate_dimension failed", r);
+    }
+  }
+
+  if (edge_lengths != NULL) {
+    minew_volume_props(&props);
+    r = miset_props_blocking(props, 3, edge_lengths);
+    if (r < 0) {
+      TESTRPT("miset_props_blocking failed", r);
+    }
+  }
+
+  r = micreate_volume(fname, 3, hdim, MI_TYPE_SHORT, MI_CLASS_REAL,
+                      props, &vol);
+  if (r < 0) {
+    TESTRPT("micreate_volume failed", r);
+    return;
+  }
+  micreate_volume_image(vol);
+
+  r = miget_volume_chunk_dims(vol, 3, chunk_dims);
+  if (r < 0) {
+    TESTRPT("miget_volume_chunk_dims failed", r);
+  }
+  else {
+    printf("chunk dims %s:", fname);
+    for (i = 0; i < 3; i++) {
+      printf("  %d", (int) chunk_dims[i]);
+      if (chunk_dims[i] != expected[i]) {
+        TESTRPT("wrong chunk size", (int) chunk_dims[i]);
+      }
+    }
+    printf("\n");
+  }
+
+  miclose_volume(vol);
+  if (props != NULL) {
+    mifree_volume_props(props);
+  }
+}
+
 
 int main(int argc, char **argv)
 {
@@ -75,6 +135,15 @@ int main(int argc, char **argv)
 
   mifree_volume_props(props);
 
+  {
+    static const int edge_lengths[3] = { 4, 8, 100 };
+    static const misize_t chunked[3] = { 4, 8, 30 };
+    static const misize_t contiguous[3] = { 10, 20, 30 };
+
+    test_chunk_dims("volprops-chunked.mnc", edge_lengths, chunked);
+    test_chunk_dims("volprops-contiguous.mnc", NULL, contiguous);
+  }
+
   while (--argc > 0) {
       r = miopen_volume(*++argv, MI2_OPEN_RDWR, &vol);
       if (r < 0) {
@@ -383,6 +383,51 @@ static void test4(struct testinfo *ip, struct dimdef *dims, int ndims)
   
 }
 
+/* Check the coordinates and range of the MINC 1.0 file through the
+ * MINC 2.0 API.
+ */
+static void test5(struct testinfo *ip, struct dimdef *dims, int ndims)
+{
+  mihandle_t vol;
+  midimhandle_t hdims[3];
+  double step, start;
+  double range[2];
+  int i;
+
+  if (miopen_volume(ip->name, MI2_OPEN_READ, &vol) < 0) {
+    FUNC_ERROR("miopen_volume");
+    return;
+  }
+
+  if (miget_volume_dimensions(vol, MI_DIMCLASS_ANY, MI_DIMATTR_ALL,
+                              MI_DIMORDER_FILE, ndims, hdims) != ndims) {
+    FUNC_ERROR("miget_volume_dimensions");
+  }
+  else {
+    for (i = 0; i < ndims; i++) {
+      if (miget_dimension_separation(hdims[i], MI_FILE_ORDER, &step) < 0 ||
+          miget_dimension_start(hdims[i], MI_FILE_ORDER, &start) < 0) {
+        FUNC_ERROR("miget_dimension_separation");
+      }
+      else if (step != 0.8 || start != 22.0) {
+        fprintf(stderr, "Bad coordinates for %s: %g %g\n", dims[i].name,
+                step, start);
+        errors++;
+      }
+    }
+  }
+
+  if (miget_volume_real_range(vol, range) < 0) {
+    FUNC_ERROR("miget_volume_real_range");
+  }
+  else if (range[0] != 0.0 || range[1] != (XSIZE * 10000.0)) {
+    fprintf(stderr, "miget_volume_real_range: bad result\n");
+    errors++;
+  }
+
+  miclose_volume(vol);
+}
+
 /* Test MINC API's 
  */
 int main(int argc, char **argv)
@@ -401,6 +446,8 @@ int main(int argc, char **argv)
   
   /*now let's use MINC2 API*/
   test4(&info, dimtab1, 3);
+
+  test5(&info, dimtab1, 3);
   
   /*unlink(info.name);*/		/* Delete the temporary file. */
 
@@ -0,0 +1,116 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <volume_io.h>
+#include <nifti1_io.h>
+
+/* Benchmark loading a compressed 4D NIfTI time series, with the NIfTI-1
+ * library and through volume_io, and check that the data read back is
+ * what was written.  Use a size like 128 128 64 1000 to get a 2GB volume.
+ */
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static short voxel_value(size_t i, size_t slice)
+{
+  return (short)((i % 251) * 7 + (i / slice) % 1000);
+}
+
+int main(int argc, char **argv)
+{
+  int dims[8] = { 4, 1, 1, 1, 1, 1, 1, 1 };
+  nifti_image *nim;
+  short *data;
+  size_t i, n, slice;
+  double t_write, t_read, t_input;
+  int d, x, y, z, t;
+  VIO_Volume volume;
+  int sizes[VIO_MAX_DIMENSIONS];
+
+  if (argc < 6) {
+    fprintf(stderr, "usage: %s nx ny nz nt file.nii.gz\n", argv[0]);
+    return 1;
+  }
+  for (d = 1; d <= 4; d++)
+    dims[d] = atoi(argv[d]);
+
+  nim = nifti_make_new_nim(dims, DT_INT16, 1);
+  if (nim == NULL || nifti_set_filenames(nim, argv[5], 0, 1) != 0) {
+    fprintf(stderr, "Failed to create %s\n", argv[5]);
+    return 1;
+  }
+
+  n = nim->nvox;
+  slice = (size_t)dims[1] * dims[2];
+  data = (short *)nim->data;
+  for (i = 0; i < n; i++)
+    data[i] = voxel_value(i, slice);
+
+  t_write = now();
+  nifti_image_write(nim);
+  t_write = now() - t_write;
+  nifti_image_free(nim);
+
+  t_read = now();
+  nim = nifti_image_read(argv[5], 1);
+  t_read = now() - t_read;
+  if (nim == NULL || nim->data == NULL || nim->nvox != n) {
+    fprintf(stderr, "Failed to read %s\n", argv[5]);
+    return 1;
+  }
+
+  data = (short *)nim->data;
+  for (i = 0; i < n; i++) {
+    if (data[i] != voxel_value(i, slice)) {
+      fprintf(stderr, "Data mismatch at voxel %lu\n", (unsigned long)i);
+      return 1;
+    }
+  }
+  nifti_image_free(nim);
+
+  t_input = now();
+  if (input_volume(argv[5], 4, NULL, MI_ORIGINAL_TYPE, FALSE, 0.0, 0.0,
+                   TRUE, &volume, NULL) != VIO_OK) {
+    fprintf(stderr, "Failed to input %s\n", argv[5]);
+    return 1;
+  }
+  t_input = now() - t_input;
+
+  get_volume_sizes(volume, sizes);
+  for (d = 0; d < 4; d++) {
+    if (sizes[d] != dims[d + 1]) {
+      fprintf(stderr, "Size mismatch on axis %d\n", d);
+      return 1;
+    }
+  }
+  i = 0;
+  for (t = 0; t < dims[4]; t++)
+    for (z = 0; z < dims[3]; z++)
+      for (y = 0; y < dims[2]; y++)
+        for (x = 0; x < dims[1]; x++, i++) {
+          if (get_volume_real_value(volume, x, y, z, t, 0) !=
+              voxel_value(i, slice)) {
+            fprintf(stderr, "Volume mismatch at voxel %lu\n",
+                    (unsigned long)i);
+            return 1;
+          }
+        }
+  delete_volume(volume);
+
+  printf("%dx%dx%dx%d voxels, %.1f MB\n", dims[1], dims[2], dims[3], dims[4],
+         n * sizeof(short) / 1048576.0);
+  printf("  write: %8.3f s\n", t_write);
+  printf("  read:  %8.3f s\n", t_read);
+  printf("  input: %8.3f s\n", t_input);
+  return 0;
+}
@@ -0,0 +1,225 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <volume_io.h>
+#include <nifti1.h>
+
+/* Write volumes to NIfTI-1 and MGH files through output_volume(), in
+ * the volume type and converted to other types, compressed and not, and
+ * as a NIfTI-1 .hdr/.img pair, and read them back through input_volume()
+ * to check the real values and, for NIfTI-1, the world coordinates of
+ * the voxels.
+ */
+
+#define NX 9
+#define NY 6
+#define NZ 5
+
+#define ERROR fprintf(stderr, "ERROR in %s:%d\n", __func__, __LINE__)
+
+static double real_value(int x, int y, int z)
+{
+  return 0.5 * (x + 10 * y + 100 * z) - 120.0;
+}
+
+/* Make a volume with the default zspace, yspace, xspace order, steps of
+ * different sizes and signs, and an offset.
+ */
+static VIO_Volume make_volume(nc_type nc_data_type, VIO_BOOL signed_flag)
+{
+  static VIO_STR dim_names[] = { MIzspace, MIyspace, MIxspace };
+  int sizes[3] = { NZ, NY, NX };
+  VIO_Real steps[3] = { 2.5, -1.5, 1.0 };
+  VIO_Real starts[3] = { -20.0, 15.0, 3.0 };
+  VIO_Volume volume;
+  int x, y, z;
+
+  volume = create_volume(3, dim_names, nc_data_type, signed_flag,
+                         0.0, 0.0);
+  set_volume_sizes(volume, sizes);
+  set_volume_separations(volume, steps);
+  set_volume_starts(volume, starts);
+  alloc_volume_data(volume);
+  set_volume_real_range(volume, real_value(0, 0, 0),
+                        real_value(NX - 1, NY - 1, NZ - 1));
+
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++)
+        set_volume_real_value(volume, z, y, x, 0, 0, real_value(x, y, z));
+
+  return volume;
+}
+
+/* Read the file back, and compare every voxel, looked up by its world
+ * position for NIfTI-1, or by its index for MGH.
+ */
+static int check_file(VIO_Volume volume, const char *fname,
+                      double tolerance, int check_world)
+{
+  VIO_Volume file_volume;
+  int sizes[VIO_MAX_DIMENSIONS], file_sizes[VIO_MAX_DIMENSIONS];
+  int x, y, z, errors = 0;
+
+  if (input_volume((char *) fname, 3, XYZ_dimension_names, MI_ORIGINAL_TYPE,
+                   FALSE, 0.0, 0.0, TRUE, &file_volume, NULL) != VIO_OK)
+  {
+    ERROR;
+    return 1;
+  }
+
+  get_volume_sizes(volume, sizes);
+  get_volume_sizes(file_volume, file_sizes);
+  if (file_sizes[0] != NX || file_sizes[1] != NY || file_sizes[2] != NZ)
+  {
+    fprintf(stderr, "%s: sizes %d %d %d\n", fname,
+            file_sizes[0], file_sizes[1], file_sizes[2]);
+    delete_volume(file_volume);
+    return 1;
+  }
+
+  for (z = 0; z < NZ && errors < 5; z++)
+  {
+    for (y = 0; y < NY && errors < 5; y++)
+    {
+      for (x = 0; x < NX && errors < 5; x++)
+      {
+        double expected = real_value(x, y, z);
+        double value = get_volume_real_value(file_volume, x, y, z, 0, 0);
+
+        if (check_world)
+        {
+          VIO_Real wx, wy, wz, fx, fy, fz;
+
+          convert_3D_voxel_to_world(volume, z, y, x, &wx, &wy, &wz);
+          convert_3D_voxel_to_world(file_volume, x, y, z, &fx, &fy, &fz);
+          if (fabs(wx - fx) > 1e-4 || fabs(wy - fy) > 1e-4 ||
+              fabs(wz - fz) > 1e-4)
+          {
+            fprintf(stderr, "%s: voxel (%d,%d,%d) is at (%g,%g,%g), "
+                    "expected (%g,%g,%g)\n", fname, x, y, z,
+                    fx, fy, fz, wx, wy, wz);
+            errors++;
+          }
+        }
+
+        if (fabs(value - expected) > tolerance)
+        {
+          fprintf(stderr, "%s: voxel (%d,%d,%d) is %g, expected %g\n",
+                  fname, x, y, z, value, expected);
+          errors++;
+        }
+      }
+    }
+  }
+
+  delete_volume(file_volume);
+  return errors != 0;
+}
+
+/* Check that a NIfTI-1 pair was written as a header of 348 bytes with
+ * the pair magic, and an image file holding the voxels.
+ */
+static int check_pair(const char *hdr_name, const char *img_name)
+{
+  nifti_1_header hdr;
+  FILE *fp;
+  long img_size;
+
+  fp = fopen(hdr_name, "rb");
+  if (fp == NULL || fread(&hdr, sizeof(hdr), 1, fp) != 1)
+  {
+    fprintf(stderr, "%s: no header\n", hdr_name);
+    return 1;
+  }
+  fseek(fp, 0, SEEK_END);
+  if (ftell(fp) != (long) sizeof(hdr) && ftell(fp) != (long) sizeof(hdr) + 4)
+  {
+    fprintf(stderr, "%s: header is %ld bytes\n", hdr_name, ftell(fp));
+    fclose(fp);
+    return 1;
+  }
+  fclose(fp);
+  if (strcmp(hdr.magic, "ni1") != 0)
+  {
+    fprintf(stderr, "%s: magic is '%.4s'\n", hdr_name, hdr.magic);
+    return 1;
+  }
+
+  fp = fopen(img_name, "rb");
+  if (fp == NULL)
+  {
+    fprintf(stderr, "%s: not written\n", img_name);
+    return 1;
+  }
+  fseek(fp, 0, SEEK_END);
+  img_size = ftell(fp);
+  fclose(fp);
+  if (img_size != (long) NX * NY * NZ * (long) sizeof(short))
+  {
+    fprintf(stderr, "%s: image is %ld bytes\n", img_name, img_size);
+    return 1;
+  }
+  return 0;
+}
+
+static int write_and_check(VIO_Volume volume, const char *fname,
+                           nc_type nc_data_type, VIO_BOOL signed_flag,
+                           double tolerance, int check_world)
+{
+  if (output_volume((char *) fname, nc_data_type, signed_flag, 0.0, 0.0,
+                    volume, NULL, NULL) != VIO_OK)
+  {
+    fprintf(stderr, "%s: failed to write\n", fname);
+    return 1;
+  }
+  return check_file(volume, fname, tolerance, check_world);
+}
+
+int main(void)
+{
+  VIO_Volume short_volume = make_volume(NC_SHORT, TRUE);
+  VIO_Volume float_volume = make_volume(NC_FLOAT, TRUE);
+  double byte_step = (real_value(NX - 1, NY - 1, NZ - 1) -
+                      real_value(0, 0, 0)) / 255.0;
+  int errors = 0;
+
+  /* NIfTI-1 in the volume type, with the volume scaling */
+  errors += write_and_check(short_volume, "nii_output_short.nii",
+                            MI_ORIGINAL_TYPE, FALSE, 1e-2, 1);
+  errors += write_and_check(short_volume, "nii_output_short.nii.gz",
+                            MI_ORIGINAL_TYPE, FALSE, 1e-2, 1);
+  errors += write_and_check(float_volume, "nii_output_float.nii",
+                            MI_ORIGINAL_TYPE, FALSE, 1e-4, 1);
+
+  /* NIfTI-1 as a .hdr/.img pair */
+  errors += write_and_check(short_volume, "nii_output_pair.hdr",
+                            MI_ORIGINAL_TYPE, FALSE, 1e-2, 1);
+  errors += check_pair("nii_output_pair.hdr", "nii_output_pair.img");
+
+  /* converted, and scaled to the range of the file type */
+  errors += write_and_check(short_volume, "nii_output_byte.nii.gz",
+                            NC_BYTE, FALSE, byte_step, 1);
+  errors += write_and_check(float_volume, "nii_output_int.nii",
+                            NC_INT, TRUE, 1e-4, 1);
+
+  /* MGH holds real values */
+  errors += write_and_check(short_volume, "mgh_output_short.mgh",
+                            MI_ORIGINAL_TYPE, FALSE, 1e-2, 0);
+  errors += write_and_check(float_volume, "mgh_output_float.mgz",
+                            MI_ORIGINAL_TYPE, FALSE, 1e-4, 0);
+  errors += write_and_check(float_volume, "mgh_output_int.mgz",
+                            NC_INT, TRUE, 0.5, 0);
+
+  delete_volume(short_volume);
+  delete_volume(float_volume);
+
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors != 0;
+}
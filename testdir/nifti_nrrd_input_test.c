@@ -0,0 +1,500 @@
+#define _GNU_SOURCE 1
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <volume_io.h>
+#include <nifti1_io.h>
+#include <zlib.h>
+
+/* Load NIfTI-1 and NRRD files through volume_io, both from compressed
+ * files and through the file mapping used for uncompressed data, with
+ * the file axes in the volume order or reversed, and in either byte
+ * order, and ASCII NRRD files, and check the voxels against the values
+ * written. Ranges of frames are also loaded from a NIfTI-1 time series.
+ */
+
+#define NX 7
+#define NY 5
+#define NZ 4
+#define NT 6
+
+#define ERROR fprintf(stderr, "ERROR in %s:%d\n", __func__, __LINE__)
+
+static double file_value(int i, int j, int k)
+{
+  return i + 10 * j + 100 * k - 150;
+}
+
+static void swap_bytes(void *data, size_t n, int size)
+{
+  unsigned char *p = data;
+  size_t i;
+  int b;
+
+  for (i = 0; i < n; i++, p += size)
+  {
+    for (b = 0; b < size / 2; b++)
+    {
+      unsigned char t = p[b];
+      p[b] = p[size - 1 - b];
+      p[size - 1 - b] = t;
+    }
+  }
+}
+
+static int machine_is_little_endian(void)
+{
+  short one = 1;
+  return *(char *) &one;
+}
+
+/* Write a NIfTI-1 file of shorts or floats, with the first file axis
+ * along x, or along z if reversed.
+ */
+static int write_nifti(const char *fname, int datatype, int reversed,
+                       int swapped)
+{
+  int dims[8] = { 3, NX, NY, NZ, 1, 1, 1, 1 };
+  nifti_image *nim;
+  struct nifti_1_header hdr;
+  char ext[4] = { 0, 0, 0, 0 };
+  size_t i, n = (size_t) NX * NY * NZ;
+  FILE *fp;
+  int a;
+
+  nim = nifti_make_new_nim(dims, datatype, 1);
+  if (nim == NULL)
+    return 1;
+
+  for (i = 0; i < n; i++)
+  {
+    double v = file_value(i % NX, (i / NX) % NY, i / (NX * NY));
+    if (datatype == DT_INT16)
+      ((short *) nim->data)[i] = (short) v;
+    else
+      ((float *) nim->data)[i] = (float) v;
+  }
+  if (datatype == DT_FLOAT32)
+    ((float *) nim->data)[1] = NAN;
+
+  nim->sform_code = NIFTI_XFORM_SCANNER_ANAT;
+  memset(&nim->sto_xyz, 0, sizeof(nim->sto_xyz));
+  for (a = 0; a < 3; a++)
+  {
+    int spatial = reversed ? 2 - a : a;
+    nim->sto_xyz.m[spatial][a] = 1.0f;
+  }
+  nim->sto_xyz.m[3][3] = 1.0f;
+  nim->sto_ijk = nifti_mat44_inverse(nim->sto_xyz);
+
+  if (strstr(fname, ".gz") != NULL)
+  {
+    if (nifti_set_filenames(nim, fname, 0, 1) != 0)
+      return 1;
+    nifti_image_write(nim);
+    nifti_image_free(nim);
+    return 0;
+  }
+
+  /* Write the file by hand, so the byte order can be chosen.
+   */
+  hdr = nifti_convert_nim2nhdr(nim);
+  hdr.vox_offset = 352;
+  memcpy(hdr.magic, "n+1", 4);
+  if (swapped)
+  {
+    swap_nifti_header(&hdr, 1);
+    swap_bytes(nim->data, n, nim->nbyper);
+  }
+  fp = fopen(fname, "wb");
+  if (fp == NULL ||
+      fwrite(&hdr, sizeof(hdr), 1, fp) != 1 ||
+      fwrite(ext, 4, 1, fp) != 1 ||
+      fwrite(nim->data, nim->nbyper, n, fp) != n)
+    return 1;
+  fclose(fp);
+  nifti_image_free(nim);
+  return 0;
+}
+
+/* Write a NIfTI-1 time series of shorts, with each frame offset by
+ * 1000 times its index.
+ */
+static int write_nifti_series(const char *fname)
+{
+  int dims[8] = { 4, NX, NY, NZ, NT, 1, 1, 1 };
+  nifti_image *nim;
+  size_t i, n = (size_t) NX * NY * NZ;
+  int t;
+
+  nim = nifti_make_new_nim(dims, DT_INT16, 1);
+  if (nim == NULL)
+    return 1;
+
+  for (t = 0; t < NT; t++)
+    for (i = 0; i < n; i++)
+      ((short *) nim->data)[t * n + i] =
+        (short) (file_value(i % NX, (i / NX) % NY, i / (NX * NY)) + 1000 * t);
+
+  nim->sform_code = NIFTI_XFORM_SCANNER_ANAT;
+  memset(&nim->sto_xyz, 0, sizeof(nim->sto_xyz));
+  for (t = 0; t < 4; t++)
+    nim->sto_xyz.m[t][t] = 1.0f;
+  nim->sto_ijk = nifti_mat44_inverse(nim->sto_xyz);
+
+  nim->dt = nim->pixdim[4] = 2.0f;
+  nim->toffset = 10.0f;
+  nim->time_units = NIFTI_UNITS_SEC;
+
+  if (nifti_set_filenames(nim, fname, 0, 1) != 0)
+    return 1;
+  nifti_image_write(nim);
+  nifti_image_free(nim);
+  return 0;
+}
+
+/* Load frames first to first + count - 1 of the time series, or to the
+ * last frame if count is zero, and check the voxels and frame times.
+ */
+static int check_frames(const char *fname, int first, int count)
+{
+  VIO_Volume volume;
+  minc_input_options options;
+  int sizes[VIO_MAX_DIMENSIONS];
+  VIO_Real starts[VIO_MAX_DIMENSIONS];
+  int i, j, k, t;
+  int errors = 0;
+
+  set_default_minc_input_options(&options);
+  set_minc_input_nonspatial_range(&options, 0, first, count);
+  if (count == 0)
+    count = NT - first;
+
+  if (input_volume((char *) fname, 4, NULL, MI_ORIGINAL_TYPE, FALSE,
+                   0.0, 0.0, TRUE, &volume, &options) != VIO_OK)
+  {
+    ERROR;
+    return 1;
+  }
+
+  get_volume_sizes(volume, sizes);
+  get_volume_starts(volume, starts);
+  if (get_volume_n_dimensions(volume) != 4 || sizes[0] != NX ||
+      sizes[1] != NY || sizes[2] != NZ || sizes[3] != count)
+  {
+    fprintf(stderr, "%s: sizes %d %d %d %d\n", fname,
+            sizes[0], sizes[1], sizes[2], sizes[3]);
+    delete_volume(volume);
+    return 1;
+  }
+  if (fabs(starts[3] - (10.0 + 2.0 * first)) > 1e-4)
+  {
+    fprintf(stderr, "%s: frames start at %g\n", fname, starts[3]);
+    errors++;
+  }
+
+  for (t = 0; t < count; t++)
+  {
+    for (k = 0; k < NZ; k++)
+    {
+      for (j = 0; j < NY; j++)
+      {
+        for (i = 0; i < NX; i++)
+        {
+          double expected = file_value(i, j, k) + 1000 * (first + t);
+          double value = get_volume_real_value(volume, i, j, k, t, 0);
+
+          if (fabs(value - expected) > 1e-4 && errors < 5)
+          {
+            fprintf(stderr, "%s: voxel (%d,%d,%d,%d) is %g, expected %g\n",
+                    fname, i, j, k, t, value, expected);
+            errors++;
+          }
+        }
+      }
+    }
+  }
+
+  delete_volume(volume);
+  return errors != 0;
+}
+
+/* Write a raw or gzip encoded NRRD file of shorts.
+ */
+static int write_nrrd(const char *fname, int reversed, int swapped,
+                      int gzipped)
+{
+  short data[NX * NY * NZ];
+  size_t i, n = (size_t) NX * NY * NZ;
+  int little = machine_is_little_endian() ? !swapped : swapped;
+  char header[512];
+  FILE *fp;
+  gzFile gzfp;
+
+  for (i = 0; i < n; i++)
+    data[i] = (short) file_value(i % NX, (i / NX) % NY, i / (NX * NY));
+  if (swapped)
+    swap_bytes(data, n, sizeof(short));
+
+  snprintf(header, sizeof(header),
+           "NRRD0004\ntype: short\ndimension: 3\nspace: RAS\n"
+           "sizes: %d %d %d\nspace directions: %s\n"
+           "space origin: (0,0,0)\nencoding: %s\nendian: %s\n",
+           NX, NY, NZ,
+           reversed ? "(0,0,1) (0,1,0) (1,0,0)" : "(1,0,0) (0,1,0) (0,0,1)",
+           gzipped ? "gzip" : "raw", little ? "little" : "big");
+
+  /* keep the data aligned, or it cannot be used in place */
+  if (strlen(header) % 2 == 0)
+    strcat(header, "# \n");
+  strcat(header, "\n");
+
+  fp = fopen(fname, "wb");
+  if (fp == NULL || fputs(header, fp) == EOF)
+    return 1;
+  if (gzipped)
+  {
+    /* the compressed data follows the header as a gzip member */
+    fclose(fp);
+    gzfp = gzopen(fname, "ab");
+    if (gzfp == NULL ||
+        gzwrite(gzfp, data, n * sizeof(short)) != (int) (n * sizeof(short)))
+      return 1;
+    gzclose(gzfp);
+    return 0;
+  }
+  if (fwrite(data, sizeof(short), n, fp) != n)
+    return 1;
+  fclose(fp);
+  return 0;
+}
+
+/* Write an ASCII NRRD file of the given type, with the values spread
+ * over lines of different lengths and separated by assorted white space.
+ */
+static int write_ascii_nrrd(const char *fname, const char *type,
+                            int nx, int ny, int nz)
+{
+  static const char *separators[] = { " ", "  ", "\t", "\n", " \r\n" };
+  size_t i, n = (size_t) nx * ny * nz;
+  FILE *fp;
+
+  fp = fopen(fname, "w");
+  if (fp == NULL)
+    return 1;
+
+  fprintf(fp, "NRRD0004\ntype: %s\ndimension: 3\nspace: RAS\n"
+          "sizes: %d %d %d\n"
+          "space directions: (1,0,0) (0,1,0) (0,0,1)\n"
+          "space origin: (0,0,0)\nencoding: ascii\n\n", type, nx, ny, nz);
+
+  for (i = 0; i < n; i++)
+  {
+    double v = file_value(i % nx, (i / nx) % ny, i / ((size_t) nx * ny));
+    if (strcmp(type, "float") == 0)
+      fprintf(fp, "%.2f", v / 4.0);
+    else
+      fprintf(fp, "%+d", (int) v);
+    fputs(separators[i % 7 % 5], fp);
+  }
+  fclose(fp);
+  return 0;
+}
+
+/* Load a large ASCII NRRD file converted by one thread and by several,
+ * and check every voxel.
+ */
+static int check_ascii_volume(const char *fname, int nx, int ny, int nz)
+{
+  static const char *n_threads[] = { "1", "4" };
+  VIO_Volume volume;
+  int sizes[VIO_MAX_DIMENSIONS];
+  int t, i, j, k;
+  int errors = 0;
+
+  for (t = 0; t < 2; t++)
+  {
+    setenv("VOLUME_IO_NRRD_THREADS", n_threads[t], 1);
+    if (input_volume((char *) fname, 3, NULL, MI_ORIGINAL_TYPE, FALSE,
+                     0.0, 0.0, TRUE, &volume, NULL) != VIO_OK)
+    {
+      ERROR;
+      return 1;
+    }
+
+    get_volume_sizes(volume, sizes);
+    if (sizes[0] != nx || sizes[1] != ny || sizes[2] != nz)
+    {
+      ERROR;
+      return 1;
+    }
+
+    for (i = 0; i < nx && errors < 5; i++)
+    {
+      for (j = 0; j < ny && errors < 5; j++)
+      {
+        for (k = 0; k < nz && errors < 5; k++)
+        {
+          double expected = file_value(i, j, k) / 4.0;
+          double value = get_volume_real_value(volume, i, j, k, 0, 0);
+
+          if (value != expected)
+          {
+            fprintf(stderr, "%s, %s threads: voxel (%d,%d,%d) is %g, "
+                    "expected %g\n", fname, n_threads[t], i, j, k,
+                    value, expected);
+            errors++;
+          }
+        }
+      }
+    }
+    delete_volume(volume);
+  }
+  unsetenv("VOLUME_IO_NRRD_THREADS");
+  return errors != 0;
+}
+
+/* Load the file, and check the voxels and whether the volume uses the
+ * file mapping as its storage.
+ */
+static int check_volume(const char *fname, int reversed, int nan_voxel,
+                        int expect_mapped)
+{
+  VIO_Volume volume;
+  int sizes[VIO_MAX_DIMENSIONS];
+  int i, j, k;
+  int errors = 0;
+
+  if (input_volume((char *) fname, 3, NULL, MI_ORIGINAL_TYPE, FALSE,
+                   0.0, 0.0, TRUE, &volume, NULL) != VIO_OK)
+  {
+    ERROR;
+    return 1;
+  }
+
+  /* with reversed axes, volume voxel (i,j,k) is file voxel (k,j,i) */
+  get_volume_sizes(volume, sizes);
+  if (sizes[0] != (reversed ? NZ : NX) || sizes[1] != NY ||
+      sizes[2] != (reversed ? NX : NZ))
+  {
+    ERROR;
+    return 1;
+  }
+
+  if (volume->external_storage != expect_mapped)
+  {
+    fprintf(stderr, "%s: expected the volume %sto use the file mapping\n",
+            fname, expect_mapped ? "" : "not ");
+    errors++;
+  }
+
+  for (i = 0; i < sizes[0]; i++)
+  {
+    for (j = 0; j < sizes[1]; j++)
+    {
+      for (k = 0; k < sizes[2]; k++)
+      {
+        int fi = reversed ? k : i;
+        int fk = reversed ? i : k;
+        double expected = file_value(fi, j, fk);
+        double value = get_volume_real_value(volume, i, j, k, 0, 0);
+
+        /* the invalid float is file voxel (1,0,0) */
+        if (nan_voxel && fi == 1 && j == 0 && fk == 0)
+          expected = 0.0;
+        if (fabs(value - expected) > 1e-4)
+        {
+          fprintf(stderr, "%s: voxel (%d,%d,%d) is %g, expected %g\n",
+                  fname, i, j, k, value, expected);
+          errors++;
+        }
+      }
+    }
+  }
+
+  delete_volume(volume);
+  return errors != 0;
+}
+
+int main(void)
+{
+  int errors = 0;
+
+  /* NIfTI-1, compressed, read slice by slice */
+  errors += write_nifti("nii_input_gz.nii.gz", DT_INT16, 0, 0);
+  errors += check_volume("nii_input_gz.nii.gz", 0, 0, 0);
+
+  /* NIfTI-1, mapped and converted into the volume */
+  errors += write_nifti("nii_input_map.nii", DT_INT16, 0, 0);
+  errors += check_volume("nii_input_map.nii", 0, 0, 0);
+
+  /* NIfTI-1, other byte order, read slice by slice */
+  errors += write_nifti("nii_input_swap.nii", DT_INT16, 0, 1);
+  errors += check_volume("nii_input_swap.nii", 0, 0, 0);
+
+  /* NIfTI-1, axes in volume order, mapped as the volume storage */
+  errors += write_nifti("nii_input_rev.nii", DT_INT16, 1, 0);
+  errors += check_volume("nii_input_rev.nii", 1, 0, 1);
+
+  errors += write_nifti("nii_input_rev_swap.nii", DT_INT16, 1, 1);
+  errors += check_volume("nii_input_rev_swap.nii", 1, 0, 1);
+
+  /* invalid floats are set to zero on every path */
+  errors += write_nifti("nii_input_float.nii", DT_FLOAT32, 0, 0);
+  errors += check_volume("nii_input_float.nii", 0, 1, 0);
+
+  errors += write_nifti("nii_input_rev_float.nii", DT_FLOAT32, 1, 0);
+  errors += check_volume("nii_input_rev_float.nii", 1, 1, 1);
+
+  errors += write_nifti("nii_input_float.nii.gz", DT_FLOAT32, 0, 0);
+  errors += check_volume("nii_input_float.nii.gz", 0, 1, 0);
+
+  /* ranges of frames from a time series, mapped, and seeking through
+   * compressed data
+   */
+  errors += write_nifti_series("nii_input_series.nii");
+  errors += check_frames("nii_input_series.nii", 2, 3);
+  errors += check_frames("nii_input_series.nii", 4, 0);
+  errors += write_nifti_series("nii_input_series.nii.gz");
+  errors += check_frames("nii_input_series.nii.gz", 1, 2);
+  errors += check_frames("nii_input_series.nii.gz", 5, 1);
+
+  /* NRRD, the same cases */
+  errors += write_nrrd("nrrd_input_map.nrrd", 0, 0, 0);
+  errors += check_volume("nrrd_input_map.nrrd", 0, 0, 0);
+
+  errors += write_nrrd("nrrd_input_swap.nrrd", 0, 1, 0);
+  errors += check_volume("nrrd_input_swap.nrrd", 0, 0, 0);
+
+  errors += write_nrrd("nrrd_input_rev.nrrd", 1, 0, 0);
+  errors += check_volume("nrrd_input_rev.nrrd", 1, 0, 1);
+
+  errors += write_nrrd("nrrd_input_rev_swap.nrrd", 1, 1, 0);
+  errors += check_volume("nrrd_input_rev_swap.nrrd", 1, 0, 1);
+
+  /* gzip NRRD, inflated ahead of the reader */
+  errors += write_nrrd("nrrd_input_gz.nrrd", 0, 0, 1);
+  errors += check_volume("nrrd_input_gz.nrrd", 0, 0, 0);
+
+  errors += write_nrrd("nrrd_input_gz_swap.nrrd", 0, 1, 1);
+  errors += check_volume("nrrd_input_gz_swap.nrrd", 0, 0, 0);
+
+  /* ASCII NRRD, read slice by slice, and large enough to be converted
+   * in parallel
+   */
+  errors += write_ascii_nrrd("nrrd_input_ascii.nrrd", "short", NX, NY, NZ);
+  errors += check_volume("nrrd_input_ascii.nrrd", 0, 0, 0);
+
+  errors += write_ascii_nrrd("nrrd_input_ascii_float.nrrd", "float",
+                             160, 128, 96);
+  errors += check_ascii_volume("nrrd_input_ascii_float.nrrd", 160, 128, 96);
+
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors != 0;
+}
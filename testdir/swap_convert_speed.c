@@ -0,0 +1,233 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <sys/time.h>
+#include "swap_convert.h"
+
+/* Check minc_swap_convert() for every pair of types and byte orders,
+ * in separate and shared buffers, against one element at a time, then
+ * time byte swapping and conversion from the size of a slice to the
+ * size of a whole volume.
+ */
+
+#define N_TYPES 8
+#define N_CHECK 2503            /* not a multiple of any block size */
+
+static const char *type_names[N_TYPES] = {
+  "ubyte", "byte", "ushort", "short", "uint", "int", "float", "double"
+};
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static void swap_one(unsigned char *p, size_t size)
+{
+  size_t j;
+
+  for (j = 0; j < size / 2; j++)
+  {
+    unsigned char t = p[j];
+    p[j] = p[size - 1 - j];
+    p[size - 1 - j] = t;
+  }
+}
+
+static double get_value(const void *p, minc_value_type type)
+{
+  switch (type)
+  {
+  case MINC_VALUE_UBYTE:  return *(const unsigned char *) p;
+  case MINC_VALUE_BYTE:   return *(const signed char *) p;
+  case MINC_VALUE_USHORT: return *(const unsigned short *) p;
+  case MINC_VALUE_SHORT:  return *(const short *) p;
+  case MINC_VALUE_UINT:   return *(const unsigned int *) p;
+  case MINC_VALUE_INT:    return *(const int *) p;
+  case MINC_VALUE_FLOAT:  return *(const float *) p;
+  case MINC_VALUE_DOUBLE: return *(const double *) p;
+  }
+  return 0.0;
+}
+
+/* Reference conversion of one value, clamped and truncated. */
+static void put_value(void *p, minc_value_type type, double v)
+{
+  double lo = 0.0, hi = 0.0;
+
+  switch (type)
+  {
+  case MINC_VALUE_UBYTE:  lo = 0;         hi = UCHAR_MAX; break;
+  case MINC_VALUE_BYTE:   lo = SCHAR_MIN; hi = SCHAR_MAX; break;
+  case MINC_VALUE_USHORT: lo = 0;         hi = USHRT_MAX; break;
+  case MINC_VALUE_SHORT:  lo = SHRT_MIN;  hi = SHRT_MAX;  break;
+  case MINC_VALUE_UINT:   lo = 0;         hi = UINT_MAX;  break;
+  case MINC_VALUE_INT:    lo = INT_MIN;   hi = INT_MAX;   break;
+  case MINC_VALUE_FLOAT:  *(float *) p = (float) v;        return;
+  case MINC_VALUE_DOUBLE: *(double *) p = v;               return;
+  }
+  if (v != v)
+    v = 0.0;
+  v = v < lo ? lo : v > hi ? hi : v;
+  switch (type)
+  {
+  case MINC_VALUE_UBYTE:  *(unsigned char *) p = (unsigned char) v;   break;
+  case MINC_VALUE_BYTE:   *(signed char *) p = (signed char) v;       break;
+  case MINC_VALUE_USHORT: *(unsigned short *) p = (unsigned short) v; break;
+  case MINC_VALUE_SHORT:  *(short *) p = (short) v;                   break;
+  case MINC_VALUE_UINT:   *(unsigned int *) p = (unsigned int) v;     break;
+  case MINC_VALUE_INT:    *(int *) p = (int) v;                       break;
+  default: break;
+  }
+}
+
+/* Values covering the range of every type, with some out of range. */
+static double test_value(size_t i)
+{
+  if (i == 17)
+    return NAN;
+  return ((double) (i * 7919 % 2003) - 1001.0) * (i % 3 == 0 ? 3.7e6 : 0.731);
+}
+
+static int check_pair(minc_value_type dst_type, minc_value_type src_type,
+                      int flags, int shared)
+{
+  size_t src_size = minc_value_size(src_type);
+  size_t dst_size = minc_value_size(dst_type);
+  unsigned char *src = malloc(N_CHECK * 8);
+  unsigned char *dst = malloc(N_CHECK * 8);
+  unsigned char *expected = malloc(N_CHECK * 8);
+  unsigned char elem[8];
+  size_t i;
+  int errors = 0;
+
+  for (i = 0; i < N_CHECK; i++)
+  {
+    put_value(src + i * src_size, src_type, test_value(i));
+
+    /* one element at a time */
+    memcpy(elem, src + i * src_size, src_size);
+    put_value(expected + i * dst_size, dst_type, get_value(elem, src_type));
+    if (flags & MINC_SWAP_DST)
+      swap_one(expected + i * dst_size, dst_size);
+    if (flags & MINC_SWAP_SRC)
+      swap_one(src + i * src_size, src_size);
+  }
+
+  if (shared)
+  {
+    memcpy(dst, src, N_CHECK * src_size);
+    minc_swap_convert(dst, dst_type, dst, src_type, N_CHECK, flags);
+  }
+  else
+  {
+    minc_swap_convert(dst, dst_type, src, src_type, N_CHECK, flags);
+  }
+
+  for (i = 0; i < N_CHECK && errors < 5; i++)
+  {
+    if (memcmp(dst + i * dst_size, expected + i * dst_size, dst_size) != 0)
+    {
+      fprintf(stderr, "%s to %s, flags %d%s: element %lu differs\n",
+              type_names[src_type], type_names[dst_type], flags,
+              shared ? ", in place" : "", (unsigned long) i);
+      errors++;
+    }
+  }
+
+  free(src);
+  free(dst);
+  free(expected);
+  return errors;
+}
+
+/* Time the conversion of a short volume to float, and swapping of the
+ * shorts, against a plain loop.
+ */
+static int time_size(size_t n, int repeat)
+{
+  short *src = malloc(n * sizeof(short));
+  float *dst = malloc(n * sizeof(float));
+  double t_loop, t_swap, t_conv;
+  size_t i;
+  int r;
+
+  if (src == NULL || dst == NULL)
+    return 1;
+
+  for (i = 0; i < n; i++)
+    src[i] = (short) (i * 31);
+
+  t_loop = now();
+  for (r = 0; r < repeat; r++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      short v = src[i];
+      swap_one((unsigned char *) &v, sizeof(v));
+      dst[i] = (float) v;
+    }
+  }
+  t_loop = (now() - t_loop) / repeat;
+
+  t_swap = now();
+  for (r = 0; r < repeat; r++)
+    minc_swap_bytes(src, n, sizeof(short));
+  t_swap = (now() - t_swap) / repeat;
+
+  t_conv = now();
+  for (r = 0; r < repeat; r++)
+    minc_swap_convert(dst, MINC_VALUE_FLOAT, src, MINC_VALUE_SHORT, n,
+                      MINC_SWAP_SRC);
+  t_conv = (now() - t_conv) / repeat;
+
+  printf("%10lu voxels: swap %8.3f ms, swap+convert %8.3f ms, "
+         "plain loop %8.3f ms\n", (unsigned long) n,
+         t_swap * 1e3, t_conv * 1e3, t_loop * 1e3);
+
+  free(src);
+  free(dst);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  size_t slice, volume, n;
+  int s, d, flags, shared;
+  int errors = 0;
+
+  if (argc < 4)
+  {
+    fprintf(stderr, "usage: %s nx ny nz\n", argv[0]);
+    return 1;
+  }
+  slice = (size_t) atoi(argv[1]) * atoi(argv[2]);
+  volume = slice * atoi(argv[3]);
+
+  for (s = 0; s < N_TYPES; s++)
+    for (d = 0; d < N_TYPES; d++)
+      for (flags = 0; flags < 4; flags++)
+        for (shared = 0; shared < 2; shared++)
+          errors += check_pair((minc_value_type) d, (minc_value_type) s,
+                               flags, shared);
+
+  if (errors)
+  {
+    fprintf(stderr, "%d errors\n", errors);
+    return 1;
+  }
+
+  for (n = slice; n < volume; n *= 4)
+    errors += time_size(n, 8);
+  errors += time_size(volume, 2);
+
+  return errors != 0;
+}
@@ -4,6 +4,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <minc.h>
 #include <float.h>
 
@@ -33,9 +35,12 @@ char *nctypename(nc_type datatype)
     return "unknown";
 }
 
+/* Read the file slice by slice through an icv of the given type, with
+   the x axis flipped if xdir is MI_ICV_NEGATIVE, and report the range of
+   each slice and the rate at which voxels were converted. */
 int
 test_icv_read(char *filename, int xsize, int ysize, double image_min,
-              double image_max, nc_type datatype, char *signtype)
+              double image_max, nc_type datatype, char *signtype, int xdir)
 {
    int icv, cdfid, img, ndims;
    static long coord[MAX_VAR_DIMS];
@@ -46,6 +51,8 @@ test_icv_read(char *filename, int xsize, int ysize, double image_min,
    int i;
    double min, max;
    int n;
+   clock_t start_time;
+   double seconds;
 
    min = DBL_MAX;
    max = -DBL_MAX;
@@ -57,7 +64,7 @@ test_icv_read(char *filename, int xsize, int ysize, double image_min,
 
    /* Create the icv */
    icv=miicv_create();
-   (void) miicv_setint(icv, MI_ICV_XDIM_DIR, MI_ICV_POSITIVE);
+   (void) miicv_setint(icv, MI_ICV_XDIM_DIR, xdir);
    (void) miicv_setint(icv, MI_ICV_YDIM_DIR, MI_ICV_POSITIVE);
    (void) miicv_setint(icv, MI_ICV_ZDIM_DIR, MI_ICV_POSITIVE);
    (void) miicv_setint(icv, MI_ICV_ADIM_SIZE, xsize);
@@ -91,9 +98,12 @@ test_icv_read(char *filename, int xsize, int ysize, double image_min,
    coord[2]=0;
 
    /* Get the data */
+   seconds = 0.0;
    for (i=0; i<dim_size; i++) {
       coord[0]=i;
+      start_time = clock();
       (void) miicv_get(icv, coord, count, image);
+      seconds += (double) (clock() - start_time) / CLOCKS_PER_SEC;
 
       switch (datatype) {
       case NC_BYTE:
@@ -194,6 +204,12 @@ test_icv_read(char *filename, int xsize, int ysize, double image_min,
       printf("%d %s %s %f %f\n", i, signtype, nctypename(datatype), min, max);
    }
 
+   if (seconds > 0.0) {
+      printf("%s %s%s: %.1f Mvoxels/s\n", signtype, nctypename(datatype),
+             (xdir == MI_ICV_NEGATIVE) ? " flipped" : "",
+             (double) dim_size * xsize * ysize / seconds / 1.0e6);
+   }
+
    /* Close the file and free the icv */
    (void) miclose(cdfid);
    (void) miicv_free(icv);
@@ -202,11 +218,14 @@ test_icv_read(char *filename, int xsize, int ysize, double image_min,
    return (NORMAL_STATUS);
 }
 
+int
 main(int argc, char *argv[])
 {
    int xsize, ysize;
    double image_max, image_min;
    char *pname, *filename;
+   static int xdirs[2] = {MI_ICV_POSITIVE, MI_ICV_NEGATIVE};
+   int idir, xdir;
 
    /* Parse the command line */
    pname=argv[0];
@@ -221,26 +240,28 @@ main(int argc, char *argv[])
    image_min=atof(argv[4]);
    image_max=atof(argv[5]);
 
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_BYTE, MI_UNSIGNED);
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_SHORT, MI_UNSIGNED);
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_INT, MI_UNSIGNED);
-
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_BYTE, MI_SIGNED);
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_SHORT, MI_SIGNED);
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_INT, MI_SIGNED);
-
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_FLOAT, MI_SIGNED);
-   test_icv_read(filename, xsize, ysize, image_min, image_max, 
-                 NC_DOUBLE, MI_SIGNED);
+   /* Each type as stored, and with the rows flipped */
+   for (idir = 0; idir < 2; idir++) {
+      xdir = xdirs[idir];
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_BYTE, MI_UNSIGNED, xdir);
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_SHORT, MI_UNSIGNED, xdir);
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_INT, MI_UNSIGNED, xdir);
 
-   return NORMAL_STATUS;
-}
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_BYTE, MI_SIGNED, xdir);
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_SHORT, MI_SIGNED, xdir);
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_INT, MI_SIGNED, xdir);
 
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_FLOAT, MI_SIGNED, xdir);
+      test_icv_read(filename, xsize, ysize, image_min, image_max, 
+                    NC_DOUBLE, MI_SIGNED, xdir);
+   }
 
+   return NORMAL_STATUS;
+}
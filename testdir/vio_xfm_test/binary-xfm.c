@@ -0,0 +1,155 @@
+#define _GNU_SOURCE 1
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <volume_io.h>
+
+#define N_LANDMARKS 20
+#define N_POINTS    1000
+
+/* Largest coordinate difference between two transforms over a set of points.
+ */
+static VIO_Real max_difference( VIO_General_transform *a, VIO_General_transform *b,
+                                VIO_Real *points )
+{
+  int i, d;
+  VIO_Real pa[3], pb[3], m = 0.0;
+
+  for ( i = 0; i < N_POINTS; i++ ) {
+    general_transform_point( a, points[3*i], points[3*i+1], points[3*i+2],
+                             &pa[0], &pa[1], &pa[2] );
+    general_transform_point( b, points[3*i], points[3*i+1], points[3*i+2],
+                             &pb[0], &pb[1], &pb[2] );
+    for ( d = 0; d < 3; d++ )
+      if ( fabs( pa[d] - pb[d] ) > m ) m = fabs( pa[d] - pb[d] );
+  }
+  return m;
+}
+
+static int write_and_read( VIO_General_transform *xfm, const char *filename,
+                           VIO_General_transform *copy )
+{
+  if ( output_transform_file( filename, "created by binary-xfm", xfm ) != VIO_OK ) {
+    fprintf( stderr, "Failed to save transform '%s'\n", filename );
+    return 0;
+  }
+  if ( input_transform_file( filename, copy ) != VIO_OK ) {
+    fprintf( stderr, "Failed to load transform '%s'\n", filename );
+    return 0;
+  }
+  return 1;
+}
+
+/* Write a concatenation of linear and thin plate spline transforms, some of
+ * them inverted, in the text and binary formats, and check that the binary
+ * format reproduces it exactly, also when found by a name without suffix.
+ */
+int main( int ac, char* av[] )
+{
+  int i, d;
+  VIO_Real **landmarks, **weights, *points, diff;
+  VIO_Transform lin;
+  VIO_General_transform parts[4], tmp, xfm, text_copy, binary_copy, found_copy;
+  char text_name[1024], binary_name[1024], prefix[1024];
+
+  if ( ac != 2 ) {
+    fprintf( stderr, "usage: %s output_prefix\n", av[0] );
+    return 1;
+  }
+
+  snprintf( text_name, sizeof(text_name), "%s.xfm", av[1] );
+  snprintf( binary_name, sizeof(binary_name), "%s.xfb", av[1] );
+  snprintf( prefix, sizeof(prefix), "%s_binary_only", av[1] );
+
+  srand( 1 );
+
+  VIO_ALLOC2D( landmarks, N_LANDMARKS, 3 );
+  VIO_ALLOC2D( weights, N_LANDMARKS + 4, 3 );
+
+  for ( i = 0; i < N_LANDMARKS; i++ )
+    for ( d = 0; d < 3; d++ ) {
+      landmarks[i][d] = 100.0 * rand() / RAND_MAX - 50.0;
+      weights[i][d] = 1e-4 * rand() / RAND_MAX;
+    }
+  for ( i = 0; i < 4; i++ )
+    for ( d = 0; d < 3; d++ )
+      weights[N_LANDMARKS+i][d] = ( i == d + 1 ) ? 1.0 : 0.0;
+
+  make_identity_transform( &lin );
+  Transform_elem( lin, 0, 0 ) = cos( 0.1 );
+  Transform_elem( lin, 0, 2 ) = sin( 0.1 );
+  Transform_elem( lin, 2, 0 ) = -sin( 0.1 );
+  Transform_elem( lin, 2, 2 ) = cos( 0.1 );
+  Transform_elem( lin, 0, 3 ) = 1.0 / 3.0;
+  create_linear_transform( &parts[0], &lin );
+
+  create_thin_plate_transform_real( &parts[1], 3, N_LANDMARKS, landmarks, weights );
+
+  make_identity_transform( &lin );
+  Transform_elem( lin, 0, 0 ) = 1.1;
+  Transform_elem( lin, 1, 1 ) = 0.9;
+  Transform_elem( lin, 2, 2 ) = 1.0 / 7.0;
+  create_linear_transform( &tmp, &lin );
+  create_inverse_general_transform( &tmp, &parts[2] );
+  delete_general_transform( &tmp );
+
+  create_inverse_general_transform( &parts[1], &parts[3] );
+
+  copy_general_transform( &parts[0], &xfm );
+  for ( i = 1; i < 4; i++ ) {
+    concat_general_transforms( &xfm, &parts[i], &tmp );
+    delete_general_transform( &xfm );
+    xfm = tmp;
+  }
+
+  points = malloc( 3 * N_POINTS * sizeof(VIO_Real) );
+  for ( i = 0; i < 3 * N_POINTS; i++ )
+    points[i] = 120.0 * rand() / RAND_MAX - 60.0;
+
+  if ( !write_and_read( &xfm, text_name, &text_copy ) ||
+       !write_and_read( &xfm, binary_name, &binary_copy ) )
+    return 2;
+
+  diff = max_difference( &xfm, &text_copy, points );
+  printf( "text format max difference:   %g\n", diff );
+  if ( diff > 1e-9 ) {
+    fprintf( stderr, "Text transform does not match\n" );
+    return 3;
+  }
+
+  diff = max_difference( &xfm, &binary_copy, points );
+  printf( "binary format max difference: %g\n", diff );
+  if ( diff != 0.0 ) {
+    fprintf( stderr, "Binary transform does not round-trip exactly\n" );
+    return 3;
+  }
+
+  /* A name without a suffix finds the .xfb file when there is no .xfm.
+   */
+  if ( output_transform_file_with_format( prefix, NULL, &xfm,
+                                          BINARY_FORMAT ) != VIO_OK ||
+       input_transform_file( prefix, &found_copy ) != VIO_OK ) {
+    fprintf( stderr, "Failed to find transform '%s.xfb'\n", prefix );
+    return 2;
+  }
+  if ( max_difference( &xfm, &found_copy, points ) != 0.0 ) {
+    fprintf( stderr, "Binary transform found by prefix does not match\n" );
+    return 3;
+  }
+
+  free( points );
+  for ( i = 0; i < 4; i++ )
+    delete_general_transform( &parts[i] );
+  delete_general_transform( &xfm );
+  delete_general_transform( &text_copy );
+  delete_general_transform( &binary_copy );
+  delete_general_transform( &found_copy );
+  VIO_FREE2D( landmarks );
+  VIO_FREE2D( weights );
+  return 0;
+}
@@ -58,27 +58,11 @@ static void assert_equal_point( VIO_Real ex, VIO_Real ey, VIO_Real ez,
 
 
 
-int main( int ac, char* av[] )
+/* Transform random points forwards and back, checking that the
+ * results are consistent.
+ */
+static int check_points( VIO_General_transform *xfm, int N )
 {
-    int N;
-    VIO_General_transform xfm;
-
-
-    if ( ac != 3 && ac != 4 ) {
-      fprintf( stderr, "usage: %s N transform.xfm [tolerance]\n", av[0] );
-      return 1;
-    }
-
-    N = atoi( av[1] );
-    if ( input_transform_file( av[2], &xfm ) != VIO_OK ) {
-      fprintf( stderr, "Failed to load transform '%s'\n", av[2] );
-      return 2;
-    }
-
-    if ( ac == 4 ) {
-      tolerance = atof( av[3] );
-      printf( "Setting tolerance to %f.\n", tolerance );
-    }
     /*Set the same seed number*/
     srand48(1);
     while (N-- > 0) {
@@ -89,7 +73,7 @@ int main( int ac, char* av[] )
       VIO_Real tx,ty,tz;
       VIO_Real a,b,c;
 
-      if(general_transform_point( &xfm,  x,y,z,  &tx,&ty,&tz ) != VIO_OK)
+      if(general_transform_point( xfm,  x,y,z,  &tx,&ty,&tz ) != VIO_OK)
       {
         fprintf( stderr, "Failed to transform point %f,%f,%f \n", x,y,z );
         return 3;
@@ -98,7 +82,7 @@ int main( int ac, char* av[] )
       /* Check that general_inverse_transform_point() and
         invert_general_transform() behave sensibly.
       */
-      if(general_inverse_transform_point( &xfm,  tx,ty,tz,  &a,&b,&c ) != VIO_OK)
+      if(general_inverse_transform_point( xfm,  tx,ty,tz,  &a,&b,&c ) != VIO_OK)
       {
         fprintf( stderr, "Failed to invert transform point %f,%f,%f \n", tx,ty,tz );
         return 3;
@@ -106,9 +90,9 @@ int main( int ac, char* av[] )
       assert_equal_point( x,y,z, a,b,c,
               "general_inverse_transform_point()" );
 
-      invert_general_transform( &xfm );
+      invert_general_transform( xfm );
 
-      if(general_transform_point( &xfm, tx,ty,tz,  &a,&b,&c ) != VIO_OK)
+      if(general_transform_point( xfm, tx,ty,tz,  &a,&b,&c ) != VIO_OK)
       {
         fprintf( stderr, "Failed to transform point %f,%f,%f \n", x,y,z );
         return 3;
@@ -117,7 +101,7 @@ int main( int ac, char* av[] )
       assert_equal_point( x,y,z, a,b,c,
               "general_transform_point() / inverted xfm" );
 
-      if(general_inverse_transform_point( &xfm,  x,y,z,  &a,&b,&c ) != VIO_OK)
+      if(general_inverse_transform_point( xfm,  x,y,z,  &a,&b,&c ) != VIO_OK)
       {
         fprintf( stderr, "Failed to invert transform point %f,%f,%f \n", x,y,z );
         return 3;
@@ -126,8 +110,49 @@ int main( int ac, char* av[] )
       assert_equal_point( tx,ty,tz, a,b,c,
               "general_inverse_transform_point() / inverted xfm" );
     }
+    return 0;
+}
+
+int main( int ac, char* av[] )
+{
+    int N, i, n_grids = 0, status;
+    VIO_General_transform xfm;
+
+
+    if ( ac != 3 && ac != 4 ) {
+      fprintf( stderr, "usage: %s N transform.xfm [tolerance]\n", av[0] );
+      return 1;
+    }
+
+    N = atoi( av[1] );
+    if ( input_transform_file( av[2], &xfm ) != VIO_OK ) {
+      fprintf( stderr, "Failed to load transform '%s'\n", av[2] );
+      return 2;
+    }
+
+    if ( ac == 4 ) {
+      tolerance = atof( av[3] );
+      printf( "Setting tolerance to %f.\n", tolerance );
+    }
+
+    if ( (status = check_points( &xfm, N )) != 0 )
+      return status;
+
+    /* Repeat with the precomputed inverse of any grid transforms */
+    for ( i = 0; i < get_n_concated_transforms( &xfm ); i++ ) {
+      VIO_General_transform *nth = get_nth_general_transform( &xfm, i );
+      if ( get_transform_type( nth ) == GRID_TRANSFORM ) {
+        if ( create_grid_transform_inverse_cache( nth ) != VIO_OK ) {
+          fprintf( stderr, "Failed to create inverse grid cache\n" );
+          return 3;
+        }
+        n_grids++;
+      }
+    }
+
+    if ( n_grids > 0 && (status = check_points( &xfm, N )) != 0 )
+      return status;
 
     delete_general_transform( &xfm );
     return 0;
 }
-
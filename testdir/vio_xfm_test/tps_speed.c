@@ -0,0 +1,145 @@
+#define _GNU_SOURCE 1
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <volume_io.h>
+
+/*Windows compatibility hack*/
+#ifndef HAVE_SRAND48
+void srand48(long seed)
+{
+  srand((unsigned int)seed);
+}
+#endif /*HAVE_SRAND48*/
+
+#ifndef HAVE_DRAND48
+double drand48(void)
+{
+  return (double)rand() / ( (double)RAND_MAX + 1);
+}
+#endif /*HAVE_DRAND48*/
+
+/* Compare two sets of points, returning the largest coordinate difference.
+ */
+static VIO_Real max_difference( int n, VIO_Real *a, VIO_Real *b )
+{
+  int i;
+  VIO_Real d, m = 0.0;
+
+  for ( i = 0; i < 3*n; i++ ) {
+    d = fabs( a[i] - b[i] );
+    if ( d > m ) m = d;
+  }
+  return m;
+}
+
+/* Benchmark and check the batch thin plate spline evaluation against
+ * general_transform_point(), on random landmarks in a brain sized box.
+ */
+int main( int ac, char* av[] )
+{
+  int n_landmarks, n_points, i, d;
+  VIO_Real tolerance, sum[3], t0, t1, t2, t3, diff;
+  VIO_Real **landmarks, **weights;
+  VIO_Real *in, *single, *exact, *approx;
+  VIO_General_transform xfm;
+
+  if ( ac != 4 ) {
+    fprintf( stderr, "usage: %s n_landmarks n_points tolerance\n", av[0] );
+    return 1;
+  }
+
+  n_landmarks = atoi( av[1] );
+  n_points = atoi( av[2] );
+  tolerance = atof( av[3] );
+
+  srand48(1);
+
+  VIO_ALLOC2D( landmarks, n_landmarks, 3 );
+  VIO_ALLOC2D( weights, n_landmarks + 4, 3 );
+
+  /* Random weights summing to zero, so the spline stays bounded, on top of
+     the identity */
+  sum[0] = sum[1] = sum[2] = 0.0;
+  for ( i = 0; i < n_landmarks; i++ ) {
+    for ( d = 0; d < 3; d++ ) {
+      landmarks[i][d] = 200.0 * ( drand48() - 0.5 );
+      weights[i][d] = 0.01 * ( drand48() - 0.5 );
+      sum[d] += weights[i][d];
+    }
+  }
+  for ( i = 0; i < n_landmarks; i++ )
+    for ( d = 0; d < 3; d++ )
+      weights[i][d] -= sum[d] / n_landmarks;
+
+  for ( i = 0; i < 4; i++ )
+    for ( d = 0; d < 3; d++ )
+      weights[n_landmarks+i][d] = ( i == d + 1 ) ? 1.0 : 0.0;
+
+  create_thin_plate_transform_real( &xfm, 3, n_landmarks, landmarks, weights );
+
+  in     = malloc( 3 * n_points * sizeof(VIO_Real) );
+  single = malloc( 3 * n_points * sizeof(VIO_Real) );
+  exact  = malloc( 3 * n_points * sizeof(VIO_Real) );
+  approx = malloc( 3 * n_points * sizeof(VIO_Real) );
+
+  for ( i = 0; i < 3 * n_points; i++ )
+    in[i] = 180.0 * ( drand48() - 0.5 );
+
+  t0 = current_realtime_seconds();
+  for ( i = 0; i < n_points; i++ ) {
+    if ( general_transform_point( &xfm, in[3*i], in[3*i+1], in[3*i+2],
+                                  &single[3*i], &single[3*i+1], &single[3*i+2] ) != VIO_OK ) {
+      fprintf( stderr, "Failed to transform point %d\n", i );
+      return 2;
+    }
+  }
+
+  t1 = current_realtime_seconds();
+  set_thin_plate_spline_tolerance( &xfm, 0.0 );
+  if ( general_transform_points( &xfm, n_points, in, exact ) != VIO_OK ) {
+    fprintf( stderr, "Failed to transform points\n" );
+    return 2;
+  }
+
+  t2 = current_realtime_seconds();
+  set_thin_plate_spline_tolerance( &xfm, tolerance );
+  if ( general_transform_points( &xfm, n_points, in, approx ) != VIO_OK ) {
+    fprintf( stderr, "Failed to transform points\n" );
+    return 2;
+  }
+  t3 = current_realtime_seconds();
+
+  printf( "%d landmarks, %d points\n", n_landmarks, n_points );
+  printf( "  general_transform_point:  %8.3f s\n", t1 - t0 );
+  printf( "  general_transform_points: %8.3f s (exact)\n", t2 - t1 );
+  printf( "  general_transform_points: %8.3f s (tolerance %g)\n", t3 - t2, tolerance );
+
+  diff = max_difference( n_points, single, exact );
+  printf( "  max difference, exact:  %g\n", diff );
+  if ( diff > 1e-8 ) {
+    fprintf( stderr, "Batch evaluation differs from single points\n" );
+    return 3;
+  }
+
+  diff = max_difference( n_points, single, approx );
+  printf( "  max difference, approx: %g\n", diff );
+  if ( diff > 2.0 * tolerance ) {
+    fprintf( stderr, "Approximation outside tolerance\n" );
+    return 3;
+  }
+
+  free( in );
+  free( single );
+  free( exact );
+  free( approx );
+  VIO_FREE2D( landmarks );
+  VIO_FREE2D( weights );
+  delete_general_transform( &xfm );
+  return 0;
+}
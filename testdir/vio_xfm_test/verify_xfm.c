@@ -44,6 +44,8 @@ int main( int ac, char* av[] )
     VIO_General_transform xfm;
     FILE *in;
     int line=1;
+    int i, n_points=0, max_points=0;
+    VIO_Real *points=NULL, *expected=NULL;
 
 
     if ( ac != 4 ) {
@@ -95,6 +97,17 @@ int main( int ac, char* av[] )
         return 3;
       }
 
+      /*Keep the points to check the batch interface below*/
+      if(n_points == max_points)
+      {
+        max_points = max_points ? 2*max_points : 64;
+        points   = realloc(points,   3*max_points*sizeof(VIO_Real));
+        expected = realloc(expected, 3*max_points*sizeof(VIO_Real));
+      }
+      points[3*n_points]   = x;  points[3*n_points+1]   = y;  points[3*n_points+2]   = z;
+      expected[3*n_points] = tx; expected[3*n_points+1] = ty; expected[3*n_points+2] = tz;
+      n_points++;
+
       if(check==3)
       {
         fprintf( stdout,"%.20lg,%.20lg,%.20lg,%.20lg,%.20lg,%.20lg,%.20lg,%.20lg,%.20lg\n",x,y,z,tx,ty,tz,ttx,tty,ttz);
@@ -110,6 +123,23 @@ int main( int ac, char* av[] )
       fgetc(in);
     }
     fclose(in);
+
+    if(general_transform_points( &xfm, n_points, points, points ) != VIO_OK)
+    {
+      fprintf( stderr, "Failed to transform %d points\n", n_points );
+      return 3;
+    }
+
+    for(i=0; i<n_points; i++)
+    {
+      char line_c[1024];
+      sprintf(line_c,"Line:%d Batch ",i+1);
+      assert_equal_point( expected[3*i],expected[3*i+1],expected[3*i+2],
+                          points[3*i],points[3*i+1],points[3*i+2], line_c );
+    }
+
+    free(points);
+    free(expected);
     
     delete_general_transform(&xfm);
     
@@ -512,6 +512,176 @@ test3(void)
   return 0;
 }
 
+/* Compare resample_volume_linear() with point-by-point evaluation.
+ */
+static int
+compare_resampled( VIO_Volume src, VIO_Volume dst,
+                   VIO_General_transform *xfm, int degree )
+{
+  int sizes[VIO_MAX_DIMENSIONS];
+  int i, j, k;
+  VIO_Real voxel[VIO_MAX_DIMENSIONS];
+  VIO_Real x, y, z, tx, ty, tz, expected, actual;
+
+  if (resample_volume_linear( src, dst, xfm, degree ) != VIO_OK)
+  {
+    ERROR;
+    return 1;
+  }
+
+  get_volume_sizes( dst, sizes );
+  for (i = 0; i < sizes[0]; i++)
+    for (j = 0; j < sizes[1]; j++)
+      for (k = 0; k < sizes[2]; k++)
+      {
+        voxel[0] = i;
+        voxel[1] = j;
+        voxel[2] = k;
+        convert_voxel_to_world( dst, voxel, &x, &y, &z );
+        general_inverse_transform_point( xfm, x, y, z, &tx, &ty, &tz );
+        evaluate_volume_in_world( src, tx, ty, tz, degree, FALSE, 0.0,
+                                  &expected, NULL, NULL, NULL,
+                                  NULL, NULL, NULL, NULL, NULL, NULL );
+        actual = get_volume_real_value( dst, i, j, k, 0, 0 );
+
+        if (fabs( actual - expected ) > 1e-3 * (1.0 + fabs( expected )))
+        {
+          ERROR;
+          fprintf(stderr, "degree %d, %d %d %d: %f %f\n",
+                  degree, i, j, k, actual, expected );
+          return 1;
+        }
+      }
+  return 0;
+}
+
+int
+test4(void)
+{
+  VIO_Volume src;
+  VIO_Volume dst;
+  VIO_Transform rotation;
+  VIO_General_transform xfm;
+  int src_sizes[VIO_MAX_DIMENSIONS] = { 23, 29, 31 };
+  int dst_sizes[VIO_MAX_DIMENSIONS] = { 27, 19, 37 };
+  VIO_Real separations[VIO_MAX_DIMENSIONS] = { 1.3, -0.9, 1.1 };
+  VIO_Real starts[VIO_MAX_DIMENSIONS] = { -5.2, 13.1, -17.3 };
+  int i, j, k, degree;
+  int errors = 0;
+  char *dim_names[] = { MIzspace, MIyspace, MIxspace };
+
+  src = create_volume( 3, dim_names, NC_SHORT, TRUE, 0, 0 );
+  set_volume_sizes( src, src_sizes );
+  alloc_volume_data( src );
+  set_volume_real_range( src, -100.0, 100.0 );
+
+  srand(0);
+  for (i = 0; i < src_sizes[0]; i++)
+    for (j = 0; j < src_sizes[1]; j++)
+      for (k = 0; k < src_sizes[2]; k++)
+        set_volume_real_value( src, i, j, k, 0, 0,
+                               (rand() % 2000) / 10.0 - 100.0 );
+
+  dst = create_volume( 3, dim_names, NC_FLOAT, FALSE, 0, 0 );
+  set_volume_sizes( dst, dst_sizes );
+  set_volume_separations( dst, separations );
+  set_volume_starts( dst, starts );
+  alloc_volume_data( dst );
+  set_volume_real_range( dst, -100.0, 100.0 );
+
+  make_identity_transform( &rotation );
+  Transform_elem( rotation, 0, 0 ) = cos( 0.3 );
+  Transform_elem( rotation, 0, 1 ) = -sin( 0.3 );
+  Transform_elem( rotation, 1, 0 ) = sin( 0.3 );
+  Transform_elem( rotation, 1, 1 ) = cos( 0.3 );
+  Transform_elem( rotation, 0, 3 ) = 2.7;
+  Transform_elem( rotation, 1, 3 ) = -1.9;
+  Transform_elem( rotation, 2, 3 ) = 0.43;
+  create_linear_transform( &xfm, &rotation );
+
+  for (degree = -1; degree <= 2; degree++)
+    errors += compare_resampled( src, dst, &xfm, degree );
+
+  delete_general_transform( &xfm );
+  delete_volume( dst );
+  delete_volume( src );
+  return errors;
+}
+
+/* The cubic B-spline built by create_bspline_coefficient_volume() must
+ * interpolate the samples, and its analytic gradient must agree with
+ * finite differences.
+ */
+int
+test5(void)
+{
+  VIO_Volume vol;
+  VIO_Volume coefs;
+  int sizes[VIO_MAX_DIMENSIONS] = { 11, 14, 17 };
+  int i, j, k, c;
+  VIO_Real voxel[VIO_MAX_DIMENSIONS], derivs[VIO_N_DIMENSIONS];
+  VIO_Real value, expected, plus, minus, h = 1e-4;
+  char *dim_names[] = { MIzspace, MIyspace, MIxspace };
+
+  vol = create_volume( 3, dim_names, NC_FLOAT, FALSE, 0, 0 );
+  set_volume_sizes( vol, sizes );
+  alloc_volume_data( vol );
+
+  srand(0);
+  for (i = 0; i < sizes[0]; i++)
+    for (j = 0; j < sizes[1]; j++)
+      for (k = 0; k < sizes[2]; k++)
+        set_volume_real_value( vol, i, j, k, 0, 0, (rand() % 1000) / 10.0 );
+
+  coefs = create_bspline_coefficient_volume( vol );
+  if (coefs == NULL)
+  {
+    ERROR;
+    return 1;
+  }
+
+  for (i = 0; i < sizes[0]; i++)
+    for (j = 0; j < sizes[1]; j++)
+      for (k = 0; k < sizes[2]; k++)
+      {
+        voxel[0] = i;
+        voxel[1] = j;
+        voxel[2] = k;
+        evaluate_bspline_volume( coefs, voxel, 0.0, &value, NULL );
+        expected = get_volume_real_value( vol, i, j, k, 0, 0 );
+        if (fabs( value - expected ) > 1e-3)
+        {
+          ERROR;
+          fprintf(stderr, "%d %d %d: %f %f\n", i, j, k, value, expected );
+          return 1;
+        }
+      }
+
+  voxel[0] = 4.3;
+  voxel[1] = 0.2;
+  voxel[2] = 15.7;
+  evaluate_bspline_volume( coefs, voxel, 0.0, &value, derivs );
+  for (c = 0; c < VIO_N_DIMENSIONS; c++)
+  {
+    voxel[c] += h;
+    evaluate_bspline_volume( coefs, voxel, 0.0, &plus, NULL );
+    voxel[c] -= 2.0 * h;
+    evaluate_bspline_volume( coefs, voxel, 0.0, &minus, NULL );
+    voxel[c] += h;
+    if (fabs( derivs[c] - (plus - minus) / (2.0 * h) ) > 1e-3)
+    {
+      ERROR;
+      fprintf(stderr, "axis %d: %f %f\n", c, derivs[c],
+              (plus - minus) / (2.0 * h) );
+      return 1;
+    }
+  }
+
+  delete_volume( coefs );
+  delete_volume( vol );
+  return 0;
+}
+
 static void
 test_error( char *msg )
 {
@@ -528,6 +698,8 @@ main(int argc, char **argv)
   errors += test1();
   errors += test2();
   errors += test3();
+  errors += test4();
+  errors += test5();
 
   if (errors != 0)
   {
@@ -0,0 +1,203 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include <minc.h>
+#include <voxel_loop.h>
+#include "minc2.h"
+
+/* Benchmark voxel_loop averaging of many MINC 2.0 files, through icv's
+ * on the netCDF emulation and through the MINC 2.0 volume API, and check
+ * that both give the same result.
+ */
+
+#define NDIMS 3
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static int create_input(const char *fname, int ifile, int size)
+{
+  static const char *names[NDIMS] = { "zspace", "yspace", "xspace" };
+  midimhandle_t hdim[NDIMS];
+  mihandle_t hvol;
+  misize_t start[NDIMS], count[NDIMS];
+  double *buf;
+  int i, j, k;
+
+  for (i = 0; i < NDIMS; i++) {
+    if (micreate_dimension(names[i], MI_DIMCLASS_SPATIAL,
+                           MI_DIMATTR_REGULARLY_SAMPLED, size,
+                           &hdim[i]) != MI_NOERROR)
+      return 1;
+  }
+  if (micreate_volume(fname, NDIMS, hdim, MI_TYPE_SHORT, MI_CLASS_REAL,
+                      NULL, &hvol) != MI_NOERROR)
+    return 1;
+  if (miset_slice_scaling_flag(hvol, TRUE) != MI_NOERROR ||
+      micreate_volume_image(hvol) != MI_NOERROR)
+    return 1;
+
+  buf = malloc(size * size * sizeof(double));
+  start[1] = start[2] = 0;
+  count[0] = 1;
+  count[1] = count[2] = size;
+  for (k = 0; k < size; k++) {
+    for (j = 0; j < size; j++)
+      for (i = 0; i < size; i++)
+        buf[j * size + i] = 100.0 * sin(0.1 * (i + 2 * j + 3 * k + ifile)) + k;
+    start[0] = k;
+    if (miset_slice_range(hvol, start, NDIMS, k + 100.0, k - 100.0) != MI_NOERROR ||
+        miset_real_value_hyperslab(hvol, MI_TYPE_DOUBLE, start, count,
+                                   buf) != MI_NOERROR)
+      return 1;
+  }
+  free(buf);
+
+  return miclose_volume(hvol) != MI_NOERROR;
+}
+
+static void average_start(void *caller_data, long num_voxels,
+                          int output_num_buffers, int output_vector_length,
+                          double *output_data[], Loop_Info *loop_info)
+{
+  long ivox;
+
+  for (ivox = 0; ivox < num_voxels * output_vector_length; ivox++)
+    output_data[0][ivox] = 0.0;
+}
+
+static void average_voxels(void *caller_data, long num_voxels,
+                           int input_num_buffers, int input_vector_length,
+                           double *input_data[],
+                           int output_num_buffers, int output_vector_length,
+                           double *output_data[], Loop_Info *loop_info)
+{
+  long ivox;
+
+  for (ivox = 0; ivox < num_voxels * input_vector_length; ivox++)
+    output_data[0][ivox] += input_data[0][ivox];
+}
+
+static void average_finish(void *caller_data, long num_voxels,
+                           int output_num_buffers, int output_vector_length,
+                           double *output_data[], Loop_Info *loop_info)
+{
+  int num_files = *(int *) caller_data;
+  long ivox;
+
+  for (ivox = 0; ivox < num_voxels * output_vector_length; ivox++)
+    output_data[0][ivox] /= num_files;
+}
+
+static double run_average(int num_files, char **input_files,
+                          char *output_file, int native)
+{
+  Loop_Options *loop_options;
+  double t0;
+
+  loop_options = create_loop_options();
+  set_loop_clobber(loop_options, TRUE);
+  set_loop_v2format(loop_options, TRUE);
+  set_loop_minc2_native(loop_options, native);
+  set_loop_accumulate(loop_options, TRUE, 0, average_start, average_finish);
+
+  t0 = now();
+  if (voxel_loop(num_files, input_files, 1, &output_file, NULL,
+                 loop_options, average_voxels, &num_files) != 0) {
+    fprintf(stderr, "voxel_loop failed\n");
+    exit(2);
+  }
+  free_loop_options(loop_options);
+
+  return now() - t0;
+}
+
+static double *read_volume(const char *fname, int size)
+{
+  mihandle_t hvol;
+  misize_t start[NDIMS] = { 0, 0, 0 };
+  misize_t count[NDIMS];
+  double *buf;
+
+  count[0] = count[1] = count[2] = size;
+  buf = malloc(size * size * size * sizeof(double));
+  if (miopen_volume(fname, MI2_OPEN_READ, &hvol) != MI_NOERROR ||
+      miget_real_value_hyperslab(hvol, MI_TYPE_DOUBLE, start, count,
+                                 buf) != MI_NOERROR) {
+    fprintf(stderr, "Failed to read %s\n", fname);
+    exit(2);
+  }
+  miclose_volume(hvol);
+  return buf;
+}
+
+int main(int argc, char **argv)
+{
+  int num_files, size, ifile;
+  long ivox, nvox;
+  char **input_files, icv_output[1024], native_output[1024];
+  double t_icv, t_native, diff, max_diff, *icv_data, *native_data;
+
+  if (argc != 4) {
+    fprintf(stderr, "usage: %s num_files size prefix\n", argv[0]);
+    return 1;
+  }
+  num_files = atoi(argv[1]);
+  size = atoi(argv[2]);
+
+  input_files = malloc(num_files * sizeof(char *));
+  for (ifile = 0; ifile < num_files; ifile++) {
+    input_files[ifile] = malloc(1024);
+    snprintf(input_files[ifile], 1024, "%s_in_%d.mnc", argv[3], ifile);
+    if (create_input(input_files[ifile], ifile, size)) {
+      fprintf(stderr, "Failed to create %s\n", input_files[ifile]);
+      return 2;
+    }
+  }
+  snprintf(icv_output, sizeof(icv_output), "%s_icv.mnc", argv[3]);
+  snprintf(native_output, sizeof(native_output), "%s_native.mnc", argv[3]);
+
+  t_icv = run_average(num_files, input_files, icv_output, FALSE);
+  t_native = run_average(num_files, input_files, native_output, TRUE);
+
+  printf("average of %d files of %d^3 voxels\n", num_files, size);
+  printf("  icv:    %8.3f s\n", t_icv);
+  printf("  native: %8.3f s\n", t_native);
+
+  icv_data = read_volume(icv_output, size);
+  native_data = read_volume(native_output, size);
+  nvox = (long) size * size * size;
+  max_diff = 0.0;
+  for (ivox = 0; ivox < nvox; ivox++) {
+    diff = fabs(icv_data[ivox] - native_data[ivox]);
+    if (diff > max_diff) max_diff = diff;
+  }
+  printf("  max difference: %g\n", max_diff);
+
+  /* Both round to the same short voxels, give or take one step */
+  if (max_diff > 0.01) {
+    fprintf(stderr, "Native loop differs from icv loop\n");
+    return 3;
+  }
+
+  for (ifile = 0; ifile < num_files; ifile++) {
+    remove(input_files[ifile]);
+    free(input_files[ifile]);
+  }
+  free(input_files);
+  free(icv_data);
+  free(native_data);
+  remove(icv_output);
+  remove(native_output);
+  return 0;
+}
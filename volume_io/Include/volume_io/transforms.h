@@ -72,6 +72,7 @@ typedef struct VIO_General_transform
 
     void                        *displacement_volume;
     VIO_STR                     displacement_volume_file;
+    void                        *displacement_cache;  /* see grid_transforms.c */
 
     /* --- user_defined */
 
@@ -85,6 +86,11 @@ typedef struct VIO_General_transform
     int                         n_transforms;
     struct VIO_General_transform    *transforms;
 
+    /* --- thin-plate spline batch evaluation error tolerance, */
+    /*     see set_thin_plate_spline_tolerance() */
+
+    VIO_Real                    spline_tolerance;
+
 } VIO_General_transform;
 
 #endif
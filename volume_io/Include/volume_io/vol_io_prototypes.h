@@ -8,6 +8,8 @@
 
 VIOAPI  VIO_STR  get_default_transform_file_suffix( void );
 
+VIOAPI  VIO_STR  get_default_binary_transform_file_suffix( void );
+
 VIOAPI  VIO_Status  output_transform(
     FILE                *file,
     const char          *filename,
@@ -15,11 +17,23 @@ VIOAPI  VIO_Status  output_transform(
     const char          *comments,
     VIO_General_transform   *transform );
 
+VIOAPI  VIO_Status  output_binary_transform(
+    FILE                    *file,
+    const char              *filename,
+    int                     *volume_count_ptr,
+    VIO_General_transform   *transform );
+
 VIOAPI  VIO_Status  input_transform(
     FILE                *file,
     const char          *filename,
     VIO_General_transform   *transform );
 
+VIOAPI  VIO_Status  output_transform_file_with_format(
+    const char              *filename,
+    const char              *comments,
+    VIO_General_transform   *transform,
+    VIO_File_formats        format );
+
 VIOAPI  VIO_Status  output_transform_file(
     const char           *filename,
     const char           *comments,
@@ -120,6 +134,19 @@ VIOAPI  VIO_Status  general_inverse_transform_point(
     VIO_Real                *y_transformed,
     VIO_Real                *z_transformed );
 
+VIOAPI  void  set_thin_plate_spline_tolerance(
+    VIO_General_transform   *transform,
+    VIO_Real                tolerance );
+
+VIOAPI  VIO_Real  get_thin_plate_spline_tolerance(
+    VIO_General_transform   *transform );
+
+VIOAPI  VIO_Status  general_transform_points(
+    VIO_General_transform   *transform,
+    int                     n_points,
+    VIO_Real                in_xyz[],
+    VIO_Real                out_xyz[] );
+
 VIOAPI  void  copy_general_transform(
     VIO_General_transform   *transform,
     VIO_General_transform   *copy );
@@ -309,6 +336,15 @@ VIOAPI  VIO_Real  thin_plate_spline_U(
     VIO_Real   landmark[],
     int    n_dims );
 
+VIOAPI  VIO_Status  thin_plate_spline_transform_points(
+    int         n_dims,
+    int         n_points,
+    VIO_Real    **points,
+    VIO_Real    **weights,
+    VIO_Real    tolerance,
+    int         n_xyz,
+    VIO_Real    xyz[] );
+
 VIOAPI  VIO_Colour  make_rgba_Colour(
     int    r,
     int    g,
@@ -728,6 +764,16 @@ VIOAPI  VIO_Status  set_file_position(
 VIOAPI  VIO_Status  close_file(
     FILE     *file );
 
+VIOAPI  VIO_Status  map_file_data(
+    VIO_STR    filename,
+    size_t     byte_offset,
+    size_t     n_bytes,
+    void       **data,
+    void       **mapping );
+
+VIOAPI  void  unmap_file_data(
+    void   *mapping );
+
 VIOAPI  VIO_STR  extract_directory(
     const char    *filename );
 
@@ -1126,6 +1172,33 @@ VIOAPI  void   evaluate_volume_in_world(
     VIO_Real           deriv_yz[],
     VIO_Real           deriv_zz[] );
 
+VIOAPI  VIO_Status  resample_volume_linear(
+    VIO_Volume              src,
+    VIO_Volume              dst,
+    VIO_General_transform   *transform,
+    int                     degrees_continuity );
+
+VIOAPI  VIO_Volume  create_bspline_coefficient_volume(
+    VIO_Volume   volume );
+
+VIOAPI  void  evaluate_bspline_volume(
+    VIO_Volume   coefficients,
+    VIO_Real     voxel[],
+    VIO_Real     outside_value,
+    VIO_Real     *value,
+    VIO_Real     derivs[] );
+
+VIOAPI  void  evaluate_bspline_volume_in_world(
+    VIO_Volume   coefficients,
+    VIO_Real     x,
+    VIO_Real     y,
+    VIO_Real     z,
+    VIO_Real     outside_value,
+    VIO_Real     *value,
+    VIO_Real     *deriv_x,
+    VIO_Real     *deriv_y,
+    VIO_Real     *deriv_z );
+
 VIOAPI  void  convert_voxels_to_values(
     VIO_Volume   volume,
     int      n_voxels,
@@ -1401,6 +1474,12 @@ VIOAPI  void  set_minc_input_user_real_range(
     double              minimum,
     double              maximum );
 
+VIOAPI  void  set_minc_input_nonspatial_range(
+    minc_input_options  *options,
+    int                 index,
+    int                 start,
+    int                 count );
+
 VIOAPI  VIO_Status  start_volume_input(
     VIO_STR              filename,
     int                  n_dimensions,
@@ -1485,6 +1564,13 @@ VIOAPI   void   create_multidim_array(
     int             sizes[],
     VIO_Data_types  data_type );
 
+VIOAPI  void  set_multidim_storage(
+    VIO_multidim_array   *array,
+    void                 *storage );
+
+VIOAPI  void  delete_multidim_storage(
+    VIO_multidim_array   *array );
+
 VIOAPI  void  delete_multidim_array(
     VIO_multidim_array   *array );
 
@@ -1955,6 +2041,12 @@ VIOAPI  VIO_BOOL is_an_rgb_volume(
 VIOAPI  void  alloc_volume_data(
     VIO_Volume   volume );
 
+VIOAPI  VIO_BOOL  set_volume_data_storage(
+    VIO_Volume   volume,
+    void         *storage,
+    void         (*release_storage)( void * ),
+    void         *storage_handle );
+
 VIOAPI  VIO_BOOL volume_is_alloced(
     VIO_Volume   volume );
 
@@ -2214,4 +2306,18 @@ VIOAPI  VIO_Status  grid_inverse_transform_point(
     VIO_Real                *y_transformed,
     VIO_Real                *z_transformed );
 
+VIOAPI  VIO_Status  create_grid_transform_cache(
+    VIO_General_transform   *transform );
+
+VIOAPI  void  delete_grid_transform_cache(
+    VIO_General_transform   *transform );
+
+VIOAPI  VIO_Status  grid_transform_points(
+    VIO_General_transform   *transform,
+    int                     n_points,
+    VIO_Real                xyz[] );
+
+VIOAPI  VIO_Status  create_grid_transform_inverse_cache(
+    VIO_General_transform   *transform );
+
 #endif /*VOL_IO_PROTOTYPES_H*/
@@ -120,6 +120,10 @@ typedef  struct
     VIO_Real               *irregular_starts[VIO_MAX_DIMENSIONS];
     VIO_Real               *irregular_widths[VIO_MAX_DIMENSIONS];
     VIO_BOOL               is_labels;
+
+    VIO_BOOL                external_storage; /* voxels are not owned by array */
+    void                    (*release_storage)( void * );
+    void                    *storage_handle;
 } volume_struct;
 
 typedef  volume_struct  *VIO_Volume;
@@ -392,6 +396,10 @@ typedef  struct
     double      user_real_range[2];
     /*mostly for debugging*/
     VIO_BOOL    prefer_minc2_api;
+    /* part of each non-spatial file dimension to read, for the formats
+       read by volume_io itself; a count of zero reads to the end */
+    int         nonspatial_start[VIO_MAX_DIMENSIONS - VIO_N_DIMENSIONS];
+    int         nonspatial_count[VIO_MAX_DIMENSIONS - VIO_N_DIMENSIONS];
 } minc_input_options;
 
 typedef  struct
@@ -486,6 +494,9 @@ typedef struct
     void                 *header_info;
     /*Mostly for debugging right now*/
     VIO_BOOL             prefer_minc2_api; 
+    long                 starts_in_file[VIO_MAX_DIMENSIONS]; /* of the part read */
+    VIO_BOOL             image_in_buffer; /* generic_slice_buffer holds all slices */
+    void                 *image_mapping;  /* file mapping generic_slice_buffer points into */
 } volume_input_struct;
 
 /* --------------------- filter types -------------------------------- */
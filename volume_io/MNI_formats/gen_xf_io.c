@@ -34,6 +34,38 @@ static const VIO_STR      DISPLACEMENTS_STRING = "Displacements";
 static const VIO_STR      GRID_TRANSFORM_STRING = "Grid_Transform";
 static const VIO_STR      DISPLACEMENT_VOLUME = "Displacement_Volume";
 
+static   const char      COMMENT_CHAR1 = '%';
+static   const char      COMMENT_CHAR2 = '#';
+
+/*--------------------- binary file format -------------------------------- */
+
+/* A binary transform file starts with the magic string, a byte order mark
+   written as 1 in the byte order of the writer, the format version and the
+   number of transforms that follow.  Each transform is a pair of ints (type,
+   inverse flag) followed by its data, and every record is padded to a
+   multiple of 8 bytes so that all the reals in the file are aligned when it
+   is mapped into memory:
+
+       Linear:             16 reals of the transform and 16 of its inverse,
+                           row by row
+       Thin plate spline:  ints n_dimensions, n_points, then the points and
+                           the n_points+n_dimensions+1 displacements
+       Grid:               ints name length, 0, then the displacement volume
+                           filename, padded with nulls
+
+   Concatenated transforms are stored as their components, as in the text
+   format. */
+
+static const char         BINARY_TRANSFORM_MAGIC[8] = "MNI_XFB";
+static const int          BINARY_TRANSFORM_VERSION = 1;
+
+typedef struct
+{
+    char     *data;
+    size_t   length;
+    size_t   pos;
+} xfm_buffer;
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : get_default_transform_file_suffix
 @INPUT      : 
@@ -52,6 +84,156 @@ VIOAPI  VIO_STR  get_default_transform_file_suffix( void )
     return( "xfm" );
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_default_binary_transform_file_suffix
+@INPUT      : 
+@OUTPUT     : 
+@RETURNS    : "xfb"
+@DESCRIPTION: Returns the default suffix of binary transform files.  Files
+              written with this suffix by output_transform_file() use the
+              binary format, and input_transform_file() tries it after the
+              text suffix for filenames without one.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_STR  get_default_binary_transform_file_suffix( void )
+{
+    return( "xfb" );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : output_grid_volume
+@INPUT      : filename        \ these two used to manufacture unique filenames
+              volume_count    / for grid transform volume files.
+              transform
+@OUTPUT     : 
+@RETURNS    : the volume filename, without directories
+@DESCRIPTION: Writes the displacement volume of a grid transform to a file
+              of the same prefix as the transform file, but ending in
+              _grid_N.mnc, and increments *volume_count.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Feb 21, 1995    David MacDonald
+@MODIFIED   : Oct. 19, 2026   : moved out of output_one_transform()
+---------------------------------------------------------------------------- */
+
+static  VIO_STR  output_grid_volume(
+    const char              *filename,
+    int                     *volume_count,
+    VIO_General_transform   *transform )
+{
+    int        i;
+    VIO_STR    volume_filename, base_filename, prefix_filename;
+
+    if( filename == NULL || string_length(filename) == 0 )
+        prefix_filename = create_string( "grid" );
+    else
+    {
+        prefix_filename = create_string( filename );
+        i = string_length( prefix_filename ) - 1;
+        while( i > 0 && prefix_filename[i] != '.' &&
+               prefix_filename[i] != '/' )
+            --i;
+        if( i >= 0 && prefix_filename[i] == '.' )
+            prefix_filename[i] = VIO_END_OF_STRING;
+    }
+
+    if( transform->displacement_volume_file )
+    {
+        delete_string( transform->displacement_volume_file );
+        transform->displacement_volume_file = NULL;
+    }
+
+    volume_filename = alloc_string( string_length(prefix_filename) + 100 );
+    sprintf( volume_filename, "%s_grid_%d.mnc", prefix_filename,
+             *volume_count );
+
+    transform->displacement_volume_file = volume_filename;
+
+    /* Increment the volume counter as a side-effect to ensure that grid
+     * files have different names.
+     */
+    (*volume_count)++;
+
+    base_filename = remove_directories_from_filename( volume_filename );
+
+    if( transform->displacement_volume )
+        output_volume( transform->displacement_volume_file,
+                       MI_ORIGINAL_TYPE, FALSE, 0.0, 0.0,
+                       (VIO_Volume) transform->displacement_volume,
+                       NULL, NULL );
+
+    delete_string( prefix_filename );
+
+    return( base_filename );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : input_grid_volume
+@INPUT      : filename          - the transform file, for relative paths
+              volume_filename   - the displacement volume, as stored
+@OUTPUT     : transform
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Reads the displacement volume of a grid transform and creates
+              the transform.  A relative volume filename is taken relative
+              to the directory of the transform file.  Takes ownership of
+              volume_filename.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Feb 21, 1995    David MacDonald
+@MODIFIED   : Oct. 19, 2026   : moved out of input_one_transform()
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  input_grid_volume(
+    const char              *filename,
+    VIO_STR                 volume_filename,
+    VIO_General_transform   *transform )
+{
+    VIO_STR             directory, tmp_filename;
+    VIO_Volume          volume;
+    minc_input_options  options;
+
+    /*--- if the volume filename is relative, add the required directory */
+
+    if( volume_filename[0] != '/' && filename != NULL )
+    {
+        directory = extract_directory( filename );
+
+        if( string_length(directory) > 0 )
+        {
+            tmp_filename = concat_strings( directory, "/" );
+            concat_to_string( &tmp_filename, volume_filename );
+            replace_string( &volume_filename, tmp_filename );
+        }
+
+        delete_string( directory );
+    }
+
+    /*--- input the displacement volume */
+
+    set_default_minc_input_options( &options );
+    set_minc_input_vector_to_scalar_flag( &options, FALSE );
+
+    if( input_volume( volume_filename, 4, NULL,
+                      MI_ORIGINAL_TYPE, FALSE, 0.0, 0.0,
+                      TRUE, &volume, &options ) != VIO_OK )
+    {
+        delete_string( volume_filename );
+        return( VIO_ERROR );
+    }
+
+    create_grid_transform_no_copy( transform, volume, volume_filename );
+    delete_string( volume_filename );
+
+    return( VIO_OK );
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : output_one_transform
 @INPUT      : file
@@ -79,7 +261,7 @@ static  void  output_one_transform(
 {
     int        i, c, trans;
     VIO_Transform  *lin_transform;
-    VIO_STR     volume_filename, base_filename, prefix_filename;
+    VIO_STR     base_filename;
 
     switch( transform->type )
     {
@@ -156,60 +338,11 @@ static  void  output_one_transform(
         if( invert )
             (void) fprintf( file, "%s = %s;\n", INVERT_FLAG_STRING,TRUE_STRING);
 
-        /*--- the volume will be stored in a file of the same prefix as this
-              transform, but ending in _grid.mnc */
-
-        if( filename == NULL || string_length(filename) == 0 )
-            prefix_filename = create_string( "grid" );
-        else
-        {
-            prefix_filename = create_string( filename );
-            i = string_length( prefix_filename ) - 1;
-            while( i > 0 && prefix_filename[i] != '.' &&
-                   prefix_filename[i] != '/' )
-                --i;
-            if( i >= 0 && prefix_filename[i] == '.' )
-                prefix_filename[i] = VIO_END_OF_STRING;
-        }
-        
-        if( transform->displacement_volume_file )
-        {
-          delete_string( transform->displacement_volume_file );
-          transform->displacement_volume_file = NULL;
-        }
-        
-        /*--- write out the volume filename to the transform file */
-/*        if( ! transform->displacement_volume_file )
-        {*/
-          volume_filename = alloc_string( string_length(prefix_filename) +
-                                        100 );
-          sprintf( volume_filename, "%s_grid_%d.mnc", prefix_filename,
-                        *volume_count );
-          
-          transform->displacement_volume_file = volume_filename;
-
-/*        }*/
-        /* Increment the volume counter as a side-effect to ensure that grid
-        * files have different names.
-        */
-        (*volume_count)++;
-
-        /*--- decide where to write the volume file */
-
-        base_filename = remove_directories_from_filename( transform->displacement_volume_file );
+        base_filename = output_grid_volume( filename, volume_count,
+                                            transform );
 
         fprintf( file, "%s = %s;\n", DISPLACEMENT_VOLUME, base_filename);
 
-        /*--- write the volume file */
-
-        if( transform->displacement_volume )
-          output_volume( transform->displacement_volume_file, 
-                              MI_ORIGINAL_TYPE, FALSE, 0.0, 0.0,
-                              (VIO_Volume) transform->displacement_volume,
-                              NULL, NULL );
-
-        delete_string( prefix_filename );
-        /*delete_string( volume_filename );*/
         delete_string( base_filename );
 
         break;
@@ -305,191 +438,545 @@ VIOAPI  VIO_Status  output_transform(
 }
 
 /* ----------------------------- MNI Header -----------------------------------
-@NAME       : input_one_transform
+@NAME       : read_transform_buffer
 @INPUT      : file
-              filename    - used to get relative paths
-@OUTPUT     : transform
+@OUTPUT     : buffer
 @RETURNS    : VIO_OK or VIO_ERROR
-@DESCRIPTION: Inputs a transform from the file.
+@DESCRIPTION: Reads the rest of the file into memory, so that the transform
+              parsers below work on a string rather than a character at a
+              time through the stdio library.  The text is terminated by a
+              null character.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
-@CREATED    : 1993            David MacDonald
-@MODIFIED   : Feb. 21, 1995   David MacDonald - added grid transforms
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
 ---------------------------------------------------------------------------- */
 
-static VIO_Status input_one_transform(
-    FILE                *file,
-    const char          *filename,
-    VIO_General_transform   *transform )
+static  VIO_Status  read_transform_buffer(
+    FILE          *file,
+    xfm_buffer    *buffer )
 {
-    VIO_Status        status;
-    int               i, j, n_points, n_dimensions;
-    VIO_Real          **points, **displacements;
-    VIO_Real          value, *points_1d;
-    VIO_STR           type_name, str, volume_filename, directory, tmp_filename;
-    VIO_Volume        volume;
-    VIO_Transform     linear_transform;
-    VIO_Transform_types   transform_type;
-    VIO_BOOL              inverse_flag;
-    VIO_General_transform inverse;
-    minc_input_options    options;
-
-    inverse_flag = FALSE;
-
-    /* --- read the type of transform */
-
-    status = mni_input_keyword_and_equal_sign( file, TYPE_STRING, FALSE );
+    size_t   n_alloced, n_read;
 
-    if( status != VIO_OK )
-        return( status );
+    n_alloced = 65536;
+    ALLOC( buffer->data, n_alloced + 1 );
+    buffer->length = 0;
+    buffer->pos = 0;
 
-    if( mni_input_string( file, &type_name, (char) ';', (char) 0 ) != VIO_OK )
+    while( (n_read = fread( buffer->data + buffer->length, 1,
+                            n_alloced - buffer->length, file )) > 0 )
     {
-        print_error( "input_transform(): missing transform type.\n");
-        return( VIO_ERROR );
+        buffer->length += n_read;
+        if( buffer->length == n_alloced )
+        {
+            n_alloced *= 2;
+            REALLOC( buffer->data, n_alloced + 1 );
+        }
     }
-    if( mni_skip_expected_character( file, (char) ';' ) != VIO_OK )
-        return( VIO_ERROR );
 
-    if( equal_strings( type_name, LINEAR_TYPE ) )
-        transform_type = LINEAR;
-    else if( equal_strings( type_name, THIN_PLATE_SPLINE_STRING ) )
-        transform_type = THIN_PLATE_SPLINE;
-    else if( equal_strings( type_name, GRID_TRANSFORM_STRING ) )
-        transform_type = GRID_TRANSFORM;
-    else
+    if( ferror( file ) )
     {
-        delete_string( type_name );
-        print_error( "input_transform(): invalid transform type.\n");
+        print_error( "Error reading transform file.\n" );
+        FREE( buffer->data );
         return( VIO_ERROR );
     }
 
-    delete_string( type_name );
+    buffer->data[buffer->length] = VIO_END_OF_STRING;
 
-    /* --- read the next string */
+    return( VIO_OK );
+}
 
-    if( mni_input_string( file, &str, (char) '=', (char) 0 ) != VIO_OK )
-        return( VIO_ERROR );
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_get_nonwhite_character
+@INPUT      : buffer
+@OUTPUT     : ch
+@RETURNS    : VIO_OK or VIO_END_OF_FILE
+@DESCRIPTION: Gets the next non white space character from the buffer,
+              skipping comments.  Equivalent to mni_get_nonwhite_character().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
 
-    if( equal_strings( str, INVERT_FLAG_STRING ) )
+static  VIO_Status  buffer_get_nonwhite_character(
+    xfm_buffer   *buffer,
+    char         *ch )
+{
+    VIO_BOOL  in_comment;
+    char      c;
+
+    in_comment = FALSE;
+
+    while( buffer->pos < buffer->length )
     {
-        delete_string( str );
+        c = buffer->data[buffer->pos++];
 
-        if( mni_skip_expected_character( file, (char) '=' ) != VIO_OK )
-            return( VIO_ERROR );
-        if( mni_input_string( file, &str, (char) ';', (char) 0 ) != VIO_OK )
-            return( VIO_ERROR );
-        if( mni_skip_expected_character( file, (char) ';' ) != VIO_OK )
+        if( c == COMMENT_CHAR1 || c == COMMENT_CHAR2 )
+            in_comment = TRUE;
+        else if( c == '\n' )
+            in_comment = FALSE;
+        else if( !in_comment && c != ' ' && c != '\t' && c != '\r' )
         {
-            delete_string( str );
-            return( VIO_ERROR );
+            *ch = c;
+            return( VIO_OK );
         }
+    }
 
-        if( equal_strings( str, TRUE_STRING ) )
-            inverse_flag = TRUE;
-        else if( equal_strings( str, FALSE_STRING ) )
-            inverse_flag = FALSE;
-        else
-        {
-            delete_string( str );
-            print_error( "Expected %s or %s after %s =\n",
-                         TRUE_STRING, FALSE_STRING, INVERT_FLAG_STRING );
-            return( VIO_ERROR );
-        }
+    *ch = 0;
 
-        delete_string( str );
+    return( VIO_END_OF_FILE );
+}
 
-        if( mni_input_string( file, &str, (char) '=', (char) 0 ) != VIO_OK )
-            return( VIO_ERROR );
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_skip_expected_character
+@INPUT      : buffer
+              expected_ch
+@OUTPUT     : 
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Gets the next nonwhite character.  If it is not the expected
+              character, prints an error message.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  buffer_skip_expected_character(
+    xfm_buffer   *buffer,
+    char         expected_ch )
+{
+    char     ch;
+
+    if( buffer_get_nonwhite_character( buffer, &ch ) != VIO_OK )
+    {
+        print_error( "Expected '%c', found end of file.\n", expected_ch );
+        return( VIO_END_OF_FILE );
     }
 
-    switch( transform_type )
+    if( ch != expected_ch )
     {
-    default:
-        print_error( "Unsupported transform type %d \n", transform_type );
-        delete_string( str );
+        print_error( "Expected '%c', found '%c'.\n", expected_ch, ch );
         return( VIO_ERROR );
-        
-    case LINEAR:
-        if( !equal_strings( str, LINEAR_TRANSFORM_STRING ) )
-        {
-            print_error( "Expected %s =\n", LINEAR_TRANSFORM_STRING );
-            delete_string( str );
-            return( VIO_ERROR );
-        }
-
-        delete_string( str );
-
-        if( mni_skip_expected_character( file, (char) '=' ) != VIO_OK )
-            return( VIO_ERROR );
+    }
 
-        make_identity_transform( &linear_transform );
+    return( VIO_OK );
+}
 
-        /* now read the 3 lines of transforms */
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_input_string
+@INPUT      : buffer
+              termination_char1
+              termination_char2
+@OUTPUT     : string
+@RETURNS    : VIO_OK, VIO_END_OF_FILE or VIO_ERROR
+@DESCRIPTION: Inputs a string from the buffer, up to the next occurrence of
+              one of the termination characters or a newline, which is left
+              in the buffer.  If the first nonwhite character is a '"', the
+              string ends at the closing '"' instead.  Equivalent to
+              mni_input_string().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
 
-        for_less( i, 0, 3 )
-        {
-            for_less( j, 0, 4 )
-            {
-                if( mni_input_real( file, &value ) != VIO_OK )
-                {
-                    print_error(
-                    "input_transform(): error reading transform elem [%d,%d]\n",
-                    i+1, j+1 );
-                    return( VIO_ERROR );
-                }
+static  VIO_Status  buffer_input_string(
+    xfm_buffer   *buffer,
+    VIO_STR      *string,
+    char         termination_char1,
+    char         termination_char2 )
+{
+    VIO_Status   status;
+    VIO_BOOL     quoted;
+    size_t       start, end, i;
+    int          len;
+    char         ch;
 
-                Transform_elem(linear_transform,i,j) = value;
-            }
-        }
+    *string = NULL;
 
-        if( mni_skip_expected_character( file, (char) ';' ) != VIO_OK )
-            return( VIO_ERROR );
+    status = buffer_get_nonwhite_character( buffer, &ch );
 
-        create_linear_transform( transform, &linear_transform );
+    if( status == VIO_OK && ch == '"' )
+    {
+        quoted = TRUE;
+        status = buffer_get_nonwhite_character( buffer, &ch );
+        termination_char1 = '"';
+        termination_char2 = '"';
+    }
+    else
+        quoted = FALSE;
 
-        break;
+    if( status != VIO_OK )
+        return( status );
 
-    case THIN_PLATE_SPLINE:
+    start = buffer->pos - 1;
+    end = start;
 
-        /* --- read Number_Dimensions = 3; */
+    while( end < buffer->length &&
+           buffer->data[end] != termination_char1 &&
+           buffer->data[end] != termination_char2 &&
+           buffer->data[end] != '\n' )
+        ++end;
 
-        if( !equal_strings( str, N_DIMENSIONS_STRING ) )
-        {
-            print_error( "Expected %s =\n", N_DIMENSIONS_STRING );
-            delete_string( str );
-            return( VIO_ERROR );
-        }
+    if( end == buffer->length )
+    {
+        buffer->pos = end;
+        return( VIO_ERROR );
+    }
 
-        delete_string( str );
+    *string = alloc_string( (int) (end - start) );
 
-        if( mni_skip_expected_character( file, (char) '=' ) != VIO_OK )
-            return( VIO_ERROR );
-        if( mni_input_int( file, &n_dimensions ) != VIO_OK )
-            return( VIO_ERROR );
-        if( mni_skip_expected_character( file, (char) ';' ) != VIO_OK )
-            return( VIO_ERROR );
+    len = 0;
+    for( i = start;  i < end;  ++i )
+    {
+        if( buffer->data[i] != '\r' )     /* Always ignore carriage returns */
+            (*string)[len++] = buffer->data[i];
+    }
 
-        /* --- read Points = x y z x y z .... ; */
+    while( len > 0 && (*string)[len-1] == ' ' )
+        --len;
 
-        if( mni_input_keyword_and_equal_sign( file, POINTS_STRING, TRUE ) != VIO_OK)
-            return( VIO_ERROR );
-        if( mni_input_reals( file, &n_points, &points_1d ) != VIO_OK )
-            return( VIO_ERROR );
+    (*string)[len] = VIO_END_OF_STRING;
 
-        if( n_points % n_dimensions != 0 )
-        {
-            print_error(
-                        "Number of points (%d) must be multiple of number of dimensions (%d)\n",
-                        n_points, n_dimensions );
-            return( VIO_ERROR );
-        }
+    buffer->pos = quoted ? end + 1 : end;
 
-        n_points = n_points / n_dimensions;
+    return( VIO_OK );
+}
 
-        VIO_ALLOC2D( points, n_points, n_dimensions );
-        for_less( i, 0, n_points )
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_input_keyword_and_equal_sign
+@INPUT      : buffer
+              keyword
+              print_error_message - whether to print error messages
+@OUTPUT     : 
+@RETURNS    : VIO_OK, VIO_END_OF_FILE or VIO_ERROR
+@DESCRIPTION: Inputs the desired keyword from the buffer and an equal sign.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  buffer_input_keyword_and_equal_sign(
+    xfm_buffer   *buffer,
+    const char   keyword[],
+    VIO_BOOL     print_error_message )
+{
+    VIO_Status     status;
+    VIO_STR        str;
+
+    status = buffer_input_string( buffer, &str, (char) '=', (char) 0 );
+
+    if( status == VIO_END_OF_FILE )
+        return( status );
+
+    if( status != VIO_OK || !equal_strings( str, keyword ) ||
+        buffer_skip_expected_character( buffer, (char) '=' ) != VIO_OK )
+    {
+        if( print_error_message )
+            print_error( "Expected \"%s =\"\n", keyword );
+        status = VIO_ERROR;
+    }
+
+    delete_string( str );
+
+    return( status );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_input_real
+@INPUT      : buffer
+@OUTPUT     : d
+@RETURNS    : VIO_OK, VIO_END_OF_FILE or VIO_ERROR
+@DESCRIPTION: Converts the next number in the buffer in place with strtod().
+              If there is no number, the buffer is left at the next nonwhite
+              character.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  buffer_input_real(
+    xfm_buffer   *buffer,
+    VIO_Real     *d )
+{
+    char     ch, *start, *end;
+
+    if( buffer_get_nonwhite_character( buffer, &ch ) != VIO_OK )
+        return( VIO_END_OF_FILE );
+
+    --buffer->pos;
+    start = &buffer->data[buffer->pos];
+
+    *d = strtod( start, &end );
+
+    if( end == start )
+        return( VIO_ERROR );
+
+    buffer->pos += (size_t) (end - start);
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_input_reals
+@INPUT      : buffer
+@OUTPUT     : n
+              reals
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Inputs an arbitrary number of real values, up to the next
+              semicolon.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  buffer_input_reals(
+    xfm_buffer   *buffer,
+    int          *n,
+    VIO_Real     *reals[] )
+{
+    VIO_Real  d;
+
+    *n = 0;
+
+    while( buffer_input_real( buffer, &d ) == VIO_OK )
+    {
+        ADD_ELEMENT_TO_ARRAY( *reals, *n, d, DEFAULT_CHUNK_SIZE );
+    }
+
+    return( buffer_skip_expected_character( buffer, (char) ';' ) );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_input_int
+@INPUT      : buffer
+@OUTPUT     : i
+@RETURNS    : VIO_OK, VIO_END_OF_FILE or VIO_ERROR
+@DESCRIPTION: Converts the next integer in the buffer in place.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  buffer_input_int(
+    xfm_buffer   *buffer,
+    int          *i )
+{
+    char     ch, *start, *end;
+
+    if( buffer_get_nonwhite_character( buffer, &ch ) != VIO_OK )
+        return( VIO_END_OF_FILE );
+
+    --buffer->pos;
+    start = &buffer->data[buffer->pos];
+
+    *i = (int) strtol( start, &end, 10 );
+
+    if( end == start )
+        return( VIO_ERROR );
+
+    buffer->pos += (size_t) (end - start);
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : input_one_transform
+@INPUT      : buffer
+              filename    - used to get relative paths
+@OUTPUT     : transform
+@RETURNS    : VIO_OK, VIO_END_OF_FILE or VIO_ERROR
+@DESCRIPTION: Inputs a transform from the in-memory text of the file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : 1993            David MacDonald
+@MODIFIED   : Feb. 21, 1995   David MacDonald - added grid transforms
+---------------------------------------------------------------------------- */
+
+static VIO_Status input_one_transform(
+    xfm_buffer          *buffer,
+    const char          *filename,
+    VIO_General_transform   *transform )
+{
+    VIO_Status        status;
+    int               i, j, n_points, n_dimensions;
+    VIO_Real          **points, **displacements;
+    VIO_Real          value, *points_1d;
+    VIO_STR           type_name, str, volume_filename;
+    VIO_Transform     linear_transform;
+    VIO_Transform_types   transform_type;
+    VIO_BOOL              inverse_flag;
+    VIO_General_transform inverse;
+
+    inverse_flag = FALSE;
+
+    /* --- read the type of transform */
+
+    status = buffer_input_keyword_and_equal_sign( buffer, TYPE_STRING, FALSE );
+
+    if( status != VIO_OK )
+        return( status );
+
+    if( buffer_input_string( buffer, &type_name, (char) ';', (char) 0 ) != VIO_OK )
+    {
+        print_error( "input_transform(): missing transform type.\n");
+        return( VIO_ERROR );
+    }
+    if( buffer_skip_expected_character( buffer, (char) ';' ) != VIO_OK )
+        return( VIO_ERROR );
+
+    if( equal_strings( type_name, LINEAR_TYPE ) )
+        transform_type = LINEAR;
+    else if( equal_strings( type_name, THIN_PLATE_SPLINE_STRING ) )
+        transform_type = THIN_PLATE_SPLINE;
+    else if( equal_strings( type_name, GRID_TRANSFORM_STRING ) )
+        transform_type = GRID_TRANSFORM;
+    else
+    {
+        delete_string( type_name );
+        print_error( "input_transform(): invalid transform type.\n");
+        return( VIO_ERROR );
+    }
+
+    delete_string( type_name );
+
+    /* --- read the next string */
+
+    if( buffer_input_string( buffer, &str, (char) '=', (char) 0 ) != VIO_OK )
+        return( VIO_ERROR );
+
+    if( equal_strings( str, INVERT_FLAG_STRING ) )
+    {
+        delete_string( str );
+
+        if( buffer_skip_expected_character( buffer, (char) '=' ) != VIO_OK )
+            return( VIO_ERROR );
+        if( buffer_input_string( buffer, &str, (char) ';', (char) 0 ) != VIO_OK )
+            return( VIO_ERROR );
+        if( buffer_skip_expected_character( buffer, (char) ';' ) != VIO_OK )
+        {
+            delete_string( str );
+            return( VIO_ERROR );
+        }
+
+        if( equal_strings( str, TRUE_STRING ) )
+            inverse_flag = TRUE;
+        else if( equal_strings( str, FALSE_STRING ) )
+            inverse_flag = FALSE;
+        else
+        {
+            delete_string( str );
+            print_error( "Expected %s or %s after %s =\n",
+                         TRUE_STRING, FALSE_STRING, INVERT_FLAG_STRING );
+            return( VIO_ERROR );
+        }
+
+        delete_string( str );
+
+        if( buffer_input_string( buffer, &str, (char) '=', (char) 0 ) != VIO_OK )
+            return( VIO_ERROR );
+    }
+
+    switch( transform_type )
+    {
+    default:
+        print_error( "Unsupported transform type %d \n", transform_type );
+        delete_string( str );
+        return( VIO_ERROR );
+        
+    case LINEAR:
+        if( !equal_strings( str, LINEAR_TRANSFORM_STRING ) )
+        {
+            print_error( "Expected %s =\n", LINEAR_TRANSFORM_STRING );
+            delete_string( str );
+            return( VIO_ERROR );
+        }
+
+        delete_string( str );
+
+        if( buffer_skip_expected_character( buffer, (char) '=' ) != VIO_OK )
+            return( VIO_ERROR );
+
+        make_identity_transform( &linear_transform );
+
+        /* now read the 3 lines of transforms */
+
+        for_less( i, 0, 3 )
+        {
+            for_less( j, 0, 4 )
+            {
+                if( buffer_input_real( buffer, &value ) != VIO_OK )
+                {
+                    print_error(
+                    "input_transform(): error reading transform elem [%d,%d]\n",
+                    i+1, j+1 );
+                    return( VIO_ERROR );
+                }
+
+                Transform_elem(linear_transform,i,j) = value;
+            }
+        }
+
+        if( buffer_skip_expected_character( buffer, (char) ';' ) != VIO_OK )
+            return( VIO_ERROR );
+
+        create_linear_transform( transform, &linear_transform );
+
+        break;
+
+    case THIN_PLATE_SPLINE:
+
+        /* --- read Number_Dimensions = 3; */
+
+        if( !equal_strings( str, N_DIMENSIONS_STRING ) )
+        {
+            print_error( "Expected %s =\n", N_DIMENSIONS_STRING );
+            delete_string( str );
+            return( VIO_ERROR );
+        }
+
+        delete_string( str );
+
+        if( buffer_skip_expected_character( buffer, (char) '=' ) != VIO_OK )
+            return( VIO_ERROR );
+        if( buffer_input_int( buffer, &n_dimensions ) != VIO_OK )
+            return( VIO_ERROR );
+        if( buffer_skip_expected_character( buffer, (char) ';' ) != VIO_OK )
+            return( VIO_ERROR );
+
+        /* --- read Points = x y z x y z .... ; */
+
+        if( buffer_input_keyword_and_equal_sign( buffer, POINTS_STRING, TRUE ) != VIO_OK)
+            return( VIO_ERROR );
+        if( buffer_input_reals( buffer, &n_points, &points_1d ) != VIO_OK )
+            return( VIO_ERROR );
+
+        if( n_points % n_dimensions != 0 )
+        {
+            print_error(
+                        "Number of points (%d) must be multiple of number of dimensions (%d)\n",
+                        n_points, n_dimensions );
+            return( VIO_ERROR );
+        }
+
+        n_points = n_points / n_dimensions;
+
+        VIO_ALLOC2D( points, n_points, n_dimensions );
+        for_less( i, 0, n_points )
         {
             for_less( j, 0, n_dimensions )
             {
@@ -497,106 +984,614 @@ static VIO_Status input_one_transform(
             }
         }
 
-        FREE( points_1d );
+        FREE( points_1d );
+
+        /* --- allocate and input the displacements */
+
+        VIO_ALLOC2D( displacements, n_points + n_dimensions + 1, n_dimensions );
+
+        if( buffer_input_keyword_and_equal_sign( buffer, DISPLACEMENTS_STRING, TRUE )
+                                                                       != VIO_OK )
+            return( VIO_ERROR );
+
+        for_less( i, 0, n_points + n_dimensions + 1 )
+        {
+            for_less( j, 0, n_dimensions )
+            {
+                if( buffer_input_real( buffer, &value ) != VIO_OK )
+                {
+                    print_error( "Expected more displacements.\n" );
+                    return( VIO_ERROR );
+                }
+                displacements[i][j] = value;
+            }
+        }
+
+        if( buffer_skip_expected_character( buffer, (char) ';' ) != VIO_OK )
+            return( VIO_ERROR );
+
+        create_thin_plate_transform_real( transform, n_dimensions,
+                                          n_points, points, displacements );
+
+
+        VIO_FREE2D( points );
+        VIO_FREE2D( displacements );
+
+        break;
+        
+    case GRID_TRANSFORM:
+
+        /*--- read the displacement volume filename */
+
+        if( !equal_strings( str, DISPLACEMENT_VOLUME ) )
+        {
+            print_error( "Expected %s =\n", DISPLACEMENT_VOLUME );
+            delete_string( str );
+            return( VIO_ERROR );
+        }
+
+        delete_string( str );
+
+        if( buffer_skip_expected_character( buffer, (char) '=' ) != VIO_OK )
+            return( VIO_ERROR );
+
+        if( buffer_input_string( buffer, &volume_filename,
+                              (char) ';', (char) 0 ) != VIO_OK )
+            return( VIO_ERROR );
+
+        if( buffer_skip_expected_character( buffer, (char) ';' ) != VIO_OK )
+        {
+            delete_string( volume_filename );
+            return( VIO_ERROR );
+        }
+
+        if( input_grid_volume( filename, volume_filename, transform ) != VIO_OK )
+            return( VIO_ERROR );
+
+        break;
+    }
+
+    if( inverse_flag )
+    {
+        create_inverse_general_transform( transform, &inverse );
+        delete_general_transform( transform );
+        *transform = inverse;
+    }
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : add_input_transform
+@INPUT      : n_transforms - the number of transforms read so far
+              next
+@OUTPUT     : transform
+@RETURNS    : 
+@DESCRIPTION: Concatenates the next transform read from a file onto the
+              transforms read so far.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  add_input_transform(
+    int                     n_transforms,
+    VIO_General_transform   *next,
+    VIO_General_transform   *transform )
+{
+    VIO_General_transform   concated;
+
+    if( n_transforms == 0 )
+        *transform = *next;
+    else
+    {
+        concat_general_transforms( transform, next, &concated );
+        delete_general_transform( transform );
+        delete_general_transform( next );
+        *transform = concated;
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : input_text_transform
+@INPUT      : buffer
+              filename    - used to define directory for relative filename
+@OUTPUT     : transform
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Inputs the transform from the in-memory text of a file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : 1993            David MacDonald
+@MODIFIED   : Oct. 19, 2026   : parses from memory
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  input_text_transform(
+    xfm_buffer              *buffer,
+    const char              *filename,
+    VIO_General_transform   *transform )
+{
+    VIO_Status              status;
+    int                     n_transforms;
+    VIO_STR                 line;
+    VIO_General_transform   next;
+
+    /* okay read the header */
+
+    if( buffer_input_string( buffer, &line, (char) 0, (char) 0 ) != VIO_OK )
+    {
+        delete_string( line );
+        print_error( "input_transform(): could not read header in file.\n");
+        return( VIO_ERROR );
+    }
+
+    if( !equal_strings( line, TRANSFORM_FILE_HEADER ) )
+    {
+        delete_string( line );
+        print_error( "input_transform(): invalid header in file.\n");
+        return( VIO_ERROR );
+    }
+
+    delete_string( line );
+
+    n_transforms = 0;
+    while( (status = input_one_transform( buffer, filename, &next )) == VIO_OK )
+    {
+        add_input_transform( n_transforms, &next, transform );
+        ++n_transforms;
+    }
+
+    if( status == VIO_ERROR )
+    {
+        if( n_transforms > 0 )
+            delete_general_transform( transform );
+        print_error( "input_transform: error reading transform.\n" );
+        return( VIO_ERROR );
+    }
+    else if( n_transforms == 0 )
+    {
+        print_error( "input_transform: no transform present.\n" );
+        return( VIO_ERROR );
+    }
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : output_binary_values
+@INPUT      : file
+              data
+              element_size
+              n
+@OUTPUT     : 
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Outputs n values, followed by enough null bytes to keep the
+              file 8-byte aligned.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  output_binary_values(
+    FILE     *file,
+    void     *data,
+    size_t   element_size,
+    int      n )
+{
+    static  char  padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    size_t        n_padding;
+
+    if( n > 0 && output_binary_data( file, data, element_size, n ) != VIO_OK )
+        return( VIO_ERROR );
+
+    n_padding = (8 - (element_size * (size_t) n) % 8) % 8;
+
+    if( n_padding > 0 &&
+        output_binary_data( file, padding, 1, (int) n_padding ) != VIO_OK )
+        return( VIO_ERROR );
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_n_binary_transforms
+@INPUT      : transform
+@OUTPUT     : 
+@RETURNS    : number of records
+@DESCRIPTION: Returns the number of records the transform is written as,
+              i.e., the number of non-concatenated transforms in it.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  int  get_n_binary_transforms(
+    VIO_General_transform   *transform )
+{
+    int   trans, n_transforms;
+
+    if( transform->type != CONCATENATED_TRANSFORM )
+        return( 1 );
+
+    n_transforms = 0;
+    for_less( trans, 0, get_n_concated_transforms(transform) )
+    {
+        n_transforms += get_n_binary_transforms(
+                              get_nth_general_transform(transform,trans) );
+    }
+
+    return( n_transforms );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : output_one_binary_transform
+@INPUT      : file
+              filename        \ these two used to manufacture unique filenames
+              volume_count    / for grid transform volume files.
+              invert  - whether to invert the transform
+              transform
+@OUTPUT     : 
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Outputs the records of a transform to the binary transform
+              file, as output_one_transform() does for the text format.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  output_one_binary_transform(
+    FILE                    *file,
+    const char              *filename,
+    int                     *volume_count,
+    VIO_BOOL                invert,
+    VIO_General_transform   *transform )
+{
+    int            i, j, trans, header[2], sizes[2];
+    VIO_Real       matrices[32];
+    VIO_Transform  *lin_transform, *inverse_transform;
+    VIO_STR        base_filename;
+    VIO_Status     status;
+
+    if( transform->type != LINEAR && transform->type != CONCATENATED_TRANSFORM
+        && transform->inverse_flag )
+        invert = !invert;
+
+    header[0] = (int) transform->type;
+    header[1] = (transform->type == LINEAR) ? FALSE : invert;
+
+    switch( transform->type )
+    {
+    case LINEAR:
+        /*--- the inverse is stored too, rather than recomputed on input,
+              so that the transform round-trips exactly */
+
+        if( invert )
+        {
+            lin_transform = get_inverse_linear_transform_ptr( transform );
+            inverse_transform = get_linear_transform_ptr( transform );
+        }
+        else
+        {
+            lin_transform = get_linear_transform_ptr( transform );
+            inverse_transform = get_inverse_linear_transform_ptr( transform );
+        }
+
+        for_less( i, 0, 4 )
+        {
+            for_less( j, 0, 4 )
+            {
+                matrices[VIO_IJ(i,j,4)] = Transform_elem(*lin_transform,i,j);
+                matrices[16+VIO_IJ(i,j,4)] =
+                                      Transform_elem(*inverse_transform,i,j);
+            }
+        }
+
+        status = output_binary_values( file, header, sizeof(int), 2 );
+        if( status == VIO_OK )
+            status = output_binary_values( file, matrices, sizeof(VIO_Real),
+                                           32 );
+        break;
+
+    case THIN_PLATE_SPLINE:
+        sizes[0] = transform->n_dimensions;
+        sizes[1] = transform->n_points;
+
+        status = output_binary_values( file, header, sizeof(int), 2 );
+        if( status == VIO_OK )
+            status = output_binary_values( file, sizes, sizeof(int), 2 );
+
+        for_less( i, 0, transform->n_points )
+        {
+            if( status == VIO_OK )
+                status = output_binary_values( file, transform->points[i],
+                                sizeof(VIO_Real), transform->n_dimensions );
+        }
+
+        for_less( i, 0, transform->n_points + transform->n_dimensions + 1 )
+        {
+            if( status == VIO_OK )
+                status = output_binary_values( file,
+                                transform->displacements[i],
+                                sizeof(VIO_Real), transform->n_dimensions );
+        }
+        break;
+
+    case GRID_TRANSFORM:
+        base_filename = output_grid_volume( filename, volume_count,
+                                            transform );
+
+        sizes[0] = string_length( base_filename );
+        sizes[1] = 0;
+
+        status = output_binary_values( file, header, sizeof(int), 2 );
+        if( status == VIO_OK )
+            status = output_binary_values( file, sizes, sizeof(int), 2 );
+        if( status == VIO_OK )
+            status = output_binary_values( file, base_filename, 1, sizes[0] );
+
+        delete_string( base_filename );
+        break;
+
+    case CONCATENATED_TRANSFORM:
+
+        if( transform->inverse_flag )
+            invert = !invert;
+
+        status = VIO_OK;
+
+        for_less( i, 0, get_n_concated_transforms(transform) )
+        {
+            trans = invert ? get_n_concated_transforms(transform) - 1 - i : i;
+
+            if( status == VIO_OK )
+                status = output_one_binary_transform( file, filename,
+                               volume_count, invert,
+                               get_nth_general_transform(transform,trans) );
+        }
+        break;
+
+    case USER_TRANSFORM:
+    default:
+        print_error( "Cannot output user transformation.\n" );
+        status = VIO_ERROR;
+        break;
+    }
+
+    return( status );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : output_binary_transform
+              file
+              filename          \  these two args used to manufacture unique
+              volume_count_ptr  /  filenames for grid transform volumes
+              transform
+@INPUT      : 
+@OUTPUT     : 
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Outputs the transform to the file in the binary transform
+              format.  Grid transform volumes are written as for
+              output_transform().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  output_binary_transform(
+    FILE                    *file,
+    const char              *filename,
+    int                     *volume_count_ptr,
+    VIO_General_transform   *transform )
+{
+    int    volume_count, header[4];
+
+    if( file == NULL )
+    {
+        print_error( "output_binary_transform(): passed NULL FILE ptr.\n" );
+        return( VIO_ERROR );
+    }
+
+    if( volume_count_ptr == NULL )
+    {
+        volume_count = 0;
+        volume_count_ptr = &volume_count;
+    }
 
-        /* --- allocate and input the displacements */
+    header[0] = 1;
+    header[1] = BINARY_TRANSFORM_VERSION;
+    header[2] = get_n_binary_transforms( transform );
+    header[3] = 0;
 
-        VIO_ALLOC2D( displacements, n_points + n_dimensions + 1, n_dimensions );
+    if( output_binary_values( file, (void *) BINARY_TRANSFORM_MAGIC, 1,
+                              sizeof(BINARY_TRANSFORM_MAGIC) ) != VIO_OK ||
+        output_binary_values( file, header, sizeof(int), 4 ) != VIO_OK )
+        return( VIO_ERROR );
 
-        if( mni_input_keyword_and_equal_sign( file, DISPLACEMENTS_STRING, TRUE )
-                                                                       != VIO_OK )
-            return( VIO_ERROR );
+    return( output_one_binary_transform( file, filename, volume_count_ptr,
+                                         FALSE, transform ) );
+}
 
-        for_less( i, 0, n_points + n_dimensions + 1 )
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : buffer_input_binary
+@INPUT      : buffer
+              element_size
+              n
+              swap          - whether to reverse the bytes of each element
+@OUTPUT     : data
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Copies n values out of a binary transform file in memory and
+              skips the padding after them.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  buffer_input_binary(
+    xfm_buffer   *buffer,
+    size_t       element_size,
+    int          n,
+    VIO_BOOL     swap,
+    void         *data )
+{
+    size_t   n_bytes, i, b;
+    char     *bytes, tmp;
+
+    n_bytes = element_size * (size_t) n;
+
+    if( n < 0 || buffer->length - buffer->pos < n_bytes )
+    {
+        print_error( "Binary transform file is truncated.\n" );
+        return( VIO_ERROR );
+    }
+
+    (void) memcpy( data, &buffer->data[buffer->pos], n_bytes );
+
+    if( swap && element_size > 1 )
+    {
+        bytes = (char *) data;
+        for( i = 0;  i < n_bytes;  i += element_size )
         {
-            for_less( j, 0, n_dimensions )
+            for( b = 0;  b < element_size / 2;  ++b )
             {
-                if( mni_input_real( file, &value ) != VIO_OK )
-                {
-                    print_error( "Expected more displacements.\n" );
-                    return( VIO_ERROR );
-                }
-                displacements[i][j] = value;
+                tmp = bytes[i+b];
+                bytes[i+b] = bytes[i+element_size-1-b];
+                bytes[i+element_size-1-b] = tmp;
             }
         }
+    }
 
-        if( mni_skip_expected_character( file, (char) ';' ) != VIO_OK )
-            return( VIO_ERROR );
-
-        create_thin_plate_transform_real( transform, n_dimensions,
-                                          n_points, points, displacements );
+    buffer->pos += n_bytes + (8 - n_bytes % 8) % 8;
+    if( buffer->pos > buffer->length )
+        buffer->pos = buffer->length;
 
+    return( VIO_OK );
+}
 
-        VIO_FREE2D( points );
-        VIO_FREE2D( displacements );
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : input_one_binary_transform
+@INPUT      : buffer
+              filename    - used to get relative paths
+              swap        - whether the file has the other byte order
+@OUTPUT     : transform
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Inputs one transform record from a binary transform file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
 
-        break;
-        
-    case GRID_TRANSFORM:
+static  VIO_Status  input_one_binary_transform(
+    xfm_buffer              *buffer,
+    const char              *filename,
+    VIO_BOOL                swap,
+    VIO_General_transform   *transform )
+{
+    int                     i, j, header[2], sizes[2];
+    VIO_Real                matrices[32], **points, **displacements;
+    VIO_STR                 volume_filename;
+    VIO_General_transform   inverse;
 
-        /*--- read the displacement volume filename */
+    if( buffer_input_binary( buffer, sizeof(int), 2, swap, header ) != VIO_OK )
+        return( VIO_ERROR );
 
-        if( !equal_strings( str, DISPLACEMENT_VOLUME ) )
-        {
-            print_error( "Expected %s =\n", DISPLACEMENT_VOLUME );
-            delete_string( str );
+    switch( header[0] )
+    {
+    case LINEAR:
+        if( buffer_input_binary( buffer, sizeof(VIO_Real), 32, swap,
+                                 matrices ) != VIO_OK )
             return( VIO_ERROR );
-        }
 
-        delete_string( str );
+        create_linear_transform( transform, NULL );
 
-        if( mni_skip_expected_character( file, (char) '=' ) != VIO_OK )
-            return( VIO_ERROR );
+        for_less( i, 0, 4 )
+        {
+            for_less( j, 0, 4 )
+            {
+                Transform_elem(*transform->linear_transform,i,j) =
+                                                 matrices[VIO_IJ(i,j,4)];
+                Transform_elem(*transform->inverse_linear_transform,i,j) =
+                                                 matrices[16+VIO_IJ(i,j,4)];
+            }
+        }
+        break;
 
-        if( mni_input_string( file, &volume_filename,
-                              (char) ';', (char) 0 ) != VIO_OK )
+    case THIN_PLATE_SPLINE:
+        if( buffer_input_binary( buffer, sizeof(int), 2, swap, sizes )
+                                                                   != VIO_OK )
             return( VIO_ERROR );
 
-        if( mni_skip_expected_character( file, (char) ';' ) != VIO_OK )
+        if( sizes[0] < 1 || sizes[1] < 0 )
         {
-            delete_string( volume_filename );
+            print_error( "Invalid thin plate spline in binary transform.\n" );
             return( VIO_ERROR );
         }
 
-        /*--- if the volume filename is relative, add the required directory */
+        VIO_ALLOC2D( points, MAX( sizes[1], 1 ), sizes[0] );
+        VIO_ALLOC2D( displacements, sizes[1] + sizes[0] + 1, sizes[0] );
 
-        if( volume_filename[0] != '/' && filename != NULL )
+        if( (sizes[1] > 0 &&
+             buffer_input_binary( buffer, sizeof(VIO_Real), sizes[1] * sizes[0],
+                                  swap, points[0] ) != VIO_OK) ||
+            buffer_input_binary( buffer, sizeof(VIO_Real),
+                                 (sizes[1] + sizes[0] + 1) * sizes[0],
+                                 swap, displacements[0] ) != VIO_OK )
         {
-            directory = extract_directory( filename );
+            VIO_FREE2D( points );
+            VIO_FREE2D( displacements );
+            return( VIO_ERROR );
+        }
 
-            if( string_length(directory) > 0 )
-            {
-                tmp_filename = concat_strings( directory, "/" );
-                concat_to_string( &tmp_filename, volume_filename );
-                replace_string( &volume_filename, tmp_filename );
-            }
+        create_thin_plate_transform_real( transform, sizes[0], sizes[1],
+                                          points, displacements );
 
-            delete_string( directory );
-        }
+        VIO_FREE2D( points );
+        VIO_FREE2D( displacements );
+        break;
 
-        /*--- input the displacement volume */
+    case GRID_TRANSFORM:
+        if( buffer_input_binary( buffer, sizeof(int), 2, swap, sizes )
+                                                                   != VIO_OK )
+            return( VIO_ERROR );
 
-        /*TODO: initialize strings*/
-        set_default_minc_input_options( &options );
-        set_minc_input_vector_to_scalar_flag( &options, FALSE );
+        if( sizes[0] < 1 )
+        {
+            print_error( "Invalid grid filename in binary transform.\n" );
+            return( VIO_ERROR );
+        }
 
-        if( input_volume( volume_filename, 4, NULL, 
-                          MI_ORIGINAL_TYPE, FALSE, 0.0, 0.0, 
-                          TRUE, &volume, &options ) != VIO_OK )
+        volume_filename = alloc_string( sizes[0] );
+        if( buffer_input_binary( buffer, 1, sizes[0], FALSE,
+                                 volume_filename ) != VIO_OK )
         {
             delete_string( volume_filename );
             return( VIO_ERROR );
         }
-        create_grid_transform_no_copy( transform, volume, volume_filename );
-        delete_string( volume_filename );
-
-        /*--- create the transform */
-
+        volume_filename[sizes[0]] = VIO_END_OF_STRING;
 
+        if( input_grid_volume( filename, volume_filename, transform ) != VIO_OK )
+            return( VIO_ERROR );
         break;
+
+    default:
+        print_error( "Unsupported transform type %d \n", header[0] );
+        return( VIO_ERROR );
     }
 
-    if( inverse_flag )
+    if( header[1] )
     {
         create_inverse_general_transform( transform, &inverse );
         delete_general_transform( transform );
@@ -607,135 +1602,329 @@ static VIO_Status input_one_transform(
 }
 
 /* ----------------------------- MNI Header -----------------------------------
-@NAME       : input_transform
-@INPUT      : file
+@NAME       : input_binary_transform
+@INPUT      : buffer
               filename    - used to define directory for relative filename
 @OUTPUT     : transform
 @RETURNS    : VIO_OK or VIO_ERROR
-@DESCRIPTION: Inputs the transform from the file.
+@DESCRIPTION: Inputs the transform from a binary transform file in memory.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
-@CREATED    : 1993            David MacDonald
-@MODIFIED   : Feb. 21, 1995   D. MacDonald
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
 ---------------------------------------------------------------------------- */
 
-VIOAPI  VIO_Status  input_transform(
-    FILE                *file,
-    const char          *filename,
+static  VIO_Status  input_binary_transform(
+    xfm_buffer              *buffer,
+    const char              *filename,
     VIO_General_transform   *transform )
 {
-    VIO_Status              status;
-    int                 n_transforms;
-    VIO_STR              line;
-    VIO_General_transform   next, concated;
+    int                     trans, header[4];
+    VIO_BOOL                swap;
+    VIO_General_transform   next;
 
-    /* parameter checking */
+    buffer->pos = sizeof(BINARY_TRANSFORM_MAGIC);
 
-    if( file == (FILE *) 0 )
-    {
-        print_error( "input_transform(): passed NULL FILE ptr.\n");
+    if( buffer_input_binary( buffer, sizeof(int), 4, FALSE, header ) != VIO_OK )
         return( VIO_ERROR );
-    }
 
-    /* okay read the header */
+    swap = (header[0] != 1);
 
-    if( mni_input_string( file, &line, (char) 0, (char) 0 ) != VIO_OK )
+    if( swap )
     {
-        delete_string( line );
-        print_error( "input_transform(): could not read header in file.\n");
-        return( VIO_ERROR );
+        buffer->pos = sizeof(BINARY_TRANSFORM_MAGIC);
+        (void) buffer_input_binary( buffer, sizeof(int), 4, TRUE, header );
     }
 
-    if( !equal_strings( line, TRANSFORM_FILE_HEADER ) )
+    if( header[0] != 1 || header[1] > BINARY_TRANSFORM_VERSION )
     {
-        delete_string( line );
-        print_error( "input_transform(): invalid header in file.\n");
+        print_error( "input_transform(): unsupported binary transform file.\n" );
         return( VIO_ERROR );
     }
 
-    delete_string( line );
+    if( header[2] < 1 )
+    {
+        print_error( "input_transform: no transform present.\n" );
+        return( VIO_ERROR );
+    }
 
-    n_transforms = 0;
-    while( (status = input_one_transform( file, filename, &next )) == VIO_OK )
+    for_less( trans, 0, header[2] )
     {
-        if( n_transforms == 0 )
-            *transform = next;
-        else
+        if( input_one_binary_transform( buffer, filename, swap, &next )
+                                                                   != VIO_OK )
         {
-            concat_general_transforms( transform, &next, &concated );
-            delete_general_transform( transform );
-            delete_general_transform( &next );
-            *transform = concated;
+            if( trans > 0 )
+                delete_general_transform( transform );
+            print_error( "input_transform: error reading transform.\n" );
+            return( VIO_ERROR );
         }
-        ++n_transforms;
+
+        add_input_transform( trans, &next, transform );
     }
 
-    if( status == VIO_ERROR )
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : input_transform
+@INPUT      : file
+              filename    - used to define directory for relative filename
+@OUTPUT     : transform
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Inputs the transform from the file, which may be in either the
+              text or the binary format.
+@METHOD     : The rest of the file is read into memory and parsed there.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : 1993            David MacDonald
+@MODIFIED   : Feb. 21, 1995   D. MacDonald
+@MODIFIED   : Oct. 19, 2026   : binary format, parse from memory
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  input_transform(
+    FILE                *file,
+    const char          *filename,
+    VIO_General_transform   *transform )
+{
+    VIO_Status   status;
+    xfm_buffer   buffer;
+
+    /* parameter checking */
+
+    if( file == (FILE *) 0 )
     {
-        print_error( "input_transform: error reading transform.\n" );
+        print_error( "input_transform(): passed NULL FILE ptr.\n");
         return( VIO_ERROR );
     }
-    else if( n_transforms == 0 )
-    {
-        print_error( "input_transform: no transform present.\n" );
+
+    if( read_transform_buffer( file, &buffer ) != VIO_OK )
         return( VIO_ERROR );
-    }
 
-    return( VIO_OK );
+    if( buffer.length >= sizeof(BINARY_TRANSFORM_MAGIC) &&
+        memcmp( buffer.data, BINARY_TRANSFORM_MAGIC,
+                sizeof(BINARY_TRANSFORM_MAGIC) ) == 0 )
+        status = input_binary_transform( &buffer, filename, transform );
+    else
+        status = input_text_transform( &buffer, filename, transform );
+
+    FREE( buffer.data );
+
+    return( status );
 }
 
 /* ----------------------------- MNI Header -----------------------------------
-@NAME       : output_transform_file
+@NAME       : output_transform_file_with_format
 @INPUT      : filename
               comments
               transform
+              format      - ASCII_FORMAT or BINARY_FORMAT
 @OUTPUT     : 
 @RETURNS    : VIO_OK or VIO_ERROR
-@DESCRIPTION: Opens the file, outputs the transform, and closes the file.
+@DESCRIPTION: Opens the file, outputs the transform in the text or binary
+              transform format, and closes the file.  Comments are not
+              stored in binary files.  If the filename has no suffix, .xfm
+              or .xfb is added.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
-@CREATED    : 1993            David MacDonald
+@CREATED    : Oct. 19, 2026
 @MODIFIED   : 
 ---------------------------------------------------------------------------- */
 
-VIOAPI  VIO_Status  output_transform_file(
-    const char           *filename,
-    const char           *comments,
-    VIO_General_transform   *transform )
+VIOAPI  VIO_Status  output_transform_file_with_format(
+    const char              *filename,
+    const char              *comments,
+    VIO_General_transform   *transform,
+    VIO_File_formats        format )
 {
     VIO_Status  status;
     FILE    *file;
     int     volume_count;
 
-    status = open_file_with_default_suffix( filename,
+    if( format == BINARY_FORMAT )
+        status = open_file_with_default_suffix( filename,
+                      get_default_binary_transform_file_suffix(),
+                      WRITE_FILE, BINARY_FORMAT, &file );
+    else
+        status = open_file_with_default_suffix( filename,
                       get_default_transform_file_suffix(),
                       WRITE_FILE, ASCII_FORMAT, &file );
 
     volume_count = 0;
 
     if( status == VIO_OK )
-        status = output_transform( file, filename, &volume_count,
-                                   comments, transform );
+    {
+        if( format == BINARY_FORMAT )
+            status = output_binary_transform( file, filename, &volume_count,
+                                              transform );
+        else
+            status = output_transform( file, filename, &volume_count,
+                                       comments, transform );
 
-    if( status == VIO_OK )
-        status = close_file( file );
+        if( close_file( file ) != VIO_OK )
+            status = VIO_ERROR;
+    }
 
     return( status );
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : output_transform_file
+@INPUT      : filename
+              comments
+              transform
+@OUTPUT     : 
+@RETURNS    : VIO_OK or VIO_ERROR
+@DESCRIPTION: Opens the file, outputs the transform, and closes the file.
+              Filenames ending in .xfb are written in the binary format.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : 1993            David MacDonald
+@MODIFIED   : Oct. 19, 2026   : binary format
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  output_transform_file(
+    const char           *filename,
+    const char           *comments,
+    VIO_General_transform   *transform )
+{
+    VIO_File_formats  format;
+
+    if( filename_extension_matches( (VIO_STR) filename,
+                                    get_default_binary_transform_file_suffix() ) )
+        format = BINARY_FORMAT;
+    else
+        format = ASCII_FORMAT;
+
+    return( output_transform_file_with_format( filename, comments,
+                                               transform, format ) );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_input_transform_filename
+@INPUT      : filename
+@OUTPUT     : 
+@RETURNS    : the name of the file to read
+@DESCRIPTION: Expands the filename and, if no file of that name exists and
+              it has no suffix, tries adding the text suffix, .xfm, then the
+              binary suffix, .xfb.  Returns the expanded filename unchanged
+              if neither exists, so the error is reported when it is opened.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_STR  get_input_transform_filename(
+    const char   *filename )
+{
+    VIO_STR   expanded, used_filename, suffixes[2];
+    char      *base;
+    int       i;
+
+    expanded = expand_filename( filename );
+
+    if( file_exists( expanded ) )
+        return( expanded );
+
+    base = strrchr( expanded, '/' );
+    if( strchr( base == NULL ? expanded : base, '.' ) != NULL )
+        return( expanded );
+
+    suffixes[0] = get_default_transform_file_suffix();
+    suffixes[1] = get_default_binary_transform_file_suffix();
+
+    for_less( i, 0, 2 )
+    {
+        used_filename = concat_strings( expanded, "." );
+        concat_to_string( &used_filename, suffixes[i] );
+        if( file_exists( used_filename ) )
+        {
+            delete_string( expanded );
+            return( used_filename );
+        }
+        delete_string( used_filename );
+    }
+
+    return( expanded );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : input_mapped_binary_transform
+@INPUT      : file
+              used_filename  - the name the file was opened with
+              filename       - used to define directory for relative filename
+@OUTPUT     : transform
+              status
+@RETURNS    : TRUE if the file was mapped
+@DESCRIPTION: If the file is a binary transform file, maps it into memory and
+              inputs the transform from the mapping, so that the points and
+              displacements are copied once, straight from the page cache.
+              Returns FALSE, leaving the file at its start, if the file is a
+              text file or cannot be mapped.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_BOOL  input_mapped_binary_transform(
+    FILE                    *file,
+    VIO_STR                 used_filename,
+    const char              *filename,
+    VIO_General_transform   *transform,
+    VIO_Status              *status )
+{
+    char         magic[sizeof(BINARY_TRANSFORM_MAGIC)];
+    long         n_bytes;
+    void         *data, *mapping;
+    VIO_BOOL     mapped;
+    xfm_buffer   buffer;
+
+    mapped = FALSE;
+
+    if( fread( magic, 1, sizeof(magic), file ) == sizeof(magic) &&
+        memcmp( magic, BINARY_TRANSFORM_MAGIC, sizeof(magic) ) == 0 &&
+        fseek( file, 0, SEEK_END ) == 0 &&
+        (n_bytes = ftell( file )) > 0 &&
+        map_file_data( used_filename, 0, (size_t) n_bytes,
+                       &data, &mapping ) == VIO_OK )
+    {
+        buffer.data = (char *) data;
+        buffer.length = (size_t) n_bytes;
+        buffer.pos = 0;
+
+        *status = input_binary_transform( &buffer, filename, transform );
+
+        unmap_file_data( mapping );
+        mapped = TRUE;
+    }
+    else
+        rewind( file );
+
+    return( mapped );
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : input_transform_file
 @INPUT      : filename
 @OUTPUT     : transform
 @RETURNS    : VIO_OK or VIO_ERROR
 @DESCRIPTION: Opens the file, inputs the transform, and closes the file.
+              The text and binary formats are told apart by their contents,
+              not their suffix.  If the file does not exist as given and the
+              filename has no suffix, the file with .xfm added is read if it
+              exists, otherwise the one with .xfb added.  Binary files are
+              mapped into memory where the system allows it.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : 1993            David MacDonald
-@MODIFIED   : 
+@MODIFIED   : Oct. 19, 2026   : .xfb suffix, mapped binary files
 ---------------------------------------------------------------------------- */
 
 VIOAPI  VIO_Status  input_transform_file(
@@ -744,16 +1933,23 @@ VIOAPI  VIO_Status  input_transform_file(
 {
     VIO_Status  status;
     FILE    *file;
+    VIO_STR  used_filename;
 
-    status = open_file_with_default_suffix( filename,
-                      get_default_transform_file_suffix(),
-                      READ_FILE, ASCII_FORMAT, &file );
+    used_filename = get_input_transform_filename( filename );
 
-    if( status == VIO_OK )
-        status = input_transform( file, filename, transform );
+    status = open_file( used_filename, READ_FILE, BINARY_FORMAT, &file );
 
     if( status == VIO_OK )
-        status = close_file( file );
+    {
+        if( !input_mapped_binary_transform( file, used_filename, filename,
+                                            transform, &status ) )
+            status = input_transform( file, filename, transform );
+
+        if( close_file( file ) != VIO_OK )
+            status = VIO_ERROR;
+    }
+
+    delete_string( used_filename );
 
     return( status );
 }
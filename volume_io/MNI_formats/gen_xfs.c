@@ -100,6 +100,7 @@ static  void  initialize_thin_plate_transform(
     transform->n_dimensions = n_dimensions;
     transform->n_points = n_points;
     transform->displacement_volume = NULL;
+    transform->spline_tolerance = 0.0;
 
     VIO_ALLOC2D( transform->points, n_points, n_dimensions );
     VIO_ALLOC2D( transform->displacements, n_points + n_dimensions + 1,
@@ -276,6 +277,7 @@ static  void  internal_create_grid_transform(
 
       transform->type = GRID_TRANSFORM;
       transform->inverse_flag = FALSE;
+      transform->displacement_cache = NULL;
 
 
       /* --- force 4th dimension to be vector dimension */
@@ -289,6 +291,7 @@ static  void  internal_create_grid_transform(
       transform->type = GRID_TRANSFORM;
       transform->inverse_flag = FALSE;
       transform->displacement_volume = NULL;
+      transform->displacement_cache = NULL;
     }
     
     /*Will be initialized on save*/
@@ -804,6 +807,406 @@ VIOAPI  VIO_Status  general_inverse_transform_point(
                                x_transformed, y_transformed, z_transformed );
 }
 
+/* --- one step of a transform chain, as applied by general_transform_points(),
+       either a grid, thin plate spline or user transform, or a linear
+       transform folded from one or more consecutive linear transforms */
+
+typedef struct
+{
+    VIO_General_transform   *transform;     /* NULL for a linear step */
+    VIO_BOOL                inverse_flag;
+    VIO_Transform           linear;
+} transform_step;
+
+#define  POINTS_PER_BLOCK  1024
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : add_transform_steps
+@INPUT      : transform
+              inverse_flag
+              steps
+              n_steps
+@OUTPUT     : steps
+              n_steps
+@RETURNS    : 
+@DESCRIPTION: Appends the steps needed to apply the transform, or its inverse,
+              to the list of steps, flattening concatenated transforms and
+              folding consecutive linear transforms into one matrix.  The
+              list must have room for one step per transform in the chain.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  add_transform_steps(
+    VIO_General_transform   *transform,
+    VIO_BOOL                inverse_flag,
+    transform_step          steps[],
+    int                     *n_steps )
+{
+    int              trans;
+    VIO_Transform    *linear;
+    transform_step   *last;
+
+    switch( transform->type )
+    {
+    case LINEAR:
+        if( inverse_flag )
+            linear = transform->inverse_linear_transform;
+        else
+            linear = transform->linear_transform;
+
+        last = (*n_steps > 0) ? &steps[*n_steps-1] : NULL;
+
+        if( last != NULL && last->transform == NULL )
+            concat_transforms( &last->linear, &last->linear, linear );
+        else
+        {
+            steps[*n_steps].transform = NULL;
+            steps[*n_steps].inverse_flag = FALSE;
+            steps[*n_steps].linear = *linear;
+            ++(*n_steps);
+        }
+        break;
+
+    case CONCATENATED_TRANSFORM:
+        if( inverse_flag )
+        {
+            for( trans = transform->n_transforms-1;  trans >= 0;  --trans )
+                add_transform_steps( &transform->transforms[trans],
+                                     !transform->transforms[trans].inverse_flag,
+                                     steps, n_steps );
+        }
+        else
+        {
+            for_less( trans, 0, transform->n_transforms )
+                add_transform_steps( &transform->transforms[trans],
+                                     transform->transforms[trans].inverse_flag,
+                                     steps, n_steps );
+        }
+        break;
+
+    default:
+        steps[*n_steps].transform = transform;
+        steps[*n_steps].inverse_flag = inverse_flag;
+        ++(*n_steps);
+        break;
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : count_transforms
+@INPUT      : transform
+@OUTPUT     : 
+@RETURNS    : number of non-concatenated transforms
+@DESCRIPTION: Counts the transforms in the chain, recursing into nested
+              concatenations.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  int  count_transforms(
+    VIO_General_transform   *transform )
+{
+    int   trans, n;
+
+    if( transform->type != CONCATENATED_TRANSFORM )
+        return( 1 );
+
+    n = 0;
+    for_less( trans, 0, transform->n_transforms )
+        n += count_transforms( &transform->transforms[trans] );
+
+    return( n );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : apply_transform_step
+@INPUT      : step
+              n_points
+              xyz
+@OUTPUT     : xyz
+@RETURNS    : VIO_Status
+@DESCRIPTION: Applies one step of a transform chain to the points in place.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  apply_transform_step(
+    transform_step   *step,
+    int              n_points,
+    VIO_Real         xyz[] )
+{
+    int             p;
+    VIO_Real        x, y, z;
+    VIO_Transform   *t;
+    VIO_Status      status;
+
+    if( step->transform == NULL )
+    {
+        t = &step->linear;
+
+        if( Transform_elem(*t,3,0) != 0.0 || Transform_elem(*t,3,1) != 0.0 ||
+            Transform_elem(*t,3,2) != 0.0 || Transform_elem(*t,3,3) != 1.0 )
+        {
+            for_less( p, 0, n_points )
+            {
+                (void) transform_point( t, xyz[3*p], xyz[3*p+1], xyz[3*p+2],
+                                    &xyz[3*p], &xyz[3*p+1], &xyz[3*p+2] );
+            }
+            return( VIO_OK );
+        }
+
+        for_less( p, 0, n_points )
+        {
+            x = xyz[3*p];
+            y = xyz[3*p+1];
+            z = xyz[3*p+2];
+
+            xyz[3*p]   = Transform_elem(*t,0,0) * x +
+                         Transform_elem(*t,0,1) * y +
+                         Transform_elem(*t,0,2) * z +
+                         Transform_elem(*t,0,3);
+            xyz[3*p+1] = Transform_elem(*t,1,0) * x +
+                         Transform_elem(*t,1,1) * y +
+                         Transform_elem(*t,1,2) * z +
+                         Transform_elem(*t,1,3);
+            xyz[3*p+2] = Transform_elem(*t,2,0) * x +
+                         Transform_elem(*t,2,1) * y +
+                         Transform_elem(*t,2,2) * z +
+                         Transform_elem(*t,2,3);
+        }
+        return( VIO_OK );
+    }
+
+    if( step->transform->type == GRID_TRANSFORM && !step->inverse_flag )
+        return( grid_transform_points( step->transform, n_points, xyz ) );
+
+    for_less( p, 0, n_points )
+    {
+        status = transform_or_invert_point_with_input_steps( step->transform,
+                             step->inverse_flag,
+                             xyz[3*p], xyz[3*p+1], xyz[3*p+2], NULL,
+                             &xyz[3*p], &xyz[3*p+1], &xyz[3*p+2] );
+        if( status != VIO_OK )
+            return( status );
+    }
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : set_thin_plate_spline_tolerance
+@INPUT      : transform
+              tolerance
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Sets the error tolerance used when general_transform_points()
+              applies a thin plate spline transform, for the transform or,
+              if it is a concatenation, for each thin plate spline in it.
+              Zero, the default, means evaluate the spline exactly at each
+              point.  See thin_plate_spline_transform_points().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  set_thin_plate_spline_tolerance(
+    VIO_General_transform   *transform,
+    VIO_Real                tolerance )
+{
+    int   trans;
+
+    switch( transform->type )
+    {
+    case THIN_PLATE_SPLINE:
+        transform->spline_tolerance = tolerance;
+        break;
+
+    case CONCATENATED_TRANSFORM:
+        for_less( trans, 0, transform->n_transforms )
+            set_thin_plate_spline_tolerance( &transform->transforms[trans],
+                                             tolerance );
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_thin_plate_spline_tolerance
+@INPUT      : transform
+@OUTPUT     : 
+@RETURNS    : tolerance
+@DESCRIPTION: Returns the tolerance set by set_thin_plate_spline_tolerance()
+              for a thin plate spline transform, or zero for other types.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Real  get_thin_plate_spline_tolerance(
+    VIO_General_transform   *transform )
+{
+    if( transform->type != THIN_PLATE_SPLINE )
+        return( 0.0 );
+
+    return( transform->spline_tolerance );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : general_transform_points
+@INPUT      : transform
+              n_points
+              in_xyz     - n_points interleaved x,y,z positions
+@OUTPUT     : out_xyz    - n_points interleaved transformed positions, may
+                           be the same array as in_xyz
+@RETURNS    : VIO_Status
+@DESCRIPTION: Transforms many points by the general transform, giving the same
+              results as calling general_transform_point() on each.
+              Consecutive linear transforms in a concatenation are folded
+              into a single matrix, and each remaining step is applied to all
+              the points in turn.  Grid transforms are evaluated from a
+              cached copy of their displacement volume (see
+              create_grid_transform_cache()), thin plate splines by
+              thin_plate_spline_transform_points() with the tolerance stored
+              in each by set_thin_plate_spline_tolerance(), and blocks of
+              points are processed in parallel when OpenMP is enabled and the chain
+              contains no user transforms or cached displacement volumes.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  general_transform_points(
+    VIO_General_transform   *transform,
+    int                     n_points,
+    VIO_Real                in_xyz[],
+    VIO_Real                out_xyz[] )
+{
+    int              s, n_steps, n_blocks, block, n_errors;
+    VIO_BOOL         parallel;
+    VIO_Status       status;
+    VIO_Volume       volume;
+    transform_step   *steps;
+
+    if( n_points <= 0 )
+        return( VIO_OK );
+
+    if( out_xyz != in_xyz )
+        (void) memcpy( out_xyz, in_xyz, (size_t) n_points * 3 * sizeof(VIO_Real) );
+
+    ALLOC( steps, count_transforms( transform ) );
+    n_steps = 0;
+    add_transform_steps( transform, transform->inverse_flag, steps, &n_steps );
+
+    /*--- create the grid caches before any threads are started */
+
+    parallel = TRUE;
+    for_less( s, 0, n_steps )
+    {
+        if( steps[s].transform == NULL )
+            continue;
+
+        switch( steps[s].transform->type )
+        {
+        case GRID_TRANSFORM:
+            volume = (VIO_Volume) steps[s].transform->displacement_volume;
+            if( volume == NULL )
+            {
+                handle_internal_error( "Not initialized grid transform, make sure you have MINC1" );
+                FREE( steps );
+                return( VIO_ERROR );
+            }
+            if( steps[s].inverse_flag )
+            {
+                if( volume->is_cached_volume )
+                    parallel = FALSE;
+            }
+            else if( create_grid_transform_cache( steps[s].transform ) != VIO_OK )
+            {
+                FREE( steps );
+                return( VIO_ERROR );
+            }
+            break;
+
+        case USER_TRANSFORM:
+            parallel = FALSE;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    n_blocks = (n_points + POINTS_PER_BLOCK - 1) / POINTS_PER_BLOCK;
+    status = VIO_OK;
+
+    for_less( s, 0, n_steps )
+    {
+        /*--- thin plate splines are applied to the whole set of points,
+              which thin_plate_spline_transform_points() splits up itself */
+
+        if( steps[s].transform != NULL &&
+            steps[s].transform->type == THIN_PLATE_SPLINE &&
+            !steps[s].inverse_flag )
+        {
+            status = thin_plate_spline_transform_points(
+                                   steps[s].transform->n_dimensions,
+                                   steps[s].transform->n_points,
+                                   steps[s].transform->points,
+                                   steps[s].transform->displacements,
+                                   steps[s].transform->spline_tolerance,
+                                   n_points, out_xyz );
+            if( status != VIO_OK )
+                break;
+            continue;
+        }
+
+        n_errors = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for if( parallel && n_blocks > 1 ) reduction(+:n_errors) schedule(dynamic)
+#endif
+        for( block = 0; block < n_blocks; ++block )
+        {
+            int   first, n;
+
+            first = block * POINTS_PER_BLOCK;
+            n = MIN( POINTS_PER_BLOCK, n_points - first );
+
+            if( apply_transform_step( &steps[s], n,
+                                      &out_xyz[3*(size_t)first] ) != VIO_OK )
+                ++n_errors;
+        }
+
+        if( n_errors > 0 )
+        {
+            status = VIO_ERROR;
+            break;
+        }
+    }
+
+    FREE( steps );
+
+    return( status );
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : copy_and_invert_transform
 @INPUT      : transform
@@ -868,6 +1271,7 @@ static  void  copy_and_invert_transform(
         break;
 
     case GRID_TRANSFORM:
+        copy->displacement_cache = NULL;
         if( transform->displacement_volume )
           copy->displacement_volume = (void *) copy_volume(
                                       (VIO_Volume) transform->displacement_volume );
@@ -1156,6 +1560,7 @@ VIOAPI  void  delete_general_transform(
         break;
 
     case GRID_TRANSFORM:
+        delete_grid_transform_cache( transform );
         if( transform->displacement_volume ) 
           delete_volume( (VIO_Volume) transform->displacement_volume );
         if( transform->displacement_volume_file )
@@ -17,6 +17,10 @@
 
 #include  <internal_volume_io.h>
 
+#ifdef _OPENMP
+#include  <omp.h>
+#endif
+
 #define   DEGREES_CONTINUITY         2    /* -1 = Nearest; 0 = Linear; 1 = Quadratic; 2 = Cubic interpolation */
 #define   SPLINE_DEGREE         ((DEGREES_CONTINUITY) + 2)
 
@@ -41,6 +45,44 @@ static void   evaluate_grid_volume(
     VIO_Real           deriv_y[],
     VIO_Real           deriv_z[] );
 
+/* --- the displacement volume resampled once into a contiguous array of
+       interleaved float x,y,z displacements, in the voxel order of the
+       three spatial dimensions of the volume, along with the world to
+       voxel mapping of those dimensions.  Used for bulk transformation */
+
+typedef struct
+{
+    int        sizes[VIO_N_DIMENSIONS];
+    size_t     strides[VIO_N_DIMENSIONS];
+    int        slice_axis;
+    VIO_Real   world_to_voxel[VIO_N_DIMENSIONS][4];
+    VIO_Real   voxel_to_world[VIO_N_DIMENSIONS][4];
+    float      *displacements;
+    float      *inverse_displacements;
+} grid_cache_struct;
+
+static  VIO_Real  get_grid_inverse_tolerance(
+    VIO_Volume   volume,
+    VIO_Real     *input_volume_steps );
+
+static  void  evaluate_grid_cache(
+    grid_cache_struct   *cache,
+    float               *field,
+    VIO_Real            x,
+    VIO_Real            y,
+    VIO_Real            z,
+    VIO_Real            values[] );
+
+static  VIO_Status  cached_grid_inverse_transform_point(
+    VIO_General_transform   *transform,
+    VIO_Real                x,
+    VIO_Real                y,
+    VIO_Real                z,
+    VIO_Real                *input_volume_steps,
+    VIO_Real                *x_transformed,
+    VIO_Real                *y_transformed,
+    VIO_Real                *z_transformed );
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : grid_transform_point
 @INPUT      : transform
@@ -269,11 +311,15 @@ VIOAPI  VIO_Status  grid_inverse_transform_point_with_input_steps(
     VIO_Real   error_x, error_y, error_z, error, smallest_e;
     VIO_Real   ftol;
     VIO_Status status=VIO_ERROR;
-    int    sizes[VIO_MAX_DIMENSIONS];
-    VIO_Real   steps[VIO_MAX_DIMENSIONS];
-    VIO_Volume volume;
-    short d, vector_dim = -1;
-    int i;
+
+    if( transform->displacement_cache != NULL &&
+        ((grid_cache_struct *) transform->displacement_cache)->
+                                          inverse_displacements != NULL )
+    {
+        return( cached_grid_inverse_transform_point( transform, x, y, z,
+                                  input_volume_steps,
+                                  x_transformed, y_transformed, z_transformed ) );
+    }
 
     if((status=grid_transform_point( transform, x, y, z, &tx, &ty, &tz ))!=VIO_OK)
       return status;
@@ -295,6 +341,64 @@ VIOAPI  VIO_Status  grid_inverse_transform_point_with_input_steps(
     best_y = ty;
     best_z = tz;
 
+    ftol = get_grid_inverse_tolerance( (VIO_Volume) transform->displacement_volume,
+                                       input_volume_steps );
+
+    while( ++tries < NUMBER_TRIES && smallest_e > ftol ) {
+        tx += 0.95 * error_x;
+        ty += 0.95 * error_y;
+        tz += 0.95 * error_z;
+
+        if((status=grid_transform_point( transform, tx, ty, tz, &gx, &gy, &gz ))!=VIO_OK)
+          return status;
+
+        error_x = x - gx;
+        error_y = y - gy;
+        error_z = z - gz;
+    
+        error = VIO_FABS(error_x) + VIO_FABS(error_y) + VIO_FABS(error_z);
+
+        if( error < smallest_e ) {
+            smallest_e = error;
+            best_x = tx;
+            best_y = ty;
+            best_z = tz;
+        }
+    }
+
+    *x_transformed = best_x;
+    *y_transformed = best_y;
+    *z_transformed = best_z;
+    return VIO_OK;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_grid_inverse_tolerance
+@INPUT      : volume               - the displacement volume
+              input_volume_steps   - may be NULL
+@OUTPUT     : 
+@RETURNS    : the tolerance
+@DESCRIPTION: Computes the error tolerance used when inverting the grid
+              transform by iteration, from the step sizes of the input volume
+              if known, or else from those of the displacement volume.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : 1993?   Louis Collins
+@MODIFIED   : Oct. 19, 2026, moved out of
+                         grid_inverse_transform_point_with_input_steps
+---------------------------------------------------------------------------- */
+
+static  VIO_Real  get_grid_inverse_tolerance(
+    VIO_Volume   volume,
+    VIO_Real     *input_volume_steps )
+{
+    VIO_Real   ftol;
+    int    sizes[VIO_MAX_DIMENSIONS];
+    VIO_Real   steps[VIO_MAX_DIMENSIONS];
+    short d, vector_dim = -1;
+    int i;
+
     // Adapt ftol to grid step sizes. For 1mm stx volume with grid 4mm, we
     // are using ftol=0.05 (=4mm/80). For histology data at grid 0.125mm,
     // then use ftol=0.125/80=0.0015625, which is fine on 0.01mm volume. 
@@ -306,7 +410,6 @@ VIOAPI  VIO_Status  grid_inverse_transform_point_with_input_steps(
     // ftol = 0.05 * smallest_e + 0.0001;
 
 
-    volume = (VIO_Volume) transform->displacement_volume;
     get_volume_sizes( volume, sizes );
     get_volume_separations( volume, steps );
 
@@ -342,32 +445,7 @@ VIOAPI  VIO_Status  grid_inverse_transform_point_with_input_steps(
     ftol = ftol / 80.0;
     if( ftol > 0.05 ) ftol = 0.05;   // just to be sure for large grids
 
-    while( ++tries < NUMBER_TRIES && smallest_e > ftol ) {
-        tx += 0.95 * error_x;
-        ty += 0.95 * error_y;
-        tz += 0.95 * error_z;
-
-        if((status=grid_transform_point( transform, tx, ty, tz, &gx, &gy, &gz ))!=VIO_OK)
-          return status;
-
-        error_x = x - gx;
-        error_y = y - gy;
-        error_z = z - gz;
-    
-        error = VIO_FABS(error_x) + VIO_FABS(error_y) + VIO_FABS(error_z);
-
-        if( error < smallest_e ) {
-            smallest_e = error;
-            best_x = tx;
-            best_y = ty;
-            best_z = tz;
-        }
-    }
-
-    *x_transformed = best_x;
-    *y_transformed = best_y;
-    *z_transformed = best_z;
-    return VIO_OK;
+    return( ftol );
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -641,3 +719,636 @@ static  void   evaluate_grid_volume(
         }
     }
 }
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_grid_vector_dim
+@INPUT      : volume
+@OUTPUT     : 
+@RETURNS    : the index of the vector dimension
+@DESCRIPTION: Finds which of the 4 dimensions of the displacement volume is
+              the non-spatial, vector dimension.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  int  get_grid_vector_dim(
+    VIO_Volume   volume )
+{
+    int   vector_dim, d;
+
+    for_less( vector_dim, 0, FOUR_DIMS ) {
+        for_less( d, 0, VIO_N_DIMENSIONS ) {
+            if( volume->spatial_axes[d] == vector_dim )
+                break;
+        }
+        if( d == VIO_N_DIMENSIONS )
+            break;
+    }
+
+    return( vector_dim );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_grid_transform_cache
+@INPUT      : transform
+@OUTPUT     : 
+@RETURNS    : VIO_Status
+@DESCRIPTION: Resamples the displacement volume of the grid transform into
+              the contiguous float array used by grid_transform_points(), if
+              this has not already been done.  The cache is not updated if
+              the displacement volume is later modified, so a program which
+              does this must call delete_grid_transform_cache() first.
+              Not safe to call from several threads on the same transform.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  create_grid_transform_cache(
+    VIO_General_transform   *transform )
+{
+    int                 a, c, d, vector_dim, axes[VIO_N_DIMENSIONS];
+    int                 v0, sizes[VIO_MAX_DIMENSIONS];
+    VIO_Real            origin[VIO_MAX_DIMENSIONS], voxel[VIO_MAX_DIMENSIONS];
+    VIO_Volume          volume;
+    grid_cache_struct   *cache;
+
+    if( transform->type != GRID_TRANSFORM || !transform->displacement_volume )
+        return( VIO_ERROR );
+
+    if( transform->displacement_cache != NULL )
+        return( VIO_OK );
+
+    volume = (VIO_Volume) transform->displacement_volume;
+
+    if( get_volume_n_dimensions(volume) != FOUR_DIMS )
+    {
+        handle_internal_error( "create_grid_transform_cache" );
+        return( VIO_ERROR );
+    }
+
+    vector_dim = get_grid_vector_dim( volume );
+    get_volume_sizes( volume, sizes );
+
+    ALLOC( cache, 1 );
+
+    /*--- the spatial dimensions, in volume order */
+
+    a = 0;
+    cache->slice_axis = -1;
+    for_less( d, 0, FOUR_DIMS )
+    {
+        if( d == vector_dim )
+            continue;
+        axes[a] = d;
+        cache->sizes[a] = sizes[d];
+        if( sizes[d] == 1 )
+            cache->slice_axis = a;
+        ++a;
+    }
+
+    cache->strides[2] = N_COMPONENTS;
+    cache->strides[1] = cache->strides[2] * (size_t) cache->sizes[2];
+    cache->strides[0] = cache->strides[1] * (size_t) cache->sizes[1];
+
+    /*--- the world to voxel mapping is affine, so recover it from the
+          images of the origin and the unit vectors */
+
+    convert_world_to_voxel( volume, 0.0, 0.0, 0.0, origin );
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+    {
+        convert_world_to_voxel( volume, c == VIO_X ? 1.0 : 0.0,
+                                        c == VIO_Y ? 1.0 : 0.0,
+                                        c == VIO_Z ? 1.0 : 0.0, voxel );
+        for_less( a, 0, VIO_N_DIMENSIONS )
+            cache->world_to_voxel[a][c] = voxel[axes[a]] - origin[axes[a]];
+    }
+
+    for_less( a, 0, VIO_N_DIMENSIONS )
+        cache->world_to_voxel[a][3] = origin[axes[a]];
+
+    /*--- and likewise for the voxel to world mapping */
+
+    for_less( d, 0, FOUR_DIMS )
+        voxel[d] = 0.0;
+
+    convert_voxel_to_world( volume, voxel, &origin[VIO_X], &origin[VIO_Y],
+                            &origin[VIO_Z] );
+
+    for_less( a, 0, VIO_N_DIMENSIONS )
+    {
+        VIO_Real   world[VIO_N_DIMENSIONS];
+
+        voxel[axes[a]] = 1.0;
+        convert_voxel_to_world( volume, voxel, &world[VIO_X], &world[VIO_Y],
+                                &world[VIO_Z] );
+        voxel[axes[a]] = 0.0;
+
+        for_less( c, 0, VIO_N_DIMENSIONS )
+            cache->voxel_to_world[c][a] = world[c] - origin[c];
+    }
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+        cache->voxel_to_world[c][3] = origin[c];
+
+    cache->inverse_displacements = NULL;
+
+    ALLOC( cache->displacements, cache->strides[0] * (size_t) cache->sizes[0] );
+
+    /*--- copy the real values, interleaving the components */
+
+#ifdef _OPENMP
+#pragma omp parallel for if( !volume->is_cached_volume ) schedule(static)
+#endif
+    for( v0 = 0; v0 < sizes[0]; ++v0 )
+    {
+        int        v[FOUR_DIMS];
+        size_t     offset;
+        VIO_Real   value;
+
+        v[0] = v0;
+        for_less( v[1], 0, sizes[1] )
+        for_less( v[2], 0, sizes[2] )
+        for_less( v[3], 0, sizes[3] )
+        {
+            GET_VALUE_4D_TYPED( value, (VIO_Real), volume,
+                                v[0], v[1], v[2], v[3] );
+
+            offset = (size_t) v[vector_dim] +
+                     (size_t) v[axes[0]] * cache->strides[0] +
+                     (size_t) v[axes[1]] * cache->strides[1] +
+                     (size_t) v[axes[2]] * cache->strides[2];
+
+            cache->displacements[offset] = (float) value;
+        }
+    }
+
+    transform->displacement_cache = (void *) cache;
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : delete_grid_transform_cache
+@INPUT      : transform
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Frees the cache created by create_grid_transform_cache(), if
+              any.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  delete_grid_transform_cache(
+    VIO_General_transform   *transform )
+{
+    grid_cache_struct   *cache;
+
+    if( transform->type != GRID_TRANSFORM ||
+        transform->displacement_cache == NULL )
+        return;
+
+    cache = (grid_cache_struct *) transform->displacement_cache;
+
+    FREE( cache->displacements );
+    if( cache->inverse_displacements != NULL )
+        FREE( cache->inverse_displacements );
+    FREE( cache );
+
+    transform->displacement_cache = NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_grid_weights
+@INPUT      : degrees_continuity
+              u
+@OUTPUT     : weights
+@RETURNS    : 
+@DESCRIPTION: Computes the degrees_continuity+2 weights of the interpolating
+              spline at the fractional position u, the same weights used by
+              evaluate_interpolating_spline().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  get_grid_weights(
+    int        degrees_continuity,
+    VIO_Real   u,
+    VIO_Real   weights[] )
+{
+    VIO_Real   u2, u3;
+
+    u2 = u * u;
+    u3 = u2 * u;
+
+    switch( degrees_continuity )
+    {
+    case -1:
+        weights[0] = 1.0;
+        break;
+
+    case 0:
+        weights[0] = 1.0 - u;
+        weights[1] = u;
+        break;
+
+    case 1:
+        weights[0] = 0.5 - u + 0.5 * u2;
+        weights[1] = 0.5 + u - u2;
+        weights[2] = 0.5 * u2;
+        break;
+
+    case 2:
+        weights[0] = -0.5 * u + u2 - 0.5 * u3;
+        weights[1] = 1.0 - 2.5 * u2 + 1.5 * u3;
+        weights[2] = 0.5 * u + 2.0 * u2 - 1.5 * u3;
+        weights[3] = -0.5 * u2 + 0.5 * u3;
+        break;
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : evaluate_grid_cache
+@INPUT      : cache
+              field     - the forward or inverse displacements of the cache
+              x
+              y
+              z
+@OUTPUT     : values
+@RETURNS    : 
+@DESCRIPTION: Evaluates the displacement at a world position from a cached
+              displacement array.  For the forward field, gives the same
+              result as
+              evaluate_grid_volume() with DEGREES_CONTINUITY, including the
+              reduction of the degree of continuity near the edges and the
+              handling of 2D grids.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  evaluate_grid_cache(
+    grid_cache_struct   *cache,
+    float               *field,
+    VIO_Real            x,
+    VIO_Real            y,
+    VIO_Real            z,
+    VIO_Real            values[] )
+{
+    int        a, i, j, k, degrees_continuity;
+    int        start[VIO_N_DIMENSIONS], n[VIO_N_DIMENSIONS];
+    VIO_Real   voxel[VIO_N_DIMENSIONS], bound, pos, w01, w;
+    VIO_Real   weights[VIO_N_DIMENSIONS][SPLINE_DEGREE];
+    float      *ptr;
+
+    for_less( a, 0, VIO_N_DIMENSIONS )
+    {
+        voxel[a] = cache->world_to_voxel[a][0] * x +
+                   cache->world_to_voxel[a][1] * y +
+                   cache->world_to_voxel[a][2] * z +
+                   cache->world_to_voxel[a][3];
+    }
+
+    values[VIO_X] = 0.0;
+    values[VIO_Y] = 0.0;
+    values[VIO_Z] = 0.0;
+
+    /*--- check if outside */
+
+    for_less( a, 0, VIO_N_DIMENSIONS )
+    {
+        if( voxel[a] < -0.5 || voxel[a] > cache->sizes[a] - 0.5 )
+            return;
+    }
+
+    /*--- near the edges, reduce the degrees of continuity,
+          as in evaluate_grid_volume() */
+
+    degrees_continuity = DEGREES_CONTINUITY;
+    bound = (VIO_Real) degrees_continuity / 2.0;
+
+    for_less( a, 0, VIO_N_DIMENSIONS )
+    {
+        if( a == cache->slice_axis )
+            continue;
+        while( degrees_continuity >= -1 &&
+               (voxel[a] < bound ||
+                voxel[a] > (VIO_Real) cache->sizes[a] - 1.0 - bound ||
+                bound == (VIO_Real) cache->sizes[a] - 1.0 - bound ) )
+        {
+            --degrees_continuity;
+            if( degrees_continuity == 1 )
+                degrees_continuity = 0;
+            bound = (VIO_Real) degrees_continuity / 2.0;
+        }
+    }
+
+    /*--- find the control vertices and their weights along each axis */
+
+    for_less( a, 0, VIO_N_DIMENSIONS )
+    {
+        if( a == cache->slice_axis )
+        {
+            start[a] = 0;
+            n[a] = 1;
+            weights[a][0] = 1.0;
+        }
+        else
+        {
+            pos = voxel[a] - bound;
+            start[a] = VIO_FLOOR( pos );
+            if( start[a] < 0 )
+                start[a] = 0;
+            else if( start[a] + degrees_continuity + 1 >= cache->sizes[a] )
+                start[a] = cache->sizes[a] - degrees_continuity - 2;
+            n[a] = degrees_continuity + 2;
+            get_grid_weights( degrees_continuity, pos - (VIO_Real) start[a],
+                              weights[a] );
+        }
+    }
+
+    /*--- tensor product of the weights with the interleaved vectors */
+
+    for_less( i, 0, n[0] )
+    {
+        for_less( j, 0, n[1] )
+        {
+            w01 = weights[0][i] * weights[1][j];
+            ptr = &field[(size_t) (start[0] + i) * cache->strides[0] +
+                         (size_t) (start[1] + j) * cache->strides[1] +
+                         (size_t) start[2] * cache->strides[2]];
+
+            for_less( k, 0, n[2] )
+            {
+                w = w01 * weights[2][k];
+                values[VIO_X] += w * (VIO_Real) ptr[0];
+                values[VIO_Y] += w * (VIO_Real) ptr[1];
+                values[VIO_Z] += w * (VIO_Real) ptr[2];
+                ptr += N_COMPONENTS;
+            }
+        }
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : grid_transform_points
+@INPUT      : transform
+              n_points
+              xyz       - n_points interleaved x,y,z positions
+@OUTPUT     : xyz       - the transformed positions
+@RETURNS    : VIO_Status
+@DESCRIPTION: Applies a grid transform to many points in place.  The first
+              call creates the displacement cache (see
+              create_grid_transform_cache()); after that, the points are
+              transformed without going through the volume accessors, and
+              the call may be made from several threads at once.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  grid_transform_points(
+    VIO_General_transform   *transform,
+    int                     n_points,
+    VIO_Real                xyz[] )
+{
+    int                 p;
+    VIO_Real            displacements[N_COMPONENTS];
+    grid_cache_struct   *cache;
+
+    if( create_grid_transform_cache( transform ) != VIO_OK )
+        return( VIO_ERROR );
+
+    cache = (grid_cache_struct *) transform->displacement_cache;
+
+    for_less( p, 0, n_points )
+    {
+        evaluate_grid_cache( cache, cache->displacements,
+                             xyz[0], xyz[1], xyz[2], displacements );
+
+        xyz[0] += displacements[VIO_X];
+        xyz[1] += displacements[VIO_Y];
+        xyz[2] += displacements[VIO_Z];
+        xyz += N_COMPONENTS;
+    }
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_grid_transform_inverse_cache
+@INPUT      : transform
+@OUTPUT     : 
+@RETURNS    : VIO_Status
+@DESCRIPTION: Computes, once, an approximate inverse displacement field on the
+              nodes of the displacement volume, and caches it along with the
+              forward field (see create_grid_transform_cache()).  Once it
+              exists, grid_inverse_transform_point_with_input_steps() starts
+              each point from the interpolated inverse field, so that one or
+              two refinement steps usually suffice, and inverting a grid
+              transform costs about as much as applying it.
+@METHOD     : Each node is inverted independently by the same fixed point
+              iteration as grid_inverse_transform_point_with_input_steps(),
+              seeded from the forward field and run to a tighter tolerance,
+              in parallel when OpenMP is enabled.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  create_grid_transform_inverse_cache(
+    VIO_General_transform   *transform )
+{
+#define  INVERSE_CACHE_TRIES  50
+    int                 v0;
+    VIO_Real            ftol;
+    grid_cache_struct   *cache;
+
+    if( create_grid_transform_cache( transform ) != VIO_OK )
+        return( VIO_ERROR );
+
+    cache = (grid_cache_struct *) transform->displacement_cache;
+
+    if( cache->inverse_displacements != NULL )
+        return( VIO_OK );
+
+    ftol = get_grid_inverse_tolerance(
+                  (VIO_Volume) transform->displacement_volume, NULL ) / 100.0;
+
+    ALLOC( cache->inverse_displacements,
+           cache->strides[0] * (size_t) cache->sizes[0] );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for( v0 = 0; v0 < cache->sizes[0]; ++v0 )
+    {
+        int        v1, v2, c, tries;
+        size_t     offset;
+        VIO_Real   voxel[VIO_N_DIMENSIONS], node[VIO_N_DIMENSIONS];
+        VIO_Real   t[VIO_N_DIMENSIONS], best[VIO_N_DIMENSIONS];
+        VIO_Real   g[VIO_N_DIMENSIONS], error[VIO_N_DIMENSIONS];
+        VIO_Real   e, smallest_e;
+
+        voxel[0] = (VIO_Real) v0;
+        for_less( v1, 0, cache->sizes[1] )
+        for_less( v2, 0, cache->sizes[2] )
+        {
+            voxel[1] = (VIO_Real) v1;
+            voxel[2] = (VIO_Real) v2;
+
+            for_less( c, 0, VIO_N_DIMENSIONS )
+            {
+                node[c] = cache->voxel_to_world[c][0] * voxel[0] +
+                          cache->voxel_to_world[c][1] * voxel[1] +
+                          cache->voxel_to_world[c][2] * voxel[2] +
+                          cache->voxel_to_world[c][3];
+            }
+
+            /*--- seed with the negated forward displacement */
+
+            offset = (size_t) v0 * cache->strides[0] +
+                     (size_t) v1 * cache->strides[1] +
+                     (size_t) v2 * cache->strides[2];
+
+            for_less( c, 0, VIO_N_DIMENSIONS )
+                t[c] = node[c] - (VIO_Real) cache->displacements[offset+c];
+
+            smallest_e = -1.0;
+            tries = 0;
+            do
+            {
+                evaluate_grid_cache( cache, cache->displacements,
+                                     t[VIO_X], t[VIO_Y], t[VIO_Z], g );
+
+                e = 0.0;
+                for_less( c, 0, VIO_N_DIMENSIONS )
+                {
+                    error[c] = node[c] - (t[c] + g[c]);
+                    e += VIO_FABS( error[c] );
+                }
+
+                if( smallest_e < 0.0 || e < smallest_e )
+                {
+                    smallest_e = e;
+                    for_less( c, 0, VIO_N_DIMENSIONS )
+                        best[c] = t[c];
+                }
+
+                for_less( c, 0, VIO_N_DIMENSIONS )
+                    t[c] += 0.95 * error[c];
+            }
+            while( ++tries < INVERSE_CACHE_TRIES && smallest_e > ftol );
+
+            for_less( c, 0, VIO_N_DIMENSIONS )
+                cache->inverse_displacements[offset+c] =
+                                           (float) (best[c] - node[c]);
+        }
+    }
+
+    return( VIO_OK );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : cached_grid_inverse_transform_point
+@INPUT      : transform
+              x
+              y
+              z
+              input_volume_steps
+@OUTPUT     : x_transformed
+              y_transformed
+              z_transformed
+@RETURNS    : VIO_Status
+@DESCRIPTION: Inverts the grid transform at a point using the cached forward
+              and inverse fields: starts from the interpolated inverse field
+              and refines with the fixed point iteration of
+              grid_inverse_transform_point_with_input_steps(), to the same
+              tolerance.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_Status  cached_grid_inverse_transform_point(
+    VIO_General_transform   *transform,
+    VIO_Real                x,
+    VIO_Real                y,
+    VIO_Real                z,
+    VIO_Real                *input_volume_steps,
+    VIO_Real                *x_transformed,
+    VIO_Real                *y_transformed,
+    VIO_Real                *z_transformed )
+{
+    int                 c, tries;
+    VIO_Real            point[VIO_N_DIMENSIONS], t[VIO_N_DIMENSIONS];
+    VIO_Real            best[VIO_N_DIMENSIONS], g[VIO_N_DIMENSIONS];
+    VIO_Real            error[VIO_N_DIMENSIONS], e, smallest_e, ftol;
+    grid_cache_struct   *cache;
+
+    cache = (grid_cache_struct *) transform->displacement_cache;
+
+    point[VIO_X] = x;
+    point[VIO_Y] = y;
+    point[VIO_Z] = z;
+
+    evaluate_grid_cache( cache, cache->inverse_displacements, x, y, z, g );
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+        t[c] = point[c] + g[c];
+
+    ftol = get_grid_inverse_tolerance(
+                  (VIO_Volume) transform->displacement_volume,
+                  input_volume_steps );
+
+    smallest_e = -1.0;
+    tries = 0;
+    do
+    {
+        evaluate_grid_cache( cache, cache->displacements,
+                             t[VIO_X], t[VIO_Y], t[VIO_Z], g );
+
+        e = 0.0;
+        for_less( c, 0, VIO_N_DIMENSIONS )
+        {
+            error[c] = point[c] - (t[c] + g[c]);
+            e += VIO_FABS( error[c] );
+        }
+
+        if( smallest_e < 0.0 || e < smallest_e )
+        {
+            smallest_e = e;
+            for_less( c, 0, VIO_N_DIMENSIONS )
+                best[c] = t[c];
+        }
+
+        for_less( c, 0, VIO_N_DIMENSIONS )
+            t[c] += 0.95 * error[c];
+    }
+    while( ++tries < NUMBER_TRIES && smallest_e > ftol );
+
+    *x_transformed = best[VIO_X];
+    *y_transformed = best[VIO_Y];
+    *z_transformed = best[VIO_Z];
+
+    return( VIO_OK );
+}
@@ -17,6 +17,14 @@
 
 #include <internal_volume_io.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define   INVERSE_FUNCTION_TOLERANCE     0.01
 #define   INVERSE_DELTA_TOLERANCE        0.01
 #define   MAX_INVERSE_ITERATIONS         20
@@ -51,6 +59,31 @@ typedef  struct
     int    n_dims;
 } spline_data_struct;
 
+/* ----- landmarks and weights in structure of arrays form, for batches ---- */
+
+typedef  struct
+{
+    int        n_dims;
+    int        n_landmarks;        /* padded to an even number */
+    VIO_Real   *coords[VIO_N_DIMENSIONS];
+    VIO_Real   *weights[VIO_N_DIMENSIONS];
+    VIO_Real   affine[VIO_N_DIMENSIONS][VIO_N_DIMENSIONS+1];
+} spline_soa_struct;
+
+/* ----- the spline sampled on a regular grid, for the approximate mode ---- */
+
+typedef  struct
+{
+    int        sizes[VIO_N_DIMENSIONS];
+    VIO_Real   origin[VIO_N_DIMENSIONS];
+    VIO_Real   step[VIO_N_DIMENSIONS];
+    VIO_Real   *values;            /* [sizes[0]][sizes[1]][sizes[2]][3] */
+} spline_grid_struct;
+
+#define   POINTS_PER_BLOCK           256
+#define   MIN_GRID_SIZE              4
+#define   N_ERROR_SAMPLES            4096
+
 /*------------ static functions -----------------*/
 
 static  void   newton_function(
@@ -471,3 +504,539 @@ static  VIO_Real  thin_plate_spline_U_deriv(
 
     return( deriv );
 }
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_spline_soa
+@INPUT      : n_dims
+              n_points
+              points
+              weights
+@OUTPUT     : spline
+@RETURNS    : 
+@DESCRIPTION: Copies the landmarks and their weights into separate
+              contiguous arrays per coordinate, padded with landmarks of zero
+              weight to an even count, and the constant and linear terms into
+              a small matrix.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  create_spline_soa(
+    int                 n_dims,
+    int                 n_points,
+    VIO_Real            **points,
+    VIO_Real            **weights,
+    spline_soa_struct   *spline )
+{
+    int   d, v, p;
+
+    spline->n_dims = n_dims;
+    spline->n_landmarks = n_points + (n_points % 2);
+
+    for_less( d, 0, VIO_N_DIMENSIONS )
+    {
+        ALLOC( spline->coords[d], spline->n_landmarks );
+        ALLOC( spline->weights[d], spline->n_landmarks );
+
+        for_less( p, 0, spline->n_landmarks )
+        {
+            if( p < n_points && d < n_dims )
+            {
+                spline->coords[d][p] = points[p][d];
+                spline->weights[d][p] = weights[p][d];
+            }
+            else
+            {
+                spline->coords[d][p] = 0.0;
+                spline->weights[d][p] = 0.0;
+            }
+        }
+    }
+
+    for_less( v, 0, VIO_N_DIMENSIONS )
+    {
+        for_less( d, 0, VIO_N_DIMENSIONS + 1 )
+            spline->affine[v][d] = 0.0;
+
+        if( v >= n_dims )
+            continue;
+
+        spline->affine[v][0] = weights[n_points][v];
+        for_less( d, 0, n_dims )
+            spline->affine[v][d+1] = weights[n_points+1+d][v];
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : delete_spline_soa
+@INPUT      : spline
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Frees the arrays allocated by create_spline_soa().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  delete_spline_soa(
+    spline_soa_struct   *spline )
+{
+    int   d;
+
+    for_less( d, 0, VIO_N_DIMENSIONS )
+    {
+        FREE( spline->coords[d] );
+        FREE( spline->weights[d] );
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : evaluate_spline_soa
+@INPUT      : spline
+              pos
+@OUTPUT     : values
+@RETURNS    : 
+@DESCRIPTION: Evaluates the thin plate spline at one position, as
+              evaluate_thin_plate_spline() does, but from the structure of
+              arrays form.  In 3D, where U is the distance, two landmarks are
+              processed per SSE2 instruction when available.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  evaluate_spline_soa(
+    spline_soa_struct   *spline,
+    VIO_Real            pos[],
+    VIO_Real            values[] )
+{
+    int        p, v, n;
+    VIO_Real   dx, dy, r, u;
+    VIO_Real   sum[VIO_N_DIMENSIONS];
+    VIO_Real   *cx, *cy, *cz, *wx, *wy, *wz;
+
+    n = spline->n_landmarks;
+    cx = spline->coords[VIO_X];
+    cy = spline->coords[VIO_Y];
+    cz = spline->coords[VIO_Z];
+    wx = spline->weights[VIO_X];
+    wy = spline->weights[VIO_Y];
+    wz = spline->weights[VIO_Z];
+
+    sum[VIO_X] = 0.0;
+    sum[VIO_Y] = 0.0;
+    sum[VIO_Z] = 0.0;
+
+    switch( spline->n_dims )
+    {
+    case 1:
+        for_less( p, 0, n )
+        {
+            r = VIO_FABS( pos[VIO_X] - cx[p] );
+            sum[VIO_X] += wx[p] * r * r * r;
+        }
+        break;
+
+    case 2:
+        for_less( p, 0, n )
+        {
+            dx = pos[VIO_X] - cx[p];
+            dy = pos[VIO_Y] - cy[p];
+            r = dx * dx + dy * dy;
+            u = (r == 0.0) ? 0.0 : r * log( r );
+            sum[VIO_X] += wx[p] * u;
+            sum[VIO_Y] += wy[p] * u;
+        }
+        break;
+
+    case 3:
+#ifdef __SSE2__
+        {
+            __m128d   px, py, pz, ddx, ddy, ddz, rr, sx, sy, sz;
+            double    out[2];
+
+            px = _mm_set1_pd( pos[VIO_X] );
+            py = _mm_set1_pd( pos[VIO_Y] );
+            pz = _mm_set1_pd( pos[VIO_Z] );
+            sx = _mm_setzero_pd();
+            sy = _mm_setzero_pd();
+            sz = _mm_setzero_pd();
+
+            for( p = 0; p < n; p += 2 )
+            {
+                ddx = _mm_sub_pd( px, _mm_loadu_pd( &cx[p] ) );
+                ddy = _mm_sub_pd( py, _mm_loadu_pd( &cy[p] ) );
+                ddz = _mm_sub_pd( pz, _mm_loadu_pd( &cz[p] ) );
+                rr = _mm_sqrt_pd( _mm_add_pd(
+                                      _mm_add_pd( _mm_mul_pd( ddx, ddx ),
+                                                  _mm_mul_pd( ddy, ddy ) ),
+                                      _mm_mul_pd( ddz, ddz ) ) );
+                sx = _mm_add_pd( sx, _mm_mul_pd( rr, _mm_loadu_pd( &wx[p] ) ) );
+                sy = _mm_add_pd( sy, _mm_mul_pd( rr, _mm_loadu_pd( &wy[p] ) ) );
+                sz = _mm_add_pd( sz, _mm_mul_pd( rr, _mm_loadu_pd( &wz[p] ) ) );
+            }
+
+            _mm_storeu_pd( out, sx );
+            sum[VIO_X] = out[0] + out[1];
+            _mm_storeu_pd( out, sy );
+            sum[VIO_Y] = out[0] + out[1];
+            _mm_storeu_pd( out, sz );
+            sum[VIO_Z] = out[0] + out[1];
+        }
+#else
+        {
+            VIO_Real   dz;
+
+            for_less( p, 0, n )
+            {
+                dx = pos[VIO_X] - cx[p];
+                dy = pos[VIO_Y] - cy[p];
+                dz = pos[VIO_Z] - cz[p];
+                r = sqrt( dx * dx + dy * dy + dz * dz );
+                sum[VIO_X] += wx[p] * r;
+                sum[VIO_Y] += wy[p] * r;
+                sum[VIO_Z] += wz[p] * r;
+            }
+        }
+#endif
+        break;
+    }
+
+    for_less( v, 0, spline->n_dims )
+    {
+        values[v] = sum[v] + spline->affine[v][0] +
+                    spline->affine[v][1] * pos[VIO_X] +
+                    spline->affine[v][2] * pos[VIO_Y] +
+                    spline->affine[v][3] * pos[VIO_Z];
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_cubic_weights
+@INPUT      : u
+@OUTPUT     : weights
+@RETURNS    : 
+@DESCRIPTION: Computes the 4 weights of the interpolating cubic spline at the
+              fractional position u between the second and third node.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  get_cubic_weights(
+    VIO_Real   u,
+    VIO_Real   weights[] )
+{
+    VIO_Real   u2, u3;
+
+    u2 = u * u;
+    u3 = u2 * u;
+
+    weights[0] = -0.5 * u + u2 - 0.5 * u3;
+    weights[1] = 1.0 - 2.5 * u2 + 1.5 * u3;
+    weights[2] = 0.5 * u + 2.0 * u2 - 1.5 * u3;
+    weights[3] = -0.5 * u2 + 0.5 * u3;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : evaluate_spline_grid
+@INPUT      : grid
+              pos
+              n_dims
+@OUTPUT     : values
+@RETURNS    : 
+@DESCRIPTION: Interpolates the sampled spline at a position inside the grid,
+              with a tricubic interpolating spline.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  evaluate_spline_grid(
+    spline_grid_struct   *grid,
+    VIO_Real             pos[],
+    int                  n_dims,
+    VIO_Real             values[] )
+{
+    int        a, i, j, k, v, start[VIO_N_DIMENSIONS];
+    VIO_Real   voxel, weights[VIO_N_DIMENSIONS][4], w;
+    VIO_Real   *ptr;
+
+    for_less( a, 0, VIO_N_DIMENSIONS )
+    {
+        voxel = (pos[a] - grid->origin[a]) / grid->step[a];
+        start[a] = (int) floor( voxel ) - 1;
+        if( start[a] < 0 )
+            start[a] = 0;
+        else if( start[a] > grid->sizes[a] - 4 )
+            start[a] = grid->sizes[a] - 4;
+        get_cubic_weights( voxel - (VIO_Real) (start[a] + 1), weights[a] );
+    }
+
+    for_less( v, 0, n_dims )
+        values[v] = 0.0;
+
+    for_less( i, 0, 4 )
+    for_less( j, 0, 4 )
+    {
+        ptr = &grid->values[3 * (((size_t) (start[0] + i) * grid->sizes[1] +
+                                  (size_t) (start[1] + j)) * grid->sizes[2] +
+                                  (size_t) start[2])];
+        for_less( k, 0, 4 )
+        {
+            w = weights[0][i] * weights[1][j] * weights[2][k];
+            for_less( v, 0, n_dims )
+                values[v] += w * ptr[v];
+            ptr += 3;
+        }
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_spline_grid
+@INPUT      : spline
+              lower       - corner of the region to cover
+              upper       - opposite corner
+              tolerance
+              max_nodes   - give up if more nodes than this are needed
+@OUTPUT     : grid
+@RETURNS    : TRUE if a grid meeting the tolerance was built
+@DESCRIPTION: Samples the spline on successively finer regular grids covering
+              the region until the interpolated values agree with the exact
+              spline to within the tolerance, judged at the centres of a
+              sample of grid cells, where the interpolation error is largest.
+              The spline is smooth away from its landmarks, so a grid much
+              coarser than the query points usually suffices.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  VIO_BOOL  create_spline_grid(
+    spline_soa_struct    *spline,
+    VIO_Real             lower[],
+    VIO_Real             upper[],
+    VIO_Real             tolerance,
+    size_t               max_nodes,
+    spline_grid_struct   *grid )
+{
+    int        a, n_cells, sample, n_samples;
+    size_t     n_nodes, node;
+    VIO_Real   extent, max_extent, error;
+
+    max_extent = 0.0;
+    for_less( a, 0, VIO_N_DIMENSIONS )
+        max_extent = MAX( max_extent, upper[a] - lower[a] );
+
+    if( max_extent <= 0.0 )
+        max_extent = 1.0;
+
+    n_cells = MIN_GRID_SIZE;
+
+    while( TRUE )
+    {
+        /*--- nodes extend one cell beyond the region on each side, so that
+              the cubic stencil is always centred inside it */
+
+        n_nodes = 1;
+        for_less( a, 0, VIO_N_DIMENSIONS )
+        {
+            extent = upper[a] - lower[a];
+            grid->step[a] = max_extent / (VIO_Real) n_cells;
+            grid->sizes[a] = (int) ceil( extent / grid->step[a] ) + 3;
+            if( grid->sizes[a] < 4 )
+                grid->sizes[a] = 4;
+            grid->origin[a] = lower[a] - grid->step[a];
+            n_nodes *= (size_t) grid->sizes[a];
+        }
+
+        if( n_nodes > max_nodes )
+            return( FALSE );
+
+        ALLOC( grid->values, 3 * n_nodes );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for( node = 0; node < n_nodes; ++node )
+        {
+            VIO_Real   pos[VIO_N_DIMENSIONS];
+
+            pos[0] = grid->origin[0] + grid->step[0] *
+                     (VIO_Real) (node / ((size_t) grid->sizes[1] * grid->sizes[2]));
+            pos[1] = grid->origin[1] + grid->step[1] *
+                     (VIO_Real) ((node / grid->sizes[2]) % grid->sizes[1]);
+            pos[2] = grid->origin[2] + grid->step[2] *
+                     (VIO_Real) (node % grid->sizes[2]);
+
+            evaluate_spline_soa( spline, pos, &grid->values[3*node] );
+        }
+
+        /*--- check the error at cell centres spread through the grid */
+
+        n_samples = (int) MIN( (size_t) N_ERROR_SAMPLES, n_nodes );
+        error = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(max:error)
+#endif
+        for( sample = 0; sample < n_samples; ++sample )
+        {
+            int        c, v;
+            size_t     cell;
+            VIO_Real   pos[VIO_N_DIMENSIONS], exact[VIO_N_DIMENSIONS];
+            VIO_Real   approx[VIO_N_DIMENSIONS];
+
+            cell = (size_t) sample * (n_nodes / (size_t) n_samples);
+
+            pos[0] = (VIO_Real) (cell / ((size_t) grid->sizes[1] * grid->sizes[2]));
+            pos[1] = (VIO_Real) ((cell / grid->sizes[2]) % grid->sizes[1]);
+            pos[2] = (VIO_Real) (cell % grid->sizes[2]);
+
+            for_less( c, 0, VIO_N_DIMENSIONS )
+            {
+                pos[c] = MIN( pos[c], (VIO_Real) grid->sizes[c] - 2.0 );
+                pos[c] = grid->origin[c] + grid->step[c] * (pos[c] + 0.5);
+            }
+
+            evaluate_spline_soa( spline, pos, exact );
+            evaluate_spline_grid( grid, pos, spline->n_dims, approx );
+
+            for_less( v, 0, spline->n_dims )
+                error = MAX( error, VIO_FABS( exact[v] - approx[v] ) );
+        }
+
+        if( error <= tolerance )
+            return( TRUE );
+
+        FREE( grid->values );
+        n_cells *= 2;
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : thin_plate_spline_transform_points
+@INPUT      : n_dims      - number of dimensions (1, 2 or 3)
+              n_points    - number of landmarks
+              points      - the landmarks, as for thin_plate_spline_transform
+              weights     - the weights, as for thin_plate_spline_transform
+              tolerance   - zero for exact evaluation, else the allowed
+                            error of the approximation
+              n_xyz       - number of positions to transform
+              xyz         - n_xyz interleaved x,y,z positions
+@OUTPUT     : xyz         - the transformed positions
+@RETURNS    : VIO_Status
+@DESCRIPTION: Transforms many points by the thin plate spline.  The landmarks
+              are copied once into structure of arrays form and blocks of
+              points are evaluated in parallel when OpenMP is enabled.  If
+              the tolerance is positive, the spline is instead sampled on a
+              regular grid covering the points, fine enough that tricubic
+              interpolation of it stays within the tolerance, which turns the
+              cost per point from one term per landmark into 64 terms.  If
+              such a grid would need more than a quarter as many nodes as
+              there are points, the exact evaluation is used.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  thin_plate_spline_transform_points(
+    int         n_dims,
+    int         n_points,
+    VIO_Real    **points,
+    VIO_Real    **weights,
+    VIO_Real    tolerance,
+    int         n_xyz,
+    VIO_Real    xyz[] )
+{
+    int                  a, p, block, n_blocks;
+    VIO_BOOL             use_grid;
+    VIO_Real             lower[VIO_N_DIMENSIONS], upper[VIO_N_DIMENSIONS];
+    spline_soa_struct    spline;
+    spline_grid_struct   grid;
+
+    if( n_dims < 1 || n_dims > VIO_N_DIMENSIONS )
+    {
+        print_error( "thin_plate_spline_transform_points: invalid n dims: %d\n",
+                     n_dims );
+        return( VIO_ERROR );
+    }
+
+    if( n_xyz <= 0 )
+        return( VIO_OK );
+
+    create_spline_soa( n_dims, n_points, points, weights, &spline );
+
+    use_grid = FALSE;
+
+    if( tolerance > 0.0 )
+    {
+        for_less( a, 0, VIO_N_DIMENSIONS )
+        {
+            lower[a] = (a < n_dims) ? xyz[a] : 0.0;
+            upper[a] = lower[a];
+        }
+
+        for_less( p, 1, n_xyz )
+        {
+            for_less( a, 0, n_dims )
+            {
+                lower[a] = MIN( lower[a], xyz[3*p+a] );
+                upper[a] = MAX( upper[a], xyz[3*p+a] );
+            }
+        }
+
+        use_grid = create_spline_grid( &spline, lower, upper, tolerance,
+                                       (size_t) n_xyz / 4, &grid );
+    }
+
+    n_blocks = (n_xyz + POINTS_PER_BLOCK - 1) / POINTS_PER_BLOCK;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for( block = 0; block < n_blocks; ++block )
+    {
+        int        i, v, end;
+        VIO_Real   pos[VIO_N_DIMENSIONS], values[VIO_N_DIMENSIONS];
+
+        end = MIN( n_xyz, (block + 1) * POINTS_PER_BLOCK );
+
+        for_less( i, block * POINTS_PER_BLOCK, end )
+        {
+            pos[VIO_X] = xyz[3*i];
+            pos[VIO_Y] = (n_dims >= 2) ? xyz[3*i+1] : 0.0;
+            pos[VIO_Z] = (n_dims >= 3) ? xyz[3*i+2] : 0.0;
+
+            if( use_grid )
+                evaluate_spline_grid( &grid, pos, n_dims, values );
+            else
+                evaluate_spline_soa( &spline, pos, values );
+
+            for_less( v, 0, n_dims )
+                xyz[3*i+v] = values[v];
+        }
+    }
+
+    if( use_grid )
+        FREE( grid.values );
+
+    delete_spline_soa( &spline );
+
+    return( VIO_OK );
+}
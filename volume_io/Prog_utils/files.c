@@ -33,6 +33,9 @@
 #if HAVE_FCNTL_H
 #include <fcntl.h>
 #endif /* HAVE_FCNTL_H */
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif /* HAVE_SYS_MMAN_H */
 
 #include  <errno.h>
 
@@ -1213,6 +1216,112 @@ VIOAPI  VIO_Status  close_file(
         return( VIO_ERROR );
 }
 
+typedef struct
+{
+    void    *address;
+    size_t  length;
+} file_mapping_struct;
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : map_file_data
+@INPUT      : filename
+              byte_offset
+              n_bytes
+@OUTPUT     : data
+              mapping
+@RETURNS    : VIO_OK if the data was mapped
+@DESCRIPTION: Maps n_bytes of the file, starting at byte_offset, into memory.
+              The mapping is private: the data may be modified in memory,
+              but the changes are never written to the file.  Pages are read
+              from the file as they are first used.  Returns VIO_ERROR,
+              without printing anything, if the file is too short or cannot
+              be mapped, so the caller can fall back to reading it.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  map_file_data(
+    VIO_STR    filename,
+    size_t     byte_offset,
+    size_t     n_bytes,
+    void       **data,
+    void       **mapping )
+{
+#if HAVE_SYS_MMAN_H && HAVE_SYS_STAT_H && HAVE_FCNTL_H
+    int                  fd;
+    struct stat          st;
+    size_t               page_offset;
+    void                 *address;
+    file_mapping_struct  *map;
+    VIO_STR              expanded;
+
+    if( n_bytes == 0 )
+        return( VIO_ERROR );
+
+    expanded = expand_filename( filename );
+    fd = open( expanded, O_RDONLY );
+    delete_string( expanded );
+    if( fd < 0 )
+        return( VIO_ERROR );
+
+    /* mapping past the end of the file would fault when the data is used */
+    if( fstat( fd, &st ) != 0 || !S_ISREG( st.st_mode ) ||
+        (size_t) st.st_size < byte_offset ||
+        (size_t) st.st_size - byte_offset < n_bytes )
+    {
+        close( fd );
+        return( VIO_ERROR );
+    }
+
+    page_offset = byte_offset % (size_t) sysconf( _SC_PAGESIZE );
+    address = mmap( NULL, n_bytes + page_offset, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE, fd, (off_t) (byte_offset - page_offset) );
+    close( fd );
+    if( address == MAP_FAILED )
+        return( VIO_ERROR );
+
+    ALLOC( map, 1 );
+    map->address = address;
+    map->length = n_bytes + page_offset;
+
+    *data = (char *) address + page_offset;
+    *mapping = map;
+    return( VIO_OK );
+#else
+    return( VIO_ERROR );
+#endif
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : unmap_file_data
+@INPUT      : mapping
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Unmaps data mapped by map_file_data().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  unmap_file_data(
+    void   *mapping )
+{
+#if HAVE_SYS_MMAN_H && HAVE_SYS_STAT_H && HAVE_FCNTL_H
+    file_mapping_struct  *map = (file_mapping_struct *) mapping;
+
+    if( map == NULL )
+        return;
+
+    (void) munmap( map->address, map->length );
+    FREE( map );
+#endif
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : extract_directory
 @INPUT      : filename
@@ -0,0 +1,519 @@
+/**
+ * \file Cubic B-spline coefficient volumes.
+ *
+ * A volume is prefiltered once into a float volume of B-spline
+ * coefficients, which is then interpolated with a fixed 4x4x4 kernel,
+ * with analytic derivatives, by evaluate_bspline_volume() and
+ * evaluate_bspline_volume_in_world(). The interpolating cubic of
+ * evaluate_volume() is separate, and unchanged.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include  <internal_volume_io.h>
+
+#ifdef _OPENMP
+#include  <omp.h>
+#endif
+
+/* --- pole of the cubic B-spline prefilter, sqrt(3) - 2 */
+
+#define  BSPLINE_POLE        -0.267949192431122706472553658494
+#define  BSPLINE_TOLERANCE   1.0e-9
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : mirror_index
+@INPUT      : i
+              n
+@OUTPUT     :
+@RETURNS    : index in the range 0 to n-1
+@DESCRIPTION: Maps an index outside the volume back inside it, using
+              whole-sample mirror boundary conditions, the same boundary
+              assumed by the prefilter.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : Oct. 19, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+static  int  mirror_index(
+    int   i,
+    int   n )
+{
+    int   period;
+
+    if( i >= 0 && i < n )
+        return( i );
+
+    if( n == 1 )
+        return( 0 );
+
+    period = 2 * n - 2;
+    i %= period;
+    if( i < 0 )
+        i += period;
+    if( i >= n )
+        i = period - i;
+
+    return( i );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : prefilter_line
+@INPUT      : c     - n samples
+              n
+@OUTPUT     : c     - n cubic B-spline coefficients
+@RETURNS    :
+@DESCRIPTION: Converts a line of samples to cubic B-spline coefficients in
+              place, with a causal and an anti-causal first order recursive
+              filter.
+@METHOD     : M. Unser, "Splines: a perfect fit for signal and image
+              processing", IEEE Signal Processing Magazine, 1999.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : Oct. 19, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+static  void  prefilter_line(
+    VIO_Real   c[],
+    int        n )
+{
+    int        k, horizon;
+    VIO_Real   z, zn, z2n, iz, sum;
+
+    if( n == 1 )
+        return;
+
+    z = BSPLINE_POLE;
+
+    for_less( k, 0, n )
+        c[k] *= (1.0 - z) * (1.0 - 1.0 / z);
+
+    /*--- initial causal coefficient, mirror boundary */
+
+    horizon = (int) ceil( log( BSPLINE_TOLERANCE ) / log( fabs( z ) ) );
+
+    if( horizon < n )
+    {
+        zn = z;
+        sum = c[0];
+        for_less( k, 1, horizon )
+        {
+            sum += zn * c[k];
+            zn *= z;
+        }
+    }
+    else
+    {
+        zn = z;
+        iz = 1.0 / z;
+        z2n = pow( z, (VIO_Real) (n - 1) );
+        sum = c[0] + z2n * c[n-1];
+        z2n *= z2n * iz;
+        for_less( k, 1, n - 1 )
+        {
+            sum += (zn + z2n) * c[k];
+            zn *= z;
+            z2n *= iz;
+        }
+        sum /= 1.0 - zn * zn;
+    }
+
+    c[0] = sum;
+
+    for_less( k, 1, n )
+        c[k] += z * c[k-1];
+
+    /*--- initial anti-causal coefficient, mirror boundary */
+
+    c[n-1] = (z / (z * z - 1.0)) * (z * c[n-2] + c[n-1]);
+
+    for_down( k, n - 2, 0 )
+        c[k] = z * (c[k+1] - c[k]);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : prefilter_axis
+@INPUT      : data
+              sizes
+              axis
+@OUTPUT     : data
+@RETURNS    :
+@DESCRIPTION: Applies the prefilter to every line of the contiguous 3D float
+              array along the given axis.  Lines are independent, so they are
+              distributed over threads when OpenMP is enabled.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : Oct. 19, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+static  void  prefilter_axis(
+    float      *data,
+    int        sizes[],
+    int        axis )
+{
+    int        a1, a2, n, n_lines, n_threads, line;
+    size_t     strides[VIO_N_DIMENSIONS];
+    VIO_Real   *buffers;
+
+    strides[2] = 1;
+    strides[1] = (size_t) sizes[2];
+    strides[0] = (size_t) sizes[1] * (size_t) sizes[2];
+
+    n = sizes[axis];
+    a1 = (axis + 1) % VIO_N_DIMENSIONS;
+    a2 = (axis + 2) % VIO_N_DIMENSIONS;
+    n_lines = sizes[a1] * sizes[a2];
+
+#ifdef _OPENMP
+    n_threads = omp_get_max_threads();
+#else
+    n_threads = 1;
+#endif
+
+    ALLOC( buffers, (size_t) n_threads * (size_t) n );
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for( line = 0; line < n_lines; ++line )
+    {
+        int        k;
+        float      *ptr;
+        VIO_Real   *c;
+
+#ifdef _OPENMP
+        c = &buffers[(size_t) omp_get_thread_num() * (size_t) n];
+#else
+        c = buffers;
+#endif
+
+        ptr = data + (size_t) (line / sizes[a2]) * strides[a1] +
+                     (size_t) (line % sizes[a2]) * strides[a2];
+
+        for_less( k, 0, n )
+            c[k] = (VIO_Real) ptr[(size_t) k * strides[axis]];
+
+        prefilter_line( c, n );
+
+        for_less( k, 0, n )
+            ptr[(size_t) k * strides[axis]] = (float) c[k];
+    }
+
+    FREE( buffers );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_bspline_coefficient_volume
+@INPUT      : volume
+@OUTPUT     :
+@RETURNS    : new volume, or NULL on error
+@DESCRIPTION: Creates a float volume with the same sampling as the given 3D
+              volume, holding the cubic B-spline coefficients which
+              interpolate its real values.  The coefficients are computed
+              once, by separable recursive filtering along each axis, so that
+              evaluate_bspline_volume() can then interpolate any point with a
+              fixed 4x4x4 kernel.  The coefficient volume is always held in
+              memory, never cached, and should be deleted with
+              delete_volume().
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : Oct. 19, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Volume  create_bspline_coefficient_volume(
+    VIO_Volume   volume )
+{
+    int          v0, v1, v2, axis, sizes[VIO_MAX_DIMENSIONS];
+    size_t       i, n_voxels;
+    float        *data;
+    VIO_Real     *slice, min_value, max_value;
+    VIO_Volume   coefficients;
+
+    if( get_volume_n_dimensions( volume ) != 3 || is_an_rgb_volume( volume ) )
+    {
+        print_error(
+           "create_bspline_coefficient_volume: volume must be 3D scalar.\n" );
+        return( NULL );
+    }
+
+    coefficients = copy_volume_definition_no_alloc( volume, NC_FLOAT, TRUE,
+                                                    0.0, 0.0 );
+
+    coefficients->is_cached_volume = FALSE;
+    alloc_multidim_array( &coefficients->array );
+
+    if( !multidim_array_is_alloced( &coefficients->array ) )
+    {
+        delete_volume( coefficients );
+        return( NULL );
+    }
+
+    get_volume_sizes( volume, sizes );
+    n_voxels = (size_t) sizes[0] * (size_t) sizes[1] * (size_t) sizes[2];
+
+    GET_MULTIDIM_PTR_3D( data, coefficients->array, 0, 0, 0 );
+
+    /*--- copy the real values of the volume, a slice at a time */
+
+    ALLOC( slice, (size_t) sizes[1] * (size_t) sizes[2] );
+
+    for_less( v0, 0, sizes[0] )
+    {
+        get_volume_value_hyperslab_3d( volume, v0, 0, 0,
+                                       1, sizes[1], sizes[2], slice );
+
+        i = (size_t) v0 * (size_t) sizes[1] * (size_t) sizes[2];
+        for_less( v1, 0, sizes[1] )
+        {
+            for_less( v2, 0, sizes[2] )
+            {
+                data[i] = (float) slice[v1 * sizes[2] + v2];
+                ++i;
+            }
+        }
+    }
+
+    FREE( slice );
+
+    /*--- the tensor product prefilter is separable */
+
+    for_less( axis, 0, VIO_N_DIMENSIONS )
+        prefilter_axis( data, sizes, axis );
+
+    /*--- the coefficients overshoot the range of the samples */
+
+    min_value = max_value = (VIO_Real) data[0];
+    for_less( i, 1, n_voxels )
+    {
+        if( data[i] < min_value )
+            min_value = (VIO_Real) data[i];
+        else if( data[i] > max_value )
+            max_value = (VIO_Real) data[i];
+    }
+
+    set_volume_real_range( coefficients, min_value, max_value );
+
+    return( coefficients );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : bspline_weights
+@INPUT      : x        - voxel coordinate
+              n        - size of the axis
+@OUTPUT     : offsets  - element offsets of the 4 coefficients, before scaling
+                         by the axis stride
+              weights
+              derivs   - derivative weights, may be NULL
+@RETURNS    :
+@DESCRIPTION: Computes the 4 cubic B-spline weights for one axis.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : Oct. 19, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+static  void  bspline_weights(
+    VIO_Real   x,
+    int        n,
+    int        offsets[],
+    VIO_Real   weights[],
+    VIO_Real   derivs[] )
+{
+    int        i, start;
+    VIO_Real   t, t2, t3, s;
+
+    start = (int) VIO_FLOOR( x );
+    t = x - (VIO_Real) start;
+    t2 = t * t;
+    t3 = t2 * t;
+    s = 1.0 - t;
+
+    weights[0] = s * s * s / 6.0;
+    weights[1] = (3.0 * t3 - 6.0 * t2 + 4.0) / 6.0;
+    weights[2] = (-3.0 * t3 + 3.0 * t2 + 3.0 * t + 1.0) / 6.0;
+    weights[3] = t3 / 6.0;
+
+    if( derivs != NULL )
+    {
+        derivs[0] = -0.5 * s * s;
+        derivs[1] = 1.5 * t2 - 2.0 * t;
+        derivs[2] = -1.5 * t2 + t + 0.5;
+        derivs[3] = 0.5 * t2;
+    }
+
+    for_less( i, 0, 4 )
+        offsets[i] = mirror_index( start - 1 + i, n );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : evaluate_bspline_volume
+@INPUT      : coefficients   - created by create_bspline_coefficient_volume()
+              voxel
+              outside_value
+@OUTPUT     : value
+              derivs         - voxel space first derivatives, may be NULL
+@RETURNS    :
+@DESCRIPTION: Evaluates the cubic B-spline at a voxel position, and
+              optionally its analytic first derivatives.  Positions more
+              than half a voxel outside the volume get the outside_value
+              and zero derivatives.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : Oct. 19, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  evaluate_bspline_volume(
+    VIO_Volume   coefficients,
+    VIO_Real     voxel[],
+    VIO_Real     outside_value,
+    VIO_Real     *value,
+    VIO_Real     derivs[] )
+{
+    int        c, i, j, k, *sizes;
+    int        off[VIO_N_DIMENSIONS][4];
+    size_t     base_i, base_ij;
+    float      *data, *ptr;
+    VIO_Real   w[VIO_N_DIMENSIONS][4], dw[VIO_N_DIMENSIONS][4];
+    VIO_Real   sum, dsum, wij, value_sum, dx, dy, dz;
+
+    if( coefficients->is_cached_volume ||
+        coefficients->array.n_dimensions != 3 ||
+        coefficients->array.data_type != VIO_FLOAT )
+    {
+        handle_internal_error( "evaluate_bspline_volume: not a coefficient volume" );
+        return;
+    }
+
+    sizes = coefficients->array.sizes;
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+    {
+        if( voxel[c] < -0.5 || voxel[c] > (VIO_Real) sizes[c] - 0.5 )
+        {
+            *value = outside_value;
+            if( derivs != NULL )
+            {
+                derivs[0] = 0.0;
+                derivs[1] = 0.0;
+                derivs[2] = 0.0;
+            }
+            return;
+        }
+
+        bspline_weights( voxel[c], sizes[c], off[c], w[c],
+                         (derivs != NULL) ? dw[c] : NULL );
+    }
+
+    for_less( i, 0, 4 )
+    {
+        off[0][i] *= sizes[1] * sizes[2];
+        off[1][i] *= sizes[2];
+    }
+
+    GET_MULTIDIM_PTR_3D( data, coefficients->array, 0, 0, 0 );
+
+    value_sum = 0.0;
+    dx = 0.0;
+    dy = 0.0;
+    dz = 0.0;
+
+    for_less( i, 0, 4 )
+    {
+        base_i = (size_t) off[0][i];
+
+        for_less( j, 0, 4 )
+        {
+            base_ij = base_i + (size_t) off[1][j];
+            ptr = data + base_ij;
+
+            sum = 0.0;
+            for_less( k, 0, 4 )
+                sum += w[2][k] * (VIO_Real) ptr[off[2][k]];
+
+            wij = w[0][i] * w[1][j];
+            value_sum += wij * sum;
+
+            if( derivs != NULL )
+            {
+                dsum = 0.0;
+                for_less( k, 0, 4 )
+                    dsum += dw[2][k] * (VIO_Real) ptr[off[2][k]];
+
+                dx += dw[0][i] * w[1][j] * sum;
+                dy += w[0][i] * dw[1][j] * sum;
+                dz += wij * dsum;
+            }
+        }
+    }
+
+    *value = value_sum;
+
+    if( derivs != NULL )
+    {
+        derivs[0] = dx;
+        derivs[1] = dy;
+        derivs[2] = dz;
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : evaluate_bspline_volume_in_world
+@INPUT      : coefficients   - created by create_bspline_coefficient_volume()
+              x
+              y
+              z
+              outside_value
+@OUTPUT     : value
+              deriv_x        - may be NULL, or all three non-NULL
+              deriv_y
+              deriv_z
+@RETURNS    :
+@DESCRIPTION: Takes a world space position and evaluates the cubic B-spline
+              there, passing back the world space gradient if requested.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : Oct. 19, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  evaluate_bspline_volume_in_world(
+    VIO_Volume   coefficients,
+    VIO_Real     x,
+    VIO_Real     y,
+    VIO_Real     z,
+    VIO_Real     outside_value,
+    VIO_Real     *value,
+    VIO_Real     *deriv_x,
+    VIO_Real     *deriv_y,
+    VIO_Real     *deriv_z )
+{
+    VIO_Real   voxel[VIO_MAX_DIMENSIONS], derivs[VIO_MAX_DIMENSIONS];
+
+    convert_world_to_voxel( coefficients, x, y, z, voxel );
+
+    if( deriv_x == NULL )
+    {
+        evaluate_bspline_volume( coefficients, voxel, outside_value,
+                                 value, NULL );
+        return;
+    }
+
+    evaluate_bspline_volume( coefficients, voxel, outside_value,
+                             value, derivs );
+
+    convert_voxel_normal_vector_to_world( coefficients, derivs,
+                                          deriv_x, deriv_y, deriv_z );
+}
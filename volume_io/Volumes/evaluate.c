@@ -1367,3 +1367,380 @@ VIOAPI  void   evaluate_volume_in_world(
         VIO_FREE3D( second_deriv );
     }
 }
+
+/* --- whether sample k of the line lies inside the box */
+
+static  VIO_BOOL  sample_in_box(
+    VIO_Real   origin[],
+    VIO_Real   step[],
+    VIO_Real   lower[],
+    VIO_Real   upper[],
+    int        k )
+{
+    int        c;
+    VIO_Real   pos;
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+    {
+        pos = origin[c] + (VIO_Real) k * step[c];
+        if( pos < lower[c] || pos >= upper[c] )
+            return( FALSE );
+    }
+
+    return( TRUE );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : clip_line_to_box
+@INPUT      : origin        - position of the first sample of the line
+              step          - change in position between samples
+              lower         - inclusive lower bound for each axis
+              upper         - exclusive upper bound for each axis
+              n_samples
+@OUTPUT     : first
+              last          - one past the last sample inside the box
+@RETURNS    : 
+@DESCRIPTION: Finds the range of samples origin + k * step, 0 <= k < n_samples,
+              which lie inside the box.  Since the intersection of a line with
+              a box is a single interval, the analytic estimate is refined by
+              testing the sample positions exactly as the caller computes
+              them, so no sample is misclassified by round-off.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  clip_line_to_box(
+    VIO_Real   origin[],
+    VIO_Real   step[],
+    VIO_Real   lower[],
+    VIO_Real   upper[],
+    int        n_samples,
+    int        *first,
+    int        *last )
+{
+    int        c;
+    VIO_Real   k_min, k_max, t_lower, t_upper;
+
+    k_min = 0.0;
+    k_max = (VIO_Real) n_samples;
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+    {
+        if( step[c] == 0.0 )
+        {
+            if( origin[c] < lower[c] || origin[c] >= upper[c] )
+                k_max = k_min;
+        }
+        else
+        {
+            t_lower = (lower[c] - origin[c]) / step[c];
+            t_upper = (upper[c] - origin[c]) / step[c];
+
+            if( step[c] > 0.0 )
+            {
+                k_min = MAX( k_min, ceil( t_lower ) );
+                k_max = MIN( k_max, ceil( t_upper ) );
+            }
+            else
+            {
+                k_min = MAX( k_min, floor( t_upper ) + 1.0 );
+                k_max = MIN( k_max, floor( t_lower ) + 1.0 );
+            }
+        }
+    }
+
+    if( k_max <= k_min )
+    {
+        *first = 0;
+        *last = 0;
+        return;
+    }
+
+    *first = (int) k_min;
+    *last = (int) k_max;
+
+    /*--- correct any round-off in the estimate of the interval */
+
+    while( *first < *last &&
+           !sample_in_box( origin, step, lower, upper, *first ) )
+        ++(*first);
+
+    while( *last > *first &&
+           !sample_in_box( origin, step, lower, upper, *last - 1 ) )
+        --(*last);
+
+    if( *first == *last )
+    {
+        *first = 0;
+        *last = 0;
+        return;
+    }
+
+    while( *first > 0 &&
+           sample_in_box( origin, step, lower, upper, *first - 1 ) )
+        --(*first);
+
+    while( *last < n_samples &&
+           sample_in_box( origin, step, lower, upper, *last ) )
+        ++(*last);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : resample_row_linear
+@INPUT      : src
+              dst
+              v0, v1              - the row of dst to fill
+              origin              - src voxel position of the first sample
+              step                - src voxel increment along the row
+              degrees_continuity
+              use_trilinear       - call trilinear_interpolate() directly
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Fills in one row of a 3D destination volume, where the source
+              positions of consecutive voxels differ by a constant step.
+              The row is clipped against the source volume up front, so
+              samples which cannot touch the source are set to zero without
+              being evaluated.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+static  void  resample_row_linear(
+    VIO_Volume   src,
+    VIO_Volume   dst,
+    int          v0,
+    int          v1,
+    VIO_Real     origin[],
+    VIO_Real     step[],
+    int          degrees_continuity,
+    VIO_BOOL     use_trilinear )
+{
+    int        c, k, n_samples, src_sizes[VIO_MAX_DIMENSIONS];
+    int        dst_sizes[VIO_MAX_DIMENSIONS];
+    int        first, last;
+    VIO_Real   bound, lower[VIO_N_DIMENSIONS], upper[VIO_N_DIMENSIONS];
+    VIO_Real   voxel[VIO_MAX_DIMENSIONS], value;
+
+    get_volume_sizes( src, src_sizes );
+    get_volume_sizes( dst, dst_sizes );
+    n_samples = dst_sizes[2];
+
+    /*--- find the samples whose interpolation footprint overlaps the
+          source, the same test evaluate_volume() uses for fully_outside */
+
+    bound = (VIO_Real) degrees_continuity / 2.0;
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+    {
+        lower[c] = bound - (VIO_Real) (degrees_continuity + 1);
+        upper[c] = (VIO_Real) src_sizes[c] + bound;
+    }
+
+    clip_line_to_box( origin, step, lower, upper, n_samples, &first, &last );
+
+    for_less( k, 0, first )
+        set_volume_real_value( dst, v0, v1, k, 0, 0, 0.0 );
+
+    for_less( k, first, last )
+    {
+        for_less( c, 0, VIO_N_DIMENSIONS )
+            voxel[c] = origin[c] + (VIO_Real) k * step[c];
+
+        if( use_trilinear )
+            trilinear_interpolate( src, voxel, 0.0, &value, NULL );
+        else
+            (void) evaluate_volume( src, voxel, NULL, degrees_continuity,
+                                    FALSE, 0.0, &value, NULL, NULL );
+
+        set_volume_real_value( dst, v0, v1, k, 0, 0, value );
+    }
+
+    for_less( k, last, n_samples )
+        set_volume_real_value( dst, v0, v1, k, 0, 0, 0.0 );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : resample_volume_linear
+@INPUT      : src
+              dst
+              transform           - maps src world space to dst world space,
+                                    or NULL for the identity
+              degrees_continuity  - -1 = nearest neighbour, 0 = linear,
+                                    1 = quadratic, 2 = cubic
+@OUTPUT     : 
+@RETURNS    : VIO_OK if successful
+@DESCRIPTION: Resamples the 3D volume src onto the sampling grid of the 3D
+              volume dst, using the inverse of transform to find the source
+              position of each destination voxel.  Destination voxels which
+              map outside the source are set to zero.
+              If the combined voxel-to-voxel mapping is linear, the source
+              positions are stepped along each destination row instead of
+              transforming every voxel, each row is clipped against the
+              source bounds before any voxel is evaluated, and rows are
+              processed in parallel when OpenMP is enabled and neither volume
+              is cached.  Other transforms fall back to transforming and
+              evaluating every voxel.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_Status  resample_volume_linear(
+    VIO_Volume              src,
+    VIO_Volume              dst,
+    VIO_General_transform   *transform,
+    int                     degrees_continuity )
+{
+    int                    c, d, row, n_rows, v0, v1, v2;
+    int                    dst_sizes[VIO_MAX_DIMENSIONS];
+    VIO_Real               voxel[VIO_MAX_DIMENSIONS], value;
+    VIO_Real               xyz[VIO_N_DIMENSIONS], src_xyz[VIO_N_DIMENSIONS];
+    VIO_Real               origin[VIO_MAX_DIMENSIONS];
+    VIO_Real               steps[VIO_N_DIMENSIONS][VIO_MAX_DIMENSIONS];
+    VIO_General_transform  inverse, dst_to_src_world, src_world_to_voxel;
+    VIO_General_transform  voxel_transform;
+    VIO_BOOL               use_trilinear;
+
+    if( get_volume_n_dimensions( src ) != 3 ||
+        get_volume_n_dimensions( dst ) != 3 )
+    {
+        print_error( "resample_volume_linear: volumes must be 3D.\n" );
+        return( VIO_ERROR );
+    }
+
+    for_less( c, 0, VIO_N_DIMENSIONS )
+    {
+        if( src->spatial_axes[c] < 0 || dst->spatial_axes[c] < 0 )
+        {
+            print_error(
+                "resample_volume_linear: volumes must have 3 spatial axes.\n" );
+            return( VIO_ERROR );
+        }
+    }
+
+    if( degrees_continuity < -1 || degrees_continuity > 2 )
+    {
+        print_error( "resample_volume_linear: degrees invalid: %d\n",
+                     degrees_continuity );
+        return( VIO_ERROR );
+    }
+
+    if( !volume_is_alloced( dst ) )
+        alloc_volume_data( dst );
+
+    /*--- build the mapping from dst voxel to src voxel coordinates */
+
+    if( transform != NULL )
+    {
+        create_inverse_general_transform( transform, &inverse );
+        concat_general_transforms( get_voxel_to_world_transform( dst ),
+                                   &inverse, &dst_to_src_world );
+        delete_general_transform( &inverse );
+    }
+    else
+        copy_general_transform( get_voxel_to_world_transform( dst ),
+                                &dst_to_src_world );
+
+    create_inverse_general_transform( get_voxel_to_world_transform( src ),
+                                      &src_world_to_voxel );
+    concat_general_transforms( &dst_to_src_world, &src_world_to_voxel,
+                               &voxel_transform );
+    delete_general_transform( &dst_to_src_world );
+    delete_general_transform( &src_world_to_voxel );
+
+    get_volume_sizes( dst, dst_sizes );
+
+    if( get_transform_type( &voxel_transform ) != LINEAR )
+    {
+        /*--- non-linear mappings must be evaluated point by point */
+
+        for_less( v0, 0, dst_sizes[0] )
+        for_less( v1, 0, dst_sizes[1] )
+        for_less( v2, 0, dst_sizes[2] )
+        {
+            voxel[0] = (VIO_Real) v0;
+            voxel[1] = (VIO_Real) v1;
+            voxel[2] = (VIO_Real) v2;
+
+            reorder_voxel_to_xyz( dst, voxel, xyz );
+            general_transform_point( &voxel_transform,
+                                     xyz[VIO_X], xyz[VIO_Y], xyz[VIO_Z],
+                                     &src_xyz[VIO_X], &src_xyz[VIO_Y],
+                                     &src_xyz[VIO_Z] );
+            reorder_xyz_to_voxel( src, src_xyz, voxel );
+
+            (void) evaluate_volume( src, voxel, NULL, degrees_continuity,
+                                    FALSE, 0.0, &value, NULL, NULL );
+
+            set_volume_real_value( dst, v0, v1, v2, 0, 0, value );
+        }
+
+        delete_general_transform( &voxel_transform );
+        return( VIO_OK );
+    }
+
+    /*--- find the src voxel position of dst voxel (0,0,0) and the change
+          in src voxel position for a unit step along each dst axis */
+
+    for_less( d, 0, VIO_N_DIMENSIONS )
+        voxel[d] = 0.0;
+
+    reorder_voxel_to_xyz( dst, voxel, xyz );
+    general_transform_point( &voxel_transform,
+                             xyz[VIO_X], xyz[VIO_Y], xyz[VIO_Z],
+                             &src_xyz[VIO_X], &src_xyz[VIO_Y], &src_xyz[VIO_Z] );
+    reorder_xyz_to_voxel( src, src_xyz, origin );
+
+    for_less( d, 0, VIO_N_DIMENSIONS )
+    {
+        for_less( c, 0, VIO_N_DIMENSIONS )
+            voxel[c] = (c == d) ? 1.0 : 0.0;
+
+        reorder_voxel_to_xyz( dst, voxel, xyz );
+        general_transform_point( &voxel_transform,
+                                 xyz[VIO_X], xyz[VIO_Y], xyz[VIO_Z],
+                                 &src_xyz[VIO_X], &src_xyz[VIO_Y],
+                                 &src_xyz[VIO_Z] );
+        reorder_xyz_to_voxel( src, src_xyz, steps[d] );
+
+        for_less( c, 0, VIO_N_DIMENSIONS )
+            steps[d][c] -= origin[c];
+    }
+
+    delete_general_transform( &voxel_transform );
+
+    /*--- evaluate_volume() sends trilinear requests straight to
+          trilinear_interpolate(), so rows may do the same */
+
+    use_trilinear = (degrees_continuity == 0 && !is_an_rgb_volume( src ));
+
+    n_rows = dst_sizes[0] * dst_sizes[1];
+
+#ifdef _OPENMP
+#pragma omp parallel for private(c,v0,v1) schedule(dynamic) if(!src->is_cached_volume && !dst->is_cached_volume)
+#endif
+    for( row = 0; row < n_rows; ++row )
+    {
+        VIO_Real  row_origin[VIO_N_DIMENSIONS];
+
+        v0 = row / dst_sizes[1];
+        v1 = row % dst_sizes[1];
+
+        for_less( c, 0, VIO_N_DIMENSIONS )
+            row_origin[c] = origin[c] + (VIO_Real) v0 * steps[0][c] +
+                                        (VIO_Real) v1 * steps[1][c];
+
+        resample_row_linear( src, dst, v0, v1, row_origin, steps[2],
+                             degrees_continuity, use_trilinear );
+    }
+
+    return( VIO_OK );
+}
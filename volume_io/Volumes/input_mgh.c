@@ -15,27 +15,12 @@
 #  include <arpa/inet.h> /* for ntohl and ntohs */
 #endif
 #include "znzlib.h"
+#include "read_ahead.h"
+#include "swap_convert.h"
 #include "errno.h"
 
 #define NUM_BYTE_VALUES      (UCHAR_MAX + 1)
 
-#define MGH_MAX_DIMS 4          /* Maximum number of dimensions */
-#define MGH_N_SPATIAL VIO_N_DIMENSIONS /* Number of spatial dimensions */
-#define MGH_N_COMPONENTS 4      /* Number of transform components. */
-#define MGH_N_XFORM (MGH_N_COMPONENTS * MGH_N_SPATIAL)
-
-#define MGH_HEADER_SIZE 284 /* Total number of bytes in the header. */
-
-#define MGH_EXTRA_SIZE 194   /* Number of "unused" bytes in the header. */
-
-#define MGH_TYPE_UCHAR 0  /**< Voxels are 1-byte unsigned integers. */
-#define MGH_TYPE_INT 1    /**< Voxels are 4-byte signed integers. */
-#define MGH_TYPE_LONG 2   /**< Unsupported here.  */
-#define MGH_TYPE_FLOAT 3  /**< Voxels are 4-byte floating point. */
-#define MGH_TYPE_SHORT 4  /**< Voxels are 2-byte signed integers. */
-#define MGH_TYPE_BITMAP 5 /**< Unsupported here. */
-#define MGH_TYPE_TENSOR 6 /**< Unsupported here. */
-
 /* MGH tag types, at least the ones that are minimally documented.
  */
 #define TAG_OLD_COLORTABLE          1
@@ -80,23 +65,22 @@ struct mgh_trailer {
 };
 
 /**
- * Trivial function to swap floats if necessary.
- * \param f The big-endian 4-byte float value.
- * \return The float value in host byte order.
+ * Converts a buffer of big-endian MGH data to host byte order, in place.
+ *
+ * \param in_ptr The volume input information.
+ * \param data_ptr The data.
+ * \param n_voxels The number of voxels in the buffer.
  */
-static float
-swapFloat(float f)
+static void
+mgh_data_to_host_order(const volume_input_struct *in_ptr,
+                       void *data_ptr,
+                       size_t n_voxels)
 {
-  union {
-    float f;
-    int i;
-  } sl;
-
-  sl.f = f;
-
-  sl.i = ntohl(sl.i);
-
-  return sl.f;
+  if (!minc_host_big_endian())
+  {
+    minc_swap_bytes(data_ptr, n_voxels,
+                    get_type_size(in_ptr->file_data_type));
+  }
 }
 
 /**
@@ -113,19 +97,20 @@ input_next_slice(
 {
   size_t n_voxels_in_slice;
   size_t n_bytes_per_voxel;
-  znzFile fp = (znzFile) in_ptr->volume_file;
+  read_ahead_file file = (read_ahead_file) in_ptr->volume_file;
 
   n_bytes_per_voxel = get_type_size(in_ptr->file_data_type);
   n_voxels_in_slice = (in_ptr->sizes_in_file[0] *
                        in_ptr->sizes_in_file[1]);
-  if (znzread(in_ptr->generic_slice_buffer,
-              n_bytes_per_voxel,
-              n_voxels_in_slice,
-              fp) != n_voxels_in_slice)
+  if (read_ahead_data(file, in_ptr->generic_slice_buffer,
+                      n_bytes_per_voxel * n_voxels_in_slice) !=
+      n_bytes_per_voxel * n_voxels_in_slice)
   {
     fprintf(stderr, "read error %d\n", errno);
     return VIO_ERROR;
   }
+  mgh_data_to_host_order(in_ptr, in_ptr->generic_slice_buffer,
+                         n_voxels_in_slice);
 
   return VIO_OK;
 }
@@ -291,13 +276,10 @@ mgh_header_from_file(znzFile fp, struct mgh_header *hdr_ptr)
 
   if (hdr_ptr->goodRASflag)
   {
-    for (i = 0; i < MGH_N_SPATIAL; i++)
+    if (!minc_host_big_endian())
     {
-      hdr_ptr->spacing[i] = swapFloat(hdr_ptr->spacing[i]);
-      for (j = 0; j < MGH_N_COMPONENTS; j++)
-      {
-        hdr_ptr->dircos[j][i] = swapFloat(hdr_ptr->dircos[j][i]);
-      }
+      minc_swap_bytes(hdr_ptr->spacing, MGH_N_SPATIAL, sizeof(float));
+      minc_swap_bytes(hdr_ptr->dircos, MGH_N_XFORM, sizeof(float));
     }
   }
   else
@@ -324,78 +306,60 @@ mgh_header_from_file(znzFile fp, struct mgh_header *hdr_ptr)
   return TRUE;
 }
 
-static VIO_BOOL
-mgh_scan_for_voxel_range(volume_input_struct *in_ptr, 
-                         long n_voxels_in_slice,
-                         float *min_value_ptr,
-                         float *max_value_ptr)
+/**
+ * Updates the voxel range with a buffer of MGH data, already in host
+ * byte order. The caller initializes the range.
+ *
+ * \param in_ptr The volume input information.
+ * \param data_ptr The data.
+ * \param n_voxels The number of voxels in the buffer.
+ * \param min_value_ptr A pointer to the minimum voxel value.
+ * \param max_value_ptr A pointer to the maximum voxel value.
+ */
+static void
+mgh_update_voxel_range(const volume_input_struct *in_ptr,
+                       const void *data_ptr,
+                       size_t n_voxels,
+                       float *min_value_ptr,
+                       float *max_value_ptr)
 {
-  znzFile fp = (znzFile) in_ptr->volume_file;
-  float min_value = FLT_MAX;
-  float max_value = -FLT_MAX;
-  int slice;
   float value = 0;
-  int i;
-  void *data_ptr;
-  long int data_offset = znztell((znzFile) fp);
-  int total_slices = in_ptr->sizes_in_file[2];
-
-  if (in_ptr->sizes_in_file[3] > 1)
-  {
-    /* If there is a time dimension, incorporate that into our slice
-     * count.
-     */
-    total_slices *= in_ptr->sizes_in_file[3];
-  }
+  size_t i;
 
-  if (data_offset < 0)
-    return FALSE;
-  
-  for (slice = 0; slice < total_slices; slice++)
+  for (i = 0; i < n_voxels; i++)
   {
-    input_next_slice( in_ptr );
-    data_ptr = in_ptr->generic_slice_buffer;
-    for (i = 0; i < n_voxels_in_slice; i++)
+    switch (in_ptr->file_data_type)
     {
-      switch (in_ptr->file_data_type)
-      {
-      case VIO_UNSIGNED_BYTE:
-        value = ((unsigned char *)data_ptr)[i];
-        break;
-  
-      case VIO_SIGNED_SHORT:
-        value = ntohs(((short *)data_ptr)[i]);
-        break;
-
-      case VIO_SIGNED_INT:
-        value = ntohl(((int *)data_ptr)[i]);
-        break;
-
-      case VIO_FLOAT:
-        value = swapFloat(((float *)data_ptr)[i]);
-        break;
-
-      case VIO_NO_DATA_TYPE:
-      case VIO_SIGNED_BYTE:
-      case VIO_UNSIGNED_SHORT:
-      case VIO_UNSIGNED_INT:
-      case VIO_DOUBLE:
-      case VIO_MAX_DATA_TYPE:
-        break;
-      }
-  
-      if (value < min_value )
-        min_value = value;
-      if (value > max_value )
-        max_value = value;
+    case VIO_UNSIGNED_BYTE:
+      value = ((const unsigned char *)data_ptr)[i];
+      break;
+
+    case VIO_SIGNED_SHORT:
+      value = ((const short *)data_ptr)[i];
+      break;
+
+    case VIO_SIGNED_INT:
+      value = ((const int *)data_ptr)[i];
+      break;
+
+    case VIO_FLOAT:
+      value = ((const float *)data_ptr)[i];
+      break;
+
+    case VIO_NO_DATA_TYPE:
+    case VIO_SIGNED_BYTE:
+    case VIO_UNSIGNED_SHORT:
+    case VIO_UNSIGNED_INT:
+    case VIO_DOUBLE:
+    case VIO_MAX_DATA_TYPE:
+      break;
     }
-  }
 
-  *min_value_ptr = min_value;
-  *max_value_ptr = max_value;
-  in_ptr->slice_index = 0;
-  znzseek((znzFile) fp, data_offset, SEEK_SET);
-  return TRUE;
+    if (value < *min_value_ptr)
+      *min_value_ptr = value;
+    if (value > *max_value_ptr)
+      *max_value_ptr = value;
+  }
 }
 
 VIOAPI  VIO_Status
@@ -408,6 +372,7 @@ initialize_mgh_format_input(VIO_STR             filename,
   int               n_bytes_per_voxel;
   nc_type           desired_nc_type;
   znzFile           fp;
+  read_ahead_file   file;
   int               axis;
   struct mgh_header hdr;
   VIO_General_transform mnc_native_xform;
@@ -431,6 +396,16 @@ initialize_mgh_format_input(VIO_STR             filename,
     return VIO_ERROR;
   }
 
+  /* Compressed data is inflated ahead of the reader, where possible.
+   */
+  file = open_read_ahead(fp, filename_extension_matches(filename, "mgz") ||
+                         string_ends_in(filename, ".gz"));
+  if (file == NULL)
+  {
+    znzclose(fp);
+    return VIO_ERROR;
+  }
+
   /* Translate from MGH to VIO types.
    */
   switch (hdr.type)
@@ -457,7 +432,7 @@ initialize_mgh_format_input(VIO_STR             filename,
     break;
   default:
     print_error("Unknown MGH data type.\n");
-    znzclose(fp);
+    close_read_ahead(file);
     return VIO_ERROR;
   }
 
@@ -585,29 +560,59 @@ initialize_mgh_format_input(VIO_STR             filename,
   in_ptr->min_value = DBL_MAX;
   in_ptr->max_value = -DBL_MAX;
 
-  /* Allocate the slice buffer. */
-
-  in_ptr->generic_slice_buffer = malloc(n_voxels_in_slice * n_bytes_per_voxel);
-  if (in_ptr->generic_slice_buffer == NULL)
-  {
-    return VIO_ERROR;
-  }
-
-  in_ptr->volume_file = (FILE *) fp;
+  in_ptr->volume_file = (FILE *) file;
 
   in_ptr->slice_index = 0;
 
-  /* If the data must be converted to byte, read the entire image file simply
-   * to find the max and min values. This allows us to set the value_scale and
-   * value_translation properly when we read the file.
+  /* If the data must be converted to byte, we need the max and min values
+   * before any voxel is stored, so that we can set the value_scale and
+   * value_translation properly. Read the entire image now and keep it,
+   * rather than reading (and for .mgz, decompressing) the file twice.
    */
   if (get_volume_data_type(volume) != in_ptr->file_data_type )
   {
-    float min_value, max_value;
+    float min_value = FLT_MAX, max_value = -FLT_MAX;
+    size_t n_voxels = n_voxels_in_slice * in_ptr->sizes_in_file[2];
+
+    if (in_ptr->sizes_in_file[3] > 1)
+    {
+      n_voxels *= in_ptr->sizes_in_file[3];
+    }
 
-    mgh_scan_for_voxel_range(in_ptr, n_voxels_in_slice, &min_value, &max_value);
+    in_ptr->generic_slice_buffer = malloc(n_voxels * n_bytes_per_voxel);
+    if (in_ptr->generic_slice_buffer == NULL)
+    {
+      close_read_ahead(file);
+      return VIO_ERROR;
+    }
+    if (read_ahead_data(file, in_ptr->generic_slice_buffer,
+                        n_bytes_per_voxel * n_voxels) !=
+        n_bytes_per_voxel * n_voxels)
+    {
+      print_error("Failed to read MGH image data.\n");
+      free(in_ptr->generic_slice_buffer);
+      in_ptr->generic_slice_buffer = NULL;
+      close_read_ahead(file);
+      return VIO_ERROR;
+    }
+    in_ptr->image_in_buffer = TRUE;
+
+    mgh_data_to_host_order(in_ptr, in_ptr->generic_slice_buffer, n_voxels);
+    mgh_update_voxel_range(in_ptr, in_ptr->generic_slice_buffer, n_voxels,
+                           &min_value, &max_value);
     set_volume_voxel_range(volume, min_value, max_value);
   }
+  else
+  {
+    /* Allocate the slice buffer. */
+    in_ptr->image_in_buffer = FALSE;
+    in_ptr->generic_slice_buffer = malloc(n_voxels_in_slice * n_bytes_per_voxel);
+    if (in_ptr->generic_slice_buffer == NULL)
+    {
+      close_read_ahead(file);
+      return VIO_ERROR;
+    }
+  }
   return VIO_OK;
 }
 
@@ -616,11 +621,11 @@ delete_mgh_format_input(
                         volume_input_struct   *in_ptr
                         )
 {
-  znzFile fp = (znzFile) in_ptr->volume_file;
+  read_ahead_file file = (read_ahead_file) in_ptr->volume_file;
 
   free( in_ptr->generic_slice_buffer );
 
-  znzclose( fp );
+  close_read_ahead( file );
 }
 
 VIOAPI  VIO_BOOL
@@ -639,6 +644,8 @@ input_more_mgh_format_file(
   void           *data_ptr;
   int            data_ind;
   int            total_slices = in_ptr->sizes_in_file[2];
+  size_t         n_voxels_in_slice = (in_ptr->sizes_in_file[0] *
+                                      in_ptr->sizes_in_file[1]);
 
   if (in_ptr->sizes_in_file[3] > 1)
   {
@@ -663,10 +670,21 @@ input_more_mgh_format_file(
       }
     }
 
-    status = input_next_slice( in_ptr );
-    if ( status != VIO_OK )
+    if (in_ptr->image_in_buffer)
     {
-        return FALSE;
+      status = VIO_OK;
+      data_ptr = ((char *) in_ptr->generic_slice_buffer +
+                  (size_t) in_ptr->slice_index * n_voxels_in_slice *
+                  get_type_size( in_ptr->file_data_type ));
+    }
+    else
+    {
+      status = input_next_slice( in_ptr );
+      if ( status != VIO_OK )
+      {
+          return FALSE;
+      }
+      data_ptr = in_ptr->generic_slice_buffer;
     }
 
     /* See if we need to apply scaling to this slice. This is only
@@ -706,7 +724,6 @@ input_more_mgh_format_file(
 
     if ( status == VIO_OK )
     {
-      data_ptr = in_ptr->generic_slice_buffer;
       data_ind = 0;
 
       for_less( i, 0, in_ptr->sizes_in_file[1] )
@@ -720,13 +737,13 @@ input_more_mgh_format_file(
             value = ((unsigned char *)data_ptr)[data_ind++];
             break;
           case VIO_SIGNED_SHORT:
-            value = ntohs(((short *)data_ptr)[data_ind++]);
+            value = ((short *)data_ptr)[data_ind++];
             break;
           case VIO_SIGNED_INT:
-            value = ntohl(((int *)data_ptr)[data_ind++]);
+            value = ((int *)data_ptr)[data_ind++];
             break;
           case VIO_FLOAT:
-            value = swapFloat(((float *)data_ptr)[data_ind++]);
+            value = ((float *)data_ptr)[data_ind++];
             break;
           default:
             handle_internal_error( "input_more_mgh_format_file" );
@@ -6,6 +6,25 @@
 #include <volume_io/basic.h>
 #include <volume_io/volume.h>
 
+/* Layout of the MGH file header, shared by the reader and the writer.
+ */
+#define MGH_MAX_DIMS 4          /* Maximum number of dimensions */
+#define MGH_N_SPATIAL VIO_N_DIMENSIONS /* Number of spatial dimensions */
+#define MGH_N_COMPONENTS 4      /* Number of transform components. */
+#define MGH_N_XFORM (MGH_N_COMPONENTS * MGH_N_SPATIAL)
+
+#define MGH_HEADER_SIZE 284 /* Total number of bytes in the header. */
+
+#define MGH_EXTRA_SIZE 194   /* Number of "unused" bytes in the header. */
+
+#define MGH_TYPE_UCHAR 0  /**< Voxels are 1-byte unsigned integers. */
+#define MGH_TYPE_INT 1    /**< Voxels are 4-byte signed integers. */
+#define MGH_TYPE_LONG 2   /**< Unsupported here.  */
+#define MGH_TYPE_FLOAT 3  /**< Voxels are 4-byte floating point. */
+#define MGH_TYPE_SHORT 4  /**< Voxels are 2-byte signed integers. */
+#define MGH_TYPE_BITMAP 5 /**< Unsupported here. */
+#define MGH_TYPE_TENSOR 6 /**< Unsupported here. */
+
 /**
  * Initializes loading a MGH format file by reading the header.
  * This function assumes that volume->filename has been assigned.
@@ -1377,6 +1377,7 @@ VIOAPI  void  set_default_minc_input_options(
     minc_input_options  *options )
 {
     static  int     default_rgba_indices[4] = { 0, 1, 2, 3 };
+    int             i;
     
     /*mostly for debugging*/
     options->prefer_minc2_api=miget_cfg_bool(MICFG_MINC_PREFER_V2_API);
@@ -1388,6 +1389,9 @@ VIOAPI  void  set_default_minc_input_options(
     set_minc_input_colour_max_dimension_size( options, 4 );
     set_minc_input_colour_indices( options, default_rgba_indices );
     set_minc_input_user_real_range(options, 0.0, 0.0);
+
+    for_less( i, 0, VIO_MAX_DIMENSIONS - VIO_N_DIMENSIONS )
+        set_minc_input_nonspatial_range( options, i, 0, 0 );
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -1579,3 +1583,41 @@ VIOAPI  void  set_minc_input_user_real_range(
     options->user_real_range[1] = maximum;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : set_minc_input_nonspatial_range
+@INPUT      : index - which non-spatial dimension of the file, 0 for the
+                      first one (usually time)
+              start
+              count - number of positions to read, or 0 for the rest
+@OUTPUT     : options
+@RETURNS    : 
+@DESCRIPTION: Selects the part of a non-spatial file dimension to read, such
+              as a range of frames of a time series.  The volume gets only
+              those positions, with its start moved to the first one.  Used
+              for the file formats read by volume_io itself (currently
+              NIfTI-1), which read only the selected part of the file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  set_minc_input_nonspatial_range(
+    minc_input_options  *options,
+    int                 index,
+    int                 start,
+    int                 count )
+{
+    if( index < 0 || index >= VIO_MAX_DIMENSIONS - VIO_N_DIMENSIONS ||
+        start < 0 || count < 0 )
+    {
+        print_error( "Warning: set_minc_input_nonspatial_range:\n" );
+        print_error( "         illegal range: %d %d %d\n", index, start, count );
+        return;
+    }
+
+    options->nonspatial_start[index] = start;
+    options->nonspatial_count[index] = count;
+}
+
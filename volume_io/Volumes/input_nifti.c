@@ -10,113 +10,168 @@
 
 #include "nifti1.h"
 #include "nifti1_io.h"
+#include "swap_convert.h"
+#include "read_ahead.h"
 
 #define NUM_BYTE_VALUES (UCHAR_MAX + 1)
 
 /**
- * Scan through the file to determine the range of the data.
+ * Update the range of the data with a buffer of voxels in file format.
+ * Invalid floating point values are set to zero, as nifti_read_buffer()
+ * would, so the buffer may be modified. The caller initializes the range.
  */
+#define NIFTI_RANGE_LOOP(type)                          \
+  for (j = 0; j < n_voxels; j++)                        \
+  {                                                     \
+    tmp = (double) ((const type *)data)[j];             \
+    if (tmp < min_value) min_value = tmp;               \
+    if (tmp > max_value) max_value = tmp;               \
+  }
 
-#define CHUNK_SIZE 10240
+#ifdef isfinite
+#define NIFTI_FIX_FLOAT_LOOP(type)                      \
+  for (j = 0; j < n_voxels; j++)                        \
+  {                                                     \
+    if (!isfinite(((type *)data)[j]))                   \
+      ((type *)data)[j] = 0;                            \
+  }
+#else
+#define NIFTI_FIX_FLOAT_LOOP(type)
+#endif
 
 static void
-nifti_find_data_range(nifti_image *nii_ptr,
-                      znzFile zfp,
-                      VIO_Real *min_value_ptr,
-                      VIO_Real *max_value_ptr)
+nifti_update_data_range(nifti_image *nii_ptr,
+                        void *data,
+                        size_t n_voxels,
+                        VIO_Real *min_value_ptr,
+                        VIO_Real *max_value_ptr)
 {
-  size_t i, j;
-  long int initial_offset = znztell(zfp);
-  double data[CHUNK_SIZE / sizeof(double)];
-  size_t n_voxels_per_chunk;
+  size_t j;
+  double tmp;
+  double min_value = *min_value_ptr;
+  double max_value = *max_value_ptr;
 
-  if (initial_offset < 0)       /* Did znztell() give an error? */
+  switch (nii_ptr->datatype)
   {
-    print_error("nifti_find_data_range: Tell failed.\n");
+  case DT_RGB24:
+    *min_value_ptr = 0;
+    *max_value_ptr = 0xffffffff;
+    return;
+  case DT_INT8:
+    NIFTI_RANGE_LOOP(signed char);
+    break;
+  case DT_UINT8:
+    NIFTI_RANGE_LOOP(unsigned char);
+    break;
+  case DT_INT16:
+    NIFTI_RANGE_LOOP(short);
+    break;
+  case DT_UINT16:
+    NIFTI_RANGE_LOOP(unsigned short);
+    break;
+  case DT_INT32:
+    NIFTI_RANGE_LOOP(int);
+    break;
+  case DT_UINT32:
+    NIFTI_RANGE_LOOP(unsigned int);
+    break;
+  case DT_FLOAT32:
+    NIFTI_FIX_FLOAT_LOOP(float);
+    NIFTI_RANGE_LOOP(float);
+    break;
+  case DT_FLOAT64:
+    NIFTI_FIX_FLOAT_LOOP(double);
+    NIFTI_RANGE_LOOP(double);
+    break;
+  default:
+    fprintf(stderr, "NIfTI-1 data type %d not handled\n",
+            nii_ptr->datatype);
     return;
   }
+  *min_value_ptr = min_value;
+  *max_value_ptr = max_value;
+}
 
-  *min_value_ptr = DBL_MAX;
-  *max_value_ptr = -DBL_MAX;
+/**
+ * Is the data scaled into the byte range as it is loaded?
+ */
+static VIO_BOOL
+nifti_scale_to_byte(VIO_Volume volume, const volume_input_struct *in_ptr)
+{
+  return (get_volume_data_type(volume) == VIO_UNSIGNED_BYTE &&
+          in_ptr->file_data_type != VIO_UNSIGNED_BYTE);
+}
 
-  n_voxels_per_chunk = CHUNK_SIZE / nii_ptr->nbyper;
+/**
+ * Set the voxel and real range of the volume from the range of the
+ * data in the file, using the NIfTI slope and intercept if appropriate.
+ */
+static void
+nifti_set_volume_range(VIO_Volume volume,
+                       volume_input_struct *in_ptr,
+                       nifti_image *nii_ptr,
+                       VIO_Real min_voxel,
+                       VIO_Real max_voxel)
+{
+  VIO_Real min_real, max_real;
 
-  if ( nii_ptr->datatype == DT_RGB24 )
+  if (nii_ptr->scl_slope > 0)
   {
-    *min_value_ptr = 0;
-    *max_value_ptr = 0xffffffff;
-    return;
+    min_real = (min_voxel * nii_ptr->scl_slope) + nii_ptr->scl_inter;
+    max_real = (max_voxel * nii_ptr->scl_slope) + nii_ptr->scl_inter;
+  }
+  else
+  {
+    min_real = min_voxel;
+    max_real = max_voxel;
   }
 
-  for (i = 0; i < nii_ptr->nvox; i += n_voxels_per_chunk)
+  /* As a special case, if we are converting the file to byte,
+   * we need to prepare to scale the voxels into the final range.
+   */
+  if (nifti_scale_to_byte(volume, in_ptr))
   {
-    double tmp = 0.0;
-    size_t n_bytes_to_read;
-    if (i + n_voxels_per_chunk > nii_ptr->nvox)
-    {
-      /* Final partial chunk. Adjust the counters to read only
-       * the bytes and voxels actually loaded.
-       */
-      n_voxels_per_chunk = nii_ptr->nvox - i;
-      n_bytes_to_read = n_voxels_per_chunk * nii_ptr->nbyper;
-    }
-    else
-    {
-      n_bytes_to_read = CHUNK_SIZE;
-    }
+    /* Set up the scaling for when we actually read the data.
+     */
+    in_ptr->min_value = min_voxel;
+    in_ptr->max_value = max_voxel;
 
-    if (nifti_read_buffer(zfp, data, n_bytes_to_read, nii_ptr) !=
-        n_bytes_to_read)
-    {
-      print_error("nifti_find_data_range: Read error.\n");
-      return;
-    }
+    min_voxel = 0;
+    max_voxel = UCHAR_MAX;
+  }
+
+  set_volume_voxel_range(volume, min_voxel, max_voxel);
+  set_volume_real_range(volume, min_real, max_real);
+}
 
-    for (j = 0; j < n_voxels_per_chunk; j++)
+/**
+ * Can the volume use the image data of the file as its own storage?
+ * The voxels must be stored with the same type, and the axes of the
+ * volume must be those of the file in reverse order, since the first
+ * file axis varies fastest while the last volume axis does.
+ */
+static VIO_BOOL
+nifti_volume_matches_file(VIO_Volume volume,
+                          const volume_input_struct *in_ptr,
+                          const nifti_image *nii_ptr)
+{
+  int axis;
+  int n_dimensions = get_volume_n_dimensions(volume);
+
+  if (nii_ptr->datatype == DT_RGB24 ||
+      get_volume_data_type(volume) != in_ptr->file_data_type ||
+      volume_is_alloced(volume))
+  {
+    return FALSE;
+  }
+  for_less( axis, 0, n_dimensions )
+  {
+    if (in_ptr->axis_index_from_file[axis] != n_dimensions - 1 - axis)
     {
-      switch (nii_ptr->datatype)
-      {
-      case DT_INT8:
-        tmp = (double) ((char *)data)[j];
-        break;
-      case DT_UINT8:
-        tmp = (double) ((unsigned char *)data)[j];
-        break;
-      case DT_INT16:
-        tmp = (double) ((short *)data)[j];
-        break;
-      case DT_UINT16:
-        tmp = (double) ((unsigned short *)data)[j];
-        break;
-      case DT_INT32:
-        tmp = (double) ((int *)data)[j];
-        break;
-      case DT_UINT32:
-        tmp = (double) ((unsigned int *)data)[j];
-        break;
-      case DT_FLOAT32:
-        tmp = (double) ((float *)data)[j];
-        break;
-      case DT_FLOAT64:
-        tmp = (double) ((double *)data)[j];
-        break;
-      default:
-        fprintf(stderr, "NIfTI-1 data type %d not handled\n",
-                nii_ptr->datatype);
-        return;
-      }
-      if (tmp < *min_value_ptr)
-      {
-        *min_value_ptr = tmp;
-      }
-      if (tmp > *max_value_ptr)
-      {
-        *max_value_ptr = tmp;
-      }
+      return FALSE;
     }
   }
-
-  znzseek(zfp, initial_offset, SEEK_SET);
+  return TRUE;
 }
 
 /**
@@ -269,7 +324,8 @@ nifti_image_to_minc_attributes(nifti_image *nii_ptr,
  * essentially copied the procedure here.
  */
 static int
-nifti_skip_header(znzFile zfp, nifti_image *nii_ptr)
+nifti_skip_header(read_ahead_file file, nifti_image *nii_ptr,
+                  size_t *offset_ptr)
 {
   size_t ioff;
   size_t volsize = nifti_get_volsize(nii_ptr); // total bytes to read.
@@ -288,13 +344,138 @@ nifti_skip_header(znzFile zfp, nifti_image *nii_ptr)
   {
     ioff = nii_ptr->iname_offset;
   }
-  znzseek(zfp, ioff, SEEK_SET);
+  *offset_ptr = ioff;
+  return read_ahead_seek(file, (long) ioff);
+}
+
+/**
+ * Returns the size of a file axis in the NIfTI-1 header, rather than of
+ * the part of it being read.
+ */
+static long
+nifti_file_axis_size(const nifti_image *nii_ptr, int axis)
+{
+  return (nii_ptr->dim[axis + 1] > 0) ? nii_ptr->dim[axis + 1] : 1;
+}
+
+/**
+ * Returns the number of slices of the part of the image being read that
+ * follow each other in the file. Runs of slices continue through each
+ * file axis which is read in full, and end at the first which is not.
+ */
+static int
+nifti_slices_per_run(const nifti_image *nii_ptr,
+                     const volume_input_struct *in_ptr,
+                     int n_dimensions)
+{
+  int slices_per_run = 1;
+  int axis;
+
+  for_less( axis, 2, n_dimensions )
+  {
+    slices_per_run *= in_ptr->sizes_in_file[axis];
+    if (in_ptr->sizes_in_file[axis] != nifti_file_axis_size(nii_ptr, axis))
+      break;
+  }
+  return slices_per_run;
+}
+
+/**
+ * Returns the offset in the file of a slice of the part of the image
+ * being read, with the slices numbered in the order they are loaded.
+ */
+static size_t
+nifti_slice_offset(const nifti_image *nii_ptr,
+                   const volume_input_struct *in_ptr,
+                   int n_dimensions,
+                   int slice_index)
+{
+  size_t file_slice = 0;
+  size_t stride = 1;
+  int axis;
+
+  for_less( axis, 2, n_dimensions )
+  {
+    file_slice += (in_ptr->starts_in_file[axis] +
+                   slice_index % in_ptr->sizes_in_file[axis]) * stride;
+    slice_index /= in_ptr->sizes_in_file[axis];
+    stride *= nifti_file_axis_size(nii_ptr, axis);
+  }
+  return ((size_t) nii_ptr->iname_offset +
+          file_slice * in_ptr->sizes_in_file[0] * in_ptr->sizes_in_file[1] *
+          nii_ptr->nbyper);
+}
+
+/**
+ * Read a buffer of voxels in file order, and swap them to the native
+ * byte order if needed.
+ */
+static VIO_Status
+nifti_read_buffer_native(read_ahead_file file,
+                         nifti_image *nii_ptr,
+                         void *data_ptr,
+                         size_t n_bytes)
+{
+  if (read_ahead_data(file, data_ptr, n_bytes) != n_bytes)
+  {
+    return VIO_ERROR;
+  }
+  if (nii_ptr->swapsize > 1 && nii_ptr->byteorder != nifti_short_order())
+  {
+    minc_swap_bytes(data_ptr, n_bytes / nii_ptr->swapsize,
+                    nii_ptr->swapsize);
+  }
+  return VIO_OK;
+}
+
+/**
+ * Read slices of the part of the image being read, seeking past the
+ * parts of the file which are not wanted. Seeks in a compressed file
+ * only decompress the data skipped, without converting it.
+ */
+static VIO_Status
+nifti_read_slices(read_ahead_file file,
+                  nifti_image *nii_ptr,
+                  const volume_input_struct *in_ptr,
+                  int n_dimensions,
+                  int first_slice,
+                  int n_slices,
+                  void *data_ptr)
+{
+  size_t n_bytes_per_slice = (in_ptr->sizes_in_file[0] *
+                              in_ptr->sizes_in_file[1] * nii_ptr->nbyper);
+  int slices_per_run = nifti_slices_per_run(nii_ptr, in_ptr, n_dimensions);
+  int slice = first_slice;
+
+  while (slice < first_slice + n_slices)
+  {
+    size_t offset = nifti_slice_offset(nii_ptr, in_ptr, n_dimensions, slice);
+    int n_run = slices_per_run - slice % slices_per_run;
+    size_t n_bytes;
+
+    if (n_run > first_slice + n_slices - slice)
+      n_run = first_slice + n_slices - slice;
+    n_bytes = n_run * n_bytes_per_slice;
+
+    if (read_ahead_tell(file) != (long) offset &&
+        read_ahead_seek(file, (long) offset) != VIO_OK)
+    {
+      return VIO_ERROR;
+    }
+    if (nifti_read_buffer_native(file, nii_ptr, data_ptr, n_bytes) != VIO_OK)
+    {
+      return VIO_ERROR;
+    }
+    data_ptr = (char *) data_ptr + n_bytes;
+    slice += n_run;
+  }
   return VIO_OK;
 }
 
 VIOAPI  VIO_Status
 initialize_nifti_format_input(VIO_STR             filename,
                               VIO_Volume          volume,
+                              minc_input_options  *options,
                               volume_input_struct *in_ptr)
 {
   int               sizes[VIO_MAX_DIMENSIONS];
@@ -309,10 +490,15 @@ initialize_nifti_format_input(VIO_STR             filename,
   VIO_Real          mnc_starts[VIO_MAX_DIMENSIONS];
   int               n_dimensions;
   znzFile           zfp;
+  read_ahead_file   file;
   nc_type           file_nc_type;
   VIO_BOOL          signed_flag;
   VIO_Real          min_voxel, max_voxel;
-  VIO_Real          min_real, max_real;
+  size_t            data_offset = 0;
+  size_t            n_bytes;
+  int               total_slices;
+  VIO_BOOL          native_order;
+  VIO_BOOL          use_file_storage;
 
   /* Read in the NIfTI file header and get a znzFile handle to the data.
    */
@@ -322,11 +508,27 @@ initialize_nifti_format_input(VIO_STR             filename,
     nifti_image_free(nii_ptr);
     return VIO_ERROR;
   }
-  else
+
+  /* Compressed data is inflated ahead of the reader, where possible.
+   */
+  file = open_read_ahead(zfp, nifti_is_gzfile(nii_ptr->iname));
+  if (file == NULL)
   {
-    nifti_skip_header(zfp, nii_ptr);
+    nifti_image_free(nii_ptr);
+    znzclose(zfp);
+    return VIO_ERROR;
+  }
+  else if (nifti_skip_header(file, nii_ptr, &data_offset) != VIO_OK)
+  {
+    nifti_image_free(nii_ptr);
+    close_read_ahead(file);
+    return VIO_ERROR;
   }
 
+  /* Keep the actual offset of the image data, for the slice offsets.
+   */
+  nii_ptr->iname_offset = data_offset;
+
   /* Translate from NIfTI to VIO types.
    */
   switch (nii_ptr->datatype)
@@ -379,7 +581,7 @@ initialize_nifti_format_input(VIO_STR             filename,
   default:
     print_error("Unknown NIfTI-1 data type.\n");
     nifti_image_free(nii_ptr);
-    znzclose(zfp);
+    close_read_ahead(file);
     return VIO_ERROR;
   }
 
@@ -401,9 +603,40 @@ initialize_nifti_format_input(VIO_STR             filename,
 
   for (axis = 0; axis < n_dimensions; axis++)
   {
-    in_ptr->sizes_in_file[axis] = nii_ptr->dim[axis + 1];
-    if (in_ptr->sizes_in_file[axis] <= 0)
-      in_ptr->sizes_in_file[axis] = 1;
+    in_ptr->sizes_in_file[axis] = nifti_file_axis_size(nii_ptr, axis);
+  }
+
+  /* Select the part of the non-spatial axes to read, such as a range
+   * of frames.
+   */
+  for_less( axis, 0, VIO_MAX_DIMENSIONS )
+  {
+    in_ptr->starts_in_file[axis] = 0;
+  }
+  for_less( axis, VIO_N_DIMENSIONS, n_dimensions )
+  {
+    long start = 0;
+    long count = 0;
+
+    if (options != NULL)
+    {
+      start = options->nonspatial_start[axis - VIO_N_DIMENSIONS];
+      count = options->nonspatial_count[axis - VIO_N_DIMENSIONS];
+    }
+    if (count == 0)
+    {
+      count = in_ptr->sizes_in_file[axis] - start;
+    }
+    if (count <= 0 || start + count > in_ptr->sizes_in_file[axis])
+    {
+      print_error("NIfTI-1 dimension %d has no positions %ld to %ld.\n",
+                  axis + 1, start, start + count - 1);
+      nifti_image_free(nii_ptr);
+      close_read_ahead(file);
+      return VIO_ERROR;
+    }
+    in_ptr->starts_in_file[axis] = start;
+    in_ptr->sizes_in_file[axis] = count;
   }
 
   /* Decide how to store data in memory. */
@@ -431,7 +664,7 @@ initialize_nifti_format_input(VIO_STR             filename,
   {
     print_error("Problem setting number of dimensions.\n");
     nifti_image_free(nii_ptr);
-    znzclose(zfp);
+    close_read_ahead(file);
     return VIO_ERROR;
   }
 
@@ -458,7 +691,8 @@ initialize_nifti_format_input(VIO_STR             filename,
     {
       sizes[axis] = in_ptr->sizes_in_file[axis];
       steps[axis] = mnc_steps[axis];
-      starts[axis] = mnc_starts[axis];
+      starts[axis] = (mnc_starts[axis] +
+                      in_ptr->starts_in_file[axis] * mnc_steps[axis]);
     }
   }
 
@@ -502,58 +736,115 @@ initialize_nifti_format_input(VIO_STR             filename,
 
   set_rgb_volume_flag( volume, nii_ptr->datatype == DT_RGB24 );
 
-  /* Determine the voxel range of NIfTI data. */
-  /* TODO: Is this really needed? Could we just assume the file uses
-   * the full available range of the datatype without any significant
-   * consequences?
-   */
-  nifti_find_data_range(nii_ptr, zfp, &min_voxel, &max_voxel);
+  in_ptr->min_value = DBL_MAX;
+  in_ptr->max_value = -DBL_MAX;
+  in_ptr->slice_index = 0;
+  in_ptr->image_mapping = NULL;
+  in_ptr->generic_slice_buffer = NULL;
+
+  total_slices = 1;
+  for_less( axis, 2, n_dimensions )
+    total_slices *= in_ptr->sizes_in_file[axis];
 
-  /* Calculate the real range of the data, using the NIfTI slope and
-   * scale, if appropriate.
+  n_bytes = (size_t) n_voxels_in_slice * total_slices * nii_ptr->nbyper;
+
+  native_order = (nii_ptr->swapsize <= 1 ||
+                  nii_ptr->byteorder == nifti_short_order());
+  use_file_storage = nifti_volume_matches_file(volume, in_ptr, nii_ptr);
+
+  /* Uncompressed data is used where it is, through a private mapping of
+   * the file, rather than read slice by slice. Data in the other byte
+   * order is only mapped if the volume can keep it, so it is swapped
+   * only once. Only data which is all in one place is mapped.
    */
-  if (nii_ptr->scl_slope > 0)
+  if ((native_order || use_file_storage) &&
+      !nifti_is_gzfile(nii_ptr->iname) &&
+      nifti_slices_per_run(nii_ptr, in_ptr, n_dimensions) == total_slices &&
+      map_file_data(nii_ptr->iname,
+                    nifti_slice_offset(nii_ptr, in_ptr, n_dimensions, 0),
+                    n_bytes,
+                    &in_ptr->generic_slice_buffer,
+                    &in_ptr->image_mapping) == VIO_OK)
   {
-    min_real = (min_voxel * nii_ptr->scl_slope) + nii_ptr->scl_inter;
-    max_real = (max_voxel * nii_ptr->scl_slope) + nii_ptr->scl_inter;
-  }
-  else
-  {
-    min_real = min_voxel;
-    max_real = max_voxel;
+    if (!native_order)
+    {
+      minc_swap_bytes(in_ptr->generic_slice_buffer,
+                      n_bytes / nii_ptr->swapsize, nii_ptr->swapsize);
+    }
+    in_ptr->image_in_buffer = TRUE;
+
+    min_voxel = DBL_MAX;
+    max_voxel = -DBL_MAX;
+    nifti_update_data_range(nii_ptr, in_ptr->generic_slice_buffer,
+                            n_bytes / nii_ptr->nbyper,
+                            &min_voxel, &max_voxel);
+    nifti_set_volume_range(volume, in_ptr, nii_ptr, min_voxel, max_voxel);
+
+    if (use_file_storage &&
+        set_volume_data_storage(volume, in_ptr->generic_slice_buffer,
+                                unmap_file_data, in_ptr->image_mapping))
+    {
+      /* The volume owns the mapping now, and there is nothing to load.
+       */
+      in_ptr->image_mapping = NULL;
+      in_ptr->generic_slice_buffer = NULL;
+      in_ptr->image_in_buffer = FALSE;
+      in_ptr->slice_index = total_slices;
+    }
   }
-
-  /* As a special case, if we are converting the file to byte,
-   * we need to prepare to scale the voxels into the final range.
-   */
-  if (get_volume_data_type(volume) == VIO_UNSIGNED_BYTE &&
-      in_ptr->file_data_type != VIO_UNSIGNED_BYTE)
+  else if (nifti_scale_to_byte(volume, in_ptr))
   {
-    /* Set up the scaling for when we actually read the data.
+    /* The range is needed before any voxel can be stored, so read the
+     * whole image now and keep it, rather than reading (and
+     * decompressing) the file twice.
      */
-    in_ptr->min_value = min_voxel;
-    in_ptr->max_value = max_voxel;
-
-    min_voxel = 0;
-    max_voxel = UCHAR_MAX;
+    in_ptr->generic_slice_buffer = malloc(n_bytes);
+    if (in_ptr->generic_slice_buffer == NULL)
+    {
+      nifti_image_free(nii_ptr);
+      close_read_ahead(file);
+      return VIO_ERROR;
+    }
+    if (nifti_read_slices(file, nii_ptr, in_ptr, n_dimensions, 0,
+                          total_slices, in_ptr->generic_slice_buffer) != VIO_OK)
+    {
+      print_error("Failed to read NIfTI-1 image data.\n");
+      free(in_ptr->generic_slice_buffer);
+      in_ptr->generic_slice_buffer = NULL;
+      nifti_image_free(nii_ptr);
+      close_read_ahead(file);
+      return VIO_ERROR;
+    }
+    in_ptr->image_in_buffer = TRUE;
+
+    min_voxel = DBL_MAX;
+    max_voxel = -DBL_MAX;
+    nifti_update_data_range(nii_ptr, in_ptr->generic_slice_buffer,
+                            n_bytes / nii_ptr->nbyper,
+                            &min_voxel, &max_voxel);
+    nifti_set_volume_range(volume, in_ptr, nii_ptr, min_voxel, max_voxel);
   }
   else
   {
-    in_ptr->min_value = 0.0;
-    in_ptr->max_value = 1.0;
-  }
+    /* The range is found while the slices are loaded, and is set
+     * after the last one. Until then use the full range of the type.
+     */
+    set_volume_voxel_range(volume, 0.0, 0.0);
+    get_volume_voxel_range(volume, &min_voxel, &max_voxel);
+    nifti_set_volume_range(volume, in_ptr, nii_ptr, min_voxel, max_voxel);
 
-  set_volume_voxel_range(volume, min_voxel, max_voxel);
-  set_volume_real_range(volume, min_real, max_real);
+    in_ptr->image_in_buffer = FALSE;
+    in_ptr->generic_slice_buffer = malloc(n_voxels_in_slice * nii_ptr->nbyper);
+    if (in_ptr->generic_slice_buffer == NULL)
+    {
+      nifti_image_free(nii_ptr);
+      close_read_ahead(file);
+      return VIO_ERROR;
+    }
+  }
 
-  in_ptr->slice_index = 0;
-  in_ptr->volume_file = (FILE *) zfp;
+  in_ptr->volume_file = (FILE *) file;
   in_ptr->header_info = nii_ptr;
-  in_ptr->generic_slice_buffer = malloc(n_voxels_in_slice * nii_ptr->nbyper);
-  if (in_ptr->generic_slice_buffer == NULL)
-  {
-    return VIO_ERROR;
-  }
   return VIO_OK;
 }
 
@@ -563,10 +854,13 @@ delete_nifti_format_input(
                           )
 {
   nifti_image *nii_ptr = (nifti_image *) in_ptr->header_info;
-  znzFile zfp = (znzFile) in_ptr->volume_file;
+  read_ahead_file file = (read_ahead_file) in_ptr->volume_file;
   nifti_image_free(nii_ptr);
-  znzclose(zfp);
-  free(in_ptr->generic_slice_buffer);
+  close_read_ahead(file);
+  if (in_ptr->image_mapping != NULL)
+    unmap_file_data(in_ptr->image_mapping);
+  else
+    free(in_ptr->generic_slice_buffer);
 }
 
 VIOAPI  VIO_BOOL
@@ -577,7 +871,7 @@ input_more_nifti_format_file(
                              )
 {
   nifti_image    *nii_ptr = (nifti_image *) in_ptr->header_info;
-  znzFile        zfp = (znzFile) in_ptr->volume_file;
+  read_ahead_file file = (read_ahead_file) in_ptr->volume_file;
   void           *data_ptr = in_ptr->generic_slice_buffer;
   int            data_ind = 0;
   double         value = 0;
@@ -586,7 +880,6 @@ input_more_nifti_format_file(
   int            i;
   int            total_slices;
   int            n_dimensions = get_volume_n_dimensions( volume );
-  int            vio_data_type = get_volume_data_type( volume );
 
   for_less(i, 0, VIO_MAX_DIMENSIONS)
     indices[i] = 0;
@@ -598,7 +891,6 @@ input_more_nifti_format_file(
   if ( in_ptr->slice_index < total_slices )
   {
     size_t     n_bytes_per_slice;
-    size_t     n_bytes_read;
     int        sizes[VIO_MAX_DIMENSIONS] = {1, 1, 1, 1, 1};
 
     sizes[in_ptr->axis_index_from_file[0]] = in_ptr->sizes_in_file[0];
@@ -620,18 +912,29 @@ input_more_nifti_format_file(
       if (!volume_is_alloced(volume))
       {
         print_error("Failed to allocate volume.\n");
+        free(temp_buffer);
         return FALSE;
       }
     }
 
-    n_bytes_read = nifti_read_buffer(zfp, data_ptr, n_bytes_per_slice, nii_ptr);
-    if (n_bytes_read < n_bytes_per_slice)
+    if (in_ptr->image_in_buffer)
     {
-      return FALSE;
+      data_ptr = (char *) data_ptr + in_ptr->slice_index * n_bytes_per_slice;
+    }
+    else
+    {
+      if (nifti_read_slices(file, nii_ptr, in_ptr, n_dimensions,
+                            in_ptr->slice_index, 1, data_ptr) != VIO_OK)
+      {
+        free(temp_buffer);
+        return FALSE;
+      }
+      nifti_update_data_range(nii_ptr, data_ptr,
+                              n_bytes_per_slice / nii_ptr->nbyper,
+                              &in_ptr->min_value, &in_ptr->max_value);
     }
 
-    if (vio_data_type == VIO_UNSIGNED_BYTE &&
-        in_ptr->file_data_type != VIO_UNSIGNED_BYTE)
+    if (nifti_scale_to_byte(volume, in_ptr))
     {
       value_offset = in_ptr->min_value;
       value_scale = (in_ptr->max_value - in_ptr->min_value) /
@@ -801,6 +1104,14 @@ input_more_nifti_format_file(
     in_ptr->slice_index++;      /* Advance to the next slice. */
 
     free(temp_buffer);
+
+    /* Now that all of the data has been seen, set the final range.
+     */
+    if (in_ptr->slice_index == total_slices && !in_ptr->image_in_buffer)
+    {
+      nifti_set_volume_range(volume, in_ptr, nii_ptr,
+                             in_ptr->min_value, in_ptr->max_value);
+    }
   }
 
   *fraction_done = (VIO_Real) in_ptr->slice_index / total_slices;
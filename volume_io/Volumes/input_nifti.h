@@ -12,12 +12,14 @@
  *
  * \param filename The filename to open for input.
  * \param volume The volume that will ultimately hold the input data.
+ * \param options The input options, for the frames to read.
  * \param in_ptr State information for the current input operation.
  * \return VIO_OK if successful.
  */
 VIOAPI  VIO_Status
 initialize_nifti_format_input(VIO_STR             filename,
                               VIO_Volume          volume,
+                              minc_input_options  *options,
                               volume_input_struct *in_ptr);
 
 
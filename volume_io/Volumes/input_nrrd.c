@@ -25,9 +25,15 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <stdint.h>             /* for int32_t, etc. */
-#include <zlib.h>
+
+#if defined(HAVE_PTHREAD_H) && !defined(NO_NRRD_PARALLEL_PARSE)
+#define NRRD_PARALLEL_PARSE 1
+#include <pthread.h>
+#endif
 
 #include "input_nrrd.h"
+#include "swap_convert.h"
+#include "read_ahead.h"
 
 #define NUM_BYTE_VALUES (UCHAR_MAX + 1)
 
@@ -36,6 +42,10 @@
 #define NRRD_MAX_PATH 2048
 #define NRRD_MAX_SPACE 3
 
+#define NRRD_TEXT_BUFFER_SIZE (4 << 20) /* ASCII data read at a time */
+#define NRRD_PARSE_MIN_SEGMENT (64 << 10) /* least text for a thread */
+#define NRRD_PARSE_MAX_THREADS 16
+
 typedef float float32_t;
 typedef double float64_t;
 
@@ -139,7 +149,15 @@ typedef struct nrrd_header {
   nrrd_centers_t centers[NRRD_MAX_DIMS];
 
   /* Stuff for reading/writing data */
-  gzFile gzfp;
+  read_ahead_file gz_file;       /* gzip data, inflated ahead of the reader */
+
+  /* Text of ASCII encoded data, read ahead of the values converted */
+  char *text_buffer;
+  size_t text_start;            /* first character not yet converted */
+  size_t text_end;              /* end of the text in the buffer */
+  VIO_BOOL text_eof;            /* no more text in the file */
+  size_t text_converted;        /* characters converted so far */
+  size_t items_converted;       /* values converted so far */
 } *nrrd_header_t;
 
 /**
@@ -741,6 +759,475 @@ nrrd_get_system_endian()
   return (v.c[1] == 2 && v.c[0] == 1) ? NRRD_ENDIAN_LITTLE : NRRD_ENDIAN_BIG;
 }
 
+/**
+ * Reverse the byte order of each element of a buffer of NRRD data.
+ * \param nrrd_ptr The internal representation of a NRRD header.
+ * \param data_ptr The data to swap, in place.
+ * \param n_bytes The size of the buffer.
+ */
+static void
+nrrd_swap_bytes(nrrd_header_t nrrd_ptr, unsigned char *data_ptr,
+                size_t n_bytes)
+{
+  size_t size = nrrd_type_to_size( nrrd_ptr->type );
+
+  if (size > 1)
+  {
+    minc_swap_bytes(data_ptr, n_bytes / size, size);
+  }
+}
+
+/**
+ * Convert one ASCII value to the NRRD type, exactly as fscanf() does
+ * with "%d" or "%u" for the integer types and "%f" or "%lf" for the
+ * floating point types. Decimal integers of up to nine digits, which
+ * cannot overflow, are converted here rather than by the C library.
+ * \param nrrd_type The NRRD type of the value.
+ * \param str_ptr The first character of the value.
+ * \param end_ptr Returns the character after the value.
+ * \param value_ptr Where the value is stored, if one is converted.
+ * \returns TRUE if a value was converted.
+ */
+static VIO_BOOL
+nrrd_scan_value(nrrd_type_t nrrd_type, const char *str_ptr, char **end_ptr,
+                void *value_ptr)
+{
+  const char *digit_ptr = str_ptr;
+  VIO_BOOL is_signed;
+  VIO_BOOL negative = FALSE;
+  unsigned long digits = 0;
+  int n_digits = 0;
+  long lvalue;
+  unsigned long ulvalue;
+  float32_t fvalue;
+  float64_t dvalue;
+
+  switch (nrrd_type)
+  {
+  case NRRD_TYPE_FLOAT32:
+    /* strtof() accepts the NAN and INF allowed by the NRRD specification.
+     */
+    fvalue = strtof(str_ptr, end_ptr);
+    if (*end_ptr == str_ptr)
+      return FALSE;
+    *(float32_t *) value_ptr = fvalue;
+    return TRUE;
+  case NRRD_TYPE_FLOAT64:
+    dvalue = strtod(str_ptr, end_ptr);
+    if (*end_ptr == str_ptr)
+      return FALSE;
+    *(float64_t *) value_ptr = dvalue;
+    return TRUE;
+  case NRRD_TYPE_INT8:
+  case NRRD_TYPE_INT16:
+  case NRRD_TYPE_INT32:
+    is_signed = TRUE;
+    break;
+  case NRRD_TYPE_UINT8:
+  case NRRD_TYPE_UINT16:
+  case NRRD_TYPE_UINT32:
+    is_signed = FALSE;
+    break;
+  default:
+    return FALSE;
+  }
+
+  if (*digit_ptr == '-' || *digit_ptr == '+')
+  {
+    negative = (*digit_ptr++ == '-');
+  }
+  while (n_digits < 10 && *digit_ptr >= '0' && *digit_ptr <= '9')
+  {
+    digits = digits * 10 + (*digit_ptr++ - '0');
+    n_digits++;
+  }
+
+  if (n_digits == 0)
+  {
+    return FALSE;
+  }
+  else if (n_digits < 10)
+  {
+    lvalue = negative ? -(long) digits : (long) digits;
+    ulvalue = (unsigned long) lvalue;
+    *end_ptr = (char *) digit_ptr;
+  }
+  else if (is_signed)
+  {
+    ulvalue = lvalue = strtol(str_ptr, end_ptr, 10);
+  }
+  else
+  {
+    lvalue = ulvalue = strtoul(str_ptr, end_ptr, 10);
+  }
+
+  /* fscanf() stores the value in an int or unsigned int first.
+   */
+  switch (nrrd_type)
+  {
+  case NRRD_TYPE_UINT8:
+    *(unsigned char *) value_ptr = (unsigned int) ulvalue;
+    break;
+  case NRRD_TYPE_INT8:
+    *(signed char *) value_ptr = (int) lvalue;
+    break;
+  case NRRD_TYPE_UINT16:
+    *(unsigned short *) value_ptr = (unsigned int) ulvalue;
+    break;
+  case NRRD_TYPE_INT16:
+    *(short *) value_ptr = (int) lvalue;
+    break;
+  case NRRD_TYPE_UINT32:
+    *(uint32_t *) value_ptr = (unsigned int) ulvalue;
+    break;
+  default:
+    *(int32_t *) value_ptr = (int) lvalue;
+    break;
+  }
+  return TRUE;
+}
+
+/**
+ * Convert up to 'n_items' ASCII values, separated by white space, from
+ * a block of text. The text must end in white space, or be followed by
+ * a NUL character.
+ * \param nrrd_type The NRRD type of the values.
+ * \param str_ptr The start of the text.
+ * \param end_ptr The end of the text.
+ * \param data_ptr Buffer where the values will be stored.
+ * \param n_items The number of values wanted.
+ * \param next_ptr Returns where the conversion stopped. This is before
+ * 'end_ptr' only if 'n_items' values were converted, or the text holds
+ * something other than a value.
+ * \returns The number of values converted.
+ */
+static size_t
+nrrd_parse_ascii(nrrd_type_t nrrd_type, const char *str_ptr,
+                 const char *end_ptr, unsigned char *data_ptr,
+                 size_t n_items, const char **next_ptr)
+{
+  size_t n_bytes_per_item = nrrd_type_to_size(nrrd_type);
+  size_t n_converted = 0;
+  char *value_end_ptr;
+
+  while (n_converted < n_items)
+  {
+    while (str_ptr < end_ptr && isspace((unsigned char) *str_ptr))
+    {
+      str_ptr++;
+    }
+    if (str_ptr == end_ptr ||
+        !nrrd_scan_value(nrrd_type, str_ptr, &value_end_ptr,
+                         data_ptr + n_converted * n_bytes_per_item))
+    {
+      break;
+    }
+    str_ptr = value_end_ptr;
+    n_converted++;
+  }
+  *next_ptr = str_ptr;
+  return n_converted;
+}
+
+#ifdef NRRD_PARALLEL_PARSE
+/**
+ * One segment of a block of ASCII text, converted by its own thread.
+ */
+typedef struct nrrd_parse_segment {
+  nrrd_type_t type;
+  const char *str_ptr;          /* start of the segment */
+  const char *end_ptr;          /* end of the segment */
+  unsigned char *data_ptr;      /* where the first value is stored */
+  size_t n_tokens;              /* number of words in the segment */
+  size_t n_items;               /* number of values wanted */
+  size_t n_converted;           /* number of values converted */
+  const char *next_ptr;         /* where the conversion stopped */
+} nrrd_parse_segment_t;
+
+static void *
+nrrd_count_tokens_thread(void *arg)
+{
+  nrrd_parse_segment_t *seg_ptr = arg;
+  const char *str_ptr;
+  VIO_BOOL in_space = TRUE;
+
+  seg_ptr->n_tokens = 0;
+  for (str_ptr = seg_ptr->str_ptr; str_ptr < seg_ptr->end_ptr; str_ptr++)
+  {
+    VIO_BOOL is_space = isspace((unsigned char) *str_ptr) != 0;
+    if (in_space && !is_space)
+    {
+      seg_ptr->n_tokens++;
+    }
+    in_space = is_space;
+  }
+  return NULL;
+}
+
+static void *
+nrrd_parse_thread(void *arg)
+{
+  nrrd_parse_segment_t *seg_ptr = arg;
+
+  seg_ptr->n_converted = nrrd_parse_ascii(seg_ptr->type, seg_ptr->str_ptr,
+                                          seg_ptr->end_ptr, seg_ptr->data_ptr,
+                                          seg_ptr->n_items,
+                                          &seg_ptr->next_ptr);
+  return NULL;
+}
+
+/**
+ * Run a function on each segment, each but the first in its own thread.
+ * \returns FALSE if a thread could not be started.
+ */
+static VIO_BOOL
+nrrd_run_segments(void *(*function)(void *), nrrd_parse_segment_t *segs,
+                  int n_segs)
+{
+  pthread_t threads[NRRD_PARSE_MAX_THREADS];
+  VIO_BOOL started[NRRD_PARSE_MAX_THREADS];
+  VIO_BOOL result = TRUE;
+  int i;
+
+  for (i = 1; i < n_segs; i++)
+  {
+    started[i] = pthread_create(&threads[i], NULL, function, &segs[i]) == 0;
+  }
+  function(&segs[0]);
+  for (i = 1; i < n_segs; i++)
+  {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+    else
+      result = FALSE;
+  }
+  return result;
+}
+
+/**
+ * Returns the number of threads to use to convert ASCII data, from the
+ * environment variable VOLUME_IO_NRRD_THREADS if it is set, or else the
+ * number of processors.
+ */
+static int
+nrrd_get_parse_threads(void)
+{
+  int n_threads = 1;
+  const char *str_ptr = getenv("VOLUME_IO_NRRD_THREADS");
+
+  if (str_ptr == NULL || sscanf(str_ptr, "%d", &n_threads) != 1)
+  {
+#ifdef _SC_NPROCESSORS_ONLN
+    n_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  }
+  if (n_threads > NRRD_PARSE_MAX_THREADS)
+    n_threads = NRRD_PARSE_MAX_THREADS;
+  return n_threads;
+}
+#endif /* NRRD_PARALLEL_PARSE */
+
+/**
+ * Convert up to 'n_items' ASCII values from a block of text, with the
+ * same result as nrrd_parse_ascii(). Large blocks are split at white
+ * space into segments which are converted in parallel. The words in
+ * each segment are counted first, to find where its values go.
+ */
+static size_t
+nrrd_parse_text(nrrd_type_t nrrd_type, const char *str_ptr,
+                const char *end_ptr, unsigned char *data_ptr,
+                size_t n_items, const char **next_ptr)
+{
+#ifdef NRRD_PARALLEL_PARSE
+  nrrd_parse_segment_t segs[NRRD_PARSE_MAX_THREADS];
+  size_t n_bytes_per_item = nrrd_type_to_size(nrrd_type);
+  size_t length = end_ptr - str_ptr;
+  size_t offset, n_converted;
+  int n_segs = nrrd_get_parse_threads();
+  int i;
+
+  if (n_segs > (int) (length / NRRD_PARSE_MIN_SEGMENT))
+    n_segs = (int) (length / NRRD_PARSE_MIN_SEGMENT);
+
+  if (n_segs > 1)
+  {
+    /* Each segment but the first starts with white space.
+     */
+    for (i = 0; i < n_segs; i++)
+    {
+      const char *seg_end_ptr = end_ptr;
+      if (i < n_segs - 1)
+      {
+        seg_end_ptr = str_ptr + length / n_segs * (i + 1);
+        while (seg_end_ptr < end_ptr && !isspace((unsigned char) *seg_end_ptr))
+          seg_end_ptr++;
+      }
+      segs[i].type = nrrd_type;
+      segs[i].str_ptr = (i == 0) ? str_ptr : segs[i - 1].end_ptr;
+      segs[i].end_ptr = seg_end_ptr;
+    }
+
+    if (nrrd_run_segments(nrrd_count_tokens_thread, segs, n_segs))
+    {
+      offset = 0;
+      for (i = 0; i < n_segs; i++)
+      {
+        segs[i].data_ptr = data_ptr + offset * n_bytes_per_item;
+        segs[i].n_items = 0;
+        if (offset < n_items)
+        {
+          segs[i].n_items = n_items - offset;
+          if (segs[i].n_items > segs[i].n_tokens)
+            segs[i].n_items = segs[i].n_tokens;
+        }
+        offset += segs[i].n_tokens;
+      }
+
+      if (nrrd_run_segments(nrrd_parse_thread, segs, n_segs))
+      {
+        /* Segments are used in order while each word was one value.
+         * Where that is not so, the rest of the text is converted
+         * here, as it would have been without the threads.
+         */
+        n_converted = 0;
+        *next_ptr = str_ptr;
+        for (i = 0; i < n_segs && n_converted < n_items; i++)
+        {
+          const char *ws_ptr = segs[i].next_ptr;
+
+          if (segs[i].n_tokens == 0)
+          {
+            *next_ptr = segs[i].end_ptr;
+            continue;
+          }
+          n_converted += segs[i].n_converted;
+          *next_ptr = segs[i].next_ptr;
+          if (segs[i].n_converted < segs[i].n_items)
+            break;
+
+          while (ws_ptr < segs[i].end_ptr && isspace((unsigned char) *ws_ptr))
+            ws_ptr++;
+          if (segs[i].n_items == segs[i].n_tokens && ws_ptr < segs[i].end_ptr)
+          {
+            n_converted += nrrd_parse_ascii(nrrd_type, *next_ptr, end_ptr,
+                                            data_ptr +
+                                            n_converted * n_bytes_per_item,
+                                            n_items - n_converted, next_ptr);
+            break;
+          }
+        }
+        return n_converted;
+      }
+    }
+  }
+#endif /* NRRD_PARALLEL_PARSE */
+
+  return nrrd_parse_ascii(nrrd_type, str_ptr, end_ptr, data_ptr, n_items,
+                          next_ptr);
+}
+
+/**
+ * Read up to 'n_items' ASCII encoded values from the NRRD file. The text
+ * is read in large blocks, kept between calls, and each block is
+ * converted at once.
+ * \param nrrd_ptr The internal representation of a NRRD header.
+ * \param data_ptr Buffer where the values will be stored.
+ * \param n_items The number of values requested.
+ * \param fp A file pointer, open for read, associated with the
+ * data of the NRRD.
+ * \returns The number of values read, or -1 on error.
+ */
+static long
+nrrd_read_ascii(nrrd_header_t nrrd_ptr, unsigned char *data_ptr,
+                size_t n_items, FILE *fp)
+{
+  size_t n_bytes_per_item = nrrd_type_to_size(nrrd_ptr->type);
+  size_t n_converted = 0;
+  size_t n_items_parsed;
+  size_t limit;
+  const char *next_ptr;
+  char *text;
+
+  if (nrrd_ptr->text_buffer == NULL)
+  {
+    nrrd_ptr->text_buffer = malloc(NRRD_TEXT_BUFFER_SIZE + 1);
+    if (nrrd_ptr->text_buffer == NULL)
+    {
+      return -1;
+    }
+    nrrd_ptr->text_start = nrrd_ptr->text_end = 0;
+    nrrd_ptr->text_buffer[0] = 0;
+  }
+  text = nrrd_ptr->text_buffer;
+
+  while (n_converted < n_items)
+  {
+    /* Top up the buffer once half of it has been converted, keeping
+     * the text not yet converted.
+     */
+    if (!nrrd_ptr->text_eof &&
+        nrrd_ptr->text_end - nrrd_ptr->text_start < NRRD_TEXT_BUFFER_SIZE / 2)
+    {
+      size_t n_kept = nrrd_ptr->text_end - nrrd_ptr->text_start;
+      size_t n_read;
+
+      memmove(text, text + nrrd_ptr->text_start, n_kept);
+      n_read = fread(text + n_kept, 1, NRRD_TEXT_BUFFER_SIZE - n_kept, fp);
+      nrrd_ptr->text_start = 0;
+      nrrd_ptr->text_end = n_kept + n_read;
+      nrrd_ptr->text_eof = (n_read < NRRD_TEXT_BUFFER_SIZE - n_kept);
+      text[nrrd_ptr->text_end] = 0;
+    }
+
+    /* Convert up to the last white space, as the last word may be cut
+     * short, unless there is no more text.
+     */
+    limit = nrrd_ptr->text_end;
+    if (!nrrd_ptr->text_eof)
+    {
+      while (limit > nrrd_ptr->text_start &&
+             !isspace((unsigned char) text[limit - 1]))
+        limit--;
+      if (limit == nrrd_ptr->text_start)
+        limit = nrrd_ptr->text_end;
+    }
+
+    /* Once the length of a value is known, give the parser little more
+     * text than the values wanted should need.
+     */
+    if (nrrd_ptr->items_converted > 0)
+    {
+      size_t wanted = nrrd_ptr->text_start + 64 +
+        (size_t) ((double) nrrd_ptr->text_converted /
+                  nrrd_ptr->items_converted * 1.125 *
+                  (n_items - n_converted));
+      if (wanted < limit)
+      {
+        while (wanted < limit && !isspace((unsigned char) text[wanted - 1]))
+          wanted++;
+        limit = wanted;
+      }
+    }
+
+    n_items_parsed = nrrd_parse_text(nrrd_ptr->type,
+                                     text + nrrd_ptr->text_start,
+                                     text + limit,
+                                     data_ptr + n_converted * n_bytes_per_item,
+                                     n_items - n_converted, &next_ptr);
+    n_converted += n_items_parsed;
+    nrrd_ptr->items_converted += n_items_parsed;
+    nrrd_ptr->text_converted += (next_ptr - text) - nrrd_ptr->text_start;
+    nrrd_ptr->text_start = next_ptr - text;
+
+    if (nrrd_ptr->text_start < limit ||
+        (nrrd_ptr->text_eof && nrrd_ptr->text_start == nrrd_ptr->text_end))
+    {
+      break;                    /* not a value, or the end of the file */
+    }
+  }
+  return (long) n_converted;
+}
+
 /**
  * Read up to 'n_bytes' bytes of data from the NRRD file. Handles
  * differences in encodings and endianness.
@@ -757,14 +1244,7 @@ nrrd_read_buffer(nrrd_header_t nrrd_ptr, unsigned char *data_ptr,
                  int n_bytes, FILE *fp)
 {
   int n_bytes_read = 0;         /* our return value */
-  int n_bytes_per_item;
-  int n_items;
-  int i;
-  double dvalue;
-  float fvalue;
-  int ivalue;
-  unsigned int uvalue;
-  int n_converted;
+  long n_items;
 
   switch (nrrd_ptr->encoding)
   {
@@ -773,74 +1253,37 @@ nrrd_read_buffer(nrrd_header_t nrrd_ptr, unsigned char *data_ptr,
     break;
 
   case NRRD_ENCODING_ASCII:
-    /* This is crufty and slow, but then we don't expect to see any
-     * large images with ASCII encoding, do we??
-     */
-    n_bytes_per_item = nrrd_type_to_size(nrrd_ptr->type);
-    n_items = n_bytes / n_bytes_per_item;
-    n_converted = 1;
-    for (i = 0; i < n_items && n_converted > 0; i++)
+    n_items = nrrd_read_ascii(nrrd_ptr, data_ptr,
+                              n_bytes / nrrd_type_to_size(nrrd_ptr->type), fp);
+    if (n_items < 0)
     {
-      switch (nrrd_ptr->type)
-      {
-      case NRRD_TYPE_UINT8:
-        if ((n_converted = fscanf(fp, "%u", &uvalue)) == 1)
-          ((unsigned char *) data_ptr)[i] = uvalue;
-        break;
-      case NRRD_TYPE_INT8:
-        if ((n_converted = fscanf(fp, "%d", &ivalue)) == 1)
-          ((signed char *) data_ptr)[i] = ivalue;
-        break;
-      case NRRD_TYPE_UINT16:
-        if ((n_converted = fscanf(fp, "%u", &uvalue)) == 1)
-          ((unsigned short *) data_ptr)[i] = uvalue;
-        break;
-      case NRRD_TYPE_INT16:
-        if ((n_converted = fscanf(fp, "%d", &ivalue)) == 1)
-          ((short *) data_ptr)[i] = ivalue;
-        break;
-      case NRRD_TYPE_UINT32:
-        if ((n_converted = fscanf(fp, "%u", &uvalue)) == 1)
-          ((uint32_t *) data_ptr)[i] = uvalue;
-        break;
-      case NRRD_TYPE_INT32:
-        if ((n_converted = fscanf(fp, "%d", &ivalue)) == 1)
-          ((int32_t *) data_ptr)[i] = ivalue;
-        break;
-      case NRRD_TYPE_FLOAT32:
-        /* According to the NRRD specification, the values NAN and INF
-         * are permitted for floating-point values. I've checked that 
-         * at least the current version of fscanf() seems to handle
-         * them correctly.
-         */
-        if ((n_converted = fscanf(fp, "%f", &fvalue)) == 1)
-          ((float32_t *)data_ptr)[i] = fvalue;
-        break;
-      case NRRD_TYPE_FLOAT64:
-        if ((n_converted = fscanf(fp, "%lf", &dvalue)) == 1)
-          ((float64_t *)data_ptr)[i] = dvalue;
-        break;
-      default:
-        break;
-      }
-      if (n_converted > 0)
-        n_bytes_read += n_bytes_per_item * n_converted;
+      return -1;
     }
+    n_bytes_read = n_items * nrrd_type_to_size(nrrd_ptr->type);
     break;
 
   case NRRD_ENCODING_GZIP:
-    if (nrrd_ptr->gzfp == NULL)
+    if (nrrd_ptr->gz_file == NULL)
     {
       int fd = dup(fileno(fp));
       off_t off = ftell(fp);
+      znzFile zfp;
+
       lseek(fd, off, SEEK_SET);
-      nrrd_ptr->gzfp = gzdopen(fd, "r");
-      if (nrrd_ptr->gzfp == Z_NULL)
+      zfp = znzdopen(fd, "rb", 1);
+      if (znz_isnull(zfp))
       {
+        close(fd);
+        return -1;
+      }
+      nrrd_ptr->gz_file = open_read_ahead(zfp, TRUE);
+      if (nrrd_ptr->gz_file == NULL)
+      {
+        znzclose(zfp);
         return -1;
       }
     }
-    n_bytes_read = gzread(nrrd_ptr->gzfp, data_ptr, n_bytes);
+    n_bytes_read = read_ahead_data(nrrd_ptr->gz_file, data_ptr, n_bytes);
     break;
 
   default:
@@ -851,139 +1294,148 @@ nrrd_read_buffer(nrrd_header_t nrrd_ptr, unsigned char *data_ptr,
 
   /* We've read all of the data, now see if we have to swap bytes.
    */
-  if ( nrrd_ptr->endian != nrrd_get_system_endian() )
+  if ( nrrd_ptr->endian != nrrd_get_system_endian() && n_bytes_read > 0 )
   {
-    int i;
-    unsigned char temp;
-
-    switch (nrrd_type_to_size( nrrd_ptr->type ))
-    {
-    case 1:
-      /* Nothing to do. */
-      break;
-
-    case 2:
-      for (i = 0; i < (int) n_bytes_read; i += 2)
-      {
-        temp = data_ptr[i + 0];
-        data_ptr[i + 0] = data_ptr[i + 1];
-        data_ptr[i + 1] = temp;
-      }
-      break;
-
-    case 4:
-      for (i = 0; i < (int) n_bytes_read; i += 4)
-      {
-        temp = data_ptr[i + 0];
-        data_ptr[i + 0] = data_ptr[i + 3];
-        data_ptr[i + 3] = temp;
-        temp = data_ptr[i + 1];
-        data_ptr[i + 1] = data_ptr[i + 2];
-        data_ptr[i + 2] = temp;
-      }
-      break;
-
-    case 8:
-      for (i = 0; i < (int) n_bytes_read; i += 8)
-      {
-        temp = data_ptr[i + 0];
-        data_ptr[i + 0] = data_ptr[i + 7];
-        data_ptr[i + 7] = temp;
-        temp = data_ptr[i + 1];
-        data_ptr[i + 1] = data_ptr[i + 6];
-        data_ptr[i + 6] = temp;
-        temp = data_ptr[i + 2];
-        data_ptr[i + 2] = data_ptr[i + 5];
-        data_ptr[i + 5] = temp;
-        temp = data_ptr[i + 3];
-        data_ptr[i + 3] = data_ptr[i + 4];
-        data_ptr[i + 4] = temp;
-      }
-      break;
-
-    default:
-      print_error("ERROR: Can't byte swap elements of type '%s'.\n",
-                  nrrd_type_to_str(nrrd_ptr->type));
-      break;
-    }
+    nrrd_swap_bytes(nrrd_ptr, data_ptr, n_bytes_read);
   }
   return n_bytes_read;
 }
 
 /**
- * Scan through the NRRD data and determine the minimum and maximul voxel
- * values. 
+ * Update the minimum and maximum voxel values with a buffer of NRRD
+ * data. The caller initializes the range.
  * \param nrrd_ptr The internal representation of the NRRD header.
- * \param fp A file pointer referencing the open data stream.
- * \param min_voxel A pointer to receive the minimum voxel value.
- * \param max_voxel A pointer to receive the maximum voxel value.
+ * \param buffer The data, already converted to native byte order.
+ * \param n_items The number of voxels in the buffer.
+ * \param min_voxel A pointer to the minimum voxel value.
+ * \param max_voxel A pointer to the maximum voxel value.
  */
+#define NRRD_RANGE_LOOP(type)                           \
+  for (i = 0; i < n_items; i++)                         \
+  {                                                     \
+    tmp = ((const type *)buffer)[i];                    \
+    if (tmp < min_value) min_value = tmp;               \
+    if (tmp > max_value) max_value = tmp;               \
+  }
+
 static void
-nrrd_find_data_range(nrrd_header_t nrrd_ptr, FILE *fp,
-                     VIO_Real *min_voxel,
-                     VIO_Real *max_voxel)
+nrrd_update_data_range(nrrd_header_t nrrd_ptr, const void *buffer,
+                       size_t n_items,
+                       VIO_Real *min_voxel,
+                       VIO_Real *max_voxel)
 {
-  unsigned char buffer[4096];
-  off_t pos = ftell(fp);
-  int i;
-  int n_bytes;
+  size_t i;
   VIO_Real tmp;
+  VIO_Real min_value = *min_voxel;
+  VIO_Real max_value = *max_voxel;
 
-  *min_voxel = DBL_MAX;
-  *max_voxel = -DBL_MAX;
-
-  while ((n_bytes = nrrd_read_buffer(nrrd_ptr, buffer, sizeof(buffer), fp)) > 0)
+  switch (nrrd_ptr->type)
   {
-    int n_items = n_bytes / nrrd_type_to_size(nrrd_ptr->type);
+  case NRRD_TYPE_INT8:
+    NRRD_RANGE_LOOP(int8_t);
+    break;
+  case NRRD_TYPE_UINT8:
+    NRRD_RANGE_LOOP(uint8_t);
+    break;
+  case NRRD_TYPE_INT16:
+    NRRD_RANGE_LOOP(int16_t);
+    break;
+  case NRRD_TYPE_UINT16:
+    NRRD_RANGE_LOOP(uint16_t);
+    break;
+  case NRRD_TYPE_INT32:
+    NRRD_RANGE_LOOP(int32_t);
+    break;
+  case NRRD_TYPE_UINT32:
+    NRRD_RANGE_LOOP(uint32_t);
+    break;
+  case NRRD_TYPE_INT64:
+    NRRD_RANGE_LOOP(int64_t);
+    break;
+  case NRRD_TYPE_UINT64:
+    NRRD_RANGE_LOOP(uint64_t);
+    break;
+  case NRRD_TYPE_FLOAT32:
+    NRRD_RANGE_LOOP(float32_t);
+    break;
+  case NRRD_TYPE_FLOAT64:
+    NRRD_RANGE_LOOP(float64_t);
+    break;
+  default:
+    print_error("Unsupported NRRD type %d\n", nrrd_ptr->type);
+    return;
+  }
+  *min_voxel = min_value;
+  *max_voxel = max_value;
+}
 
-    for (i = 0; i < n_items; i++)
+/**
+ * Can the volume use the image data of the file as its own storage?
+ * The voxels must be stored with the same type, and the axes of the
+ * volume must be those of the file in reverse order, since the first
+ * file axis varies fastest while the last volume axis does.
+ */
+static VIO_BOOL
+nrrd_volume_matches_file(VIO_Volume volume,
+                         const volume_input_struct *in_ptr)
+{
+  int axis;
+  int n_dimensions = get_volume_n_dimensions(volume);
+
+  if (get_volume_data_type(volume) != in_ptr->file_data_type ||
+      volume_is_alloced(volume))
+  {
+    return FALSE;
+  }
+  for_less( axis, 0, n_dimensions )
+  {
+    if (in_ptr->axis_index_from_file[axis] != n_dimensions - 1 - axis)
     {
-      switch (nrrd_ptr->type)
-      {
-      case NRRD_TYPE_INT8:
-        tmp = ((int8_t *)buffer)[i];
-        break;
-      case NRRD_TYPE_UINT8:
-        tmp = ((uint8_t *)buffer)[i];
-        break;
-      case NRRD_TYPE_INT16:
-        tmp = ((int16_t *)buffer)[i];
-        break;
-      case NRRD_TYPE_UINT16:
-        tmp = ((uint16_t *)buffer)[i];
-        break;
-      case NRRD_TYPE_INT32:
-        tmp = ((int32_t *)buffer)[i];
-        break;
-      case NRRD_TYPE_UINT32:
-        tmp = ((uint32_t *)buffer)[i];
-        break;
-      case NRRD_TYPE_FLOAT32:
-        tmp = ((float32_t *)buffer)[i];
-        break;
-      case NRRD_TYPE_FLOAT64:
-        tmp = ((float64_t *)buffer)[i];
-        break;
-      default:
-        print_error("Unsupported NRRD type %d\n", nrrd_ptr->type);
-        break;
-      }
-      if (tmp < *min_voxel)
-      {
-        *min_voxel = tmp;
-      }
-      if (tmp > *max_voxel)
-      {
-        *max_voxel = tmp;
-      }
+      return FALSE;
     }
   }
-  if (nrrd_ptr->encoding == NRRD_ENCODING_GZIP)
+  return TRUE;
+}
+
+/**
+ * Is the data scaled into the byte range as it is loaded?
+ */
+static VIO_BOOL
+nrrd_scale_to_byte(VIO_Volume volume, const volume_input_struct *in_ptr)
+{
+  return (get_volume_data_type(volume) == VIO_UNSIGNED_BYTE &&
+          in_ptr->file_data_type != VIO_UNSIGNED_BYTE);
+}
+
+/**
+ * Set the voxel and real range of the volume from the range of the
+ * data in the file.
+ */
+static void
+nrrd_set_volume_range(VIO_Volume volume,
+                      volume_input_struct *in_ptr,
+                      VIO_Real min_voxel,
+                      VIO_Real max_voxel)
+{
+  VIO_Real min_real = min_voxel;
+  VIO_Real max_real = max_voxel;
+
+  /* As a special case, if we are converting the file to byte,
+   * we need to prepare to scale the voxels into the final range.
+   */
+  if (nrrd_scale_to_byte(volume, in_ptr))
   {
-    gzclose(nrrd_ptr->gzfp);
-    nrrd_ptr->gzfp = NULL;
+    /* Set up the scaling for when we actually read the data.
+     */
+    in_ptr->min_value = min_voxel;
+    in_ptr->max_value = max_voxel;
+
+    min_voxel = 0;
+    max_voxel = UCHAR_MAX;
   }
-  fseek(fp, pos, SEEK_SET);
+
+  set_volume_voxel_range(volume, min_voxel, max_voxel);
+  set_volume_real_range(volume, min_real, max_real);
 }
 
 /**
@@ -1552,9 +2004,13 @@ initialize_nrrd_format_input(VIO_STR             filename,
   nc_type           file_nc_type;
   VIO_BOOL          signed_flag;
   VIO_Real          min_voxel, max_voxel;
-  VIO_Real          min_real, max_real;
   FILE              *fp;
   int               spatial_axes[VIO_MAX_DIMENSIONS];
+  char              pathname[NRRD_MAX_PATH];
+  long              data_offset;
+  size_t            n_bytes;
+  VIO_BOOL          native_order;
+  VIO_BOOL          use_file_storage;
 
   if ((fp = fopen(filename, "rb")) == NULL)
   {
@@ -1574,9 +2030,10 @@ initialize_nrrd_format_input(VIO_STR             filename,
     print_error("ERROR reading header.\n");
     return VIO_ERROR;
   }
+  strncpy(pathname, filename, NRRD_MAX_PATH - 1);
+  pathname[NRRD_MAX_PATH - 1] = 0;
   if (nrrd_ptr->data_file[0] != 0)
   {
-    char pathname[NRRD_MAX_PATH];
     /* Load the external data file if present.
      * If the data file field value does NOT start with a '/', we
      * prepend the path of the header file (from 'filename').
@@ -1596,6 +2053,10 @@ initialize_nrrd_format_input(VIO_STR             filename,
         strcpy(pathname, nrrd_ptr->data_file);
       }
     }
+    else
+    {
+      strcpy(pathname, nrrd_ptr->data_file);
+    }
     fclose(fp);
     fp = fopen(pathname, "rb");
     if (fp == NULL)
@@ -1767,43 +2228,100 @@ initialize_nrrd_format_input(VIO_STR             filename,
     n_voxels_in_slice *= in_ptr->sizes_in_file[axis];
   }
 
-  nrrd_find_data_range(nrrd_ptr, fp, &min_voxel, &max_voxel);
+  in_ptr->slice_index = 0;
+  in_ptr->volume_file = (FILE *) fp;
+  in_ptr->header_info = nrrd_ptr;
+  in_ptr->min_value = DBL_MAX;
+  in_ptr->max_value = -DBL_MAX;
+  in_ptr->image_mapping = NULL;
+  in_ptr->generic_slice_buffer = NULL;
+
+  n_bytes = (size_t) n_voxels_in_slice * nrrd_type_to_size(nrrd_ptr->type) *
+    in_ptr->sizes_in_file[n_dimensions - 1];
 
-  min_real = min_voxel;
-  max_real = max_voxel;
+  native_order = (nrrd_ptr->endian == nrrd_get_system_endian());
+  use_file_storage = nrrd_volume_matches_file(volume, in_ptr);
+  data_offset = ftell(fp);
 
-  /* As a special case, if we are converting the file to byte,
-   * we need to prepare to scale the voxels into the final range.
+  /* Raw data is used where it is, through a private mapping of the
+   * file, rather than read slice by slice. Data in the other byte order
+   * is only mapped if the volume can keep it, so it is swapped only once.
    */
-  if (get_volume_data_type(volume) == VIO_UNSIGNED_BYTE &&
-      in_ptr->file_data_type != VIO_UNSIGNED_BYTE)
+  if ((native_order || use_file_storage) &&
+      nrrd_ptr->encoding == NRRD_ENCODING_RAW && data_offset >= 0 &&
+      map_file_data(pathname, (size_t) data_offset, n_bytes,
+                    &in_ptr->generic_slice_buffer,
+                    &in_ptr->image_mapping) == VIO_OK)
   {
-    /* Set up the scaling for when we actually read the data.
+    if (!native_order)
+    {
+      nrrd_swap_bytes(nrrd_ptr, in_ptr->generic_slice_buffer, n_bytes);
+    }
+    in_ptr->image_in_buffer = TRUE;
+
+    min_voxel = DBL_MAX;
+    max_voxel = -DBL_MAX;
+    nrrd_update_data_range(nrrd_ptr, in_ptr->generic_slice_buffer,
+                           n_bytes / nrrd_type_to_size(nrrd_ptr->type),
+                           &min_voxel, &max_voxel);
+    nrrd_set_volume_range(volume, in_ptr, min_voxel, max_voxel);
+
+    if (use_file_storage &&
+        set_volume_data_storage(volume, in_ptr->generic_slice_buffer,
+                                unmap_file_data, in_ptr->image_mapping))
+    {
+      /* The volume owns the mapping now, and there is nothing to load.
+       */
+      in_ptr->image_mapping = NULL;
+      in_ptr->generic_slice_buffer = NULL;
+      in_ptr->image_in_buffer = FALSE;
+      in_ptr->slice_index = in_ptr->sizes_in_file[n_dimensions - 1];
+    }
+  }
+  else if (nrrd_scale_to_byte(volume, in_ptr))
+  {
+    /* The range is needed before any voxel can be stored, so read the
+     * whole image now and keep it, rather than reading (and
+     * decompressing) the file twice.
      */
-    in_ptr->min_value = min_voxel;
-    in_ptr->max_value = max_voxel;
+    in_ptr->generic_slice_buffer = malloc(n_bytes);
+    if (in_ptr->generic_slice_buffer == NULL)
+    {
+      print_error("ERROR allocating image buffer.\n");
+      return VIO_ERROR;
+    }
+    if (nrrd_read_buffer(nrrd_ptr, in_ptr->generic_slice_buffer, n_bytes,
+                         fp) < (int) n_bytes)
+    {
+      print_error("ERROR reading NRRD image data.\n");
+      return VIO_ERROR;
+    }
+    in_ptr->image_in_buffer = TRUE;
 
-    min_voxel = 0;
-    max_voxel = UCHAR_MAX;
+    min_voxel = DBL_MAX;
+    max_voxel = -DBL_MAX;
+    nrrd_update_data_range(nrrd_ptr, in_ptr->generic_slice_buffer,
+                           n_bytes / nrrd_type_to_size(nrrd_ptr->type),
+                           &min_voxel, &max_voxel);
+    nrrd_set_volume_range(volume, in_ptr, min_voxel, max_voxel);
   }
   else
   {
-    in_ptr->min_value = 0.0;
-    in_ptr->max_value = 1.0;
-  }
-
-  set_volume_voxel_range(volume, min_voxel, max_voxel);
-  set_volume_real_range(volume, min_real, max_real);
-
-  in_ptr->slice_index = 0;
-  in_ptr->volume_file = (FILE *) fp;
-  in_ptr->header_info = nrrd_ptr;
-  in_ptr->generic_slice_buffer = malloc(n_voxels_in_slice *
-                                        nrrd_type_to_size(nrrd_ptr->type));
-  if (in_ptr->generic_slice_buffer == NULL)
-  {
-    print_error("ERROR allocating slice buffer.\n");
-    return VIO_ERROR;
+    /* The range is found while the slices are loaded, and is set
+     * after the last one. Until then use the full range of the type.
+     */
+    set_volume_voxel_range(volume, 0.0, 0.0);
+    get_volume_voxel_range(volume, &min_voxel, &max_voxel);
+    nrrd_set_volume_range(volume, in_ptr, min_voxel, max_voxel);
+
+    in_ptr->image_in_buffer = FALSE;
+    in_ptr->generic_slice_buffer = malloc(n_voxels_in_slice *
+                                          nrrd_type_to_size(nrrd_ptr->type));
+    if (in_ptr->generic_slice_buffer == NULL)
+    {
+      print_error("ERROR allocating slice buffer.\n");
+      return VIO_ERROR;
+    }
   }
   return VIO_OK;
 }
@@ -1815,12 +2333,13 @@ delete_nrrd_format_input(volume_input_struct   *in_ptr)
   FILE *fp = (FILE *) in_ptr->volume_file;
   int i;
 
-  if (nrrd_ptr->encoding == NRRD_ENCODING_GZIP)
+  if (nrrd_ptr->gz_file != NULL)
   {
-    gzclose(nrrd_ptr->gzfp);
-    nrrd_ptr->gzfp = NULL;
+    close_read_ahead(nrrd_ptr->gz_file);
+    nrrd_ptr->gz_file = NULL;
   }
   fclose(fp);
+  free(nrrd_ptr->text_buffer);
   for (i = 0; i < nrrd_ptr->dimension; i++)
   {
     if (nrrd_ptr->labels[i] != NULL)
@@ -1829,7 +2348,10 @@ delete_nrrd_format_input(volume_input_struct   *in_ptr)
     }
   }
   free(nrrd_ptr);
-  free(in_ptr->generic_slice_buffer);
+  if (in_ptr->image_mapping != NULL)
+    unmap_file_data(in_ptr->image_mapping);
+  else
+    free(in_ptr->generic_slice_buffer);
 }
 
 VIOAPI VIO_BOOL
@@ -1847,7 +2369,6 @@ input_more_nrrd_format_file(VIO_Volume          volume,
   int            i, j;
   int            total_slices;
   int            n_dimensions = get_volume_n_dimensions( volume );
-  int            vio_data_type = get_volume_data_type( volume );
   int            *inner_index;
   int            j_max;
 
@@ -1880,15 +2401,24 @@ input_more_nrrd_format_file(VIO_Volume          volume,
       }
     }
 
-    n_bytes_read = nrrd_read_buffer(nrrd_ptr, data_ptr, n_bytes_per_slice, fp);
-    if (n_bytes_read < n_bytes_per_slice)
+    if (in_ptr->image_in_buffer)
     {
-      print_error("Failed to read buffer (%d/%d).\n", n_bytes_read, n_bytes_per_slice);
-      return FALSE;
+      data_ptr = (char *) data_ptr + (size_t) in_ptr->slice_index * n_bytes_per_slice;
+    }
+    else
+    {
+      n_bytes_read = nrrd_read_buffer(nrrd_ptr, data_ptr, n_bytes_per_slice, fp);
+      if (n_bytes_read < n_bytes_per_slice)
+      {
+        print_error("Failed to read buffer (%d/%d).\n", n_bytes_read, n_bytes_per_slice);
+        return FALSE;
+      }
+      nrrd_update_data_range(nrrd_ptr, data_ptr,
+                             n_bytes_per_slice / nrrd_type_to_size(nrrd_ptr->type),
+                             &in_ptr->min_value, &in_ptr->max_value);
     }
 
-    if (vio_data_type == VIO_UNSIGNED_BYTE &&
-        in_ptr->file_data_type != VIO_UNSIGNED_BYTE)
+    if (nrrd_scale_to_byte(volume, in_ptr))
     {
       value_offset = in_ptr->min_value;
       value_scale = (in_ptr->max_value - in_ptr->min_value) /
@@ -1965,6 +2495,14 @@ input_more_nrrd_format_file(VIO_Volume          volume,
       }
     }
     in_ptr->slice_index++;      /* Advance to the next slice. */
+
+    /* Now that all of the data has been seen, set the final range.
+     */
+    if (in_ptr->slice_index == total_slices && !in_ptr->image_in_buffer)
+    {
+      nrrd_set_volume_range(volume, in_ptr,
+                            in_ptr->min_value, in_ptr->max_value);
+    }
   }
 
   *fraction_done = (VIO_Real) in_ptr->slice_index / total_slices;
@@ -230,7 +230,8 @@ VIOAPI  VIO_Status  start_volume_input(
         break;
       case NII_FORMAT:
         status = initialize_nifti_format_input( expanded_filename,
-                                                *volume, input_info );
+                                                *volume, options,
+                                                input_info );
         break;
       case NRRD_FORMAT:
         status = initialize_nrrd_format_input( expanded_filename,
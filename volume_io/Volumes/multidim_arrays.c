@@ -371,6 +371,114 @@ VIOAPI  void  alloc_multidim_array(
     }
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : set_multidim_storage
+@INPUT      : array
+              storage
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Uses the contiguous voxels in storage as the data of the array,
+              instead of allocating them.  Only the row pointers are
+              allocated, and the array must be deleted with
+              delete_multidim_storage() rather than delete_multidim_array().
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  set_multidim_storage(
+    VIO_multidim_array   *array,
+    void                 *storage )
+{
+    int     dim;
+    size_t  type_size, sizes[5], n_rows, row_size, row;
+    void    **rows = NULL, ***p3, ****p4, *****p5;
+
+    for_less( dim, 0, array->n_dimensions )
+        sizes[dim] = (size_t) array->sizes[dim];
+
+    type_size = (size_t) get_type_size( array->data_type );
+
+    /* the row pointers are laid out like those of alloc_multidim_array(),
+       pointing into storage instead of a block of their own */
+
+    switch( array->n_dimensions )
+    {
+    case  1:
+        array->data = storage;
+        return;
+    case  2:
+        ASSIGN_PTR(rows) = alloc_memory_1d( sizes[0], sizeof(void *)
+                                            _ALLOC_SOURCE_LINE );
+        array->data = (void *) rows;
+        break;
+    case  3:
+        ASSIGN_PTR(p3) = alloc_memory_2d( sizes[0], sizes[1], sizeof(void *)
+                                          _ALLOC_SOURCE_LINE );
+        rows = p3[0];
+        array->data = (void *) p3;
+        break;
+    case  4:
+        ASSIGN_PTR(p4) = alloc_memory_3d( sizes[0], sizes[1], sizes[2],
+                                          sizeof(void *) _ALLOC_SOURCE_LINE );
+        rows = p4[0][0];
+        array->data = (void *) p4;
+        break;
+    case  5:
+        ASSIGN_PTR(p5) = alloc_memory_4d( sizes[0], sizes[1], sizes[2],
+                                          sizes[3], sizeof(void *)
+                                          _ALLOC_SOURCE_LINE );
+        rows = p5[0][0][0];
+        array->data = (void *) p5;
+        break;
+    }
+
+    n_rows = 1;
+    for_less( dim, 0, array->n_dimensions - 1 )
+        n_rows *= sizes[dim];
+    row_size = sizes[array->n_dimensions-1] * type_size;
+
+    for_less( row, 0, n_rows )
+        rows[row] = (char *) storage + row * row_size;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : delete_multidim_storage
+@INPUT      : array
+@OUTPUT     : 
+@RETURNS    : 
+@DESCRIPTION: Deletes the row pointers of an array set up with
+              set_multidim_storage(), leaving the voxels alone.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  void  delete_multidim_storage(
+    VIO_multidim_array   *array )
+{
+    if( array->data == NULL )
+        return;
+
+    switch( array->n_dimensions )
+    {
+    case  2:  free_memory_1d( (void **) &array->data _ALLOC_SOURCE_LINE );
+              break;
+    case  3:  free_memory_2d( (void ***) &array->data _ALLOC_SOURCE_LINE );
+              break;
+    case  4:  free_memory_3d( (void ****) &array->data _ALLOC_SOURCE_LINE );
+              break;
+    case  5:  free_memory_4d( (void *****) &array->data _ALLOC_SOURCE_LINE );
+              break;
+    }
+
+    array->data = NULL;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : create_multidim_array
 @INPUT      : array
@@ -0,0 +1,53 @@
+/**
+ * \file Layout helpers shared by the writers for formats that store x, y
+ * and z as the first file axes, defined in output_volume.c.
+ */
+
+#ifndef OUTPUT_FILE_H
+#define OUTPUT_FILE_H
+
+#include <internal_volume_io.h>
+#include <volume_io/basic.h>
+#include <volume_io/volume.h>
+
+/**
+ * Lays out the volume with x, y and z as the first three file axes, x
+ * varying fastest, followed by any other dimensions of the volume.
+ *
+ * \param volume The volume to write.
+ * \param max_file_dims The most file axes the format can hold.
+ * \param volume_axis_from_file Returns the volume axis of each file axis,
+ * or -1 for a spatial axis missing from the volume.
+ * \param file_sizes Returns the size of each file axis.
+ * \return The number of file axes, or -1 if there are too many.
+ */
+int  get_output_file_axes(
+    VIO_Volume   volume,
+    int          max_file_dims,
+    int          volume_axis_from_file[],
+    int          file_sizes[] );
+
+/**
+ * Gets the voxel to world transform of the file axes laid out by
+ * get_output_file_axes(), as a 3 by 4 matrix.
+ */
+void  get_output_file_transform(
+    VIO_Volume   volume,
+    int          volume_axis_from_file[],
+    VIO_Real     transform[VIO_N_DIMENSIONS][4] );
+
+/**
+ * Gets one x-y slice of the file axes laid out by get_output_file_axes(),
+ * in file order, as voxel values times scale plus translation.
+ */
+void  get_output_file_slice(
+    VIO_Volume   volume,
+    int          n_file_dims,
+    int          volume_axis_from_file[],
+    int          file_sizes[],
+    int          slice,
+    VIO_Real     scale,
+    VIO_Real     translation,
+    VIO_Real     values[] );
+
+#endif /* OUTPUT_FILE_H */
@@ -0,0 +1,253 @@
+/**
+ * \file Writer for MGH/MGZ (FreeSurfer) format files.
+ *
+ * The volume is written a slice at a time, converted to the file type
+ * and big-endian byte order in a single pass as each slice is written.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include "output_mgh.h"
+#include "output_file.h"
+#include "input_mgh.h"
+
+#include "znzlib.h"
+#include "swap_convert.h"
+#include <errno.h>
+
+/**
+ * Chooses the MGH type able to hold a netCDF type.
+ *
+ * \param nc_data_type The netCDF type.
+ * \param signed_flag TRUE if the type is signed.
+ * \param value_type_ptr Returns the matching swap_convert type.
+ * \return One of the MGH_TYPE_xxx values.
+ */
+static int
+mgh_type_from_nc(nc_type nc_data_type, VIO_BOOL signed_flag,
+                 minc_value_type *value_type_ptr)
+{
+  switch (nc_data_type)
+  {
+  case NC_BYTE:
+    if (!signed_flag)
+    {
+      *value_type_ptr = MINC_VALUE_UBYTE;
+      return MGH_TYPE_UCHAR;
+    }
+    *value_type_ptr = MINC_VALUE_SHORT;
+    return MGH_TYPE_SHORT;
+  case NC_SHORT:
+    if (signed_flag)
+    {
+      *value_type_ptr = MINC_VALUE_SHORT;
+      return MGH_TYPE_SHORT;
+    }
+    *value_type_ptr = MINC_VALUE_INT;
+    return MGH_TYPE_INT;
+  case NC_INT:
+    *value_type_ptr = MINC_VALUE_INT;
+    return MGH_TYPE_INT;
+  default:
+    *value_type_ptr = MINC_VALUE_FLOAT;
+    return MGH_TYPE_FLOAT;
+  }
+}
+
+/**
+ * Stores big-endian values in the header buffer.
+ *
+ * \param buffer_ptr The position in the header, advanced past the values.
+ * \param data The values.
+ * \param n The number of values.
+ * \param size The size of each value.
+ */
+static void
+mgh_put_header(unsigned char **buffer_ptr, const void *data, size_t n,
+               size_t size)
+{
+  memcpy(*buffer_ptr, data, n * size);
+  if (!minc_host_big_endian())
+  {
+    minc_swap_bytes(*buffer_ptr, n, size);
+  }
+  *buffer_ptr += n * size;
+}
+
+/**
+ * Fills in an MGH header from the layout and transform of the file.
+ *
+ * \param header The MGH_HEADER_SIZE bytes of the header.
+ * \param file_sizes The sizes of the file axes.
+ * \param n_file_dims The number of file axes.
+ * \param mgh_type The MGH_TYPE_xxx of the voxels.
+ * \param transform The voxel to world transform of the file.
+ */
+static void
+mgh_header_from_transform(unsigned char header[],
+                          const int file_sizes[], int n_file_dims,
+                          int mgh_type, VIO_Real transform[][4])
+{
+  int   ints[2 + MGH_MAX_DIMS];
+  short good_ras_flag = 1;
+  float spacing[MGH_N_SPATIAL];
+  float dircos[MGH_N_COMPONENTS][MGH_N_SPATIAL];
+  int   i, j;
+
+  memset(header, 0, MGH_HEADER_SIZE);
+
+  ints[0] = 1;                  /* version */
+  for (i = 0; i < MGH_MAX_DIMS; i++)
+  {
+    ints[1 + i] = (i < n_file_dims) ? file_sizes[i] : 1;
+  }
+  ints[1 + MGH_MAX_DIMS] = mgh_type;
+
+  /* The columns of the transform are the spacing times the direction
+   * cosines of each axis, and c_ras is the world position of the
+   * centre voxel.
+   */
+  for (j = 0; j < MGH_N_SPATIAL; j++)
+  {
+    double length = 0.0;
+    for (i = 0; i < MGH_N_SPATIAL; i++)
+    {
+      length += transform[i][j] * transform[i][j];
+    }
+    length = sqrt(length);
+    spacing[j] = (float) length;
+    for (i = 0; i < MGH_N_SPATIAL; i++)
+    {
+      dircos[j][i] = (float) (length > 0.0 ? transform[i][j] / length :
+                              (i == j));
+    }
+  }
+  for (i = 0; i < MGH_N_SPATIAL; i++)
+  {
+    double centre = transform[i][3];
+    for (j = 0; j < MGH_N_SPATIAL; j++)
+    {
+      centre += transform[i][j] * (ints[1 + j] / 2.0);
+    }
+    dircos[MGH_N_COMPONENTS - 1][i] = (float) centre;
+  }
+
+  mgh_put_header(&header, ints, 2 + MGH_MAX_DIMS, sizeof(int));
+  header += sizeof(int);        /* dof */
+  mgh_put_header(&header, &good_ras_flag, 1, sizeof(short));
+  mgh_put_header(&header, spacing, MGH_N_SPATIAL, sizeof(float));
+  mgh_put_header(&header, dircos, MGH_N_XFORM, sizeof(float));
+}
+
+VIOAPI  VIO_Status
+output_mgh_format_volume(VIO_STR    filename,
+                         nc_type    file_nc_data_type,
+                         VIO_BOOL   file_signed_flag,
+                         VIO_Volume volume)
+{
+  int               volume_axis_from_file[VIO_MAX_DIMENSIONS];
+  int               file_sizes[VIO_MAX_DIMENSIONS];
+  int               n_file_dims, mgh_type, axis, slice, n_slices, flags;
+  minc_value_type   value_type;
+  VIO_Real          transform[VIO_N_DIMENSIONS][4];
+  VIO_Real          scale, translation;
+  VIO_Real          *values;
+  void              *data;
+  size_t            n_voxels_in_slice, n_bytes_per_voxel;
+  unsigned char     header[MGH_HEADER_SIZE];
+  znzFile           fp;
+  VIO_Status        status = VIO_OK;
+
+  n_file_dims = get_output_file_axes(volume, MGH_MAX_DIMS,
+                                     volume_axis_from_file, file_sizes);
+  if (n_file_dims < 0)
+  {
+    print_error("Too many dimensions for an MGH file.\n");
+    return VIO_ERROR;
+  }
+
+  /* MGH files hold real values.
+   */
+  translation = convert_voxel_to_value(volume, 0.0);
+  scale = convert_voxel_to_value(volume, 1.0) - translation;
+
+  /* The voxels of a scaled volume are not its real values, so keep
+   * those in floating point unless another type was asked for.
+   */
+  if (file_nc_data_type == MI_ORIGINAL_TYPE)
+  {
+    file_nc_data_type = get_volume_nc_data_type(volume, &file_signed_flag);
+    if (scale != 1.0 || translation != 0.0)
+    {
+      file_nc_data_type = NC_FLOAT;
+    }
+  }
+  mgh_type = mgh_type_from_nc(file_nc_data_type, file_signed_flag,
+                              &value_type);
+
+  get_output_file_transform(volume, volume_axis_from_file, transform);
+  mgh_header_from_transform(header, file_sizes, n_file_dims, mgh_type,
+                            transform);
+
+  if ((fp = znzopen(filename, "wb",
+                    filename_extension_matches(filename, "mgz") ||
+                    string_ends_in(filename, ".gz"))) == NULL)
+  {
+    print_error("Unable to create file %s, errno %d.\n", filename, errno);
+    return VIO_ERROR;
+  }
+
+  if (znzwrite(header, 1, MGH_HEADER_SIZE, fp) != MGH_HEADER_SIZE)
+  {
+    print_error("Failed to write MGH header.\n");
+    znzclose(fp);
+    return VIO_ERROR;
+  }
+
+  flags = MINC_ROUND;
+  if (!minc_host_big_endian())
+  {
+    flags |= MINC_SWAP_DST;
+  }
+
+  n_voxels_in_slice = (size_t) file_sizes[0] * (size_t) file_sizes[1];
+  n_bytes_per_voxel = minc_value_size(value_type);
+  n_slices = 1;
+  for_less( axis, 2, n_file_dims )
+  {
+    n_slices *= file_sizes[axis];
+  }
+
+  data = malloc(n_voxels_in_slice * n_bytes_per_voxel);
+  if (data == NULL)
+  {
+    print_error("Failed to allocate the slice buffer.\n");
+    znzclose(fp);
+    return VIO_ERROR;
+  }
+  ALLOC(values, n_voxels_in_slice);
+
+  for_less( slice, 0, n_slices )
+  {
+    get_output_file_slice(volume, n_file_dims, volume_axis_from_file,
+                          file_sizes, slice, scale, translation, values);
+
+    minc_swap_convert(data, value_type, values, MINC_VALUE_DOUBLE,
+                      n_voxels_in_slice, flags);
+
+    if (znzwrite(data, n_bytes_per_voxel, n_voxels_in_slice, fp) !=
+        n_voxels_in_slice)
+    {
+      print_error("Failed to write MGH image data.\n");
+      status = VIO_ERROR;
+      break;
+    }
+  }
+
+  free(data);
+  FREE(values);
+  znzclose(fp);
+  return status;
+}
@@ -0,0 +1,27 @@
+/**
+ * \file Writer for MGH/MGZ (FreeSurfer) format files.
+ */
+
+#include <internal_volume_io.h>
+#include <volume_io/basic.h>
+#include <volume_io/volume.h>
+
+/**
+ * Writes a volume to an MGH file, compressed if the filename ends in
+ * ".mgz" or ".gz". MGH files hold real values, so the file type is
+ * unsigned byte, short, int or float, the nearest one that can hold the
+ * requested type, or float for the type of a scaled volume. The file is
+ * written a slice at a time, straight from the volume.
+ *
+ * \param filename The name of the file to create.
+ * \param file_nc_data_type The type of the file voxels, or
+ * MI_ORIGINAL_TYPE to use the type of the volume.
+ * \param file_signed_flag TRUE if the file voxels are signed.
+ * \param volume The volume to write.
+ * \return VIO_OK if successful.
+ */
+VIOAPI  VIO_Status
+output_mgh_format_volume(VIO_STR    filename,
+                         nc_type    file_nc_data_type,
+                         VIO_BOOL   file_signed_flag,
+                         VIO_Volume volume);
@@ -0,0 +1,279 @@
+/**
+ * \file Writer for NIfTI-1 format files.
+ *
+ * The volume is written a slice at a time: each slice is taken from the
+ * volume (or its cache) in file order, mapped to file voxel values, and
+ * converted to the file type in a single pass before it is written, so
+ * no copy of the whole volume is ever made.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include "output_nifti.h"
+#include "output_file.h"
+
+#include "nifti1.h"
+#include "nifti1_io.h"
+#include "swap_convert.h"
+
+#define NIFTI_MAX_FILE_DIMS 7   /* Dimensions after dim[0] in the header. */
+
+/**
+ * Chooses the NIfTI-1 data type for a netCDF type.
+ *
+ * \param nc_data_type The netCDF type.
+ * \param signed_flag TRUE if the type is signed.
+ * \param value_type_ptr Returns the matching swap_convert type.
+ * \return The NIfTI-1 data type, or DT_UNKNOWN.
+ */
+static int
+nifti_datatype_from_nc(nc_type nc_data_type, VIO_BOOL signed_flag,
+                       minc_value_type *value_type_ptr)
+{
+  switch (nc_data_type)
+  {
+  case NC_BYTE:
+    *value_type_ptr = signed_flag ? MINC_VALUE_BYTE : MINC_VALUE_UBYTE;
+    return signed_flag ? DT_INT8 : DT_UINT8;
+  case NC_SHORT:
+    *value_type_ptr = signed_flag ? MINC_VALUE_SHORT : MINC_VALUE_USHORT;
+    return signed_flag ? DT_INT16 : DT_UINT16;
+  case NC_INT:
+    *value_type_ptr = signed_flag ? MINC_VALUE_INT : MINC_VALUE_UINT;
+    return signed_flag ? DT_INT32 : DT_UINT32;
+  case NC_FLOAT:
+    *value_type_ptr = MINC_VALUE_FLOAT;
+    return DT_FLOAT32;
+  case NC_DOUBLE:
+    *value_type_ptr = MINC_VALUE_DOUBLE;
+    return DT_FLOAT64;
+  default:
+    return DT_UNKNOWN;
+  }
+}
+
+/**
+ * Sets the NIfTI-1 sform and qform, and the voxel sizes, from the
+ * volume's voxel to world transform.
+ */
+static void
+nifti_set_transform(nifti_image *nii_ptr, VIO_Real transform[][4])
+{
+  int i, j;
+  float qfac;
+
+  for (i = 0; i < 4; i++)
+  {
+    for (j = 0; j < 4; j++)
+    {
+      nii_ptr->sto_xyz.m[i][j] = (i < VIO_N_DIMENSIONS) ?
+        (float) transform[i][j] : (i == j ? 1.0f : 0.0f);
+    }
+  }
+  nii_ptr->sto_ijk = nifti_mat44_inverse(nii_ptr->sto_xyz);
+  nii_ptr->sform_code = NIFTI_XFORM_SCANNER_ANAT;
+
+  nifti_mat44_to_quatern(nii_ptr->sto_xyz,
+                         &nii_ptr->quatern_b, &nii_ptr->quatern_c,
+                         &nii_ptr->quatern_d, &nii_ptr->qoffset_x,
+                         &nii_ptr->qoffset_y, &nii_ptr->qoffset_z,
+                         &nii_ptr->dx, &nii_ptr->dy, &nii_ptr->dz, &qfac);
+  nii_ptr->qfac = qfac;
+  nii_ptr->qto_xyz = nifti_quatern_to_mat44(nii_ptr->quatern_b,
+                                            nii_ptr->quatern_c,
+                                            nii_ptr->quatern_d,
+                                            nii_ptr->qoffset_x,
+                                            nii_ptr->qoffset_y,
+                                            nii_ptr->qoffset_z,
+                                            nii_ptr->dx, nii_ptr->dy,
+                                            nii_ptr->dz, qfac);
+  nii_ptr->qto_ijk = nifti_mat44_inverse(nii_ptr->qto_xyz);
+  nii_ptr->qform_code = NIFTI_XFORM_SCANNER_ANAT;
+
+  nii_ptr->pixdim[1] = nii_ptr->dx;
+  nii_ptr->pixdim[2] = nii_ptr->dy;
+  nii_ptr->pixdim[3] = nii_ptr->dz;
+  nii_ptr->xyz_units = NIFTI_UNITS_MM;
+}
+
+VIOAPI  VIO_Status
+output_nifti_format_volume(VIO_STR    filename,
+                           nc_type    file_nc_data_type,
+                           VIO_BOOL   file_signed_flag,
+                           VIO_Real   file_voxel_min,
+                           VIO_Real   file_voxel_max,
+                           VIO_Volume volume,
+                           VIO_Real   real_min,
+                           VIO_Real   real_max)
+{
+  int               volume_axis_from_file[VIO_MAX_DIMENSIONS];
+  int               file_sizes[VIO_MAX_DIMENSIONS];
+  int               dims[8] = { 3, 1, 1, 1, 1, 1, 1, 1 };
+  int               n_file_dims, datatype, axis, slice, n_slices;
+  VIO_BOOL          volume_signed_flag;
+  nc_type           volume_nc_data_type;
+  minc_value_type   value_type;
+  VIO_Real          transform[VIO_N_DIMENSIONS][4];
+  VIO_Real          steps[VIO_MAX_DIMENSIONS], starts[VIO_MAX_DIMENSIONS];
+  VIO_Real          volume_scale, volume_translation;
+  VIO_Real          scale, translation, slope, intercept;
+  VIO_Real          *values;
+  void              *data;
+  size_t            n_voxels_in_slice;
+  nifti_image       *nii_ptr;
+  znzFile           fp;
+  VIO_Status        status = VIO_OK;
+
+  n_file_dims = get_output_file_axes(volume, NIFTI_MAX_FILE_DIMS,
+                                     volume_axis_from_file, file_sizes);
+  if (n_file_dims < 0)
+  {
+    print_error("Too many dimensions for a NIfTI-1 file.\n");
+    return VIO_ERROR;
+  }
+
+  volume_nc_data_type = get_volume_nc_data_type(volume, &volume_signed_flag);
+  if (file_nc_data_type == MI_ORIGINAL_TYPE)
+  {
+    file_nc_data_type = volume_nc_data_type;
+    file_signed_flag = volume_signed_flag;
+  }
+
+  datatype = nifti_datatype_from_nc(file_nc_data_type, file_signed_flag,
+                                    &value_type);
+  if (datatype == DT_UNKNOWN)
+  {
+    print_error("Unsupported NIfTI-1 output type.\n");
+    return VIO_ERROR;
+  }
+
+  dims[0] = n_file_dims;
+  for_less( axis, 0, n_file_dims )
+  {
+    dims[axis + 1] = file_sizes[axis];
+  }
+
+  nii_ptr = nifti_make_new_nim(dims, datatype, 0);
+  if (nii_ptr == NULL)
+  {
+    return VIO_ERROR;
+  }
+
+  get_output_file_transform(volume, volume_axis_from_file, transform);
+  nifti_set_transform(nii_ptr, transform);
+
+  /* Any time axis follows the spatial ones. */
+  if (n_file_dims > VIO_N_DIMENSIONS)
+  {
+    get_volume_separations(volume, steps);
+    get_volume_starts(volume, starts);
+    nii_ptr->dt = nii_ptr->pixdim[4] = steps[volume_axis_from_file[3]];
+    nii_ptr->toffset = starts[volume_axis_from_file[3]];
+    nii_ptr->time_units = NIFTI_UNITS_SEC;
+  }
+
+  /* Real values of the volume are voxel * volume_scale + volume_translation,
+   * and the file voxels are written as voxel * scale + translation.
+   */
+  volume_translation = convert_voxel_to_value(volume, 0.0);
+  volume_scale = convert_voxel_to_value(volume, 1.0) - volume_translation;
+
+  if (value_type == MINC_VALUE_FLOAT || value_type == MINC_VALUE_DOUBLE)
+  {
+    /* Real values, unscaled. */
+    scale = volume_scale;
+    translation = volume_translation;
+    slope = 0.0;
+    intercept = 0.0;
+  }
+  else if (file_nc_data_type == volume_nc_data_type &&
+           file_signed_flag == volume_signed_flag &&
+           file_voxel_min >= file_voxel_max)
+  {
+    /* The volume voxels, with the volume scaling. */
+    scale = 1.0;
+    translation = 0.0;
+    slope = volume_scale;
+    intercept = volume_translation;
+  }
+  else
+  {
+    /* Map the real range to the file voxel range. */
+    if (file_voxel_min >= file_voxel_max)
+    {
+      get_type_range(minc2_type_to_vio_type(
+                       nc_type_to_minc2_type(file_nc_data_type,
+                                             file_signed_flag)),
+                     &file_voxel_min, &file_voxel_max);
+    }
+    slope = (real_max - real_min) / (file_voxel_max - file_voxel_min);
+    if (slope <= 0.0)
+    {
+      slope = 1.0;
+    }
+    intercept = real_min - file_voxel_min * slope;
+    scale = volume_scale / slope;
+    translation = (volume_translation - intercept) / slope;
+  }
+  nii_ptr->scl_slope = (float) slope;
+  nii_ptr->scl_inter = (float) intercept;
+  nii_ptr->cal_min = (float) real_min;
+  nii_ptr->cal_max = (float) real_max;
+
+  if (nifti_set_filenames(nii_ptr, filename, 0, 1) != 0)
+  {
+    nifti_image_free(nii_ptr);
+    return VIO_ERROR;
+  }
+
+  /* Write the header, and keep the file open for the image data. */
+  fp = nifti_image_write_hdr_img(nii_ptr, 2, "wb");
+  if (znz_isnull(fp))
+  {
+    print_error("Failed to create NIfTI-1 file '%s'.\n", filename);
+    nifti_image_free(nii_ptr);
+    return VIO_ERROR;
+  }
+
+  n_voxels_in_slice = (size_t) file_sizes[0] * (size_t) file_sizes[1];
+  n_slices = 1;
+  for_less( axis, 2, n_file_dims )
+  {
+    n_slices *= file_sizes[axis];
+  }
+
+  data = malloc(n_voxels_in_slice * nii_ptr->nbyper);
+  if (data == NULL)
+  {
+    print_error("Failed to allocate the slice buffer.\n");
+    znzclose(fp);
+    nifti_image_free(nii_ptr);
+    return VIO_ERROR;
+  }
+  ALLOC(values, n_voxels_in_slice);
+
+  for_less( slice, 0, n_slices )
+  {
+    get_output_file_slice(volume, n_file_dims, volume_axis_from_file,
+                          file_sizes, slice, scale, translation, values);
+
+    minc_swap_convert(data, value_type, values, MINC_VALUE_DOUBLE,
+                      n_voxels_in_slice, MINC_ROUND);
+
+    if (znzwrite(data, nii_ptr->nbyper, n_voxels_in_slice, fp) !=
+        n_voxels_in_slice)
+    {
+      print_error("Failed to write NIfTI-1 image data.\n");
+      status = VIO_ERROR;
+      break;
+    }
+  }
+
+  free(data);
+  FREE(values);
+  znzclose(fp);
+  nifti_image_free(nii_ptr);
+  return status;
+}
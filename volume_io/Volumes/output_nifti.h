@@ -0,0 +1,33 @@
+/**
+ * \file Writer for NIfTI-1 format files.
+ */
+
+#include <internal_volume_io.h>
+#include <volume_io/basic.h>
+#include <volume_io/volume.h>
+
+/**
+ * Writes a volume to a NIfTI-1 file, compressed if the filename ends in
+ * ".gz". The file is written a slice at a time, straight from the volume.
+ *
+ * \param filename The name of the file to create.
+ * \param file_nc_data_type The type of the file voxels, or
+ * MI_ORIGINAL_TYPE to use the type of the volume.
+ * \param file_signed_flag TRUE if the file voxels are signed.
+ * \param file_voxel_min The smallest file voxel value to use.
+ * \param file_voxel_max The largest file voxel value to use, or less than
+ * file_voxel_min for the full range of the type.
+ * \param volume The volume to write.
+ * \param real_min The real value written as file_voxel_min.
+ * \param real_max The real value written as file_voxel_max.
+ * \return VIO_OK if successful.
+ */
+VIOAPI  VIO_Status
+output_nifti_format_volume(VIO_STR    filename,
+                           nc_type    file_nc_data_type,
+                           VIO_BOOL   file_signed_flag,
+                           VIO_Real   file_voxel_min,
+                           VIO_Real   file_voxel_max,
+                           VIO_Volume volume,
+                           VIO_Real   real_min,
+                           VIO_Real   real_max);
@@ -18,7 +18,12 @@
 
 
 #include  <internal_volume_io.h>
+#include  "output_file.h"
 
+#ifdef LIBMINC_NIFTI_SUPPORT
+#include "output_mgh.h"
+#include "output_nifti.h"
+#endif /*LIBMINC_NIFTI_SUPPORT*/
 
 static void calculate_volume_real_range(VIO_Volume volume,double *real_min,double *real_max);
 
@@ -290,6 +295,219 @@ VIOAPI  VIO_Status   copy_volume_auxiliary_and_history(
     return( status );
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_output_file_axes
+@INPUT      : volume
+              max_file_dims
+@OUTPUT     : volume_axis_from_file
+              file_sizes
+@RETURNS    : number of file dimensions, or -1 if there are too many
+@DESCRIPTION: Lays out the volume for the file formats that store x, y and z
+              as the first three file axes, x varying fastest, followed by
+              any other dimensions of the volume.  Spatial axes missing from
+              the volume have a volume_axis_from_file[] of -1, and a size of
+              one in the file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+int  get_output_file_axes(
+    VIO_Volume   volume,
+    int          max_file_dims,
+    int          volume_axis_from_file[],
+    int          file_sizes[] )
+{
+    int       axis, dim, n_dims, n_file_dims;
+    int       sizes[VIO_MAX_DIMENSIONS];
+    VIO_BOOL  used[VIO_MAX_DIMENSIONS];
+
+    n_dims = get_volume_n_dimensions( volume );
+    get_volume_sizes( volume, sizes );
+
+    for_less( dim, 0, n_dims )
+        used[dim] = FALSE;
+
+    for_less( axis, 0, VIO_N_DIMENSIONS )
+    {
+        dim = volume->spatial_axes[axis];
+        volume_axis_from_file[axis] = dim;
+        file_sizes[axis] = 1;
+
+        if( dim >= 0 )
+        {
+            file_sizes[axis] = sizes[dim];
+            used[dim] = TRUE;
+        }
+    }
+
+    n_file_dims = VIO_N_DIMENSIONS;
+
+    for_less( dim, 0, n_dims )
+    {
+        if( used[dim] )
+            continue;
+
+        if( n_file_dims >= max_file_dims )
+            return( -1 );
+
+        volume_axis_from_file[n_file_dims] = dim;
+        file_sizes[n_file_dims] = sizes[dim];
+        ++n_file_dims;
+    }
+
+    return( n_file_dims );
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_output_file_transform
+@INPUT      : volume
+              volume_axis_from_file
+@OUTPUT     : transform
+@RETURNS    : 
+@DESCRIPTION: Gets the linear voxel to world transform of the file laid out
+              by get_output_file_axes(), as a 3 by 4 matrix.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+void  get_output_file_transform(
+    VIO_Volume   volume,
+    int          volume_axis_from_file[],
+    VIO_Real     transform[VIO_N_DIMENSIONS][4] )
+{
+    int       axis, dim, i;
+    VIO_Real  voxel[VIO_MAX_DIMENSIONS];
+    VIO_Real  origin[VIO_N_DIMENSIONS], world[VIO_N_DIMENSIONS];
+
+    for_less( dim, 0, VIO_MAX_DIMENSIONS )
+        voxel[dim] = 0.0;
+
+    convert_voxel_to_world( volume, voxel,
+                            &origin[VIO_X], &origin[VIO_Y], &origin[VIO_Z] );
+
+    for_less( axis, 0, VIO_N_DIMENSIONS )
+    {
+        dim = volume_axis_from_file[axis];
+
+        if( dim < 0 )
+        {
+            for_less( i, 0, VIO_N_DIMENSIONS )
+                transform[i][axis] = (i == axis) ? 1.0 : 0.0;
+            continue;
+        }
+
+        voxel[dim] = 1.0;
+        convert_voxel_to_world( volume, voxel,
+                                &world[VIO_X], &world[VIO_Y], &world[VIO_Z] );
+        voxel[dim] = 0.0;
+
+        for_less( i, 0, VIO_N_DIMENSIONS )
+            transform[i][axis] = world[i] - origin[i];
+    }
+
+    for_less( i, 0, VIO_N_DIMENSIONS )
+        transform[i][3] = origin[i];
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_output_file_slice
+@INPUT      : volume
+              n_file_dims
+              volume_axis_from_file
+              file_sizes
+              slice
+              scale
+              translation
+@OUTPUT     : values
+@RETURNS    : 
+@DESCRIPTION: Gets one slice, the first two file axes, of the file laid out
+              by get_output_file_axes(), in file order.  Slices are numbered
+              through the remaining file axes, the third varying fastest.
+              The voxel values are mapped to voxel * scale + translation.
+              Cached volumes are read through the cache.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+void  get_output_file_slice(
+    VIO_Volume   volume,
+    int          n_file_dims,
+    int          volume_axis_from_file[],
+    int          file_sizes[],
+    int          slice,
+    VIO_Real     scale,
+    VIO_Real     translation,
+    VIO_Real     values[] )
+{
+    int       axis, dim, row, x_dim, y_dim;
+    int       start[VIO_MAX_DIMENSIONS], count[VIO_MAX_DIMENSIONS];
+    size_t    i, n_values;
+
+    for_less( dim, 0, VIO_MAX_DIMENSIONS )
+    {
+        start[dim] = 0;
+        count[dim] = 1;
+    }
+
+    for_less( axis, 2, n_file_dims )
+    {
+        dim = volume_axis_from_file[axis];
+        if( dim >= 0 )
+            start[dim] = slice % file_sizes[axis];
+        slice /= file_sizes[axis];
+    }
+
+    x_dim = volume_axis_from_file[0];
+    y_dim = volume_axis_from_file[1];
+    n_values = (size_t) file_sizes[0] * (size_t) file_sizes[1];
+
+    if( x_dim >= 0 )
+        count[x_dim] = file_sizes[0];
+
+    /*--- if x varies faster than y in the volume, the slice is in file
+          order already, otherwise get it a row at a time */
+
+    if( y_dim < 0 || x_dim > y_dim )
+    {
+        if( y_dim >= 0 )
+            count[y_dim] = file_sizes[1];
+
+        get_volume_voxel_hyperslab( volume,
+                                    start[0], start[1], start[2],
+                                    start[3], start[4],
+                                    count[0], count[1], count[2],
+                                    count[3], count[4], values );
+    }
+    else
+    {
+        for_less( row, 0, file_sizes[1] )
+        {
+            start[y_dim] = row;
+            get_volume_voxel_hyperslab( volume,
+                                        start[0], start[1], start[2],
+                                        start[3], start[4],
+                                        count[0], count[1], count[2],
+                                        count[3], count[4],
+                                        &values[(size_t) row * file_sizes[0]] );
+        }
+    }
+
+    if( scale != 1.0 || translation != 0.0 )
+    {
+        for_less( i, 0, n_values )
+            values[i] = values[i] * scale + translation;
+    }
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : output_modified_volume
 @INPUT      : filename
@@ -336,14 +554,6 @@ VIOAPI  VIO_Status  output_modified_volume(
     VIO_STR               *dim_names;
     minc_output_options  used_options;
 
-    dim_names = create_output_dim_names( volume, original_filename,
-                                         options, sizes );
-
-    if( dim_names == NULL )
-        return( VIO_ERROR );
-
-    n_dims = get_volume_n_dimensions(volume);
-
     if( options == NULL )
         set_default_minc_output_options( &used_options );
     else 
@@ -364,6 +574,39 @@ VIOAPI  VIO_Status  output_modified_volume(
         set_minc_output_real_range( &used_options, real_min, real_max );
     }
 
+#ifdef LIBMINC_NIFTI_SUPPORT
+    /*--- NIfTI-1 and MGH files are written by their own writers, which
+          do not keep the auxiliary data or history */
+
+    if( filename_extension_matches( filename, "nii" ) ||
+        filename_extension_matches( filename, "hdr" ) )
+    {
+        return( output_nifti_format_volume( filename,
+                                            file_nc_data_type,
+                                            file_signed_flag,
+                                            file_voxel_min, file_voxel_max,
+                                            volume,
+                                            used_options.global_image_range[0],
+                                            used_options.global_image_range[1] ) );
+    }
+
+    if( filename_extension_matches( filename, "mgh" ) ||
+        filename_extension_matches( filename, "mgz" ) )
+    {
+        return( output_mgh_format_volume( filename,
+                                          file_nc_data_type, file_signed_flag,
+                                          volume ) );
+    }
+#endif /*LIBMINC_NIFTI_SUPPORT*/
+
+    dim_names = create_output_dim_names( volume, original_filename,
+                                         options, sizes );
+
+    if( dim_names == NULL )
+        return( VIO_ERROR );
+
+    n_dims = get_volume_n_dimensions(volume);
+
     /*--- if the user has not explicitly set the use_volume_starts_and_steps
           flag, let's set it if the transform is linear, to output the
           same starts as was input, and avoid round-off error */
@@ -0,0 +1,340 @@
+/**
+ * \file Read-ahead decompression for the NIfTI-1, MGH and NRRD readers.
+ *
+ * An inflater thread owns the znzFile of a compressed file and inflates
+ * it into a ring of large buffers, while the reader copies out of the
+ * buffers that are already full. Inflating the next part of a .nii.gz, .mgz
+ * or gzip NRRD then overlaps with the reader converting the previous part.
+ *
+ * An index of inflate restart points, as in the zran example of zlib,
+ * would also make backward seeks cheap, but it is not built. The readers
+ * only seek forward, past the frames that are not wanted, and the gzFile
+ * behind a znzFile does not expose the inflate state such an index is
+ * made of.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif /*HAVE_CONFIG_H*/
+
+#include "read_ahead.h"
+
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+/* Build with NO_READ_AHEAD to always read on the calling thread.
+ */
+#if defined(HAVE_PTHREAD_H) && !defined(NO_READ_AHEAD)
+#define USE_READ_AHEAD 1
+#include <pthread.h>
+#endif
+
+#define READ_AHEAD_BUFFERS      8
+#define READ_AHEAD_BUFFER_SIZE  (1 << 20)
+
+struct read_ahead_struct
+{
+  znzFile         fp;
+#ifdef USE_READ_AHEAD
+  VIO_BOOL        threaded;     /* inflate on a background thread */
+  VIO_BOOL        running;      /* the thread has been started */
+  long            position;     /* uncompressed position of the reader */
+  pthread_t       thread;
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  char            *buffers[READ_AHEAD_BUFFERS];
+  size_t          lengths[READ_AHEAD_BUFFERS]; /* bytes in each buffer */
+  int             head;         /* next buffer to fill */
+  int             tail;         /* buffer being read */
+  int             n_full;       /* number of full buffers */
+  size_t          offset;       /* read position in the tail buffer */
+  VIO_BOOL        done;         /* the thread reached the end of the data */
+  VIO_BOOL        stop;         /* the thread should exit */
+#endif /* USE_READ_AHEAD */
+};
+
+#ifdef USE_READ_AHEAD
+
+/**
+ * Fills the buffers, in turn, until the end of the file or until asked
+ * to stop.
+ */
+static void *
+read_ahead_thread(void *arg)
+{
+  read_ahead_file file = (read_ahead_file) arg;
+  size_t n_read;
+  int b;
+
+  pthread_mutex_lock(&file->lock);
+  for (;;)
+  {
+    while (!file->stop && file->n_full == READ_AHEAD_BUFFERS)
+    {
+      pthread_cond_wait(&file->cond, &file->lock);
+    }
+    if (file->stop)
+    {
+      break;
+    }
+
+    /* The reader does not touch the head buffer until it is counted.
+     */
+    b = file->head;
+    pthread_mutex_unlock(&file->lock);
+    n_read = znzread(file->buffers[b], 1, READ_AHEAD_BUFFER_SIZE, file->fp);
+    pthread_mutex_lock(&file->lock);
+
+    file->lengths[b] = n_read;
+    file->head = (b + 1) % READ_AHEAD_BUFFERS;
+    file->n_full++;
+    if (n_read < READ_AHEAD_BUFFER_SIZE)
+    {
+      file->done = TRUE;
+    }
+    pthread_cond_broadcast(&file->cond);
+    if (file->done)
+    {
+      break;
+    }
+  }
+  pthread_mutex_unlock(&file->lock);
+  return NULL;
+}
+
+/**
+ * Releases the buffers and the synchronization objects of the thread.
+ */
+static void
+free_read_ahead(read_ahead_file file)
+{
+  int i;
+
+  pthread_cond_destroy(&file->cond);
+  pthread_mutex_destroy(&file->lock);
+  for (i = 0; i < READ_AHEAD_BUFFERS; i++)
+  {
+    free(file->buffers[i]);
+    file->buffers[i] = NULL;
+  }
+}
+
+/**
+ * Starts the thread at the current position of the znzFile, or falls
+ * back to reading on the calling thread if it cannot be started.
+ */
+static void
+start_read_ahead(read_ahead_file file)
+{
+  file->head = 0;
+  file->tail = 0;
+  file->n_full = 0;
+  file->offset = 0;
+  file->done = FALSE;
+  file->stop = FALSE;
+
+  if (pthread_create(&file->thread, NULL, read_ahead_thread, file) == 0)
+  {
+    file->running = TRUE;
+  }
+  else
+  {
+    free_read_ahead(file);
+    file->threaded = FALSE;
+  }
+}
+
+/**
+ * Stops the thread. The znzFile is then somewhere ahead of the reader.
+ */
+static void
+stop_read_ahead(read_ahead_file file)
+{
+  if (!file->running)
+  {
+    return;
+  }
+  pthread_mutex_lock(&file->lock);
+  file->stop = TRUE;
+  pthread_cond_broadcast(&file->cond);
+  pthread_mutex_unlock(&file->lock);
+  pthread_join(file->thread, NULL);
+  file->running = FALSE;
+}
+
+/**
+ * Copies up to n_bytes out of the buffers, or only skips them if data is
+ * NULL.
+ */
+static size_t
+read_ahead_buffers(read_ahead_file file, char *data, size_t n_bytes)
+{
+  size_t n_done = 0;
+
+  pthread_mutex_lock(&file->lock);
+  while (n_done < n_bytes)
+  {
+    int t;
+    size_t n_copy;
+
+    while (file->n_full == 0 && !file->done)
+    {
+      pthread_cond_wait(&file->cond, &file->lock);
+    }
+    if (file->n_full == 0)
+    {
+      break;
+    }
+
+    /* The thread does not touch the tail buffer while it is counted.
+     */
+    t = file->tail;
+    n_copy = file->lengths[t] - file->offset;
+    if (n_copy > n_bytes - n_done)
+    {
+      n_copy = n_bytes - n_done;
+    }
+    if (n_copy > 0)
+    {
+      pthread_mutex_unlock(&file->lock);
+      if (data != NULL)
+      {
+        memcpy(data + n_done, file->buffers[t] + file->offset, n_copy);
+      }
+      pthread_mutex_lock(&file->lock);
+      file->offset += n_copy;
+      n_done += n_copy;
+    }
+    if (file->offset == file->lengths[t])
+    {
+      file->tail = (t + 1) % READ_AHEAD_BUFFERS;
+      file->offset = 0;
+      file->n_full--;
+      pthread_cond_broadcast(&file->cond);
+    }
+  }
+  pthread_mutex_unlock(&file->lock);
+
+  file->position += (long) n_done;
+  return n_done;
+}
+
+#endif /* USE_READ_AHEAD */
+
+read_ahead_file
+open_read_ahead(znzFile fp, VIO_BOOL compressed)
+{
+  read_ahead_file file;
+
+  if ((file = calloc(1, sizeof(struct read_ahead_struct))) == NULL)
+  {
+    return NULL;
+  }
+  file->fp = fp;
+
+#ifdef USE_READ_AHEAD
+  file->threaded = compressed;
+#ifdef _SC_NPROCESSORS_ONLN
+  /* With a single processor the thread only adds copying.
+   */
+  if (sysconf(_SC_NPROCESSORS_ONLN) < 2)
+  {
+    file->threaded = FALSE;
+  }
+#endif
+  if (file->threaded)
+  {
+    int i;
+
+    for (i = 0; i < READ_AHEAD_BUFFERS; i++)
+    {
+      if ((file->buffers[i] = malloc(READ_AHEAD_BUFFER_SIZE)) == NULL)
+      {
+        while (i-- > 0)
+        {
+          free(file->buffers[i]);
+          file->buffers[i] = NULL;
+        }
+        file->threaded = FALSE;
+        break;
+      }
+    }
+  }
+  if (file->threaded)
+  {
+    pthread_mutex_init(&file->lock, NULL);
+    pthread_cond_init(&file->cond, NULL);
+    file->position = znztell(fp);
+  }
+#endif /* USE_READ_AHEAD */
+
+  return file;
+}
+
+size_t
+read_ahead_data(read_ahead_file file, void *data, size_t n_bytes)
+{
+#ifdef USE_READ_AHEAD
+  if (file->threaded && !file->running)
+  {
+    start_read_ahead(file);
+  }
+  if (file->running)
+  {
+    return read_ahead_buffers(file, (char *) data, n_bytes);
+  }
+#endif /* USE_READ_AHEAD */
+  return znzread(data, 1, n_bytes, file->fp);
+}
+
+VIO_Status
+read_ahead_seek(read_ahead_file file, long offset)
+{
+#ifdef USE_READ_AHEAD
+  if (file->running)
+  {
+    if (offset >= file->position)
+    {
+      read_ahead_buffers(file, NULL, (size_t) (offset - file->position));
+      return (file->position == offset) ? VIO_OK : VIO_ERROR;
+    }
+
+    /* Inflate again from the start, and restart the thread from the
+     * new position on the next read.
+     */
+    stop_read_ahead(file);
+  }
+  if (file->threaded)
+  {
+    file->position = offset;
+  }
+#endif /* USE_READ_AHEAD */
+  return (znzseek(file->fp, offset, SEEK_SET) < 0) ? VIO_ERROR : VIO_OK;
+}
+
+long
+read_ahead_tell(read_ahead_file file)
+{
+#ifdef USE_READ_AHEAD
+  if (file->threaded)
+  {
+    return file->position;
+  }
+#endif /* USE_READ_AHEAD */
+  return znztell(file->fp);
+}
+
+void
+close_read_ahead(read_ahead_file file)
+{
+#ifdef USE_READ_AHEAD
+  if (file->threaded)
+  {
+    stop_read_ahead(file);
+    free_read_ahead(file);
+  }
+#endif /* USE_READ_AHEAD */
+  znzclose(file->fp);
+  free(file);
+}
@@ -0,0 +1,59 @@
+/**
+ * \file Read-ahead decompression for the NIfTI-1, MGH and NRRD readers.
+ */
+
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#include <internal_volume_io.h>
+#include <volume_io/basic.h>
+
+#include "znzlib.h"
+
+/** A znzFile being read, possibly through a background inflater thread.
+ */
+typedef struct read_ahead_struct *read_ahead_file;
+
+/**
+ * Takes over an open znzFile. If it is compressed, and threads and more
+ * than one processor are available, the data after the current position
+ * is inflated ahead of the reader by a background thread, starting with
+ * the first read.
+ *
+ * \param fp The file, opened for reading.
+ * \param compressed TRUE if the file is gzip compressed.
+ * \return The file, or NULL if out of memory.
+ */
+read_ahead_file
+open_read_ahead(znzFile fp, VIO_BOOL compressed);
+
+/**
+ * Reads up to \a n_bytes of data.
+ *
+ * \return The number of bytes read, less than \a n_bytes only at the end
+ * of the file or on an error.
+ */
+size_t
+read_ahead_data(read_ahead_file file, void *data, size_t n_bytes);
+
+/**
+ * Moves to a position in the uncompressed data. Forward seeks skip
+ * through the data already inflated; backward seeks stop the thread and
+ * inflate again from the start of the file.
+ */
+VIO_Status
+read_ahead_seek(read_ahead_file file, long offset);
+
+/**
+ * Returns the position in the uncompressed data.
+ */
+long
+read_ahead_tell(read_ahead_file file);
+
+/**
+ * Stops the thread and closes the file.
+ */
+void
+close_read_ahead(read_ahead_file file);
+
+#endif /* READ_AHEAD_H */
@@ -173,6 +173,9 @@ VIOAPI   VIO_Volume   create_volume(
 
     volume->is_rgba_data = FALSE;
     volume->is_cached_volume = FALSE;
+    volume->external_storage = FALSE;
+    volume->release_storage = NULL;
+    volume->storage_handle = NULL;
 
     volume->real_range_set = FALSE;
     volume->real_value_scale = 1.0;
@@ -611,6 +614,12 @@ VIOAPI  void  alloc_volume_data(
 {
 #ifdef HAVE_MINC1
     unsigned long   data_size;
+#endif /*HAVE_MINC1*/
+
+    if( volume->external_storage )
+        free_volume_data( volume );
+
+#ifdef HAVE_MINC1
 
     data_size = (unsigned long) get_volume_total_n_voxels( volume ) *
                 (unsigned long) get_type_size( get_volume_data_type( volume ) );
@@ -631,6 +640,51 @@ VIOAPI  void  alloc_volume_data(
 #endif /*HAVE_MINC1*/
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : set_volume_data_storage
+@INPUT      : volume
+              storage
+              release_storage
+              storage_handle
+@OUTPUT     : 
+@RETURNS    : TRUE if the storage is used for the volume data
+@DESCRIPTION: Uses storage, which holds the voxels of the volume contiguously
+              in the volume data type and in volume order, as the volume data
+              instead of allocating it.  When the volume data is freed,
+              release_storage, if not NULL, is called with storage_handle.
+              Returns FALSE, and leaves the volume alone, if the storage is
+              not aligned for the data type.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : Oct. 19, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+
+VIOAPI  VIO_BOOL  set_volume_data_storage(
+    VIO_Volume   volume,
+    void         *storage,
+    void         (*release_storage)( void * ),
+    void         *storage_handle )
+{
+    VIO_Data_types  data_type = get_volume_data_type( volume );
+
+    if( data_type == VIO_NO_DATA_TYPE || storage == NULL ||
+        (size_t) storage % (size_t) get_type_size( data_type ) != 0 )
+        return( FALSE );
+
+    free_volume_data( volume );
+
+    volume->is_cached_volume = FALSE;
+    set_multidim_storage( &volume->array, storage );
+
+    volume->external_storage = TRUE;
+    volume->release_storage = release_storage;
+    volume->storage_handle = storage_handle;
+
+    return( TRUE );
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : volume_is_alloced
 @INPUT      : volume
@@ -671,6 +725,18 @@ VIOAPI  VIO_BOOL  volume_is_alloced(
 VIOAPI  void  free_volume_data(
     VIO_Volume   volume )
 {
+    if( volume->external_storage )
+    {
+        delete_multidim_storage( &volume->array );
+        if( volume->release_storage != NULL )
+            (*volume->release_storage)( volume->storage_handle );
+
+        volume->external_storage = FALSE;
+        volume->release_storage = NULL;
+        volume->storage_handle = NULL;
+        return;
+    }
+
 #ifdef HAVE_MINC1
     if( volume->is_cached_volume )
         delete_volume_cache( &volume->cache, volume );